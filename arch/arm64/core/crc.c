@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+
+#ifndef __ARM_FEATURE_CRC32
+/* Optional in ARMv8.0, but implemented by all the supported cores */
+#pragma GCC target("+crc")
+#endif
+#include <arm_acle.h>
+
+#define WORD_MASK (sizeof(uint64_t) - 1)
+
+uint32_t arch_crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+	for (; len > 0 && (POINTER_TO_UINT(data) & WORD_MASK); len--) {
+		crc = __crc32b(crc, *data++);
+	}
+
+	for (; len >= sizeof(uint64_t); len -= sizeof(uint64_t)) {
+		crc = __crc32d(crc, *(const uint64_t *)data);
+		data += sizeof(uint64_t);
+	}
+
+	for (; len > 0; len--) {
+		crc = __crc32b(crc, *data++);
+	}
+
+	return crc;
+}
+
+uint32_t arch_crc32c_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+	for (; len > 0 && (POINTER_TO_UINT(data) & WORD_MASK); len--) {
+		crc = __crc32cb(crc, *data++);
+	}
+
+	for (; len >= sizeof(uint64_t); len -= sizeof(uint64_t)) {
+		crc = __crc32cd(crc, *(const uint64_t *)data);
+		data += sizeof(uint64_t);
+	}
+
+	for (; len > 0; len--) {
+		crc = __crc32cb(crc, *data++);
+	}
+
+	return crc;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <nmmintrin.h> /* Header provided by the toolchain. */
+
+#include <zephyr/kernel.h>
+
+/* The crc32 instruction of SSE4.2 only implements the Castagnoli
+ * polynomial, so crc32_ieee() keeps using the tables.
+ */
+
+#ifdef CONFIG_X86_64
+typedef uint64_t crc_word_t;
+#define crc32c_word _mm_crc32_u64
+#else
+typedef uint32_t crc_word_t;
+#define crc32c_word _mm_crc32_u32
+#endif
+
+uint32_t arch_crc32c_update(uint32_t crc, const uint8_t *data, size_t len)
+{
+	for (; len > 0 && (POINTER_TO_UINT(data) & (sizeof(crc_word_t) - 1));
+	     len--) {
+		crc = _mm_crc32_u8(crc, *data++);
+	}
+
+	for (; len >= sizeof(crc_word_t); len -= sizeof(crc_word_t)) {
+		crc = crc32c_word(crc, *(const crc_word_t *)data);
+		data += sizeof(crc_word_t);
+	}
+
+	for (; len > 0; len--) {
+		crc = _mm_crc32_u8(crc, *data++);
+	}
+
+	return crc;
+}
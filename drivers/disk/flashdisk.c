@@ -11,16 +11,26 @@
 #include <zephyr/drivers/disk.h>
 #include <errno.h>
 #include <zephyr/init.h>
+#include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/flash.h>
 
 #define SECTOR_SIZE CONFIG_DISK_FLASH_SECTOR_SIZE
+#define SECTOR_COUNT (CONFIG_DISK_VOLUME_SIZE / SECTOR_SIZE)
 
 static const struct device *flash_dev;
+static K_MUTEX_DEFINE(flash_disk_lock);
 
+#if !defined(CONFIG_DISK_FLASH_WRITE_BACK_CACHE)
 /* flash read-copy-erase-write operation */
 static uint8_t __aligned(4) read_copy_buf[CONFIG_DISK_ERASE_BLOCK_SIZE];
 static uint8_t *fs_buff = read_copy_buf;
+#endif
+
+#if defined(CONFIG_DISK_FLASH_TRIM)
+/* Sectors trimmed and not written since */
+static ATOMIC_DEFINE(trimmed, SECTOR_COUNT);
+#endif
 
 /* calculate number of blocks required for a given size */
 #define GET_NUM_BLOCK(total_size, block_size) \
@@ -41,6 +51,40 @@ static off_t lba_to_address(uint32_t sector_num)
 	return flash_addr;
 }
 
+/* Whether the len bytes of flash at addr hold data to preserve, besides the
+ * size bytes at start_addr about to be overwritten.
+ */
+static bool has_live_data(off_t addr, uint32_t len, off_t start_addr,
+			  uint32_t size)
+{
+	off_t end = addr + len;
+
+	while (addr < end) {
+		uint32_t offset = (addr - CONFIG_DISK_FLASH_START) % SECTOR_SIZE;
+		uint32_t step = MIN(SECTOR_SIZE - offset, end - addr);
+
+		if ((addr < start_addr) || (addr + step > start_addr + size)) {
+#if defined(CONFIG_DISK_FLASH_TRIM)
+			/* outside of the volume, or not trimmed */
+			if ((addr < CONFIG_DISK_FLASH_START) ||
+			    (addr >= CONFIG_DISK_FLASH_START +
+				      CONFIG_DISK_VOLUME_SIZE) ||
+			    !atomic_test_bit(trimmed,
+					     (addr - CONFIG_DISK_FLASH_START) /
+					     SECTOR_SIZE)) {
+				return true;
+			}
+#else
+			return true;
+#endif
+		}
+
+		addr += step;
+	}
+
+	return false;
+}
+
 static int disk_flash_access_status(struct disk_info *disk)
 {
 	if (!flash_dev) {
@@ -64,16 +108,13 @@ static int disk_flash_access_init(struct disk_info *disk)
 	return 0;
 }
 
-static int disk_flash_access_read(struct disk_info *disk, uint8_t *buff,
-				uint32_t start_sector, uint32_t sector_count)
+static int read_flash(off_t fl_addr, uint8_t *buff, uint32_t size)
 {
-	off_t fl_addr;
 	uint32_t remaining;
 	uint32_t len;
 	uint32_t num_read;
 
-	fl_addr = lba_to_address(start_sector);
-	remaining = (sector_count * SECTOR_SIZE);
+	remaining = size;
 	len = CONFIG_DISK_FLASH_MAX_RW_SIZE;
 
 	num_read = GET_NUM_BLOCK(remaining, CONFIG_DISK_FLASH_MAX_RW_SIZE);
@@ -95,6 +136,7 @@ static int disk_flash_access_read(struct disk_info *disk, uint8_t *buff,
 	return 0;
 }
 
+#if !defined(CONFIG_DISK_FLASH_WRITE_BACK_CACHE)
 /* This performs read-copy into an output buffer */
 static int read_copy_flash_block(off_t start_addr, uint32_t size,
 				 const void *src_buff,
@@ -115,10 +157,16 @@ static int read_copy_flash_block(off_t start_addr, uint32_t size,
 	num_read = GET_NUM_BLOCK(CONFIG_DISK_ERASE_BLOCK_SIZE,
 				 CONFIG_DISK_FLASH_MAX_RW_SIZE);
 
-	/* read one block from flash */
+	/* read one block from flash, except what is overwritten or trimmed */
 	for (uint32_t i = 0; i < num_read; i++) {
 		int rc;
 
+		if (!has_live_data(fl_addr + (CONFIG_DISK_FLASH_MAX_RW_SIZE * i),
+				   CONFIG_DISK_FLASH_MAX_RW_SIZE,
+				   start_addr, size)) {
+			continue;
+		}
+
 		rc = flash_read(flash_dev,
 				fl_addr + (CONFIG_DISK_FLASH_MAX_RW_SIZE * i),
 				dest_buff + (CONFIG_DISK_FLASH_MAX_RW_SIZE * i),
@@ -133,6 +181,7 @@ static int read_copy_flash_block(off_t start_addr, uint32_t size,
 
 	return 0;
 }
+#endif
 
 /* input size is either less or equal to a block size,
  * CONFIG_DISK_ERASE_BLOCK_SIZE.
@@ -143,6 +192,7 @@ static int update_flash_block(off_t start_addr, uint32_t size, const void *buff)
 	uint8_t *src = (uint8_t *)buff;
 	uint32_t num_write;
 
+#if !defined(CONFIG_DISK_FLASH_WRITE_BACK_CACHE)
 	/* if size is a partial block, perform read-copy with user data */
 	if (size < CONFIG_DISK_ERASE_BLOCK_SIZE) {
 		int rc;
@@ -155,6 +205,10 @@ static int update_flash_block(off_t start_addr, uint32_t size, const void *buff)
 		/* now use the local buffer as the source */
 		src = (uint8_t *)fs_buff;
 	}
+#else
+	/* the cache only writes back whole blocks */
+	__ASSERT_NO_MSG(size == CONFIG_DISK_ERASE_BLOCK_SIZE);
+#endif
 
 	/* always align starting address for flash write operation */
 	fl_addr = ROUND_DOWN(start_addr, CONFIG_DISK_FLASH_ERASE_ALIGNMENT);
@@ -181,15 +235,161 @@ static int update_flash_block(off_t start_addr, uint32_t size, const void *buff)
 	return 0;
 }
 
-static int disk_flash_access_write(struct disk_info *disk, const uint8_t *buff,
-				 uint32_t start_sector, uint32_t sector_count)
+#if defined(CONFIG_DISK_FLASH_WRITE_BACK_CACHE)
+struct flash_cache_block {
+	off_t addr;
+	uint32_t last_use;
+	bool valid;
+	bool dirty;
+	uint8_t __aligned(4) data[CONFIG_DISK_ERASE_BLOCK_SIZE];
+};
+
+/* Erase blocks written since the last sync, the least recently used one
+ * is written back to flash when a new block is needed.
+ */
+static struct flash_cache_block cache[CONFIG_DISK_FLASH_CACHE_BLOCKS];
+static uint32_t cache_tick;
+
+static struct flash_cache_block *cache_find(off_t addr)
 {
-	off_t fl_addr;
-	uint32_t remaining;
-	uint32_t size;
+	for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].valid && (cache[i].addr == addr)) {
+			return &cache[i];
+		}
+	}
 
-	fl_addr = lba_to_address(start_sector);
-	remaining = (sector_count * SECTOR_SIZE);
+	return NULL;
+}
+
+static int cache_flush_block(struct flash_cache_block *cb)
+{
+	if (!cb->dirty) {
+		return 0;
+	}
+
+	if (update_flash_block(cb->addr, CONFIG_DISK_ERASE_BLOCK_SIZE,
+			       cb->data) != 0) {
+		return -EIO;
+	}
+
+	cb->dirty = false;
+
+	return 0;
+}
+
+static int cache_flush(void)
+{
+	int rc = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache_flush_block(&cache[i]) != 0) {
+			rc = -EIO;
+		}
+	}
+
+	return rc;
+}
+
+/* Get the cache entry of the erase block at addr, the block is loaded from
+ * flash unless it is about to be overwritten entirely.
+ */
+static struct flash_cache_block *cache_get(off_t addr, bool load)
+{
+	struct flash_cache_block *cb = cache_find(addr);
+
+	if (cb == NULL) {
+		cb = &cache[0];
+		for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+			if (!cache[i].valid) {
+				cb = &cache[i];
+				break;
+			}
+
+			if ((int32_t)(cache[i].last_use - cb->last_use) < 0) {
+				cb = &cache[i];
+			}
+		}
+
+		if (cache_flush_block(cb) != 0) {
+			return NULL;
+		}
+
+		cb->valid = false;
+		if (load && (read_flash(addr, cb->data,
+					CONFIG_DISK_ERASE_BLOCK_SIZE) != 0)) {
+			return NULL;
+		}
+
+		cb->addr = addr;
+		cb->valid = true;
+	}
+
+	cb->last_use = ++cache_tick;
+
+	return cb;
+}
+
+static int cache_read(off_t fl_addr, uint8_t *buff, uint32_t remaining)
+{
+	while (remaining) {
+		off_t block = ROUND_DOWN(fl_addr, CONFIG_DISK_ERASE_BLOCK_SIZE);
+		uint32_t offset = fl_addr - block;
+		uint32_t len = MIN(remaining,
+				   CONFIG_DISK_ERASE_BLOCK_SIZE - offset);
+		struct flash_cache_block *cb = cache_find(block);
+
+		if (cb != NULL) {
+			memcpy(buff, cb->data + offset, len);
+		} else if (read_flash(fl_addr, buff, len) != 0) {
+			return -EIO;
+		}
+
+		fl_addr += len;
+		buff += len;
+		remaining -= len;
+	}
+
+	return 0;
+}
+
+static int cache_write(off_t fl_addr, const uint8_t *buff, uint32_t remaining)
+{
+	while (remaining) {
+		off_t block = ROUND_DOWN(fl_addr, CONFIG_DISK_ERASE_BLOCK_SIZE);
+		uint32_t offset = fl_addr - block;
+		uint32_t len = MIN(remaining,
+				   CONFIG_DISK_ERASE_BLOCK_SIZE - offset);
+		struct flash_cache_block *cb = cache_find(block);
+
+		if ((cb == NULL) && (len == CONFIG_DISK_ERASE_BLOCK_SIZE)) {
+			/* whole blocks not in the cache are written through */
+			if (update_flash_block(block, len, buff) != 0) {
+				return -EIO;
+			}
+		} else {
+			cb = cache_get(block,
+				       has_live_data(block,
+						     CONFIG_DISK_ERASE_BLOCK_SIZE,
+						     fl_addr, len));
+			if (cb == NULL) {
+				return -EIO;
+			}
+
+			memcpy(cb->data + offset, buff, len);
+			cb->dirty = true;
+		}
+
+		fl_addr += len;
+		buff += len;
+		remaining -= len;
+	}
+
+	return 0;
+}
+#else
+static int write_flash(off_t fl_addr, const uint8_t *buff, uint32_t remaining)
+{
+	uint32_t size;
 
 	/* check if start address is erased-aligned address  */
 	if (fl_addr & (CONFIG_DISK_FLASH_ERASE_ALIGNMENT - 1)) {
@@ -249,12 +449,112 @@ static int disk_flash_access_write(struct disk_info *disk, const uint8_t *buff,
 
 	return 0;
 }
+#endif /* CONFIG_DISK_FLASH_WRITE_BACK_CACHE */
+
+static int disk_flash_access_read(struct disk_info *disk, uint8_t *buff,
+				uint32_t start_sector, uint32_t sector_count)
+{
+	off_t fl_addr;
+	uint32_t size;
+	int rc;
+
+	fl_addr = lba_to_address(start_sector);
+	size = (sector_count * SECTOR_SIZE);
+
+	k_mutex_lock(&flash_disk_lock, K_FOREVER);
+#if defined(CONFIG_DISK_FLASH_WRITE_BACK_CACHE)
+	rc = cache_read(fl_addr, buff, size);
+#else
+	rc = read_flash(fl_addr, buff, size);
+#endif
+	k_mutex_unlock(&flash_disk_lock);
+
+	return rc;
+}
+
+static int disk_flash_access_write(struct disk_info *disk, const uint8_t *buff,
+				 uint32_t start_sector, uint32_t sector_count)
+{
+	off_t fl_addr;
+	uint32_t size;
+	int rc;
+
+	fl_addr = lba_to_address(start_sector);
+	size = (sector_count * SECTOR_SIZE);
+
+	k_mutex_lock(&flash_disk_lock, K_FOREVER);
+#if defined(CONFIG_DISK_FLASH_TRIM)
+	for (uint32_t i = 0; (i < sector_count) &&
+			     (start_sector + i < SECTOR_COUNT); i++) {
+		atomic_clear_bit(trimmed, start_sector + i);
+	}
+#endif
+#if defined(CONFIG_DISK_FLASH_WRITE_BACK_CACHE)
+	rc = cache_write(fl_addr, buff, size);
+#else
+	rc = write_flash(fl_addr, buff, size);
+#endif
+	k_mutex_unlock(&flash_disk_lock);
+
+	return rc;
+}
+
+static int disk_flash_access_sync(void)
+{
+	int rc = 0;
+
+#if defined(CONFIG_DISK_FLASH_WRITE_BACK_CACHE)
+	k_mutex_lock(&flash_disk_lock, K_FOREVER);
+	rc = cache_flush();
+	k_mutex_unlock(&flash_disk_lock);
+#endif
+
+	return rc;
+}
+
+#if defined(CONFIG_DISK_FLASH_TRIM)
+static int disk_flash_access_trim(const uint32_t *range)
+{
+	uint32_t first = range[0];
+	uint32_t last = range[1];
+
+	if ((first > last) || (last >= SECTOR_COUNT)) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&flash_disk_lock, K_FOREVER);
+
+	for (uint32_t sector = first; sector <= last; sector++) {
+		atomic_set_bit(trimmed, sector);
+	}
+
+#if defined(CONFIG_DISK_FLASH_WRITE_BACK_CACHE)
+	/* cached blocks left with no data need no write back */
+	for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].valid &&
+		    !has_live_data(cache[i].addr, CONFIG_DISK_ERASE_BLOCK_SIZE,
+				   0, 0)) {
+			cache[i].valid = false;
+			cache[i].dirty = false;
+		}
+	}
+#endif
+
+	k_mutex_unlock(&flash_disk_lock);
+
+	return 0;
+}
+#endif
 
 static int disk_flash_access_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
 {
 	switch (cmd) {
 	case DISK_IOCTL_CTRL_SYNC:
-		return 0;
+		return disk_flash_access_sync();
+#if defined(CONFIG_DISK_FLASH_TRIM)
+	case DISK_IOCTL_CTRL_TRIM:
+		return disk_flash_access_trim(buff);
+#endif
 	case DISK_IOCTL_GET_SECTOR_COUNT:
 		*(uint32_t *)buff = CONFIG_DISK_VOLUME_SIZE / SECTOR_SIZE;
 		return 0;
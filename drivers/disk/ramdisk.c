@@ -68,11 +68,32 @@ static int disk_ram_access_write(struct disk_info *disk, const uint8_t *buff,
 	return 0;
 }
 
+/* Trimmed sectors read back as zeroes */
+static int disk_ram_access_trim(const uint32_t *range)
+{
+	uint32_t first = range[0];
+	uint32_t last = range[1];
+
+	if (first > last || last >= RAMDISK_SECTOR_COUNT) {
+		LOG_ERR("Trim of sectors %" PRIu32 "-%" PRIu32
+			" is outside the range %u", first, last,
+			RAMDISK_SECTOR_COUNT);
+		return -EINVAL;
+	}
+
+	memset(lba_to_address(first), 0,
+	       (last - first + 1U) * RAMDISK_SECTOR_SIZE);
+
+	return 0;
+}
+
 static int disk_ram_access_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
 {
 	switch (cmd) {
 	case DISK_IOCTL_CTRL_SYNC:
 		break;
+	case DISK_IOCTL_CTRL_TRIM:
+		return disk_ram_access_trim(buff);
 	case DISK_IOCTL_GET_SECTOR_COUNT:
 		*(uint32_t *)buff = RAMDISK_SECTOR_COUNT;
 		break;
@@ -758,6 +758,210 @@ int json_obj_encode(const struct json_obj_descr *descr, size_t descr_len,
 int json_arr_encode(const struct json_obj_descr *descr, const void *val,
 		    json_append_bytes_t append_bytes, void *data);
 
+#if defined(CONFIG_JSON_STREAM)
+/**
+ * @brief Token reported by the streaming parser.
+ */
+struct json_stream_event {
+	/** JSON_TOK_OBJECT_START, JSON_TOK_OBJECT_END, JSON_TOK_ARRAY_START,
+	 *  JSON_TOK_ARRAY_END, JSON_TOK_STRING, JSON_TOK_NUMBER,
+	 *  JSON_TOK_TRUE, JSON_TOK_FALSE or JSON_TOK_NULL.
+	 */
+	enum json_tokens type;
+	/** Nesting level of the value, 0 for the top-level value. The end
+	 *  of an object or array has the level of its start.
+	 */
+	uint8_t depth;
+	/** Name of the member, NULL for array elements, for the top-level
+	 *  value and for the end of objects and arrays. It is not
+	 *  terminated, nor unescaped.
+	 */
+	const char *key;
+	/** Length of the member name. */
+	size_t key_len;
+	/** Text of strings (without the quotes) and numbers, NULL for the
+	 *  other tokens. It is not terminated, nor unescaped.
+	 */
+	const char *value;
+	/** Length of the text. */
+	size_t value_len;
+};
+
+/**
+ * @brief Function called by the streaming parser for each token.
+ *
+ * The key and value of the event are only valid during the call.
+ *
+ * @param evt Token parsed
+ * @param user_data User-provided pointer
+ *
+ * @return 0 to continue parsing, or a negative error code to stop, which
+ * is then returned by json_stream_feed().
+ */
+typedef int (*json_stream_cb_t)(const struct json_stream_event *evt,
+				void *user_data);
+
+/**
+ * @brief Streaming parser state.
+ *
+ * The fields are internal, use json_stream_init() to set it up.
+ */
+struct json_stream {
+	json_stream_cb_t cb;
+	void *user_data;
+	/* Holds the current key, followed by the token split between
+	 * chunks, if any.
+	 */
+	char *buf;
+	size_t buf_size;
+	size_t key_len;
+	size_t val_len;
+	const char *literal;
+	/* One bit per nesting level, set for objects. */
+	uint32_t containers;
+	int err;
+	uint8_t depth;
+	uint8_t expect;
+	uint8_t lex;
+	uint8_t aux;
+	bool partial;
+};
+
+/**
+ * @brief Initialize a streaming parser.
+ *
+ * Unlike json_obj_parse(), the streaming parser does not need the whole
+ * payload at once: it is fed the payload in chunks of any size, as they
+ * arrive, and reports the tokens as they are completed, in order. It
+ * allocates no memory and keeps no reference to the chunks once
+ * json_stream_feed() returns. Only the tokens split between two chunks
+ * are copied, to @a buf.
+ *
+ * The structure, literals, escape sequences and number syntax are checked
+ * against the JSON grammar but, as with json_obj_parse(), strings are not
+ * unescaped and neither control characters nor UTF-8 sequences in strings
+ * are validated. Objects and arrays can be nested up to
+ * CONFIG_JSON_STREAM_MAX_DEPTH levels.
+ *
+ * @param stream Parser to initialize
+ * @param buf Buffer for the current member name and the token split
+ * between chunks. It has to hold the longest member name plus the longest
+ * string or number.
+ * @param buf_size Size of @a buf
+ * @param cb Function called for each token
+ * @param user_data Pointer passed to @a cb
+ */
+void json_stream_init(struct json_stream *stream, char *buf, size_t buf_size,
+		      json_stream_cb_t cb, void *user_data);
+
+/**
+ * @brief Feed the next chunk of the payload to a streaming parser.
+ *
+ * @param stream Parser
+ * @param data Chunk of the payload
+ * @param len Length of the chunk
+ *
+ * @return 0 if the chunk has been parsed, -EINVAL if the payload is not
+ * valid JSON, -ENOMEM if a token does not fit in the buffer, -ENOSPC if
+ * the nesting is too deep, or the error returned by the callback. Once an
+ * error is returned, it is returned by every call.
+ */
+int json_stream_feed(struct json_stream *stream, const char *data,
+		     size_t len);
+
+/**
+ * @brief Tell a streaming parser that the payload is complete.
+ *
+ * A number at the top-level is reported at this point, as only the end of
+ * the payload terminates it.
+ *
+ * @param stream Parser
+ *
+ * @return 0 if a whole JSON value has been parsed, -EINVAL if the payload
+ * is incomplete, or the error returned by a previous call.
+ */
+int json_stream_finish(struct json_stream *stream);
+
+/** @cond INTERNAL_HIDDEN */
+struct json_obj_stream_frame {
+	/* Objects: field descriptors. Arrays: element descriptor. */
+	const struct json_obj_descr *descr;
+	/* Objects: number of fields. Arrays: maximum number of elements. */
+	size_t len;
+	/* Objects: the struct. Arrays: the next element. */
+	void *val;
+	/* Arrays: where to store the number of elements, or NULL. */
+	size_t *elements;
+	/* Arrays: size of an element. */
+	size_t elem_size;
+	/* Objects: bitmap of the decoded fields. Arrays: decoded elements. */
+	uint32_t decoded;
+};
+/** @endcond */
+
+/**
+ * @brief Descriptor-driven streaming decoder state.
+ *
+ * The fields are internal, use json_obj_stream_init() to set it up.
+ */
+struct json_obj_stream {
+	struct json_stream stream;
+	struct json_obj_stream_frame frames[CONFIG_JSON_STREAM_MAX_DEPTH];
+	uint8_t skip;
+	int decoded;
+};
+
+/**
+ * @brief Initialize a streaming decoder.
+ *
+ * The payload is decoded according to the descriptor pointed to by
+ * @a descr, like json_obj_parse() does, but it is fed in chunks of any
+ * size with json_obj_stream_feed().
+ *
+ * The decoded strings, and the text of JSON_TOK_OPAQUE and JSON_TOK_FLOAT
+ * fields, are copied to the end of @a buf, so it must stay valid as long
+ * as the decoded values are used. The beginning of @a buf holds the tokens
+ * split between chunks (see json_stream_init()).
+ *
+ * Members not in the descriptor are skipped, whatever their type.
+ * JSON_TOK_OBJ_ARRAY fields are not supported.
+ *
+ * @param obj Decoder to initialize
+ * @param descr Pointer to the descriptor array
+ * @param descr_len Number of elements in the descriptor array. Must be less
+ * than 31.
+ * @param val Pointer to the struct to hold the decoded values
+ * @param buf Buffer for the split tokens and the decoded strings
+ * @param buf_size Size of @a buf
+ */
+void json_obj_stream_init(struct json_obj_stream *obj,
+			  const struct json_obj_descr *descr, size_t descr_len,
+			  void *val, char *buf, size_t buf_size);
+
+/**
+ * @brief Feed the next chunk of the payload to a streaming decoder.
+ *
+ * @param obj Decoder
+ * @param data Chunk of the payload
+ * @param len Length of the chunk
+ *
+ * @return 0 if the chunk has been decoded, or a negative error code (see
+ * json_stream_feed()).
+ */
+int json_obj_stream_feed(struct json_obj_stream *obj, const char *data,
+			 size_t len);
+
+/**
+ * @brief Tell a streaming decoder that the payload is complete.
+ *
+ * @param obj Decoder
+ *
+ * @return < 0 if error, bitmap of decoded fields on success (see
+ * json_obj_parse()).
+ */
+int json_obj_stream_finish(struct json_obj_stream *obj);
+#endif /* CONFIG_JSON_STREAM */
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_DEBUG_PROFILER_H_
+#define ZEPHYR_INCLUDE_DEBUG_PROFILER_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup profiler Sampling profiler
+ *  @brief Statistical profiler driven by the system timer interrupt
+ *
+ *  The profiler periodically samples the program counter (and, where the
+ *  architecture allows it, the return address) of the interrupted context
+ *  from the system timer ISR. Identical stacks are aggregated in a per-CPU
+ *  table, so the memory footprint does not depend on the sampling duration.
+ *  Results can be retrieved as folded stacks and symbolized on the host
+ *  with scripts/profiler/profiler_symbolize.py.
+ *  @{
+ */
+
+/** Program counter value recorded when an ISR was interrupted. */
+#define PROFILER_PC_ISR ((uintptr_t)1)
+
+/** @brief Profiler statistics for one CPU */
+struct profiler_stats {
+	/** Number of samples recorded */
+	uint32_t samples;
+	/** Number of samples lost because the stack table was full */
+	uint32_t dropped;
+	/** Number of distinct stacks recorded */
+	uint32_t stacks;
+};
+
+/** @brief Callback invoked for every distinct stack recorded
+ *
+ *  @param cpu CPU the stack was sampled on.
+ *  @param pcs Program counters, innermost frame first.
+ *  @param depth Number of valid entries in @p pcs.
+ *  @param count Number of samples which hit this stack.
+ *  @param user_data User data passed to profiler_foreach_stack().
+ */
+typedef void (*profiler_stack_cb)(unsigned int cpu, const uintptr_t *pcs,
+				  size_t depth, uint32_t count,
+				  void *user_data);
+
+/** @brief Start sampling
+ *
+ *  Samples are taken from the system timer interrupt. The effective
+ *  frequency is limited by the system tick rate.
+ *
+ *  @param freq_hz Sampling frequency in Hz, 0 selects
+ *		   CONFIG_PROFILER_SAMPLING_DEFAULT_FREQ.
+ *
+ *  @retval 0 on success.
+ *  @retval -EALREADY if the profiler is already running.
+ *  @retval -EINVAL if the frequency is out of range.
+ */
+int profiler_start(uint32_t freq_hz);
+
+/** @brief Stop sampling
+ *
+ *  Recorded samples are kept until profiler_reset() is called or the
+ *  profiler is started again.
+ *
+ *  @retval 0 on success.
+ *  @retval -EALREADY if the profiler is not running.
+ */
+int profiler_stop(void);
+
+/** @brief Check whether the profiler is running */
+bool profiler_is_running(void);
+
+/** @brief Discard all recorded samples */
+void profiler_reset(void);
+
+/** @brief Get profiler statistics for a CPU
+ *
+ *  @param cpu CPU index.
+ *  @param stats Statistics output.
+ *
+ *  @retval 0 on success.
+ *  @retval -EINVAL if @p cpu is out of range.
+ */
+int profiler_stats_get(unsigned int cpu, struct profiler_stats *stats);
+
+/** @brief Iterate over all recorded stacks
+ *
+ *  The callback is invoked from the calling thread context, with sampling
+ *  of the visited CPU table briefly suspended for every entry copied.
+ *
+ *  @param cb Callback invoked for every distinct stack.
+ *  @param user_data User data passed to the callback.
+ */
+void profiler_foreach_stack(profiler_stack_cb cb, void *user_data);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_DEBUG_PROFILER_H_ */
@@ -46,6 +46,13 @@ extern "C" {
 #define DISK_IOCTL_GET_ERASE_BLOCK_SZ		4
 /** Commit any cached read/writes to disk */
 #define DISK_IOCTL_CTRL_SYNC			5
+/**
+ * Inform the disk that a range of sectors no longer holds data in use. The
+ * argument points to an array of two uint32_t, the first and the last sector
+ * of the range, as passed by FatFs with CTRL_TRIM. The content of the sectors
+ * is undefined until they are written again.
+ */
+#define DISK_IOCTL_CTRL_TRIM			6
 
 /**
  * @brief Possible return bitmasks for disk_status()
@@ -62,6 +69,22 @@ extern "C" {
 
 struct disk_operations;
 
+/**
+ * @brief Disk block cache statistics
+ */
+struct disk_cache_stats {
+	/** Sectors read from the cache */
+	uint32_t hits;
+	/** Sectors read from the disk */
+	uint32_t misses;
+	/** Sectors read ahead from the disk */
+	uint32_t read_ahead;
+	/** Driver write calls issued by the cache */
+	uint32_t write_backs;
+	/** Sectors written by the cache */
+	uint32_t written_back;
+};
+
 /**
  * @brief Disk info
  */
@@ -74,6 +97,16 @@ struct disk_info {
 	const struct disk_operations *ops;
 	/** Device associated to this disk */
 	const struct device *dev;
+#if defined(CONFIG_DISK_CACHE) || defined(__DOXYGEN__)
+	/** Internally used by the block cache, sector size or 0 if unknown */
+	uint32_t cache_sector_size;
+	/** Internally used by the block cache, number of sectors */
+	uint32_t cache_sector_count;
+	/** Internally used by the block cache, sector after the last read */
+	uint32_t cache_next_sector;
+	/** Block cache statistics */
+	struct disk_cache_stats cache_stats;
+#endif
 };
 
 /**
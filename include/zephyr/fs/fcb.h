@@ -76,6 +76,45 @@ struct fcb_entry_ctx {
 	/**< Flash area where the entry is placed */
 };
 
+/**
+ * FCB key hash callback function type.
+ *
+ * Called with the FCB locked to compute the hash of the user key of an
+ * element, for the key filter of the sector index. Entry data can be read
+ * using flash_area_read(), using loc_ctx fields as arguments.
+ *
+ * @param[in] loc_ctx entry location information (full context)
+ *
+ * @return hash of the element key, or @ref FCB_KEY_HASH_ANY if the element
+ * may hold several keys.
+ */
+typedef uint32_t (*fcb_key_hash_cb)(const struct fcb_entry_ctx *loc_ctx);
+
+/**
+ * Key hash of an element matching every key, the key filter of its sector
+ * is saturated.
+ */
+#define FCB_KEY_HASH_ANY 0U
+
+/**
+ * @brief FCB sector index entry
+ *
+ * Describes the elements of one sector, see @kconfig{CONFIG_FCB_INDEX}.
+ */
+struct fcb_sector_index {
+	uint32_t fi_end;
+	/**< Offset from the start of the sector to the end of the last
+	 * element.
+	 */
+
+	uint16_t fi_count; /**< Number of valid elements in the sector */
+
+#if defined(CONFIG_FCB_INDEX_KEYS) || defined(__DOXYGEN__)
+	uint32_t fi_keys[CONFIG_FCB_INDEX_KEY_BITS / 32];
+	/**< Bloom filter of the key hashes of the elements */
+#endif
+};
+
 /**
  * @brief FCB instance structure
  *
@@ -104,6 +143,18 @@ struct fcb {
 	struct flash_sector *f_sectors;
 	/**< Array of sectors, must be contiguous */
 
+#if defined(CONFIG_FCB_INDEX) || defined(__DOXYGEN__)
+	struct fcb_sector_index *f_index;
+	/**< Optional array of f_sector_cnt index entries, filled in by
+	 * @ref fcb_init. No index is kept if it is NULL.
+	 */
+
+#if defined(CONFIG_FCB_INDEX_KEYS) || defined(__DOXYGEN__)
+	fcb_key_hash_cb f_key_hash;
+	/**< Optional callback computing the key hash of an element */
+#endif
+#endif
+
 	/* Flash circular buffer internal state */
 	struct k_mutex f_mtx;
 	/**< Locking for accessing the FCB data, internal state */
@@ -232,6 +283,75 @@ int fcb_walk(struct fcb *fcb, struct flash_sector *sector, fcb_walk_cb cb,
  */
 int fcb_getnext(struct fcb *fcb, struct fcb_entry *loc);
 
+/**
+ * Get the location of the n-th oldest fcb entry.
+ *
+ * With @kconfig{CONFIG_FCB_INDEX} enabled, only the entries of the sector
+ * holding the wanted entry are read.
+ *
+ * @param[in] fcb FCB instance structure.
+ * @param[in] n index of the entry, 0 for the oldest one.
+ * @param[out] loc entry location information
+ *
+ * @return 0 on success, -ENOENT if there are not more than n entries.
+ */
+int fcb_getnth(struct fcb *fcb, uint32_t n, struct fcb_entry *loc);
+
+/**
+ * Get next fcb entry location which may have a given key.
+ *
+ * Like @ref fcb_getnext, but with @kconfig{CONFIG_FCB_INDEX_KEYS} enabled,
+ * the sectors following loc which cannot hold an entry with the given key
+ * hash, as computed by fcb::f_key_hash, are skipped. The caller still has
+ * to check the key of the returned entry.
+ *
+ * @param[in] fcb FCB instance structure.
+ * @param[in,out] loc entry location information
+ * @param[in] key_hash hash of the key.
+ *
+ * @return 0 on success, non-zero on failure.
+ */
+int fcb_getnext_key(struct fcb *fcb, struct fcb_entry *loc,
+		    uint32_t key_hash);
+
+/**
+ * FCB bulk read callback function type.
+ *
+ * Type of function which is called for each entry read by
+ * @ref fcb_bulk_read.
+ *
+ * @param[in] loc_ctx entry location information (full context)
+ * @param[in] data entry data, or NULL if the entry did not fit in the
+ *            buffer. It can then be read using flash_area_read().
+ * @param[in,out] arg callback context, transferred from @ref fcb_bulk_read.
+ *
+ * @return 0 continue reading, non-zero stop reading.
+ */
+typedef int (*fcb_bulk_cb)(struct fcb_entry_ctx *loc_ctx, const uint8_t *data,
+			   void *arg);
+
+/**
+ * Read the entries following an entry with a single flash read.
+ *
+ * Reads the entries following loc, as many as fit in buf and up to the end
+ * of their sector, and calls cb for each of them. Entries with an invalid
+ * checksum are skipped. loc is updated to the last entry read, so that a
+ * next call continues from there.
+ *
+ * @param[in] fcb FCB instance structure.
+ * @param[in,out] loc entry location information, as for @ref fcb_getnext.
+ * @param[in] buf buffer used for reading the entries.
+ * @param[in] len size of buf, at least 2 bytes.
+ * @param[in] cb pointer to the function which gets called for each entry.
+ * @param[in,out] cb_arg callback context, transferred to the callback
+ *                implementation.
+ *
+ * @return 0 on success, -ENOTSUP if there is no entry after loc, negative
+ *         errno code on failure or non-zero value returned by cb.
+ */
+int fcb_bulk_read(struct fcb *fcb, struct fcb_entry *loc, uint8_t *buf,
+		  size_t len, fcb_bulk_cb cb, void *cb_arg);
+
 /**
  * Rotate fcb sectors
  *
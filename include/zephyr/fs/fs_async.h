@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_INCLUDE_FS_FS_ASYNC_H_
+#define ZEPHYR_INCLUDE_FS_FS_ASYNC_H_
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/slist.h>
+#include <zephyr/fs/fs.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief File System Asynchronous APIs
+ * @defgroup file_system_async_api File System Asynchronous APIs
+ * @ingroup file_system_api
+ * @{
+ */
+
+/** @brief Asynchronous file operations */
+enum fs_async_op {
+	/** fs_read() */
+	FS_ASYNC_READ,
+	/** fs_write() */
+	FS_ASYNC_WRITE,
+	/** fs_sync() */
+	FS_ASYNC_SYNC,
+};
+
+struct fs_async_req;
+
+/**
+ * @brief Asynchronous request completion callback
+ *
+ * Called from a file system worker thread. The request may be submitted
+ * again from the callback.
+ *
+ * @param req Completed request, with its result set
+ */
+typedef void (*fs_async_cb_t)(struct fs_async_req *req);
+
+/**
+ * @brief Asynchronous file request
+ *
+ * The @a cb and @a signal members are set by the caller before the request
+ * is submitted, either or both may be NULL. The other members are set on
+ * submission. The request, and the buffer it refers to, must stay valid
+ * until it completes.
+ */
+struct fs_async_req {
+	/** Internally used queue node */
+	sys_snode_t node;
+	/** File the request applies to */
+	struct fs_file_t *zfp;
+	/** Operation */
+	enum fs_async_op op;
+	/** Data buffer of read and write requests */
+	void *buf;
+	/** Size of the data buffer */
+	size_t size;
+	/** Called on completion, may be NULL */
+	fs_async_cb_t cb;
+	/** Raised with the result on completion, may be NULL */
+	struct k_poll_signal *signal;
+	/** Return value of the operation, set on completion */
+	ssize_t result;
+};
+
+/**
+ * @brief Submit an asynchronous read
+ *
+ * Requests to the same file are executed in submission order. The result
+ * is the return value of fs_read().
+ *
+ * @param req Request
+ * @param zfp Pointer to the file object
+ * @param ptr Pointer to the destination buffer
+ * @param size Number of bytes to read
+ *
+ * @retval 0 on success;
+ * @retval -EBADF when invoked on zfp that represents unopened/closed file.
+ */
+int fs_async_read(struct fs_async_req *req, struct fs_file_t *zfp,
+		  void *ptr, size_t size);
+
+/**
+ * @brief Submit an asynchronous write
+ *
+ * Requests to the same file are executed in submission order. The result
+ * is the return value of fs_write().
+ *
+ * @param req Request
+ * @param zfp Pointer to the file object
+ * @param ptr Pointer to the data buffer
+ * @param size Number of bytes to write
+ *
+ * @retval 0 on success;
+ * @retval -EBADF when invoked on zfp that represents unopened/closed file.
+ */
+int fs_async_write(struct fs_async_req *req, struct fs_file_t *zfp,
+		   const void *ptr, size_t size);
+
+/**
+ * @brief Submit an asynchronous sync
+ *
+ * The result is the return value of fs_sync(). When several syncs of a
+ * file are queued, only the last one is executed and its result is given
+ * to all of them, so a sync may complete after requests of the same file
+ * submitted after it.
+ *
+ * @param req Request
+ * @param zfp Pointer to the file object
+ *
+ * @retval 0 on success;
+ * @retval -EBADF when invoked on zfp that represents unopened/closed file.
+ */
+int fs_async_sync(struct fs_async_req *req, struct fs_file_t *zfp);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ZEPHYR_INCLUDE_FS_FS_ASYNC_H_ */
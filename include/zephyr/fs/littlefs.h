@@ -17,6 +17,18 @@
 extern "C" {
 #endif
 
+/** @brief Block allocator statistics of a LittleFS mount */
+struct fs_littlefs_alloc_stats {
+	/** Lookahead windows filled by littlefs, by traversing the file system */
+	uint32_t lookahead_scans;
+	/** Lookahead windows filled from the allocation map, without traversal */
+	uint32_t hint_fills;
+	/** File system traversals done to build the allocation map */
+	uint32_t map_rebuilds;
+	/** Whether the allocation map was loaded from flash at mount */
+	bool hint_loaded;
+};
+
 /** @brief Filesystem info structure for LittleFS mount */
 struct fs_littlefs {
 	/* Defaulted in driver, customizable before mount. */
@@ -37,6 +49,32 @@ struct fs_littlefs {
 	struct lfs lfs;
 	void *backend;
 	struct k_mutex mutex;
+
+#if defined(CONFIG_FS_LITTLEFS_ALLOC_HINT) || defined(__DOXYGEN__)
+	/* Blocks possibly in use, one bit per block. */
+	uint32_t alloc_map[DIV_ROUND_UP(CONFIG_FS_LITTLEFS_ALLOC_HINT_MAX_BLOCKS,
+					32)];
+	struct fs_littlefs_alloc_stats alloc_stats;
+	/* Lookahead window last filled or seen. */
+	lfs_block_t alloc_off;
+	lfs_block_t alloc_size;
+	/* Builds the map once the file system is idle. */
+	struct k_work_delayable alloc_work;
+	struct k_work_sync alloc_work_sync;
+	bool alloc_map_enabled;
+	bool alloc_map_valid;
+#endif
+
+#if defined(CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST) || defined(__DOXYGEN__)
+	/* Flash area storing the allocation map, used if alloc_hint_area_set
+	 * is true. Customizable before mount.
+	 */
+	uint8_t alloc_hint_area_id;
+	bool alloc_hint_area_set;
+	/* Opened at mount if the area can hold the map. */
+	const struct flash_area *alloc_hint_fa;
+	bool alloc_hint_stored;
+#endif
 };
 
 /** @brief Define a littlefs configuration with customized size
@@ -99,6 +137,36 @@ struct fs_littlefs {
 					  CONFIG_FS_LITTLEFS_CACHE_SIZE, \
 					  CONFIG_FS_LITTLEFS_LOOKAHEAD_SIZE)
 
+#if defined(CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST) || defined(__DOXYGEN__)
+/** @brief Store the block allocation map of a mounted file system.
+ *
+ * The map is stored automatically on unmount. It is used on the next
+ * mount, unless a block is erased in between, so that littlefs does not
+ * need to traverse the file system to find free blocks.
+ *
+ * @param fs the file system data of a mounted file system.
+ *
+ * @retval 0 on success;
+ * @retval -EINVAL if the file system is not mounted;
+ * @retval -ENOTSUP if the file system has no area to store the map;
+ * @retval <0 a negative errno code on error.
+ */
+int fs_littlefs_alloc_hint_save(struct fs_littlefs *fs);
+#endif
+
+#if defined(CONFIG_FS_LITTLEFS_ALLOC_HINT) || defined(__DOXYGEN__)
+/** @brief Get the block allocator statistics of a mounted file system.
+ *
+ * @param fs the file system data of a mounted file system.
+ * @param stats filled with the statistics since mount.
+ *
+ * @retval 0 on success;
+ * @retval -EINVAL if the file system is not mounted.
+ */
+int fs_littlefs_alloc_stats_get(struct fs_littlefs *fs,
+				struct fs_littlefs_alloc_stats *stats);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -44,6 +44,10 @@ extern "C" {
  * @param nvs_lock Mutex
  * @param flash_device Flash Device runtime structure
  * @param flash_parameters Flash memory parameters structure
+ * @param lookup_cache Address of the most recent ATE for each cache position
+ * @param gc_work Work item running garbage collection in the background
+ * @param gc_saturated Flag indicating that background garbage collection cannot
+ * reclaim enough space to be useful
  */
 struct nvs_fs {
 	off_t offset;
@@ -58,6 +62,23 @@ struct nvs_fs {
 #if CONFIG_NVS_LOOKUP_CACHE
 	uint32_t lookup_cache[CONFIG_NVS_LOOKUP_CACHE_SIZE];
 #endif
+#if CONFIG_NVS_BACKGROUND_GC
+	struct k_work gc_work;
+	bool gc_saturated;
+#endif
+};
+
+/**
+ * @brief Entry written by nvs_write_multi()
+ *
+ * @param id Id of the entry
+ * @param data Pointer to the data of the entry
+ * @param len Number of bytes of data, 0 deletes the entry
+ */
+struct nvs_entry {
+	uint16_t id;
+	const void *data;
+	size_t len;
 };
 
 /**
@@ -120,6 +141,27 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len);
  */
 int nvs_delete(struct nvs_fs *fs, uint16_t id);
 
+/**
+ * @brief nvs_write_multi
+ *
+ * Write several entries to the file system as one atomic update: when it is
+ * interrupted by a power loss, the entries already written are ignored.
+ * Entries of which the same data is already stored are skipped. All the
+ * entries, with their allocation table entries, must fit in a single sector.
+ *
+ * Available with CONFIG_NVS_WRITE_MULTI.
+ *
+ * @param fs Pointer to file system
+ * @param entries Entries to be written, each id may only be present once
+ * @param count Number of entries
+ * @retval 0 Success
+ * @retval -EINVAL if an id is invalid or repeated, or the update does not fit
+ * in a sector
+ * @retval -ERRNO errno code if error
+ */
+int nvs_write_multi(struct nvs_fs *fs, const struct nvs_entry *entries,
+		    size_t count);
+
 /**
  * @brief nvs_read
  *
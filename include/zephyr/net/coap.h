@@ -229,6 +229,17 @@ struct coap_observer {
 	uint8_t tkl;
 };
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+/**
+ * @brief Position of the options with a given number in a CoAP packet.
+ */
+struct coap_option_index_entry {
+	uint16_t code; /* Option number */
+	uint16_t offset; /* Offset of the first option with this number */
+	uint8_t count; /* Number of options with this number */
+};
+#endif
+
 /**
  * @brief Representation of a CoAP Packet.
  */
@@ -239,6 +250,13 @@ struct coap_packet {
 	uint8_t hdr_len; /* CoAP header length */
 	uint16_t opt_len; /* Total options length (delta + len + value) */
 	uint16_t delta; /* Used for delta calculation in CoAP packet */
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	/* Option index, built by coap_packet_parse() */
+	uint64_t opt_present; /* Option numbers below 64 present */
+	struct coap_option_index_entry opt_index[CONFIG_COAP_OPTION_INDEX_SIZE];
+	uint8_t opt_index_len; /* Entries used in opt_index */
+	bool opt_indexed; /* opt_index describes all the options */
+#endif
 #if defined(CONFIG_COAP_KEEP_USER_DATA)
 	void *user_data; /* Application specific user data */
 #endif
@@ -522,6 +540,98 @@ int coap_handle_request(struct coap_packet *cpkt,
 			uint8_t opt_num,
 			struct sockaddr *addr, socklen_t addr_len);
 
+#if defined(CONFIG_COAP_RESOURCE_INDEX) || defined(__DOXYGEN__)
+
+/**
+ * @brief Node of a resource index, one per distinct resource path prefix.
+ */
+struct coap_resource_index_node {
+	/** Path segment, not NUL terminated */
+	const char *segment;
+	/** First resource of the array with the path of this node */
+	struct coap_resource *resource;
+	/** Index of the parent node */
+	uint16_t parent;
+	/** Length of the path segment */
+	uint16_t len;
+#if defined(CONFIG_COAP_URI_WILDCARD)
+	/** Index of the "+" child node, 0 if none */
+	uint16_t single_wildcard;
+	/** Index of the "#" child node, 0 if none */
+	uint16_t multi_wildcard;
+#endif
+};
+
+/**
+ * @brief Prefix tree of the paths of an array of resources, built with
+ * coap_resource_index_init().
+ *
+ * Child nodes are found through a hash table on the parent node and path
+ * segment, so that the time to dispatch a request does not depend on the
+ * number of resources.
+ */
+struct coap_resource_index {
+	struct coap_resource_index_node *nodes;
+	uint16_t *slots;
+	uint16_t max_nodes;
+	uint16_t num_nodes;
+};
+
+/**
+ * @brief Statically define a resource index.
+ *
+ * @param _name Name of the index
+ * @param _max_nodes Maximum number of nodes: one for the root, plus one per
+ *        distinct path prefix of the resources. The number of path segments
+ *        of all resources plus one is always enough.
+ */
+#define COAP_RESOURCE_INDEX_DEFINE(_name, _max_nodes)				\
+	static struct coap_resource_index_node _name##_nodes[_max_nodes];	\
+	static uint16_t _name##_slots[2 * (_max_nodes)];			\
+	static struct coap_resource_index _name = {				\
+		.nodes = _name##_nodes,						\
+		.slots = _name##_slots,						\
+		.max_nodes = (_max_nodes),					\
+	}
+
+/**
+ * @brief Build the index of an array of resources.
+ *
+ * The resources must not be added, removed or have their path changed
+ * while the index is in use.
+ *
+ * @param index Index defined with COAP_RESOURCE_INDEX_DEFINE()
+ * @param resources Array of resources, terminated by an entry without path
+ *
+ * @return 0 in case of success, -ENOMEM if the index has too few nodes.
+ */
+int coap_resource_index_init(struct coap_resource_index *index,
+			     struct coap_resource *resources);
+
+/**
+ * @brief Same as coap_handle_request(), with the resources looked up in an
+ * index instead of compared one by one.
+ *
+ * When several resources match the request through wildcards, the first
+ * one of the array is used, as with coap_handle_request().
+ *
+ * @param cpkt Packet received
+ * @param index Index of the resources
+ * @param options Parsed options from coap_packet_parse()
+ * @param opt_num Number of options
+ * @param addr Peer address
+ * @param addr_len Peer address length
+ *
+ * @return 0 in case of success or negative in case of error.
+ */
+int coap_handle_request_index(struct coap_packet *cpkt,
+			      const struct coap_resource_index *index,
+			      struct coap_option *options,
+			      uint8_t opt_num,
+			      struct sockaddr *addr, socklen_t addr_len);
+
+#endif /* CONFIG_COAP_RESOURCE_INDEX */
+
 /**
  * Represents the size of each block that will be transferred using
  * block-wise transfers [RFC7959]:
@@ -882,6 +992,205 @@ void coap_reply_clear(struct coap_reply *reply);
  */
 void coap_replies_clear(struct coap_reply *replies, size_t len);
 
+#if defined(CONFIG_COAP_EXCHANGE_INDEX) || defined(__DOXYGEN__)
+
+/**
+ * @brief Pending requests with a hash table on the message ID and a
+ * min-heap on the expiry time.
+ *
+ * The pendings are taken with coap_pending_next_unused() on
+ * @a pendings, and have to be added with coap_pending_index_add() once
+ * initialized. Their retransmissions are then cycled with
+ * coap_pending_index_cycle() and they are released with
+ * coap_pending_index_clear().
+ */
+struct coap_pending_index {
+	/** Pending requests, @a max entries */
+	struct coap_pending *pendings;
+	/** Hash chains by message ID, entry index plus one, 0 ends a chain */
+	uint16_t *buckets;
+	uint16_t *next;
+	/** Pendings with a timeout, ordered by expiry */
+	uint16_t *heap;
+	/** Position of each pending in the heap plus one, 0 if not in it */
+	uint16_t *heap_pos;
+	uint16_t max;
+	uint16_t heap_len;
+};
+
+/**
+ * @brief Statically define a pending index and its pendings.
+ *
+ * @param _name Name of the index
+ * @param _max Number of pendings
+ */
+#define COAP_PENDING_INDEX_DEFINE(_name, _max)				\
+	static struct coap_pending _name##_pendings[_max];		\
+	static uint16_t _name##_buckets[_max];				\
+	static uint16_t _name##_next[_max];				\
+	static uint16_t _name##_heap[_max];				\
+	static uint16_t _name##_heap_pos[_max];				\
+	static struct coap_pending_index _name = {			\
+		.pendings = _name##_pendings,				\
+		.buckets = _name##_buckets,				\
+		.next = _name##_next,					\
+		.heap = _name##_heap,					\
+		.heap_pos = _name##_heap_pos,				\
+		.max = (_max),						\
+	}
+
+/**
+ * @brief Add a pending initialized with coap_pending_init() to its index.
+ *
+ * @param index Index of the pending
+ * @param pending Pending taken from the pendings of @a index
+ *
+ * @return 0 in case of success, -EINVAL if @a pending is not one of the
+ * pendings of @a index.
+ */
+int coap_pending_index_add(struct coap_pending_index *index,
+			   struct coap_pending *pending);
+
+/**
+ * @brief Same as coap_pending_cycle(), for a pending of an index.
+ *
+ * @param index Index of the pending
+ * @param pending Pending added with coap_pending_index_add()
+ *
+ * @return false if this is the last retransmission.
+ */
+bool coap_pending_index_cycle(struct coap_pending_index *index,
+			      struct coap_pending *pending);
+
+/**
+ * @brief Same as coap_pending_clear(), for a pending of an index.
+ *
+ * @param index Index of the pending
+ * @param pending Pending added with coap_pending_index_add()
+ */
+void coap_pending_index_clear(struct coap_pending_index *index,
+			      struct coap_pending *pending);
+
+/**
+ * @brief Same as coap_pendings_clear(), for all the pendings of an index.
+ *
+ * @param index Index to clear
+ */
+void coap_pending_index_clear_all(struct coap_pending_index *index);
+
+/**
+ * @brief Same as coap_pending_received(), with the pending looked up by
+ * message ID in an index.
+ *
+ * @param response The received response
+ * @param index Index of the pendings
+ *
+ * @return pointer to the associated #coap_pending structure, NULL in
+ * case none could be found.
+ */
+struct coap_pending *coap_pending_received_index(
+	const struct coap_packet *response,
+	const struct coap_pending_index *index);
+
+/**
+ * @brief Same as coap_pending_next_to_expire(), from the expiry heap of an
+ * index.
+ *
+ * @param index Index of the pendings
+ *
+ * @return The next #coap_pending to expire, NULL if none is about to
+ * expire.
+ */
+struct coap_pending *coap_pending_next_to_expire_index(
+	const struct coap_pending_index *index);
+
+/**
+ * @brief Replies with a hash table on the token, or on the message ID for
+ * requests without token.
+ *
+ * The replies are taken with coap_reply_next_unused() on @a replies, and
+ * have to be added with coap_reply_index_add() once initialized. They are
+ * released with coap_reply_index_clear().
+ */
+struct coap_reply_index {
+	/** Replies, @a max entries */
+	struct coap_reply *replies;
+	/** Hash chains, entry index plus one, 0 ends a chain */
+	uint16_t *buckets;
+	uint16_t *next;
+	uint16_t max;
+};
+
+/**
+ * @brief Statically define a reply index and its replies.
+ *
+ * @param _name Name of the index
+ * @param _max Number of replies
+ */
+#define COAP_REPLY_INDEX_DEFINE(_name, _max)				\
+	static struct coap_reply _name##_replies[_max];			\
+	static uint16_t _name##_buckets[_max];				\
+	static uint16_t _name##_next[_max];				\
+	static struct coap_reply_index _name = {			\
+		.replies = _name##_replies,				\
+		.buckets = _name##_buckets,				\
+		.next = _name##_next,					\
+		.max = (_max),						\
+	}
+
+/**
+ * @brief Add a reply initialized with coap_reply_init() to its index.
+ *
+ * The token, token length and message ID of the reply must not change
+ * until it is cleared with coap_reply_index_clear().
+ *
+ * @param index Index of the reply
+ * @param reply Reply taken from the replies of @a index
+ *
+ * @return 0 in case of success, -EINVAL if @a reply is not one of the
+ * replies of @a index.
+ */
+int coap_reply_index_add(struct coap_reply_index *index,
+			 struct coap_reply *reply);
+
+/**
+ * @brief Same as coap_reply_clear(), for a reply of an index.
+ *
+ * @param index Index of the reply
+ * @param reply Reply added with coap_reply_index_add()
+ */
+void coap_reply_index_clear(struct coap_reply_index *index,
+			    struct coap_reply *reply);
+
+/**
+ * @brief Same as coap_replies_clear(), for all the replies of an index.
+ *
+ * @param index Index to clear
+ */
+void coap_reply_index_clear_all(struct coap_reply_index *index);
+
+/**
+ * @brief Same as coap_response_received(), with the reply looked up in an
+ * index.
+ *
+ * A response with a token matches the reply with the same token, a
+ * response without token the reply without token with the same message
+ * ID.
+ *
+ * @param response A response received
+ * @param from Address from which the response was received
+ * @param index Index of the replies
+ *
+ * @return Pointer to the reply matching the packet received, NULL if
+ * none could be found.
+ */
+struct coap_reply *coap_response_received_index(
+	const struct coap_packet *response,
+	const struct sockaddr *from,
+	const struct coap_reply_index *index);
+
+#endif /* CONFIG_COAP_EXCHANGE_INDEX */
+
 /**
  * @brief Indicates that this resource was updated and that the @a
  * notify callback should be called for every registered observer.
@@ -240,6 +240,19 @@ struct dns_resolve_context {
 		 * cannot be used to find correct pending query.
 		 */
 		uint16_t query_hash;
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+		/** Addresses received so far, to be cached when the query
+		 * completes.
+		 */
+		struct sockaddr cache_addr[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+
+		/** Lowest TTL of the addresses received so far */
+		uint32_t cache_ttl;
+
+		/** Number of addresses in cache_addr */
+		uint8_t cache_num_addrs;
+#endif
 	} queries[CONFIG_DNS_NUM_CONCUR_QUERIES];
 
 	/** Is this context in use */
@@ -446,6 +459,71 @@ static inline int dns_cancel_addr_info(uint16_t dns_id)
 	return dns_resolve_cancel(dns_resolve_get_default(), dns_id);
 }
 
+/**
+ * @brief DNS resolver cache statistics.
+ */
+struct dns_resolve_cache_stats {
+	/** Queries answered from the cache */
+	uint32_t hits;
+
+	/** Queries not found in the cache */
+	uint32_t misses;
+
+	/** Entries replaced before they expired */
+	uint32_t evictions;
+};
+
+/**
+ * @typedef dns_resolve_cache_cb_t
+ * @brief Callback used while iterating over the DNS resolver cache.
+ *
+ * @param query Resolved name.
+ * @param type Query type.
+ * @param status Status returned to the caller once all the addresses have
+ * been returned: DNS_EAI_ALLDONE, or an error for a negative entry.
+ * @param addrs Addresses of the name.
+ * @param num_addrs Number of addresses, 0 for a negative entry.
+ * @param ttl Seconds left until the entry expires.
+ * @param user_data A valid pointer to user data or NULL
+ */
+typedef void (*dns_resolve_cache_cb_t)(const char *query,
+				       enum dns_query_type type,
+				       int status,
+				       const struct sockaddr *addrs,
+				       int num_addrs,
+				       uint32_t ttl,
+				       void *user_data);
+
+/**
+ * @brief Go through all the entries of the DNS resolver cache.
+ *
+ * @details The callback is called with the cache locked, so it must not
+ * resolve names or access the cache itself.
+ * Requires CONFIG_DNS_RESOLVER_CACHE.
+ *
+ * @param cb User-supplied callback function to call
+ * @param user_data User specified data
+ */
+void dns_resolve_cache_foreach(dns_resolve_cache_cb_t cb, void *user_data);
+
+/**
+ * @brief Remove all the entries of the DNS resolver cache.
+ *
+ * @details The cache is also flushed when the DNS servers of a context are
+ * changed with dns_resolve_reconfigure().
+ * Requires CONFIG_DNS_RESOLVER_CACHE.
+ */
+void dns_resolve_cache_flush(void);
+
+/**
+ * @brief Get the DNS resolver cache statistics.
+ *
+ * @details Requires CONFIG_DNS_RESOLVER_CACHE.
+ *
+ * @param stats Statistics, filled by the function.
+ */
+void dns_resolve_cache_stats_get(struct dns_resolve_cache_stats *stats);
+
 /**
  * @}
  */
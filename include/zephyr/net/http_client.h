@@ -23,6 +23,7 @@
 #include <zephyr/kernel.h>
 #include <zephyr/net/net_ip.h>
 #include <zephyr/net/http_parser.h>
+#include <zephyr/net/tls_credentials.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -44,6 +45,7 @@ enum http_final_call {
 
 struct http_request;
 struct http_response;
+struct http_session;
 
 /**
  * @typedef http_payload_cb_t
@@ -80,6 +82,43 @@ typedef int (*http_header_cb_t)(int sock,
 				struct http_request *req,
 				void *user_data);
 
+/**
+ * @typedef http_chunk_cb_t
+ * @brief Callback used to get the body of a chunked request, one chunk at a
+ * time. The chunk is sent directly from the memory it points to, so it must
+ * remain valid until the callback is called again.
+ *
+ * @param req HTTP request information
+ * @param data Where to store a pointer to the chunk.
+ * @param user_data User specified data specified in http_client_req()
+ *
+ * @return >0 length of the chunk, in this case the callback is called again
+ *            once it is sent,
+ *         0  if the body is complete,
+ *         <0 if http_client_req() should return the error code to the
+ *            caller.
+ */
+typedef int (*http_chunk_cb_t)(struct http_request *req,
+			       const uint8_t **data,
+			       void *user_data);
+
+/**
+ * @typedef http_body_cb_t
+ * @brief Callback used to deliver the response body as it is parsed.
+ *
+ * @param rsp HTTP response information
+ * @param data Start of the body fragment
+ * @param len Length of the body fragment
+ * @param user_data User specified data specified in http_client_req()
+ *
+ * @return 0 if the response should be processed further,
+ *         <0 to abort the response, the error code is then returned to the
+ *            caller.
+ */
+typedef int (*http_body_cb_t)(struct http_response *rsp,
+			      const uint8_t *data, size_t len,
+			      void *user_data);
+
 /**
  * @typedef http_response_cb_t
  * @brief Callback used when data is received from the server.
@@ -220,6 +259,12 @@ struct http_client_internal_data {
 
 	/** Request timeout */
 	k_timeout_t timeout;
+
+	/** Session the request was sent in, NULL if none */
+	struct http_session *session;
+
+	/** Error returned by the body callback */
+	int body_err;
 };
 
 /**
@@ -309,6 +354,23 @@ struct http_request {
 	 * headers will be placed into this field.
 	 */
 	const char **optional_headers;
+
+	/** User supplied callback function to call when the body of a
+	 * chunked request needs to be sent. If set, the request is sent with
+	 * "Transfer-Encoding: chunked" and the payload, payload_cb and
+	 * payload_len fields are ignored. This allows streaming a body of
+	 * unknown length without buffering it.
+	 */
+	http_chunk_cb_t chunk_cb;
+
+	/** User supplied callback function to call with each fragment of the
+	 * response body, as soon as it is parsed. This can be NULL. Unlike the
+	 * data passed to the response callback, the fragments do not contain
+	 * the headers or the chunk framing of the response, so they can be
+	 * written directly to their destination, for example with
+	 * stream_flash_buffered_write().
+	 */
+	http_body_cb_t body_cb;
 };
 
 /**
@@ -329,6 +391,130 @@ struct http_request {
 int http_client_req(int sock, struct http_request *req,
 		    int32_t timeout, void *user_data);
 
+#if defined(CONFIG_HTTP_CLIENT)
+/**
+ * HTTP client session. The session connects to the server when the first
+ * request is sent, and keeps the connection open for the following requests
+ * as long as the server allows it. Requests can also be sent before the
+ * responses to the previous ones are received (pipelining).
+ */
+struct http_session {
+	/** Address of the server, to be provided by the user */
+	const struct sockaddr *addr;
+
+	/** Length of the server address */
+	socklen_t addrlen;
+
+#if defined(CONFIG_NET_SOCKETS_SOCKOPT_TLS)
+	/** TLS credentials of the connection. If sec_tag_count is 0, the
+	 * connection is not secured.
+	 */
+	const sec_tag_t *sec_tag_list;
+
+	/** Number of entries in sec_tag_list */
+	size_t sec_tag_count;
+
+	/** Hostname the server certificate is verified against, may be NULL */
+	const char *tls_hostname;
+#endif
+
+	/** User supplied buffer where the responses are received. It is used
+	 * instead of the recv_buf of the requests sent in the session.
+	 */
+	uint8_t *recv_buf;
+
+	/** Length of the user supplied receive buffer */
+	size_t recv_buf_len;
+
+	/* The fields below are internal, the application should not touch
+	 * them.
+	 */
+
+	/** Requests waiting for their response, oldest first */
+	struct http_request *pending[CONFIG_HTTP_CLIENT_PIPELINE_DEPTH];
+
+	/** Number of requests waiting for their response */
+	uint8_t pending_count;
+
+	/** Bytes of the next response already received, at the start of
+	 * recv_buf.
+	 */
+	size_t recv_pending;
+
+	/** Socket of the connection, -1 if not connected */
+	int sock;
+};
+
+/**
+ * @brief Initialize an HTTP client session. The application must then set
+ * the server address and the receive buffer.
+ *
+ * @param session HTTP session
+ */
+void http_session_init(struct http_session *session);
+
+/**
+ * @brief Send a request in an HTTP session without waiting for the
+ * response, which must then be received with http_session_recv().
+ * The connection to the server is opened, or opened again if the server
+ * closed it, as needed.
+ *
+ * Only requests that do not change the state of the server should be
+ * pipelined, as the ones that follow a failed request are lost with the
+ * connection.
+ *
+ * @param session HTTP session
+ * @param req HTTP request information. It must remain valid until its
+ *        response is received.
+ * @param timeout Max time to wait for the response, in milliseconds.
+ * @param user_data User specified data that is passed to the callbacks.
+ *
+ * @return <0 if error, >=0 amount of data sent to the server
+ * @retval -ENOBUFS if CONFIG_HTTP_CLIENT_PIPELINE_DEPTH requests are already
+ *         waiting for their response.
+ */
+int http_session_send(struct http_session *session, struct http_request *req,
+		      int32_t timeout, void *user_data);
+
+/**
+ * @brief Receive the response to the oldest request sent in an HTTP session
+ * and pass it to the callbacks of the request.
+ *
+ * If the connection is lost, the requests still waiting for their response
+ * get a null HTTP response, like http_client_req() reports a closed
+ * connection.
+ *
+ * @param session HTTP session
+ *
+ * @return <0 if the response was not received, >=0 amount of data received
+ * @retval -ENOENT if no request is waiting for its response.
+ */
+int http_session_recv(struct http_session *session);
+
+/**
+ * @brief Do a HTTP request in an HTTP session: send the request and receive
+ * its response, after the responses to the requests sent before it.
+ *
+ * @param session HTTP session
+ * @param req HTTP request information
+ * @param timeout Max time to wait for the response, in milliseconds.
+ * @param user_data User specified data that is passed to the callbacks.
+ *
+ * @return <0 if error, >=0 amount of data sent to the server
+ */
+int http_session_req(struct http_session *session, struct http_request *req,
+		     int32_t timeout, void *user_data);
+
+/**
+ * @brief Close the connection of an HTTP session. The requests still waiting
+ * for their response get a null HTTP response. The session can be used
+ * again afterwards.
+ *
+ * @param session HTTP session
+ */
+void http_session_close(struct http_session *session);
+#endif /* CONFIG_HTTP_CLIENT */
+
 #ifdef __cplusplus
 }
 #endif
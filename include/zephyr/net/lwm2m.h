@@ -118,6 +118,24 @@ typedef void (*lwm2m_ctx_event_cb_t)(struct lwm2m_ctx *ctx,
 				     enum lwm2m_rd_client_event event);
 
 
+/**
+ * @brief Notification statistics of a LwM2M context
+ *
+ * Updated by the engine when CONFIG_LWM2M_ENGINE_NOTIFY_STATS is enabled.
+ */
+struct lwm2m_notify_stats {
+	/** Notifications sent */
+	uint32_t sent;
+	/** Resource changes sent with a notification already pending for
+	 *  the same observation, instead of in a notification of their own.
+	 */
+	uint32_t coalesced;
+	/** Longest payload encoding time of a notification */
+	uint32_t encode_time_max_us;
+	/** Total payload encoding time of the notifications sent */
+	uint64_t encode_time_us;
+};
+
 /**
  * @brief LwM2M context structure to maintain information for a single
  * LwM2M connection.
@@ -134,6 +152,13 @@ struct lwm2m_ctx {
 	sys_slist_t queued_messages;
 #endif
 	sys_slist_t observer;
+	/** Observations with a notification scheduled, by due time */
+	sys_slist_t observe_due;
+
+#if defined(CONFIG_LWM2M_ENGINE_NOTIFY_STATS)
+	/** Notification statistics, may be read and cleared by the application */
+	struct lwm2m_notify_stats notify_stats;
+#endif
 
 	/** A pointer to currently processed request, for internal LwM2M engine
 	 *  use. The underlying type is ``struct lwm2m_message``, but since it's
@@ -893,6 +918,64 @@ int lwm2m_engine_get_float(const char *pathstr, double *buf);
  */
 int lwm2m_engine_get_objlnk(const char *pathstr, struct lwm2m_objlnk *buf);
 
+/**
+ * @brief Resolved resource (instance) path
+ *
+ * Obtained with lwm2m_engine_get_res_handle(), so that a resource which is
+ * read or written often does not need its path to be parsed and looked up
+ * on every access. The handle is resolved again when object instances have
+ * been created or deleted since it was last used. Fields are internal to
+ * the engine.
+ */
+struct lwm2m_res_handle {
+	struct lwm2m_obj_path path;
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res *res;
+	struct lwm2m_engine_res_inst *res_inst;
+	uint32_t gen;
+};
+
+/**
+ * @brief Get a handle to a resource (instance)
+ *
+ * @param[in] pathstr LwM2M path string "obj/obj-inst/res(/res-inst)"
+ * @param[out] handle Handle to initialize
+ *
+ * @return 0 for success or negative in case of error.
+ */
+int lwm2m_engine_get_res_handle(const char *pathstr, struct lwm2m_res_handle *handle);
+
+/**
+ * @brief Set resource (instance) value through a handle
+ *
+ * Same as the lwm2m_engine_set_*() functions, @p value points to a value of
+ * the type of the resource, or to the data of opaque and string resources.
+ *
+ * @param[in] handle Handle obtained with lwm2m_engine_get_res_handle()
+ * @param[in] value Value to set
+ * @param[in] len Length of the value
+ *
+ * @return 0 for success or negative in case of error, -ENOENT if the
+ *         resource (instance) no longer exists.
+ */
+int lwm2m_engine_set_by_handle(struct lwm2m_res_handle *handle, void *value, uint16_t len);
+
+/**
+ * @brief Get resource (instance) value through a handle
+ *
+ * Same as the lwm2m_engine_get_*() functions, @p buf receives a value of the
+ * type of the resource, or the data of opaque and string resources.
+ *
+ * @param[in] handle Handle obtained with lwm2m_engine_get_res_handle()
+ * @param[out] buf Buffer to copy data into
+ * @param[in] buflen Length of buffer
+ *
+ * @return 0 for success or negative in case of error, -ENOENT if the
+ *         resource (instance) no longer exists.
+ */
+int lwm2m_engine_get_by_handle(struct lwm2m_res_handle *handle, void *buf, uint16_t buflen);
+
 
 /**
  * @brief Set resource (instance) read callback
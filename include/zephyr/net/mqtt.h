@@ -444,6 +444,25 @@ struct mqtt_transport {
 #endif
 };
 
+#if defined(CONFIG_MQTT_INFLIGHT)
+/** @brief Internal. Message published with QoS 1 or 2 and not acknowledged
+ *         by the broker yet.
+ */
+struct mqtt_inflight_msg {
+	/** Message id of the PUBLISH message. */
+	uint16_t message_id;
+
+	/** Length of the stored PUBLISH packet, 0 if it is not stored. */
+	uint16_t len;
+
+	/** QoS of the message. */
+	uint8_t qos : 2;
+
+	/** PUBREC was received, PUBCOMP is awaited. */
+	uint8_t released : 1;
+};
+#endif /* CONFIG_MQTT_INFLIGHT */
+
 /** @brief MQTT internal state. */
 struct mqtt_internal {
 	/** Internal. Mutex to protect access to the client instance. */
@@ -462,6 +481,26 @@ struct mqtt_internal {
 
 	/** Internal. Remaining payload length to read. */
 	uint32_t remaining_payload;
+
+#if defined(CONFIG_MQTT_INFLIGHT)
+	/** Internal. Messages in flight, oldest first. */
+	struct mqtt_inflight_msg inflight[CONFIG_MQTT_INFLIGHT_MAX_MSGS];
+
+	/** Internal. Number of messages in flight. */
+	uint8_t inflight_count;
+#endif /* CONFIG_MQTT_INFLIGHT */
+
+#if defined(CONFIG_MQTT_TX_COALESCE)
+	/** Internal. Length of the PUBLISH packets waiting to be sent at the
+	 *  start of the transmit buffer.
+	 */
+	uint32_t tx_pending;
+
+	/** Internal. Wall clock value (in milliseconds) when the first of
+	 *  the waiting PUBLISH packets was queued.
+	 */
+	uint32_t tx_pending_since;
+#endif /* CONFIG_MQTT_TX_COALESCE */
 };
 
 /**
@@ -518,6 +557,18 @@ struct mqtt_client {
 	/** Size of transmit buffer. */
 	uint32_t tx_buf_size;
 
+#if defined(CONFIG_MQTT_INFLIGHT)
+	/** Buffer where QoS 1 and QoS 2 PUBLISH packets are kept until they
+	 *  are acknowledged, to send them again when reconnecting to a
+	 *  persistent session. Can be NULL, messages are then only counted
+	 *  against the in-flight window.
+	 */
+	uint8_t *inflight_buf;
+
+	/** Size of in-flight buffer. */
+	uint32_t inflight_buf_size;
+#endif /* CONFIG_MQTT_INFLIGHT */
+
 	/** Keepalive interval for this client in seconds.
 	 *  Default is CONFIG_MQTT_KEEPALIVE.
 	 */
@@ -596,6 +647,15 @@ int mqtt_connect(struct mqtt_client *client);
  * @param[in] param Parameters to be used for the publish message.
  *                  Shall not be NULL.
  *
+ * @note With @kconfig{CONFIG_MQTT_INFLIGHT}, -EAGAIN is returned when
+ *       @kconfig{CONFIG_MQTT_INFLIGHT_MAX_MSGS} QoS 1 or QoS 2 messages are
+ *       not acknowledged yet. Call @ref mqtt_input to process the
+ *       acknowledgments and publish the message again.
+ * @note With @kconfig{CONFIG_MQTT_TX_COALESCE}, messages that fit in the
+ *       transmit buffer are sent together with the next messages, at the
+ *       latest by @ref mqtt_live once @kconfig{CONFIG_MQTT_TX_COALESCE_DELAY}
+ *       milliseconds have passed.
+ *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
  */
 int mqtt_publish(struct mqtt_client *client,
@@ -727,6 +787,8 @@ int mqtt_abort(struct mqtt_client *client);
  *        makes it possible to respect the Keep Alive time agreed with the
  *        broker on connection. @ref mqtt_connect for details on Keep Alive
  *        time.
+ * @note  With @kconfig{CONFIG_MQTT_TX_COALESCE}, this function also sends the
+ *        coalesced PUBLISH messages that have waited for long enough.
  *
  * @return 0 or a negative error code (errno.h) indicating reason of failure.
  */
@@ -739,8 +801,9 @@ int mqtt_live(struct mqtt_client *client);
  * @param[in] client Client instance for which the procedure is requested.
  *
  * @return Time in milliseconds until next keep alive message is expected to
- *         be sent. Function will return -1 if keep alive messages are
- *         not enabled.
+ *         be sent, or until coalesced PUBLISH messages are due to be sent if
+ *         that is sooner. Function will return -1 if keep alive messages are
+ *         not enabled and no messages are waiting.
  */
 int mqtt_keepalive_time_left(const struct mqtt_client *client);
 
@@ -163,6 +163,10 @@ struct zsock_pollfd {
  *  This option accepts any value.
  */
 #define TLS_SESSION_CACHE_PURGE 13
+/** Read-only socket option to obtain the handshake statistics of a socket.
+ *  It returns a struct tls_handshake_stats.
+ */
+#define TLS_HANDSHAKE_STATS 14
 
 /** @} */
 
@@ -183,6 +187,23 @@ struct zsock_pollfd {
 #define TLS_SESSION_CACHE_DISABLED 0 /**< Disable TLS session caching. */
 #define TLS_SESSION_CACHE_ENABLED 1 /**< Enable TLS session caching. */
 
+/** Handshake statistics returned by the TLS_HANDSHAKE_STATS option. */
+struct tls_handshake_stats {
+	/** Duration of the last complete handshake, in milliseconds. The
+	 *  time spent by non-blocking DTLS sockets between handshake steps
+	 *  is included.
+	 */
+	uint32_t duration_ms;
+	/** Number of handshakes completed on the socket. */
+	uint32_t count;
+	/** Client only: a stored session was offered to the server. */
+	uint8_t session_offered;
+	/** Server only: the last handshake resumed a session, from the
+	 *  session cache or from a session ticket.
+	 */
+	uint8_t session_resumed;
+};
+
 struct zsock_addrinfo {
 	struct zsock_addrinfo *ai_next;
 	int ai_flags;
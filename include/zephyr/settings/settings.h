@@ -326,6 +326,66 @@ int settings_save_one(const char *name, const void *value, size_t val_len);
  */
 int settings_delete(const char *name);
 
+/**
+ * Name under which the journal of a settings transaction is stored while it
+ * is being committed.
+ */
+#define SETTINGS_TXN_JOURNAL_NAME ".txn"
+
+/**
+ * Begin a settings transaction.
+ *
+ * Values staged with @ref settings_txn_set and @ref settings_txn_delete are
+ * kept in RAM and written to the storage by @ref settings_txn_commit. Only
+ * the last value staged for a name is written. The transaction is stored
+ * atomically, after a power loss either none or all of its values are
+ * stored, by back-ends saving it as a single batch, and by the other
+ * back-ends with CONFIG_SETTINGS_TXN_JOURNAL.
+ *
+ * The settings are locked for other threads until the transaction is
+ * committed or aborted. Only one transaction can be open at a time.
+ *
+ * @return 0 on success, -EALREADY if the calling thread already has an open
+ * transaction, -ENOENT if there is no storage backend.
+ */
+int settings_txn_begin(void);
+
+/**
+ * Stage a value in the open settings transaction.
+ *
+ * @param name Name/key of the settings item.
+ * @param value Pointer to the value of the settings item, copied in the
+ * transaction buffer.
+ * @param val_len Length of the value, 0 stages a deletion.
+ *
+ * @return 0 on success, -ENOMEM if the transaction buffer is full, -EINVAL
+ * if no transaction is open by the calling thread or arguments are invalid,
+ * which includes names holding a '=' character.
+ */
+int settings_txn_set(const char *name, const void *value, size_t val_len);
+
+/**
+ * Stage the deletion of a settings item in the open settings transaction.
+ *
+ * @param name Name/key of the settings item.
+ *
+ * @return 0 on success, negative error code as for @ref settings_txn_set.
+ */
+int settings_txn_delete(const char *name);
+
+/**
+ * Write all values staged in the open settings transaction and close it.
+ *
+ * @return 0 on success, non-zero on failure. The transaction is closed in
+ * both cases.
+ */
+int settings_txn_commit(void);
+
+/**
+ * Discard all values staged in the open settings transaction and close it.
+ */
+void settings_txn_abort(void);
+
 /**
  * Call commit for all settings handler. This should apply all
  * settings which has been set, but not applied yet.
@@ -442,6 +502,21 @@ struct settings_store_itf {
 	 * Parameters:
 	 *  - cs - Corresponding backend handler node
 	 */
+
+	int (*csi_save_batch)(struct settings_store *cs, const uint8_t *buf,
+			      size_t len);
+	/**< Save the records of a settings transaction as a single atomic
+	 * update. Optional, without it the records are saved one by one
+	 * with csi_save.
+	 *
+	 * Parameters:
+	 *  - cs - Corresponding backend handler node
+	 *  - buf - Records, each made of the length of a line (2 bytes,
+	 *    little endian) and the line "name=value", an empty value being
+	 *    a deletion. A zero line length followed by the number of
+	 *    records (2 bytes, little endian) ends the batch.
+	 *  - len - Length of the batch in bytes.
+	 */
 };
 
 /**
@@ -92,6 +92,28 @@ int disk_access_write(const char *pdrv, const uint8_t *data_buf,
  */
 int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buff);
 
+#if defined(CONFIG_DISK_CACHE) || defined(__DOXYGEN__)
+/**
+ * @brief Get the block cache statistics of a disk
+ *
+ * @param[in] pdrv          Disk name
+ * @param[out] stats        Statistics
+ *
+ * @return 0 on success, negative errno code on fail
+ */
+int disk_access_cache_stats_get(const char *pdrv,
+				struct disk_cache_stats *stats);
+
+/**
+ * @brief Reset the block cache statistics of a disk
+ *
+ * @param[in] pdrv          Disk name
+ *
+ * @return 0 on success, negative errno code on fail
+ */
+int disk_access_cache_stats_reset(const char *pdrv);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
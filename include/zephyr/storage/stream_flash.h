@@ -22,6 +22,9 @@
 
 #include <stdbool.h>
 #include <zephyr/drivers/flash.h>
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+#include <zephyr/kernel.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -62,6 +65,15 @@ struct stream_flash_ctx {
 #ifdef CONFIG_STREAM_FLASH_ERASE
 	off_t last_erased_page_start_offset; /* Last erased offset */
 #endif
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	struct k_work flush_work; /* Writes flush_buf from the work queue */
+	struct k_sem flush_sem; /* Available when no flush is in progress */
+	uint8_t *flush_buf; /* Buffer being flushed, or the next one */
+	size_t flush_bytes; /* Number of bytes in flush_buf */
+	size_t flush_next; /* Number of bytes known to follow flush_buf */
+	int flush_rc; /* Result of the last flush */
+	bool async; /* Buffers are flushed from the work queue */
+#endif
 };
 
 /**
@@ -83,6 +95,31 @@ struct stream_flash_ctx {
 int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
 		      uint8_t *buf, size_t buf_len, size_t offset, size_t size,
 		      stream_flash_callback_t cb);
+/**
+ * @brief Flush the write buffer asynchronously.
+ *
+ * Splits the write buffer of a context in two halves. Once a half is full,
+ * it is written to flash from a dedicated work queue while
+ * @ref stream_flash_buffered_write fills the other one, and only waits if
+ * that one is full too. With @kconfig{CONFIG_STREAM_FLASH_ERASE}, a page is
+ * erased from the work queue as soon as data for it has been passed to
+ * @ref stream_flash_buffered_write.
+ *
+ * The callback of the context is then called from the work queue, and
+ * @ref stream_flash_bytes_written does not account for the buffer being
+ * written until the next call to @ref stream_flash_buffered_write. A write
+ * with flush set waits for all data to be written. The context must not be
+ * reused or freed before that.
+ *
+ * Must be called right after @ref stream_flash_init.
+ *
+ * @param ctx context
+ *
+ * @return non-negative on success, -EINVAL if the buffer cannot be split
+ *         in write-block-size aligned halves, negative errno code on fail
+ */
+int stream_flash_async_enable(struct stream_flash_ctx *ctx);
+
 /**
  * @brief Read number of bytes written to the flash.
  *
@@ -1098,6 +1098,50 @@ size_t arch_icache_line_size_get(void);
 
 /** @} */
 
+#ifdef CONFIG_CRC_ARCH
+/**
+ * @defgroup arch-crc Architecture-specific CRC APIs
+ * @ingroup arch-interface
+ * @{
+ */
+
+#ifdef CONFIG_ARCH_HAS_CRC32_IEEE
+/**
+ * @brief Update a CRC-32 (IEEE 802.3) using the CRC instructions of the CPU
+ *
+ * The initial and final inversions are left to the caller.
+ *
+ * @param crc CRC of the previous bytes
+ * @param data Input bytes, of any alignment
+ * @param len Number of input bytes
+ *
+ * @return CRC including the input bytes
+ *
+ * @see crc32_ieee_update()
+ */
+uint32_t arch_crc32_ieee_update(uint32_t crc, const uint8_t *data, size_t len);
+#endif /* CONFIG_ARCH_HAS_CRC32_IEEE */
+
+#ifdef CONFIG_ARCH_HAS_CRC32C
+/**
+ * @brief Update a CRC-32C (Castagnoli) using the CRC instructions of the CPU
+ *
+ * The initial and final inversions are left to the caller.
+ *
+ * @param crc CRC of the previous bytes
+ * @param data Input bytes, of any alignment
+ * @param len Number of input bytes
+ *
+ * @return CRC including the input bytes
+ *
+ * @see crc32_c()
+ */
+uint32_t arch_crc32c_update(uint32_t crc, const uint8_t *data, size_t len);
+#endif /* CONFIG_ARCH_HAS_CRC32C */
+
+/** @} */
+#endif /* CONFIG_CRC_ARCH */
+
 #ifdef CONFIG_TIMING_FUNCTIONS
 #include <zephyr/timing/types.h>
 
@@ -763,6 +763,111 @@ int cbpprintf(cbprintf_cb out, void *ctx, void *packaged)
 	return cbpprintf_external(out, cbvprintf, ctx, packaged);
 }
 
+/** @brief varargs-aware *printf-like output through a span callback.
+ *
+ * This is z_cbvprintf_impl() except the output is generated in spans of
+ * characters: the literal text between conversions, the converted values
+ * and the padding are each passed to @p out at once, instead of a
+ * character at a time.
+ *
+ * @note With @kconfig{CONFIG_CBPRINTF_NANO} the characters are collected
+ * in a small buffer and passed to @p out when it is full.
+ *
+ * @param out the function used to emit each generated span. It must
+ * consume the whole span, a negative return value aborts the formatting.
+ *
+ * @param ctx context provided when invoking out
+ *
+ * @param format a standard ISO C format string with characters and conversion
+ * specifications.
+ *
+ * @param ap a reference to the values to be converted.
+ *
+ * @param flags flags on how to process the inputs.
+ *              @see Z_CBVPRINTF_PROCESS_FLAGS.
+ *
+ * @return the number of characters generated, or a negative error value
+ * returned from invoking @p out.
+ */
+int z_cbvprintf_span_impl(cbprintf_convert_cb out, void *ctx,
+			  const char *format, va_list ap, uint32_t flags);
+
+/** @brief varargs-aware *printf-like output through a span callback.
+ *
+ * @see z_cbvprintf_span_impl()
+ *
+ * @param out the function used to emit each generated span.
+ *
+ * @param ctx context provided when invoking out
+ *
+ * @param format a standard ISO C format string with characters and conversion
+ * specifications.
+ *
+ * @param ap a reference to the values to be converted.
+ *
+ * @return the number of characters generated, or a negative error value
+ * returned from invoking @p out.
+ */
+static inline
+int cbvprintf_span(cbprintf_convert_cb out, void *ctx, const char *format,
+		   va_list ap)
+{
+	return z_cbvprintf_span_impl(out, ctx, format, ap, 0);
+}
+
+/* Formatters for cbpprintf_span(), which go through cbpprintf_external()
+ * with the span callback passed as a character one.
+ */
+static inline
+int z_cbvprintf_span_external(cbprintf_cb out, void *ctx, const char *format,
+			      va_list ap)
+{
+	return z_cbvprintf_span_impl((cbprintf_convert_cb)out, ctx, format, ap,
+				     0);
+}
+
+static inline
+int z_cbvprintf_span_tagged_external(cbprintf_cb out, void *ctx,
+				     const char *format, va_list ap)
+{
+	return z_cbvprintf_span_impl((cbprintf_convert_cb)out, ctx, format, ap,
+				     Z_CBVPRINTF_PROCESS_FLAG_TAGGED_ARGS);
+}
+
+/** @brief Generate the output for a previously captured format
+ * operation through a span callback.
+ *
+ * This is cbpprintf() with the output generated as in cbvprintf_span().
+ *
+ * @param out the function used to emit each generated span.
+ *
+ * @param ctx context provided when invoking out
+ *
+ * @param packaged the data required to generate the formatted output, as
+ * captured by cbprintf_package() or cbvprintf_package().
+ *
+ * @return the number of characters printed, or a negative error value
+ * returned from invoking @p out.
+ */
+static inline
+int cbpprintf_span(cbprintf_convert_cb out, void *ctx, void *packaged)
+{
+#if defined(CONFIG_CBPRINTF_PACKAGE_SUPPORT_TAGGED_ARGUMENTS)
+	union cbprintf_package_hdr *hdr =
+		(union cbprintf_package_hdr *)packaged;
+
+	if ((hdr->desc.pkg_flags & CBPRINTF_PACKAGE_ARGS_ARE_TAGGED)
+	    == CBPRINTF_PACKAGE_ARGS_ARE_TAGGED) {
+		return cbpprintf_external((cbprintf_cb)out,
+					  z_cbvprintf_span_tagged_external,
+					  ctx, packaged);
+	}
+#endif
+
+	return cbpprintf_external((cbprintf_cb)out, z_cbvprintf_span_external,
+				  ctx, packaged);
+}
+
 #ifdef CONFIG_CBPRINTF_LIBC_SUBSTS
 
 #ifdef CONFIG_PICOLIBC
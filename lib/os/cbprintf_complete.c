@@ -790,17 +790,62 @@ static char *encode_uint(uint_value_type value,
 			 char *bps,
 			 const char *bpe)
 {
+	/* Pairs of decimal digits, from "00" to "99" */
+	static const char digit_pairs[] =
+		"00010203040506070809101112131415161718192021222324"
+		"25262728293031323334353637383940414243444546474849"
+		"50515253545556575859606162636465666768697071727374"
+		"75767778798081828384858687888990919293949596979899";
 	bool upcase = isupper((int)conv->specifier);
 	const unsigned int radix = conversion_radix(conv->specifier);
 	char *bp = bps + (bpe - bps);
 
-	do {
-		unsigned int lsv = (unsigned int)(value % radix);
+	if (radix == 10) {
+		uint32_t value32;
+
+		/* Two digits per division, dropping to 32-bit divisions
+		 * as soon as the value fits.  The buffer is sized for the
+		 * octal representation, so the decimal one always fits.
+		 */
+#ifdef CONFIG_CBPRINTF_FULL_INTEGRAL
+		while (value > UINT32_MAX) {
+			unsigned int pair = (unsigned int)(value % 100U);
+
+			value /= 100U;
+			bp -= 2;
+			bp[0] = digit_pairs[2 * pair];
+			bp[1] = digit_pairs[2 * pair + 1];
+		}
+#endif
+
+		value32 = (uint32_t)value;
+
+		while (value32 >= 100U) {
+			unsigned int pair = value32 % 100U;
 
-		*--bp = (lsv <= 9) ? ('0' + lsv)
-			: upcase ? ('A' + lsv - 10) : ('a' + lsv - 10);
-		value /= radix;
-	} while ((value != 0) && (bps < bp));
+			value32 /= 100U;
+			bp -= 2;
+			bp[0] = digit_pairs[2 * pair];
+			bp[1] = digit_pairs[2 * pair + 1];
+		}
+
+		if (value32 >= 10U) {
+			bp -= 2;
+			bp[0] = digit_pairs[2 * value32];
+			bp[1] = digit_pairs[2 * value32 + 1];
+		} else {
+			*--bp = '0' + value32;
+		}
+	} else {
+		const char *digits = upcase ? "0123456789ABCDEF"
+					    : "0123456789abcdef";
+		const unsigned int shift = (radix == 16) ? 4 : 3;
+
+		do {
+			*--bp = digits[value & (radix - 1)];
+			value >>= shift;
+		} while ((value != 0) && (bps < bp));
+	}
 
 	/* Record required alternate forms.  This can be determined
 	 * from the radix without re-checking specifier.
@@ -1315,14 +1360,45 @@ static inline void store_count(const struct conversion *conv,
 	}
 }
 
-/* Outline function to emit all characters in [sp, ep). */
+/* Outline function to emit one character, through out_span if it is set
+ * or else through out.
+ */
+static int outc(cbprintf_cb out,
+		cbprintf_convert_cb out_span,
+		void *ctx,
+		int c)
+{
+	char ch = (char)c;
+
+	if (out_span != NULL) {
+		return out_span(&ch, 1, ctx);
+	}
+
+	return out(c, ctx);
+}
+
+/* Outline function to emit all characters in [sp, ep), as one span if
+ * out_span is set.
+ */
 static int outs(cbprintf_cb out,
+		cbprintf_convert_cb out_span,
 		void *ctx,
 		const char *sp,
 		const char *ep)
 {
 	size_t count = 0;
 
+	if (out_span != NULL) {
+		size_t len = (ep != NULL) ? (size_t)(ep - sp) : strlen(sp);
+		int rc = 0;
+
+		if (len > 0) {
+			rc = out_span(sp, len, ctx);
+		}
+
+		return (rc < 0) ? rc : (int)len;
+	}
+
 	while ((sp < ep) || ((ep == NULL) && *sp)) {
 		int rc = out((int)*sp++, ctx);
 
@@ -1335,8 +1411,34 @@ static int outs(cbprintf_cb out,
 	return (int)count;
 }
 
-int z_cbvprintf_impl(cbprintf_cb out, void *ctx, const char *fp,
-		     va_list ap, uint32_t flags)
+/* Outline function to emit len times the padding character c. */
+static int outpad(cbprintf_cb out,
+		  cbprintf_convert_cb out_span,
+		  void *ctx,
+		  char c,
+		  int len)
+{
+	static const char zeros[] = "0000000000000000";
+	static const char spaces[] = "                ";
+	const char *pad = (c == '0') ? zeros : spaces;
+	int count = 0;
+
+	while (count < len) {
+		int n = MIN(len - count, (int)sizeof(zeros) - 1);
+		int rc = outs(out, out_span, ctx, pad, pad + n);
+
+		if (rc < 0) {
+			return rc;
+		}
+		count += n;
+	}
+
+	return count;
+}
+
+static int cbvprintf_common(cbprintf_cb out, cbprintf_convert_cb out_span,
+			    void *ctx, const char *fp, va_list ap,
+			    uint32_t flags)
 {
 	char buf[CONVERTED_BUFLEN];
 	size_t count = 0;
@@ -1351,7 +1453,7 @@ int z_cbvprintf_impl(cbprintf_cb out, void *ctx, const char *fp,
  * NB: c is evaluated exactly once: side-effects are OK
  */
 #define OUTC(c) do { \
-	int rc = (*out)((int)(c), ctx); \
+	int rc = outc(out, out_span, ctx, (int)(c)); \
 	\
 	if (rc < 0) { \
 		return rc; \
@@ -1364,7 +1466,7 @@ int z_cbvprintf_impl(cbprintf_cb out, void *ctx, const char *fp,
  */
 
 #define OUTS(_sp, _ep) do { \
-	int rc = outs(out, ctx, _sp, _ep); \
+	int rc = outs(out, out_span, ctx, _sp, _ep); \
 	\
 	if (rc < 0) {	    \
 		return rc; \
@@ -1372,9 +1474,30 @@ int z_cbvprintf_impl(cbprintf_cb out, void *ctx, const char *fp,
 	count += rc; \
 } while (false)
 
+/* Output a padding character n times, returning a negative error if
+ * output failed.
+ */
+#define OUTPAD(_c, _n) do { \
+	int rc = outpad(out, out_span, ctx, _c, _n); \
+	\
+	if (rc < 0) { \
+		return rc; \
+	} \
+	count += rc; \
+} while (false)
+
 	while (*fp != 0) {
 		if (*fp != '%') {
-			OUTC(*fp++);
+			const char *lp = fp;
+
+			/* Emit the literal text up to the next conversion
+			 * at once.
+			 */
+			do {
+				++fp;
+			} while ((*fp != 0) && (*fp != '%'));
+
+			OUTS(lp, fp);
 			continue;
 		}
 
@@ -1761,9 +1884,8 @@ int z_cbvprintf_impl(cbprintf_cb out, void *ctx, const char *fp,
 					pad = '0';
 				}
 
-				while (width-- > 0) {
-					OUTC(pad);
-				}
+				OUTPAD(pad, width);
+				width = 0;
 			}
 		}
 
@@ -1823,22 +1945,28 @@ int z_cbvprintf_impl(cbprintf_cb out, void *ctx, const char *fp,
 				OUTC(conv->specifier);
 			}
 
-			pad_len = conv->pad0_value;
-			while (pad_len-- > 0) {
-				OUTC('0');
-			}
-
+			OUTPAD('0', conv->pad0_value);
 			OUTS(bps, bpe);
 		}
 
 		/* Finish left justification */
-		while (width > 0) {
-			OUTC(' ');
-			--width;
-		}
+		OUTPAD(' ', width);
 	}
 
 	return count;
+#undef OUTPAD
 #undef OUTS
 #undef OUTC
 }
+
+int z_cbvprintf_impl(cbprintf_cb out, void *ctx, const char *fp,
+		     va_list ap, uint32_t flags)
+{
+	return cbvprintf_common(out, NULL, ctx, fp, ap, flags);
+}
+
+int z_cbvprintf_span_impl(cbprintf_convert_cb out, void *ctx, const char *fp,
+			  va_list ap, uint32_t flags)
+{
+	return cbvprintf_common(NULL, out, ctx, fp, ap, flags);
+}
@@ -353,3 +353,51 @@ start:
 		goto start;
 	}
 }
+
+/* The formatter above emits a character at a time, batch them for
+ * z_cbvprintf_span_impl().
+ */
+struct span_ctx {
+	cbprintf_convert_cb out;
+	void *ctx;
+	int rc;
+	size_t len;
+	char buf[32];
+};
+
+static void span_flush(struct span_ctx *span)
+{
+	if ((span->len > 0) && (span->rc >= 0)) {
+		span->rc = span->out(span->buf, span->len, span->ctx);
+	}
+
+	span->len = 0;
+}
+
+static int span_out(int c, void *ctx)
+{
+	struct span_ctx *span = ctx;
+
+	if (span->len == sizeof(span->buf)) {
+		span_flush(span);
+	}
+
+	span->buf[span->len++] = (char)c;
+
+	return c;
+}
+
+int z_cbvprintf_span_impl(cbprintf_convert_cb out, void *ctx, const char *fmt,
+			  va_list ap, uint32_t flags)
+{
+	struct span_ctx span = {
+		.out = out,
+		.ctx = ctx,
+	};
+	int rc;
+
+	rc = z_cbvprintf_impl(span_out, &span, fmt, ap, flags);
+	span_flush(&span);
+
+	return (span.rc < 0) ? span.rc : rc;
+}
@@ -730,6 +730,748 @@ int json_arr_separate_parse_object(struct json_obj *json, const struct json_obj_
 	return obj_parse(json, descr, descr_len, val);
 }
 
+#if defined(CONFIG_JSON_STREAM)
+enum json_stream_lex {
+	JSON_LEX_NONE,
+	JSON_LEX_STRING,
+	JSON_LEX_ESCAPE,
+	JSON_LEX_UNICODE,
+	JSON_LEX_NUMBER,
+	JSON_LEX_LITERAL,
+};
+
+/* Position in a number, kept in aux while lexing it */
+enum json_stream_num {
+	JSON_NUM_SIGN,		/* after '-' */
+	JSON_NUM_ZERO,		/* after a leading '0' */
+	JSON_NUM_INT,		/* in the integer part */
+	JSON_NUM_DOT,		/* after '.' */
+	JSON_NUM_FRAC,		/* in the fraction */
+	JSON_NUM_EXP,		/* after 'e' or 'E' */
+	JSON_NUM_EXP_SIGN,	/* after the exponent sign */
+	JSON_NUM_EXP_DIGITS,	/* in the exponent */
+	JSON_NUM_INVALID,
+};
+
+enum json_stream_expect {
+	JSON_EXPECT_VALUE,
+	JSON_EXPECT_VALUE_OR_END,
+	JSON_EXPECT_KEY,
+	JSON_EXPECT_KEY_OR_END,
+	JSON_EXPECT_COLON,
+	JSON_EXPECT_COMMA_OR_END,
+	JSON_EXPECT_DONE,
+};
+
+void json_stream_init(struct json_stream *stream, char *buf, size_t buf_size,
+		      json_stream_cb_t cb, void *user_data)
+{
+	(void)memset(stream, 0, sizeof(*stream));
+
+	stream->cb = cb;
+	stream->user_data = user_data;
+	stream->buf = buf;
+	stream->buf_size = buf_size;
+	stream->expect = JSON_EXPECT_VALUE;
+	stream->lex = JSON_LEX_NONE;
+}
+
+static bool stream_in_object(const struct json_stream *stream)
+{
+	return stream->depth > 0 &&
+	       (stream->containers & BIT(stream->depth - 1));
+}
+
+static bool stream_expects_value(const struct json_stream *stream)
+{
+	return stream->expect == JSON_EXPECT_VALUE ||
+	       stream->expect == JSON_EXPECT_VALUE_OR_END;
+}
+
+static bool stream_expects_key(const struct json_stream *stream)
+{
+	return stream->expect == JSON_EXPECT_KEY ||
+	       stream->expect == JSON_EXPECT_KEY_OR_END;
+}
+
+static void stream_value_done(struct json_stream *stream)
+{
+	stream->expect = stream->depth > 0 ? JSON_EXPECT_COMMA_OR_END :
+					     JSON_EXPECT_DONE;
+}
+
+static int stream_emit(struct json_stream *stream, enum json_tokens type,
+		       const char *value, size_t value_len)
+{
+	struct json_stream_event evt = {
+		.type = type,
+		.depth = stream->depth,
+		.value = value,
+		.value_len = value_len,
+	};
+
+	if (type != JSON_TOK_OBJECT_END && type != JSON_TOK_ARRAY_END &&
+	    stream_in_object(stream)) {
+		evt.key = stream->buf;
+		evt.key_len = stream->key_len;
+	}
+
+	return stream->cb(&evt, stream->user_data);
+}
+
+/* Keep the part of a token found in the chunk, which is gone once
+ * json_stream_feed() returns.
+ */
+static int stream_save(struct json_stream *stream, const char *data,
+		       size_t len)
+{
+	size_t used = stream->key_len + stream->val_len;
+
+	if (len > stream->buf_size - used) {
+		return -ENOMEM;
+	}
+
+	memcpy(stream->buf + used, data, len);
+	stream->val_len += len;
+	stream->partial = true;
+
+	return 0;
+}
+
+/* Get the text of a completed token, which is only copied if it started
+ * in a previous chunk.
+ */
+static int stream_token(struct json_stream *stream, const char *start,
+			const char *end, const char **text, size_t *len)
+{
+	int ret;
+
+	if (!stream->partial) {
+		*text = start;
+		*len = end - start;
+
+		return 0;
+	}
+
+	ret = stream_save(stream, start, end - start);
+	if (ret < 0) {
+		return ret;
+	}
+
+	*text = stream->buf + stream->key_len;
+	*len = stream->val_len;
+
+	stream->partial = false;
+	stream->val_len = 0;
+
+	return 0;
+}
+
+static int stream_string_end(struct json_stream *stream, const char *start,
+			     const char *end)
+{
+	const char *text;
+	size_t len;
+	int ret;
+
+	ret = stream_token(stream, start, end, &text, &len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (stream_expects_key(stream)) {
+		/* Kept until the value is complete. A key that started in a
+		 * previous chunk is already in place.
+		 */
+		if (text != stream->buf) {
+			if (len > stream->buf_size) {
+				return -ENOMEM;
+			}
+
+			memcpy(stream->buf, text, len);
+		}
+
+		stream->key_len = len;
+		stream->expect = JSON_EXPECT_COLON;
+
+		return 0;
+	}
+
+	ret = stream_emit(stream, JSON_TOK_STRING, text, len);
+	stream_value_done(stream);
+
+	return ret;
+}
+
+static int stream_number_end(struct json_stream *stream, const char *start,
+			     const char *end)
+{
+	const char *text;
+	size_t len;
+	int ret;
+
+	ret = stream_token(stream, start, end, &text, &len);
+	if (ret < 0) {
+		return ret;
+	}
+
+	/* Only complete after a digit */
+	if (stream->aux != JSON_NUM_ZERO && stream->aux != JSON_NUM_INT &&
+	    stream->aux != JSON_NUM_FRAC && stream->aux != JSON_NUM_EXP_DIGITS) {
+		return -EINVAL;
+	}
+
+	ret = stream_emit(stream, JSON_TOK_NUMBER, text, len);
+	stream_value_done(stream);
+
+	return ret;
+}
+
+static bool stream_number_char(char chr)
+{
+	return isdigit((unsigned char)chr) || chr == '.' || chr == 'e' ||
+	       chr == 'E' || chr == '+' || chr == '-';
+}
+
+/* Position in a number after chr, following the JSON number grammar:
+ * -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+ */
+static uint8_t stream_number_next(uint8_t num, char chr)
+{
+	bool digit = isdigit((unsigned char)chr);
+
+	switch (num) {
+	case JSON_NUM_SIGN:
+		if (chr == '0') {
+			return JSON_NUM_ZERO;
+		}
+
+		return digit ? JSON_NUM_INT : JSON_NUM_INVALID;
+	case JSON_NUM_INT:
+		if (digit) {
+			return JSON_NUM_INT;
+		}
+
+		__fallthrough;
+	case JSON_NUM_ZERO:
+		if (chr == '.') {
+			return JSON_NUM_DOT;
+		}
+
+		return (chr == 'e' || chr == 'E') ? JSON_NUM_EXP :
+						    JSON_NUM_INVALID;
+	case JSON_NUM_DOT:
+		return digit ? JSON_NUM_FRAC : JSON_NUM_INVALID;
+	case JSON_NUM_FRAC:
+		if (digit) {
+			return JSON_NUM_FRAC;
+		}
+
+		return (chr == 'e' || chr == 'E') ? JSON_NUM_EXP :
+						    JSON_NUM_INVALID;
+	case JSON_NUM_EXP:
+		if (chr == '+' || chr == '-') {
+			return JSON_NUM_EXP_SIGN;
+		}
+
+		__fallthrough;
+	case JSON_NUM_EXP_SIGN:
+	case JSON_NUM_EXP_DIGITS:
+		return digit ? JSON_NUM_EXP_DIGITS : JSON_NUM_INVALID;
+	default:
+		return JSON_NUM_INVALID;
+	}
+}
+
+/* Handle the first character of a token. */
+static int stream_start(struct json_stream *stream, char chr)
+{
+	int ret;
+
+	switch (chr) {
+	case '{':
+	case '[':
+		if (!stream_expects_value(stream)) {
+			return -EINVAL;
+		}
+
+		if (stream->depth == CONFIG_JSON_STREAM_MAX_DEPTH) {
+			return -ENOSPC;
+		}
+
+		ret = stream_emit(stream, (enum json_tokens)chr, NULL, 0);
+
+		WRITE_BIT(stream->containers, stream->depth, chr == '{');
+		stream->depth++;
+		stream->expect = (chr == '{') ? JSON_EXPECT_KEY_OR_END :
+						JSON_EXPECT_VALUE_OR_END;
+
+		return ret;
+	case '}':
+	case ']':
+		if (stream->depth == 0 ||
+		    stream_in_object(stream) != (chr == '}')) {
+			return -EINVAL;
+		}
+
+		if (stream->expect != JSON_EXPECT_COMMA_OR_END &&
+		    stream->expect != ((chr == '}') ? JSON_EXPECT_KEY_OR_END :
+						      JSON_EXPECT_VALUE_OR_END)) {
+			return -EINVAL;
+		}
+
+		stream->depth--;
+
+		ret = stream_emit(stream, (enum json_tokens)chr, NULL, 0);
+		stream_value_done(stream);
+
+		return ret;
+	case ',':
+		if (stream->expect != JSON_EXPECT_COMMA_OR_END) {
+			return -EINVAL;
+		}
+
+		stream->expect = stream_in_object(stream) ? JSON_EXPECT_KEY :
+							    JSON_EXPECT_VALUE;
+		return 0;
+	case ':':
+		if (stream->expect != JSON_EXPECT_COLON) {
+			return -EINVAL;
+		}
+
+		stream->expect = JSON_EXPECT_VALUE;
+		return 0;
+	case '"':
+		if (stream_expects_key(stream)) {
+			/* The previous key is not needed anymore. */
+			stream->key_len = 0;
+		} else if (!stream_expects_value(stream)) {
+			return -EINVAL;
+		}
+
+		stream->lex = JSON_LEX_STRING;
+		return 0;
+	case 't':
+	case 'f':
+	case 'n':
+		if (!stream_expects_value(stream)) {
+			return -EINVAL;
+		}
+
+		stream->literal = (chr == 't') ? "rue" :
+				  (chr == 'f') ? "alse" : "ull";
+		stream->aux = chr;
+		stream->lex = JSON_LEX_LITERAL;
+		return 0;
+	default:
+		if (chr != '-' && !isdigit((unsigned char)chr)) {
+			return -EINVAL;
+		}
+
+		if (!stream_expects_value(stream)) {
+			return -EINVAL;
+		}
+
+		stream->aux = (chr == '-') ? JSON_NUM_SIGN :
+			      (chr == '0') ? JSON_NUM_ZERO : JSON_NUM_INT;
+		stream->lex = JSON_LEX_NUMBER;
+		return 0;
+	}
+}
+
+int json_stream_feed(struct json_stream *stream, const char *data,
+		     size_t len)
+{
+	const char *end = data + len;
+	const char *pos = data;
+	/* Start of the current token in this chunk. */
+	const char *start = data;
+	int ret = 0;
+
+	if (stream->err < 0) {
+		return stream->err;
+	}
+
+	while (pos < end && ret == 0) {
+		char chr = *pos;
+
+		switch (stream->lex) {
+		case JSON_LEX_NONE:
+			pos++;
+
+			if (chr == ' ' || chr == '\t' || chr == '\n' ||
+			    chr == '\r') {
+				continue;
+			}
+
+			stream->partial = false;
+			stream->val_len = 0;
+			start = (chr == '"') ? pos : pos - 1;
+
+			ret = stream_start(stream, chr);
+			break;
+		case JSON_LEX_STRING:
+			/* Most characters need no attention. */
+			while (pos < end && *pos != '"' && *pos != '\\') {
+				pos++;
+			}
+
+			if (pos == end) {
+				break;
+			}
+
+			if (*pos == '\\') {
+				stream->lex = JSON_LEX_ESCAPE;
+				pos++;
+				break;
+			}
+
+			stream->lex = JSON_LEX_NONE;
+			ret = stream_string_end(stream, start, pos);
+			pos++;
+			break;
+		case JSON_LEX_ESCAPE:
+			pos++;
+
+			switch (chr) {
+			case '"':
+			case '\\':
+			case '/':
+			case 'b':
+			case 'f':
+			case 'n':
+			case 'r':
+			case 't':
+				stream->lex = JSON_LEX_STRING;
+				break;
+			case 'u':
+				stream->aux = 4U;
+				stream->lex = JSON_LEX_UNICODE;
+				break;
+			default:
+				ret = -EINVAL;
+				break;
+			}
+
+			break;
+		case JSON_LEX_UNICODE:
+			pos++;
+
+			if (!isxdigit((unsigned char)chr)) {
+				ret = -EINVAL;
+			} else if (--stream->aux == 0U) {
+				stream->lex = JSON_LEX_STRING;
+			}
+
+			break;
+		case JSON_LEX_NUMBER:
+			while (pos < end && stream_number_char(*pos)) {
+				stream->aux = stream_number_next(stream->aux,
+								 *pos);
+				if (stream->aux == JSON_NUM_INVALID) {
+					ret = -EINVAL;
+					break;
+				}
+
+				pos++;
+			}
+
+			if (ret < 0 || pos == end) {
+				break;
+			}
+
+			/* The character after the number is handled next. */
+			stream->lex = JSON_LEX_NONE;
+			ret = stream_number_end(stream, start, pos);
+			break;
+		case JSON_LEX_LITERAL:
+			pos++;
+
+			if (chr != *stream->literal) {
+				ret = -EINVAL;
+				break;
+			}
+
+			if (*++stream->literal == '\0') {
+				stream->lex = JSON_LEX_NONE;
+				ret = stream_emit(stream,
+						  (enum json_tokens)stream->aux,
+						  NULL, 0);
+				stream_value_done(stream);
+			}
+
+			break;
+		}
+	}
+
+	if (ret == 0 && stream->lex != JSON_LEX_NONE &&
+	    stream->lex != JSON_LEX_LITERAL) {
+		ret = stream_save(stream, start, end - start);
+	}
+
+	stream->err = ret;
+
+	return ret;
+}
+
+int json_stream_finish(struct json_stream *stream)
+{
+	int ret = stream->err;
+
+	/* Nothing but the end of the payload terminates a top-level number. */
+	if (ret == 0 && stream->lex == JSON_LEX_NUMBER) {
+		stream->lex = JSON_LEX_NONE;
+		ret = stream_number_end(stream, stream->buf, stream->buf);
+	}
+
+	if (ret == 0 && (stream->lex != JSON_LEX_NONE ||
+			 stream->expect != JSON_EXPECT_DONE)) {
+		ret = -EINVAL;
+	}
+
+	stream->err = ret;
+
+	return ret;
+}
+
+static int decode_num_text(const char *text, size_t len, int32_t *num)
+{
+	char buf[sizeof("-2147483648")];
+	char *endptr;
+	long val;
+
+	if (len >= sizeof(buf)) {
+		return -EINVAL;
+	}
+
+	memcpy(buf, text, len);
+	buf[len] = '\0';
+
+	errno = 0;
+	val = strtol(buf, &endptr, 10);
+
+	if (errno != 0) {
+		return -errno;
+	}
+
+	if (endptr != buf + len) {
+		return -EINVAL;
+	}
+
+	if (val < INT32_MIN || val > INT32_MAX) {
+		return -ERANGE;
+	}
+
+	*num = val;
+
+	return 0;
+}
+
+/* Decoded strings are stored from the end of the buffer, which leaves less
+ * room for the tokens split between chunks.
+ */
+static int obj_stream_store(struct json_obj_stream *obj, const char *text,
+			    size_t len, char **stored)
+{
+	struct json_stream *stream = &obj->stream;
+
+	if (len >= stream->buf_size - stream->key_len) {
+		return -ENOMEM;
+	}
+
+	stream->buf_size -= len + 1;
+
+	*stored = stream->buf + stream->buf_size;
+	memmove(*stored, text, len);
+	(*stored)[len] = '\0';
+
+	return 0;
+}
+
+static int obj_stream_value(struct json_obj_stream *obj,
+			    const struct json_stream_event *evt,
+			    const struct json_obj_descr *descr, void *field,
+			    void *val)
+{
+	struct json_obj_stream_frame *frame;
+	ptrdiff_t elem_size;
+
+	if (!equivalent_types(evt->type, descr->type)) {
+		return -EINVAL;
+	}
+
+	switch (descr->type) {
+	case JSON_TOK_OBJECT_START:
+		frame = &obj->frames[evt->depth];
+		frame->descr = descr->object.sub_descr;
+		frame->len = descr->object.sub_descr_len;
+		frame->val = field;
+		frame->decoded = 0U;
+
+		return 0;
+	case JSON_TOK_ARRAY_START:
+		elem_size = get_elem_size(descr->array.element_descr);
+
+		__ASSERT_NO_MSG(elem_size > 0);
+
+		frame = &obj->frames[evt->depth];
+		frame->descr = descr->array.element_descr;
+		frame->len = descr->array.n_elements;
+		frame->val = field;
+		frame->elem_size = elem_size;
+		frame->decoded = 0U;
+		frame->elements = NULL;
+
+		if (val) {
+			frame->elements = (size_t *)((char *)val +
+						     frame->descr->offset);
+			*frame->elements = 0;
+		}
+
+		return 0;
+	case JSON_TOK_FALSE:
+	case JSON_TOK_TRUE: {
+		bool *v = field;
+
+		*v = evt->type == JSON_TOK_TRUE;
+
+		return 0;
+	}
+	case JSON_TOK_NUMBER:
+		return decode_num_text(evt->value, evt->value_len, field);
+	case JSON_TOK_OPAQUE:
+	case JSON_TOK_FLOAT: {
+		struct json_obj_token *obj_token = field;
+
+		obj_token->length = evt->value_len;
+
+		return obj_stream_store(obj, evt->value, evt->value_len,
+					&obj_token->start);
+	}
+	case JSON_TOK_STRING:
+		return obj_stream_store(obj, evt->value, evt->value_len, field);
+	default:
+		return -EINVAL;
+	}
+}
+
+static int obj_stream_cb(const struct json_stream_event *evt, void *user_data)
+{
+	struct json_obj_stream *obj = user_data;
+	struct json_obj_stream_frame *frame;
+	bool start, end;
+	void *field;
+	size_t i;
+
+	start = evt->type == JSON_TOK_OBJECT_START ||
+		evt->type == JSON_TOK_ARRAY_START;
+	end = evt->type == JSON_TOK_OBJECT_END ||
+	      evt->type == JSON_TOK_ARRAY_END;
+
+	/* Members not in the descriptor are skipped with their content. */
+	if (obj->skip > 0U) {
+		if (start) {
+			obj->skip++;
+		} else if (end) {
+			obj->skip--;
+		}
+
+		return 0;
+	}
+
+	if (end) {
+		if (evt->depth == 0U) {
+			obj->decoded = obj->frames[0].decoded;
+		}
+
+		return 0;
+	}
+
+	/* The first frame is set up by json_obj_stream_init(). */
+	if (evt->depth == 0U) {
+		return evt->type == JSON_TOK_OBJECT_START ? 0 : -EINVAL;
+	}
+
+	frame = &obj->frames[evt->depth - 1];
+
+	if (evt->key == NULL) {
+		if (frame->decoded == frame->len) {
+			return -ENOSPC;
+		}
+
+		field = frame->val;
+		frame->val = (char *)frame->val + frame->elem_size;
+		frame->decoded++;
+
+		if (frame->elements) {
+			(*frame->elements)++;
+		}
+
+		return obj_stream_value(obj, evt, frame->descr, field, NULL);
+	}
+
+	for (i = 0; i < frame->len; i++) {
+		const struct json_obj_descr *descr = &frame->descr[i];
+
+		/* Field has been decoded already, skip */
+		if (frame->decoded & BIT(i)) {
+			continue;
+		}
+
+		if (evt->key_len != descr->field_name_len ||
+		    memcmp(evt->key, descr->field_name, evt->key_len)) {
+			continue;
+		}
+
+		frame->decoded |= BIT(i);
+
+		return obj_stream_value(obj, evt, descr,
+					(char *)frame->val + descr->offset,
+					frame->val);
+	}
+
+	if (start) {
+		obj->skip = 1U;
+	}
+
+	return 0;
+}
+
+void json_obj_stream_init(struct json_obj_stream *obj,
+			  const struct json_obj_descr *descr, size_t descr_len,
+			  void *val, char *buf, size_t buf_size)
+{
+	__ASSERT_NO_MSG(descr_len < (sizeof(obj->decoded) * CHAR_BIT - 1));
+
+	json_stream_init(&obj->stream, buf, buf_size, obj_stream_cb, obj);
+
+	obj->frames[0].descr = descr;
+	obj->frames[0].len = descr_len;
+	obj->frames[0].val = val;
+	obj->frames[0].decoded = 0U;
+	obj->skip = 0U;
+	obj->decoded = -EINVAL;
+}
+
+int json_obj_stream_feed(struct json_obj_stream *obj, const char *data,
+			 size_t len)
+{
+	return json_stream_feed(&obj->stream, data, len);
+}
+
+int json_obj_stream_finish(struct json_obj_stream *obj)
+{
+	int ret;
+
+	ret = json_stream_finish(&obj->stream);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return obj->decoded;
+}
+#endif /* CONFIG_JSON_STREAM */
+
 static char escape_as(char chr)
 {
 	switch (chr) {
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2022 The Zephyr Project Contributors
+#
+# SPDX-License-Identifier: Apache-2.0
+
+"""Symbolize sampling profiler output.
+
+Reads the output of the "profiler dump" shell command (a serial log is
+fine, unrelated lines are ignored), resolves the sampled addresses against
+the symbol table of zephyr.elf and prints folded stacks suitable for
+flamegraph.pl or speedscope, followed by a flat profile on stderr.
+"""
+
+import argparse
+import bisect
+import collections
+import re
+import sys
+
+from elftools.elf.elffile import ELFFile
+
+
+PROF_LINE_RE = re.compile(r"@prof (cpu\d+)((?:;0x[0-9a-fA-F]+)+) (\d+)")
+
+# Sentinel recorded by the target when an ISR was interrupted
+PC_ISR = 1
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__,
+            formatter_class=argparse.RawDescriptionHelpFormatter)
+
+    parser.add_argument("elffile", help="Zephyr ELF binary (zephyr.elf)")
+    parser.add_argument("infile", nargs="?", default="-",
+            help="Profiler dump, stdin if omitted")
+    parser.add_argument("-o", "--outfile", default="-",
+            help="Output file for folded stacks, stdout if omitted")
+    parser.add_argument("--per-cpu", action="store_true",
+            help="Prefix every stack with the CPU it was sampled on")
+    parser.add_argument("--top", type=int, default=20,
+            help="Number of functions shown in the flat profile")
+
+    return parser.parse_args()
+
+
+class Symbolizer:
+    def __init__(self, elf_path):
+        self.starts = []
+        self.ends = []
+        self.names = []
+
+        with open(elf_path, "rb") as f:
+            elf = ELFFile(f)
+            symtab = elf.get_section_by_name(".symtab")
+            if symtab is None:
+                sys.exit(f"ERROR: no symbol table in {elf_path}")
+
+            funcs = []
+            for sym in symtab.iter_symbols():
+                if sym["st_info"]["type"] != "STT_FUNC":
+                    continue
+                # Clear the Thumb bit
+                start = sym["st_value"] & ~1
+                funcs.append((start, start + max(sym["st_size"], 1),
+                              sym.name))
+
+        for start, end, name in sorted(funcs):
+            self.starts.append(start)
+            self.ends.append(end)
+            self.names.append(name)
+
+    def lookup(self, addr, return_address=False):
+        if addr == PC_ISR:
+            return "[isr]"
+
+        # A return address may point just past the end of the caller
+        if return_address:
+            addr -= 1
+
+        idx = bisect.bisect_right(self.starts, addr) - 1
+        if idx >= 0 and addr < self.ends[idx]:
+            return self.names[idx]
+
+        return f"0x{addr:x}"
+
+
+def main():
+    args = parse_args()
+    symbolizer = Symbolizer(args.elffile)
+
+    infile = sys.stdin if args.infile == "-" else open(args.infile, "r")
+    folded = collections.Counter()
+    flat = collections.Counter()
+    total = 0
+
+    for line in infile:
+        match = PROF_LINE_RE.search(line)
+        if not match:
+            continue
+
+        cpu, frames, count = match.groups()
+        count = int(count)
+        addrs = [int(a, 16) for a in frames.strip(";").split(";")]
+
+        # Outermost frame first, the last one is the sampled PC
+        names = [symbolizer.lookup(a, return_address=True)
+                 for a in addrs[:-1]]
+        names.append(symbolizer.lookup(addrs[-1]))
+        if args.per_cpu:
+            names.insert(0, cpu)
+
+        folded[";".join(names)] += count
+        flat[names[-1]] += count
+        total += count
+
+    if total == 0:
+        sys.exit("ERROR: no profiler samples found in input")
+
+    outfile = sys.stdout if args.outfile == "-" else open(args.outfile, "w")
+    for stack, count in folded.most_common():
+        outfile.write(f"{stack} {count}\n")
+
+    print(f"{total} samples", file=sys.stderr)
+    for name, count in flat.most_common(args.top):
+        print(f"{100.0 * count / total:6.2f}% {count:8d}  {name}",
+              file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
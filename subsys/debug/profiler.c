@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file
+ *  @brief Sampling profiler implementation
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/debug/profiler.h>
+#include <zephyr/sys/util.h>
+#include <string.h>
+#include <errno.h>
+
+#define DEPTH      CONFIG_PROFILER_SAMPLING_STACK_DEPTH
+#define MAX_STACKS CONFIG_PROFILER_SAMPLING_MAX_STACKS
+
+BUILD_ASSERT((MAX_STACKS & (MAX_STACKS - 1)) == 0,
+	     "CONFIG_PROFILER_SAMPLING_MAX_STACKS must be a power of two");
+
+struct profiler_entry {
+	uintptr_t pcs[DEPTH];
+	uint32_t count;
+};
+
+struct profiler_cpu {
+	struct k_spinlock lock;
+	struct profiler_stats stats;
+	struct profiler_entry entries[MAX_STACKS];
+};
+
+static struct profiler_cpu profiler_cpus[CONFIG_MP_NUM_CPUS];
+static struct k_timer profiler_timer;
+static bool profiler_running;
+
+/* Fill pcs[] with the interrupted context, innermost frame first, and
+ * return the number of frames recorded.
+ */
+static size_t profiler_arch_sample(uintptr_t *pcs)
+{
+	const z_arch_esf_t *esf;
+
+	/* RETTOBASE is set when only the currently executing exception is
+	 * active: the timer interrupt preempted a thread, whose basic stack
+	 * frame is on PSP. Otherwise it preempted another interrupt.
+	 */
+	if ((SCB->ICSR & SCB_ICSR_RETTOBASE_Msk) == 0) {
+		pcs[0] = PROFILER_PC_ISR;
+		return 1;
+	}
+
+	esf = (const z_arch_esf_t *)__get_PSP();
+
+	pcs[0] = esf->basic.pc;
+#if DEPTH > 1
+	/* LR holds the return address of a leaf function, and may be stale
+	 * for non-leaf functions which have already pushed it.
+	 */
+	pcs[1] = esf->basic.lr & ~1UL;
+	return 2;
+#else
+	return 1;
+#endif
+}
+
+static inline uint32_t profiler_hash(const uintptr_t *pcs)
+{
+	uint32_t hash = 2166136261U;
+
+	for (size_t i = 0; i < DEPTH; i++) {
+		hash = (hash ^ (uint32_t)pcs[i]) * 16777619U;
+	}
+
+	return hash;
+}
+
+static void profiler_record(struct profiler_cpu *cpu, const uintptr_t *pcs)
+{
+	uint32_t idx = profiler_hash(pcs) & (MAX_STACKS - 1);
+
+	/* Linear probing, an entry with a zero count is free */
+	for (size_t n = 0; n < MAX_STACKS; n++) {
+		struct profiler_entry *e = &cpu->entries[idx];
+
+		if (e->count == 0U) {
+			memcpy(e->pcs, pcs, sizeof(e->pcs));
+			e->count = 1U;
+			cpu->stats.stacks++;
+			cpu->stats.samples++;
+			return;
+		}
+
+		if (memcmp(e->pcs, pcs, sizeof(e->pcs)) == 0) {
+			e->count++;
+			cpu->stats.samples++;
+			return;
+		}
+
+		idx = (idx + 1U) & (MAX_STACKS - 1);
+	}
+
+	cpu->stats.dropped++;
+}
+
+static void profiler_timer_expiry(struct k_timer *timer)
+{
+	struct profiler_cpu *cpu = &profiler_cpus[_current_cpu->id];
+	uintptr_t pcs[DEPTH] = { 0 };
+	k_spinlock_key_t key;
+
+	ARG_UNUSED(timer);
+
+	(void)profiler_arch_sample(pcs);
+
+	key = k_spin_lock(&cpu->lock);
+	profiler_record(cpu, pcs);
+	k_spin_unlock(&cpu->lock, key);
+}
+
+void profiler_reset(void)
+{
+	for (unsigned int i = 0; i < ARRAY_SIZE(profiler_cpus); i++) {
+		struct profiler_cpu *cpu = &profiler_cpus[i];
+		k_spinlock_key_t key = k_spin_lock(&cpu->lock);
+
+		memset(&cpu->stats, 0, sizeof(cpu->stats));
+		memset(cpu->entries, 0, sizeof(cpu->entries));
+		k_spin_unlock(&cpu->lock, key);
+	}
+}
+
+int profiler_start(uint32_t freq_hz)
+{
+	static bool initialized;
+
+	if (freq_hz == 0U) {
+		freq_hz = CONFIG_PROFILER_SAMPLING_DEFAULT_FREQ;
+	}
+
+	if (freq_hz > USEC_PER_SEC) {
+		return -EINVAL;
+	}
+
+	if (profiler_running) {
+		return -EALREADY;
+	}
+
+	if (!initialized) {
+		k_timer_init(&profiler_timer, profiler_timer_expiry, NULL);
+		initialized = true;
+	}
+
+	profiler_reset();
+	profiler_running = true;
+	k_timer_start(&profiler_timer, K_USEC(USEC_PER_SEC / freq_hz),
+		      K_USEC(USEC_PER_SEC / freq_hz));
+
+	return 0;
+}
+
+int profiler_stop(void)
+{
+	if (!profiler_running) {
+		return -EALREADY;
+	}
+
+	k_timer_stop(&profiler_timer);
+	profiler_running = false;
+
+	return 0;
+}
+
+bool profiler_is_running(void)
+{
+	return profiler_running;
+}
+
+int profiler_stats_get(unsigned int cpu, struct profiler_stats *stats)
+{
+	k_spinlock_key_t key;
+
+	if (cpu >= ARRAY_SIZE(profiler_cpus)) {
+		return -EINVAL;
+	}
+
+	key = k_spin_lock(&profiler_cpus[cpu].lock);
+	*stats = profiler_cpus[cpu].stats;
+	k_spin_unlock(&profiler_cpus[cpu].lock, key);
+
+	return 0;
+}
+
+void profiler_foreach_stack(profiler_stack_cb cb, void *user_data)
+{
+	for (unsigned int i = 0; i < ARRAY_SIZE(profiler_cpus); i++) {
+		struct profiler_cpu *cpu = &profiler_cpus[i];
+
+		for (size_t n = 0; n < MAX_STACKS; n++) {
+			struct profiler_entry entry;
+			k_spinlock_key_t key;
+			size_t depth;
+
+			key = k_spin_lock(&cpu->lock);
+			entry = cpu->entries[n];
+			k_spin_unlock(&cpu->lock, key);
+
+			if (entry.count == 0U) {
+				continue;
+			}
+
+			/* Trailing zero frames were not captured */
+			for (depth = DEPTH; depth > 1; depth--) {
+				if (entry.pcs[depth - 1] != 0U) {
+					break;
+				}
+			}
+
+			cb(i, entry.pcs, depth, entry.count, user_data);
+		}
+	}
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/debug/profiler.h>
+#include <stdlib.h>
+
+static int cmd_profiler_start(const struct shell *shell, size_t argc,
+			      char **argv)
+{
+	uint32_t freq = 0U;
+	int err;
+
+	if (argc > 1) {
+		freq = strtoul(argv[1], NULL, 0);
+	}
+
+	err = profiler_start(freq);
+	if (err) {
+		shell_error(shell, "Failed to start profiler (err %d)", err);
+		return err;
+	}
+
+	shell_print(shell, "Profiler started");
+	return 0;
+}
+
+static int cmd_profiler_stop(const struct shell *shell, size_t argc,
+			     char **argv)
+{
+	int err;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	err = profiler_stop();
+	if (err) {
+		shell_error(shell, "Profiler not running");
+		return err;
+	}
+
+	shell_print(shell, "Profiler stopped");
+	return 0;
+}
+
+static int cmd_profiler_reset(const struct shell *shell, size_t argc,
+			      char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	profiler_reset();
+	return 0;
+}
+
+static int cmd_profiler_stats(const struct shell *shell, size_t argc,
+			      char **argv)
+{
+	struct profiler_stats stats;
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	shell_print(shell, "Profiler %s",
+		    profiler_is_running() ? "running" : "stopped");
+
+	for (unsigned int cpu = 0; cpu < CONFIG_MP_NUM_CPUS; cpu++) {
+		(void)profiler_stats_get(cpu, &stats);
+		shell_print(shell, "CPU %u: samples %u, stacks %u, dropped %u",
+			    cpu, stats.samples, stats.stacks, stats.dropped);
+	}
+
+	return 0;
+}
+
+/* Stacks are printed in the folded format, outermost frame first, so the
+ * output can be fed to flamegraph tools once symbolized on the host.
+ */
+static void folded_print_cb(unsigned int cpu, const uintptr_t *pcs,
+			    size_t depth, uint32_t count, void *user_data)
+{
+	const struct shell *shell = user_data;
+
+	shell_fprintf(shell, SHELL_NORMAL, "@prof cpu%u", cpu);
+	for (size_t i = depth; i > 0; i--) {
+		shell_fprintf(shell, SHELL_NORMAL, ";0x%lx",
+			      (unsigned long)pcs[i - 1]);
+	}
+	shell_fprintf(shell, SHELL_NORMAL, " %u\n", count);
+}
+
+static int cmd_profiler_dump(const struct shell *shell, size_t argc,
+			     char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	profiler_foreach_stack(folded_print_cb, (void *)shell);
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_profiler,
+	SHELL_CMD_ARG(start, NULL, "Start sampling [frequency in Hz].",
+		      cmd_profiler_start, 1, 1),
+	SHELL_CMD(stop, NULL, "Stop sampling.", cmd_profiler_stop),
+	SHELL_CMD(reset, NULL, "Discard recorded samples.",
+		  cmd_profiler_reset),
+	SHELL_CMD(stats, NULL, "Show sampling statistics.",
+		  cmd_profiler_stats),
+	SHELL_CMD(dump, NULL, "Dump recorded samples as folded stacks.",
+		  cmd_profiler_dump),
+	SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+
+SHELL_CMD_REGISTER(profiler, &sub_profiler, "Sampling profiler commands",
+		   NULL);
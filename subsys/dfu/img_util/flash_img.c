@@ -36,6 +36,12 @@ BUILD_ASSERT((CONFIG_IMG_BLOCK_BUF_SIZE % FLASH_WRITE_BLOCK_SIZE == 0),
 	     "CONFIG_IMG_BLOCK_BUF_SIZE is not a multiple of "
 	     "FLASH_WRITE_BLOCK_SIZE");
 
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+BUILD_ASSERT((CONFIG_IMG_BLOCK_BUF_SIZE % (2 * FLASH_WRITE_BLOCK_SIZE) == 0),
+	     "CONFIG_IMG_BLOCK_BUF_SIZE is not a multiple of "
+	     "twice FLASH_WRITE_BLOCK_SIZE");
+#endif
+
 int flash_img_buffered_write(struct flash_img_context *ctx, const uint8_t *data,
 			     size_t len, bool flush)
 {
@@ -79,9 +85,16 @@ int flash_img_init_id(struct flash_img_context *ctx, uint8_t area_id)
 
 	flash_dev = flash_area_get_device(ctx->flash_area);
 
-	return stream_flash_init(&ctx->stream, flash_dev, ctx->buf,
+	rc = stream_flash_init(&ctx->stream, flash_dev, ctx->buf,
 			CONFIG_IMG_BLOCK_BUF_SIZE, ctx->flash_area->fa_off,
 			ctx->flash_area->fa_size, NULL);
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	if (rc == 0) {
+		rc = stream_flash_async_enable(&ctx->stream);
+	}
+#endif
+
+	return rc;
 }
 
 int flash_img_init(struct flash_img_context *ctx)
@@ -13,6 +13,8 @@
 #include <errno.h>
 #include <zephyr/device.h>
 
+#include "disk_cache.h"
+
 #define LOG_LEVEL CONFIG_DISK_LOG_LEVEL
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(disk);
@@ -60,6 +62,9 @@ int disk_access_init(const char *pdrv)
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->init != NULL)) {
+#if defined(CONFIG_DISK_CACHE)
+		(void)disk_cache_release(disk);
+#endif
 		rc = disk->ops->init(disk);
 	}
 
@@ -87,7 +92,11 @@ int disk_access_read(const char *pdrv, uint8_t *data_buf,
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->read != NULL)) {
+#if defined(CONFIG_DISK_CACHE)
+		rc = disk_cache_read(disk, data_buf, start_sector, num_sector);
+#else
 		rc = disk->ops->read(disk, data_buf, start_sector, num_sector);
+#endif
 	}
 
 	return rc;
@@ -101,7 +110,11 @@ int disk_access_write(const char *pdrv, const uint8_t *data_buf,
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->write != NULL)) {
+#if defined(CONFIG_DISK_CACHE)
+		rc = disk_cache_write(disk, data_buf, start_sector, num_sector);
+#else
 		rc = disk->ops->write(disk, data_buf, start_sector, num_sector);
+#endif
 	}
 
 	return rc;
@@ -114,12 +127,57 @@ int disk_access_ioctl(const char *pdrv, uint8_t cmd, void *buf)
 
 	if ((disk != NULL) && (disk->ops != NULL) &&
 				(disk->ops->ioctl != NULL)) {
+#if defined(CONFIG_DISK_CACHE)
+		if (cmd == DISK_IOCTL_CTRL_SYNC) {
+			rc = disk_cache_sync(disk);
+			if (rc != 0) {
+				return rc;
+			}
+		} else if ((cmd == DISK_IOCTL_CTRL_TRIM) && (buf != NULL)) {
+			const uint32_t *range = buf;
+
+			/* Trimmed sectors need no write back */
+			if (range[0] <= range[1]) {
+				disk_cache_discard(disk, range[0],
+						   range[1] - range[0] + 1U);
+			}
+		}
+#endif
 		rc = disk->ops->ioctl(disk, cmd, buf);
 	}
 
 	return rc;
 }
 
+#if defined(CONFIG_DISK_CACHE)
+int disk_access_cache_stats_get(const char *pdrv,
+				struct disk_cache_stats *stats)
+{
+	struct disk_info *disk = disk_access_get_di(pdrv);
+
+	if (disk == NULL) {
+		return -EINVAL;
+	}
+
+	disk_cache_stats_get(disk, stats);
+
+	return 0;
+}
+
+int disk_access_cache_stats_reset(const char *pdrv)
+{
+	struct disk_info *disk = disk_access_get_di(pdrv);
+
+	if (disk == NULL) {
+		return -EINVAL;
+	}
+
+	disk_cache_stats_reset(disk);
+
+	return 0;
+}
+#endif /* CONFIG_DISK_CACHE */
+
 int disk_access_register(struct disk_info *disk)
 {
 	int rc = 0;
@@ -161,6 +219,9 @@ int disk_access_unregister(struct disk_info *disk)
 		rc = -EINVAL;
 		goto unreg_err;
 	}
+#if defined(CONFIG_DISK_CACHE)
+	(void)disk_cache_release(disk);
+#endif
 	/* remove disk node from the list */
 	sys_dlist_remove(&disk->node);
 	LOG_DBG("disk interface(%s) unregistered", disk->name);
@@ -0,0 +1,410 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/drivers/disk.h>
+
+#include "disk_cache.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(disk, CONFIG_DISK_LOG_LEVEL);
+
+#define IO_SECTORS CONFIG_DISK_CACHE_IO_SECTORS
+
+struct disk_cache_entry {
+	/* NULL when the entry is unused */
+	struct disk_info *disk;
+	uint32_t sector;
+	uint32_t last_use;
+	bool dirty;
+	uint8_t __aligned(4) data[CONFIG_DISK_CACHE_SECTOR_SIZE];
+};
+
+/* Shared by all disks, the least recently used entry is reused first */
+static struct disk_cache_entry cache[CONFIG_DISK_CACHE_SECTORS];
+static uint32_t cache_tick;
+
+/* Adjacent sectors for a single driver call, read-ahead or write-back */
+static uint8_t __aligned(4) io_buf[IO_SECTORS * CONFIG_DISK_CACHE_SECTOR_SIZE];
+
+static K_MUTEX_DEFINE(cache_lock);
+
+static bool cache_usable(struct disk_info *disk)
+{
+	uint32_t size;
+
+	if (disk->cache_sector_size != 0U) {
+		return disk->cache_sector_size <= CONFIG_DISK_CACHE_SECTOR_SIZE;
+	}
+
+	/* Not memorized on failure, the disk may not be initialized yet */
+	if ((disk->ops->ioctl == NULL) ||
+	    (disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_SIZE, &size) != 0) ||
+	    (size == 0U)) {
+		return false;
+	}
+
+	/* Without the sector count, sectors are not read ahead */
+	if (disk->ops->ioctl(disk, DISK_IOCTL_GET_SECTOR_COUNT,
+			     &disk->cache_sector_count) != 0) {
+		disk->cache_sector_count = 0U;
+	}
+
+	disk->cache_sector_size = size;
+	disk->cache_next_sector = UINT32_MAX;
+
+	return size <= CONFIG_DISK_CACHE_SECTOR_SIZE;
+}
+
+static struct disk_cache_entry *cache_find(struct disk_info *disk,
+					   uint32_t sector)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if ((cache[i].disk == disk) && (cache[i].sector == sector)) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Write back the dirty sectors of a disk, adjacent sectors are written with
+ * a single driver call.
+ */
+static int cache_flush(struct disk_info *disk)
+{
+	struct disk_cache_entry *run[IO_SECTORS];
+	uint32_t size = disk->cache_sector_size;
+
+	for (;;) {
+		struct disk_cache_entry *first = NULL;
+		struct disk_cache_entry *e;
+		uint32_t count = 0U;
+		int rc;
+
+		for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+			e = &cache[i];
+			if ((e->disk == disk) && e->dirty &&
+			    ((first == NULL) || (e->sector < first->sector))) {
+				first = e;
+			}
+		}
+
+		if (first == NULL) {
+			return 0;
+		}
+
+		e = first;
+		do {
+			memcpy(&io_buf[count * size], e->data, size);
+			run[count++] = e;
+			e = (count < IO_SECTORS) ?
+			    cache_find(disk, first->sector + count) : NULL;
+		} while ((e != NULL) && e->dirty);
+
+		rc = disk->ops->write(disk, io_buf, first->sector, count);
+		if (rc != 0) {
+			LOG_ERR("write back of %u sectors at %u failed (err %d)",
+				count, first->sector, rc);
+			return rc;
+		}
+
+		for (uint32_t i = 0; i < count; i++) {
+			run[i]->dirty = false;
+		}
+
+		disk->cache_stats.write_backs++;
+		disk->cache_stats.written_back += count;
+	}
+}
+
+/* Get an entry for a sector not in the cache. The least recently used entry
+ * is reused, after being written back if needed. With clean_only, entries
+ * needing a write back are skipped instead, so that io_buf is not used.
+ */
+static struct disk_cache_entry *cache_alloc(struct disk_info *disk,
+					    uint32_t sector, bool clean_only)
+{
+	struct disk_cache_entry *e = NULL;
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].disk == NULL) {
+			e = &cache[i];
+			break;
+		}
+
+		if (clean_only && cache[i].dirty) {
+			continue;
+		}
+
+		if ((e == NULL) ||
+		    ((int32_t)(cache[i].last_use - e->last_use) < 0)) {
+			e = &cache[i];
+		}
+	}
+
+	if ((e == NULL) || (e->dirty && (cache_flush(e->disk) != 0))) {
+		return NULL;
+	}
+
+	e->disk = disk;
+	e->sector = sector;
+	e->last_use = ++cache_tick;
+
+	return e;
+}
+
+static void cache_fill(struct disk_info *disk, const uint8_t *buf,
+		       uint32_t start_sector, uint32_t num_sector)
+{
+	uint32_t size = disk->cache_sector_size;
+
+	for (uint32_t i = 0; i < num_sector; i++) {
+		struct disk_cache_entry *e;
+
+		e = cache_alloc(disk, start_sector + i, true);
+		if (e == NULL) {
+			/* The data read is valid, it is just not cached */
+			return;
+		}
+
+		memcpy(e->data, &buf[i * size], size);
+	}
+}
+
+static void cache_read_ahead(struct disk_info *disk, uint32_t sector)
+{
+	uint32_t count = 0U;
+
+	if (sector >= disk->cache_sector_count) {
+		return;
+	}
+
+	while ((count < IO_SECTORS) &&
+	       (count < disk->cache_sector_count - sector) &&
+	       (cache_find(disk, sector + count) == NULL)) {
+		count++;
+	}
+
+	/* Read ahead errors are reported when the sectors are read */
+	if ((count == 0U) ||
+	    (disk->ops->read(disk, io_buf, sector, count) != 0)) {
+		return;
+	}
+
+	disk->cache_stats.read_ahead += count;
+	cache_fill(disk, io_buf, sector, count);
+}
+
+int disk_cache_read(struct disk_info *disk, uint8_t *buf,
+		    uint32_t start_sector, uint32_t num_sector)
+{
+	bool sequential;
+	uint32_t size;
+	int rc = 0;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (!cache_usable(disk)) {
+		rc = disk->ops->read(disk, buf, start_sector, num_sector);
+		goto out;
+	}
+
+	size = disk->cache_sector_size;
+	sequential = (start_sector == disk->cache_next_sector);
+	disk->cache_next_sector = start_sector + num_sector;
+
+	if (num_sector > IO_SECTORS) {
+		/* Large requests go to the disk, with the cached sectors
+		 * possibly not written back yet copied over.
+		 */
+		rc = disk->ops->read(disk, buf, start_sector, num_sector);
+		if (rc != 0) {
+			goto out;
+		}
+
+		for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+			if ((cache[i].disk == disk) &&
+			    (cache[i].sector - start_sector < num_sector)) {
+				memcpy(&buf[(cache[i].sector - start_sector) *
+					    size], cache[i].data, size);
+			}
+		}
+
+		disk->cache_stats.misses += num_sector;
+		goto out;
+	}
+
+	for (uint32_t i = 0; i < num_sector;) {
+		struct disk_cache_entry *e = cache_find(disk, start_sector + i);
+		uint32_t count = 1U;
+
+		if (e != NULL) {
+			memcpy(&buf[i * size], e->data, size);
+			e->last_use = ++cache_tick;
+			disk->cache_stats.hits++;
+			i++;
+			continue;
+		}
+
+		/* Read the adjacent missing sectors with a single call */
+		while ((i + count < num_sector) &&
+		       (cache_find(disk, start_sector + i + count) == NULL)) {
+			count++;
+		}
+
+		rc = disk->ops->read(disk, &buf[i * size], start_sector + i,
+				     count);
+		if (rc != 0) {
+			goto out;
+		}
+
+		disk->cache_stats.misses += count;
+		cache_fill(disk, &buf[i * size], start_sector + i, count);
+		i += count;
+	}
+
+	if (IS_ENABLED(CONFIG_DISK_CACHE_READ_AHEAD) && sequential) {
+		cache_read_ahead(disk, start_sector + num_sector);
+	}
+
+out:
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+int disk_cache_write(struct disk_info *disk, const uint8_t *buf,
+		     uint32_t start_sector, uint32_t num_sector)
+{
+	uint32_t size;
+	int rc = 0;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (!cache_usable(disk)) {
+		rc = disk->ops->write(disk, buf, start_sector, num_sector);
+		goto out;
+	}
+
+	size = disk->cache_sector_size;
+
+	if (num_sector > IO_SECTORS) {
+		/* Large requests are written through, the cached sectors
+		 * are updated and no longer need a write back.
+		 */
+		rc = disk->ops->write(disk, buf, start_sector, num_sector);
+		if (rc != 0) {
+			goto out;
+		}
+
+		for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+			if ((cache[i].disk == disk) &&
+			    (cache[i].sector - start_sector < num_sector)) {
+				memcpy(cache[i].data,
+				       &buf[(cache[i].sector - start_sector) *
+					    size], size);
+				cache[i].dirty = false;
+			}
+		}
+
+		goto out;
+	}
+
+	for (uint32_t i = 0; i < num_sector; i++) {
+		struct disk_cache_entry *e = cache_find(disk, start_sector + i);
+
+		if (e == NULL) {
+			e = cache_alloc(disk, start_sector + i, false);
+			if (e == NULL) {
+				rc = -EIO;
+				goto out;
+			}
+		} else {
+			e->last_use = ++cache_tick;
+		}
+
+		memcpy(e->data, &buf[i * size], size);
+		e->dirty = true;
+	}
+
+out:
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+int disk_cache_sync(struct disk_info *disk)
+{
+	int rc = 0;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	if (disk->cache_sector_size != 0U) {
+		rc = cache_flush(disk);
+	}
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+void disk_cache_discard(struct disk_info *disk, uint32_t start_sector,
+			uint32_t num_sector)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if ((cache[i].disk == disk) &&
+		    (cache[i].sector - start_sector < num_sector)) {
+			cache[i].disk = NULL;
+			cache[i].dirty = false;
+		}
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
+
+int disk_cache_release(struct disk_info *disk)
+{
+	int rc = 0;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	if (disk->cache_sector_size != 0U) {
+		rc = cache_flush(disk);
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].disk == disk) {
+			cache[i].disk = NULL;
+			cache[i].dirty = false;
+		}
+	}
+
+	/* The media may have changed */
+	disk->cache_sector_size = 0U;
+
+	k_mutex_unlock(&cache_lock);
+
+	return rc;
+}
+
+void disk_cache_stats_get(struct disk_info *disk,
+			  struct disk_cache_stats *stats)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	*stats = disk->cache_stats;
+	k_mutex_unlock(&cache_lock);
+}
+
+void disk_cache_stats_reset(struct disk_info *disk)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	memset(&disk->cache_stats, 0, sizeof(disk->cache_stats));
+	k_mutex_unlock(&cache_lock);
+}
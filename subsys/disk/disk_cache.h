@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_
+#define ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_
+
+#include <zephyr/drivers/disk.h>
+
+int disk_cache_read(struct disk_info *disk, uint8_t *buf,
+		    uint32_t start_sector, uint32_t num_sector);
+int disk_cache_write(struct disk_info *disk, const uint8_t *buf,
+		     uint32_t start_sector, uint32_t num_sector);
+int disk_cache_sync(struct disk_info *disk);
+/* Drop the sectors of a range without writing them back */
+void disk_cache_discard(struct disk_info *disk, uint32_t start_sector,
+			uint32_t num_sector);
+/* Write back and drop all the sectors of a disk */
+int disk_cache_release(struct disk_info *disk);
+void disk_cache_stats_get(struct disk_info *disk,
+			  struct disk_cache_stats *stats);
+void disk_cache_stats_reset(struct disk_info *disk);
+
+#endif /* ZEPHYR_SUBSYS_DISK_DISK_CACHE_H_ */
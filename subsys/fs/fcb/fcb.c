@@ -172,6 +172,7 @@ fcb_init(int f_area_id, struct fcb *fcb)
 			break;
 		}
 	}
+	fcb_index_build(fcb);
 	k_mutex_init(&fcb->f_mtx);
 	return rc;
 }
@@ -272,6 +273,7 @@ fcb_sector_hdr_init(struct fcb *fcb, struct flash_sector *sector, uint16_t id)
 	if (rc != 0) {
 		return -EIO;
 	}
+	fcb_index_sector_reset(fcb, sector);
 	return 0;
 }
 
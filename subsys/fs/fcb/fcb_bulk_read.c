@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/sys/crc.h>
+
+#include <zephyr/fs/fcb.h>
+#include "fcb_priv.h"
+
+struct fcb_bulk_state {
+	struct fcb_entry_ctx entry_ctx;
+	/* Last element checked, valid or not */
+	struct fcb_entry last;
+	bool found;
+	bool sector_end;
+};
+
+static inline uint32_t
+fcb_elem_end(struct fcb *fcb, const struct fcb_entry *loc)
+{
+	return loc->fe_data_off + fcb_len_in_flash(fcb, loc->fe_data_len) +
+	       fcb_len_in_flash(fcb, FCB_CRC_SZ);
+}
+
+/*
+ * Offset from the start of the sector past the last element, as far as it
+ * is known.
+ */
+static uint32_t
+fcb_sector_end(const struct fcb *fcb, const struct flash_sector *sector)
+{
+	const struct fcb_sector_index *idx;
+
+	if (sector == fcb->f_active.fe_sector) {
+		return fcb->f_active.fe_elem_off;
+	}
+
+	idx = fcb_index_get(fcb, sector);
+	if (idx != NULL) {
+		return idx->fi_end;
+	}
+
+	return sector->fs_size;
+}
+
+/*
+ * Pass the valid elements read at offset start of the sector of st->last to
+ * cb, up to the first one which does not fit in buf.
+ */
+static int
+fcb_bulk_parse(struct fcb *fcb, struct fcb_bulk_state *st, uint32_t start,
+	       uint8_t *buf, size_t n, fcb_bulk_cb cb, void *cb_arg)
+{
+	struct fcb_entry loc = {
+		.fe_sector = st->last.fe_sector,
+	};
+	size_t off = 0;
+	int rc;
+
+	while (off + 2U <= n) {
+		size_t data_off;
+		size_t crc_off;
+		uint8_t crc8;
+		int cnt;
+
+		cnt = fcb_get_len(fcb, &buf[off], &loc.fe_data_len);
+		if (cnt < 0) {
+			/* Erased, no more elements in the sector */
+			st->sector_end = true;
+			return 0;
+		}
+		data_off = off + fcb_len_in_flash(fcb, cnt);
+		crc_off = data_off + fcb_len_in_flash(fcb, loc.fe_data_len);
+		loc.fe_elem_off = start + off;
+		loc.fe_data_off = start + data_off;
+
+		if (crc_off >= n) {
+			if (st->found) {
+				/* Left for the next call */
+				return 0;
+			}
+
+			/* Larger than buf, check it in flash */
+			rc = k_mutex_lock(&fcb->f_mtx, K_FOREVER);
+			if (rc) {
+				return -EINVAL;
+			}
+			rc = fcb_elem_info(fcb, &loc);
+			k_mutex_unlock(&fcb->f_mtx);
+			if ((rc != 0) && (rc != -EBADMSG)) {
+				st->sector_end = true;
+				return 0;
+			}
+			st->last = loc;
+			if (rc == 0) {
+				st->found = true;
+				st->entry_ctx.loc = loc;
+				return cb(&st->entry_ctx, NULL, cb_arg);
+			}
+			return 0;
+		}
+
+		crc8 = crc8_ccitt(CRC8_CCITT_INITIAL_VALUE, &buf[off], cnt);
+		crc8 = crc8_ccitt(crc8, &buf[data_off], loc.fe_data_len);
+		off = crc_off + fcb_len_in_flash(fcb, FCB_CRC_SZ);
+		st->last = loc;
+		if (crc8 != buf[crc_off]) {
+			continue;
+		}
+
+		st->found = true;
+		st->entry_ctx.loc = loc;
+		rc = cb(&st->entry_ctx, &buf[data_off], cb_arg);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+int
+fcb_bulk_read(struct fcb *fcb, struct fcb_entry *loc, uint8_t *buf,
+	      size_t len, fcb_bulk_cb cb, void *cb_arg)
+{
+	const uint32_t hdr_len = fcb_len_in_flash(fcb, sizeof(struct fcb_disk_area));
+	struct fcb_bulk_state st = {
+		.entry_ctx.fap = fcb->fap,
+		.last = *loc,
+	};
+	uint32_t start;
+	uint32_t end;
+	size_t n;
+	int rc;
+
+	if (len < 2U) {
+		return -EINVAL;
+	}
+
+	if (st.last.fe_sector == NULL) {
+		st.last.fe_sector = fcb->f_oldest;
+		start = hdr_len;
+	} else if (st.last.fe_elem_off == 0U) {
+		start = hdr_len;
+	} else {
+		start = fcb_elem_end(fcb, &st.last);
+	}
+
+	do {
+		rc = k_mutex_lock(&fcb->f_mtx, K_FOREVER);
+		if (rc) {
+			return -EINVAL;
+		}
+
+		end = fcb_sector_end(fcb, st.last.fe_sector);
+		if (st.sector_end || (start + 2U > end)) {
+			/* Moving to next sector */
+			if (st.last.fe_sector == fcb->f_active.fe_sector) {
+				k_mutex_unlock(&fcb->f_mtx);
+				return -ENOTSUP;
+			}
+			st.last.fe_sector = fcb_getnext_sector(fcb,
+							       st.last.fe_sector);
+			st.last.fe_elem_off = 0U;
+			st.sector_end = false;
+			start = hdr_len;
+			k_mutex_unlock(&fcb->f_mtx);
+			continue;
+		}
+
+		n = MIN(len, end - start);
+		rc = fcb_flash_read(fcb, st.last.fe_sector, start, buf, n);
+		k_mutex_unlock(&fcb->f_mtx);
+		if (rc) {
+			return rc;
+		}
+
+		rc = fcb_bulk_parse(fcb, &st, start, buf, n, cb, cb_arg);
+		if (st.last.fe_elem_off != 0U) {
+			*loc = st.last;
+			start = fcb_elem_end(fcb, &st.last);
+		}
+		if (rc) {
+			return rc;
+		}
+	} while (!st.found);
+
+	return 0;
+}
@@ -119,3 +119,76 @@ fcb_getnext(struct fcb *fcb, struct fcb_entry *loc)
 
 	return rc;
 }
+
+int
+fcb_getnth(struct fcb *fcb, uint32_t n, struct fcb_entry *loc)
+{
+	struct fcb_sector_index *idx;
+	int rc;
+
+	rc = k_mutex_lock(&fcb->f_mtx, K_FOREVER);
+	if (rc) {
+		return -EINVAL;
+	}
+
+	loc->fe_sector = fcb->f_oldest;
+	loc->fe_elem_off = 0U;
+
+	/* Skip the sectors before the one holding the entry */
+	idx = fcb_index_get(fcb, loc->fe_sector);
+	while ((idx != NULL) && (n >= idx->fi_count)) {
+		if (loc->fe_sector == fcb->f_active.fe_sector) {
+			rc = -ENOENT;
+			goto out;
+		}
+		n -= idx->fi_count;
+		loc->fe_sector = fcb_getnext_sector(fcb, loc->fe_sector);
+		idx = fcb_index_get(fcb, loc->fe_sector);
+	}
+
+	do {
+		rc = fcb_getnext_nolock(fcb, loc);
+		if (rc) {
+			rc = -ENOENT;
+			break;
+		}
+	} while (n-- > 0U);
+
+out:
+	k_mutex_unlock(&fcb->f_mtx);
+
+	return rc;
+}
+
+int
+fcb_getnext_key(struct fcb *fcb, struct fcb_entry *loc, uint32_t key_hash)
+{
+	struct flash_sector *sector;
+	int rc;
+
+	rc = k_mutex_lock(&fcb->f_mtx, K_FOREVER);
+	if (rc) {
+		return -EINVAL;
+	}
+
+	/* Entries of the sector of loc are not filtered */
+	sector = loc->fe_sector;
+	while ((rc = fcb_getnext_nolock(fcb, loc)) == 0) {
+		if ((loc->fe_sector == sector) ||
+		    fcb_index_key_match(fcb, loc->fe_sector, key_hash)) {
+			break;
+		}
+
+		/* No entry of this sector has the key, go to the next one */
+		if (loc->fe_sector == fcb->f_active.fe_sector) {
+			rc = -ENOTSUP;
+			break;
+		}
+		loc->fe_sector = fcb_getnext_sector(fcb, loc->fe_sector);
+		loc->fe_elem_off = 0U;
+	}
+
+	k_mutex_unlock(&fcb->f_mtx);
+
+	return rc;
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+
+#include <zephyr/fs/fcb.h>
+#include "fcb_priv.h"
+
+#ifdef CONFIG_FCB_INDEX_KEYS
+#define FCB_KEY_BITS	(CONFIG_FCB_INDEX_KEY_BITS / 32 * 32)
+
+/* Two bits of the filter are set for each key, one from each half of its
+ * hash.
+ */
+static inline uint32_t fcb_key_bit(uint32_t key_hash, int n)
+{
+	return ((n == 0) ? (key_hash & 0xffff) : (key_hash >> 16)) %
+	       FCB_KEY_BITS;
+}
+#endif
+
+void
+fcb_index_sector_reset(struct fcb *fcb, const struct flash_sector *sector)
+{
+	struct fcb_sector_index *idx = fcb_index_get(fcb, sector);
+
+	if (idx == NULL) {
+		return;
+	}
+
+	(void)memset(idx, 0, sizeof(*idx));
+	idx->fi_end = fcb_len_in_flash(fcb, sizeof(struct fcb_disk_area));
+}
+
+void
+fcb_index_add(struct fcb *fcb, const struct fcb_entry *loc)
+{
+	struct fcb_sector_index *idx = fcb_index_get(fcb, loc->fe_sector);
+	uint32_t end;
+
+	if (idx == NULL) {
+		return;
+	}
+
+	end = loc->fe_data_off + fcb_len_in_flash(fcb, loc->fe_data_len) +
+	      fcb_len_in_flash(fcb, FCB_CRC_SZ);
+	idx->fi_end = MAX(idx->fi_end, end);
+	idx->fi_count++;
+
+#ifdef CONFIG_FCB_INDEX_KEYS
+	if (fcb->f_key_hash != NULL) {
+		struct fcb_entry_ctx loc_ctx = {
+			.loc = *loc,
+			.fap = fcb->fap,
+		};
+		uint32_t key_hash = fcb->f_key_hash(&loc_ctx);
+
+		if (key_hash == FCB_KEY_HASH_ANY) {
+			(void)memset(idx->fi_keys, 0xff, sizeof(idx->fi_keys));
+			return;
+		}
+
+		for (int n = 0; n < 2; n++) {
+			uint32_t bit = fcb_key_bit(key_hash, n);
+
+			idx->fi_keys[bit / 32] |= BIT(bit % 32);
+		}
+	}
+#endif
+}
+
+bool
+fcb_index_key_match(const struct fcb *fcb, const struct flash_sector *sector,
+		    uint32_t key_hash)
+{
+#ifdef CONFIG_FCB_INDEX_KEYS
+	const struct fcb_sector_index *idx = fcb_index_get(fcb, sector);
+
+	if ((idx == NULL) || (fcb->f_key_hash == NULL)) {
+		return true;
+	}
+
+	for (int n = 0; n < 2; n++) {
+		uint32_t bit = fcb_key_bit(key_hash, n);
+
+		if ((idx->fi_keys[bit / 32] & BIT(bit % 32)) == 0U) {
+			return false;
+		}
+	}
+#endif
+	return true;
+}
+
+/*
+ * Fill in the index from the content of flash, called by fcb_init() once
+ * the oldest and active sectors are known.
+ */
+void
+fcb_index_build(struct fcb *fcb)
+{
+	struct fcb_entry loc;
+	int i;
+
+	if (fcb->f_index == NULL) {
+		return;
+	}
+
+	for (i = 0; i < fcb->f_sector_cnt; i++) {
+		fcb_index_sector_reset(fcb, &fcb->f_sectors[i]);
+	}
+
+	loc.fe_sector = NULL;
+	loc.fe_elem_off = 0U;
+	while (fcb_getnext_nolock(fcb, &loc) == 0) {
+		fcb_index_add(fcb, &loc);
+	}
+}
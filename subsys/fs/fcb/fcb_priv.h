@@ -76,6 +76,49 @@ int fcb_sector_hdr_init(struct fcb *fcb, struct flash_sector *sector, uint16_t i
 int fcb_sector_hdr_read(struct fcb *fcb, struct flash_sector *sector,
 			struct fcb_disk_area *fdap);
 
+#ifdef CONFIG_FCB_INDEX
+static inline struct fcb_sector_index *
+fcb_index_get(const struct fcb *fcb, const struct flash_sector *sector)
+{
+	if (fcb->f_index == NULL) {
+		return NULL;
+	}
+	return &fcb->f_index[sector - fcb->f_sectors];
+}
+
+void fcb_index_build(struct fcb *fcb);
+void fcb_index_sector_reset(struct fcb *fcb, const struct flash_sector *sector);
+void fcb_index_add(struct fcb *fcb, const struct fcb_entry *loc);
+bool fcb_index_key_match(const struct fcb *fcb,
+			 const struct flash_sector *sector, uint32_t key_hash);
+#else
+static inline struct fcb_sector_index *
+fcb_index_get(const struct fcb *fcb, const struct flash_sector *sector)
+{
+	return NULL;
+}
+
+static inline void fcb_index_build(struct fcb *fcb)
+{
+}
+
+static inline void fcb_index_sector_reset(struct fcb *fcb,
+					  const struct flash_sector *sector)
+{
+}
+
+static inline void fcb_index_add(struct fcb *fcb, const struct fcb_entry *loc)
+{
+}
+
+static inline bool fcb_index_key_match(const struct fcb *fcb,
+				       const struct flash_sector *sector,
+				       uint32_t key_hash)
+{
+	return true;
+}
+#endif /* CONFIG_FCB_INDEX */
+
 #ifdef __cplusplus
 }
 #endif
@@ -24,6 +24,7 @@ fcb_rotate(struct fcb *fcb)
 		rc = -EIO;
 		goto out;
 	}
+	fcb_index_sector_reset(fcb, fcb->f_oldest);
 	if (fcb->f_oldest == fcb->f_active.fe_sector) {
 		/*
 		 * Need to create a new active area, as we're wiping
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/slist.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/fs_async.h>
+
+#define NUM_WORKERS CONFIG_FILE_SYSTEM_ASYNC_THREADS
+
+static K_THREAD_STACK_ARRAY_DEFINE(worker_stacks, NUM_WORKERS,
+				   CONFIG_FILE_SYSTEM_ASYNC_STACK_SIZE);
+static struct k_thread workers[NUM_WORKERS];
+
+/* Requests not taken by a worker yet, in submission order */
+static sys_slist_t queue;
+/* Mount point serviced by each worker. File systems such as FatFs are not
+ * reentrant, so only one worker services a mount point at once.
+ */
+static const struct fs_mount_t *worker_mp[NUM_WORKERS];
+static K_MUTEX_DEFINE(lock);
+static K_CONDVAR_DEFINE(cond);
+
+static bool mount_busy(const struct fs_mount_t *mp)
+{
+	for (int i = 0; i < NUM_WORKERS; i++) {
+		if (worker_mp[i] == mp) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Move all the queued requests of the first file whose mount point is not
+ * serviced by another worker to batch, in submission order.
+ */
+static struct fs_file_t *batch_take(sys_slist_t *batch)
+{
+	struct fs_file_t *zfp = NULL;
+	struct fs_async_req *req;
+	sys_snode_t *node, *next, *prev = NULL;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&queue, req, node) {
+		if (!mount_busy(req->zfp->mp)) {
+			zfp = req->zfp;
+			break;
+		}
+	}
+
+	if (zfp == NULL) {
+		return NULL;
+	}
+
+	SYS_SLIST_FOR_EACH_NODE_SAFE(&queue, node, next) {
+		req = CONTAINER_OF(node, struct fs_async_req, node);
+		if (req->zfp != zfp) {
+			prev = node;
+			continue;
+		}
+
+		sys_slist_remove(&queue, prev, node);
+		sys_slist_append(batch, node);
+	}
+
+	return zfp;
+}
+
+static void req_complete(struct fs_async_req *req)
+{
+	if (req->signal != NULL) {
+		k_poll_signal_raise(req->signal, (int)req->result);
+	}
+
+	if (req->cb != NULL) {
+		req->cb(req);
+	}
+}
+
+static bool batch_has_sync(sys_slist_t *batch)
+{
+	struct fs_async_req *req;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(batch, req, node) {
+		if (req->op == FS_ASYNC_SYNC) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void batch_run(sys_slist_t *batch)
+{
+	/* Syncs completed by the last sync of the batch */
+	sys_slist_t syncs;
+	sys_snode_t *node;
+
+	sys_slist_init(&syncs);
+
+	while ((node = sys_slist_get(batch)) != NULL) {
+		struct fs_async_req *req;
+
+		req = CONTAINER_OF(node, struct fs_async_req, node);
+
+		switch (req->op) {
+		case FS_ASYNC_READ:
+			req->result = fs_read(req->zfp, req->buf, req->size);
+			break;
+		case FS_ASYNC_WRITE:
+			req->result = fs_write(req->zfp, req->buf, req->size);
+			break;
+		case FS_ASYNC_SYNC:
+			if (batch_has_sync(batch)) {
+				sys_slist_append(&syncs, node);
+				continue;
+			}
+
+			req->result = fs_sync(req->zfp);
+			while ((node = sys_slist_get(&syncs)) != NULL) {
+				struct fs_async_req *prev_sync;
+
+				prev_sync = CONTAINER_OF(node, struct fs_async_req,
+							 node);
+				prev_sync->result = req->result;
+				req_complete(prev_sync);
+			}
+			break;
+		default:
+			req->result = -EINVAL;
+			break;
+		}
+
+		req_complete(req);
+	}
+}
+
+static void worker_thread(void *p1, void *p2, void *p3)
+{
+	int id = (int)(uintptr_t)p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	k_mutex_lock(&lock, K_FOREVER);
+
+	for (;;) {
+		struct fs_file_t *zfp;
+		sys_slist_t batch;
+
+		sys_slist_init(&batch);
+		zfp = batch_take(&batch);
+		if (zfp == NULL) {
+			(void)k_condvar_wait(&cond, &lock, K_FOREVER);
+			continue;
+		}
+
+		worker_mp[id] = zfp->mp;
+		k_mutex_unlock(&lock);
+		batch_run(&batch);
+		k_mutex_lock(&lock, K_FOREVER);
+
+		/* Requests of this mount point queued meanwhile can be taken
+		 * by any worker now.
+		 */
+		worker_mp[id] = NULL;
+		(void)k_condvar_broadcast(&cond);
+	}
+}
+
+static int req_submit(struct fs_async_req *req, struct fs_file_t *zfp,
+		      enum fs_async_op op, void *buf, size_t size)
+{
+	if (zfp->mp == NULL) {
+		return -EBADF;
+	}
+
+	req->zfp = zfp;
+	req->op = op;
+	req->buf = buf;
+	req->size = size;
+	req->result = 0;
+
+	k_mutex_lock(&lock, K_FOREVER);
+	sys_slist_append(&queue, &req->node);
+	(void)k_condvar_signal(&cond);
+	k_mutex_unlock(&lock);
+
+	return 0;
+}
+
+int fs_async_read(struct fs_async_req *req, struct fs_file_t *zfp,
+		  void *ptr, size_t size)
+{
+	return req_submit(req, zfp, FS_ASYNC_READ, ptr, size);
+}
+
+int fs_async_write(struct fs_async_req *req, struct fs_file_t *zfp,
+		   const void *ptr, size_t size)
+{
+	return req_submit(req, zfp, FS_ASYNC_WRITE, (void *)ptr, size);
+}
+
+int fs_async_sync(struct fs_async_req *req, struct fs_file_t *zfp)
+{
+	return req_submit(req, zfp, FS_ASYNC_SYNC, NULL, 0);
+}
+
+static int fs_async_init(const struct device *dev)
+{
+	ARG_UNUSED(dev);
+
+	sys_slist_init(&queue);
+
+	for (int i = 0; i < NUM_WORKERS; i++) {
+		k_tid_t tid;
+
+		tid = k_thread_create(&workers[i], worker_stacks[i],
+				      K_THREAD_STACK_SIZEOF(worker_stacks[i]),
+				      worker_thread, (void *)(uintptr_t)i,
+				      NULL, NULL,
+				      CONFIG_FILE_SYSTEM_ASYNC_PRIORITY, 0,
+				      K_NO_WAIT);
+		(void)k_thread_name_set(tid, "fs_async");
+	}
+
+	return 0;
+}
+
+SYS_INIT(fs_async_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
@@ -21,6 +21,7 @@
 #include <zephyr/drivers/flash.h>
 #include <zephyr/storage/flash_map.h>
 #include <zephyr/storage/disk_access.h>
+#include <zephyr/sys/crc.h>
 
 #include "fs_impl.h"
 
@@ -78,16 +79,6 @@ static inline void fc_release(void *buf)
 	k_heap_free(&file_cache_heap, buf);
 }
 
-static inline void fs_lock(struct fs_littlefs *fs)
-{
-	k_mutex_lock(&fs->mutex, K_FOREVER);
-}
-
-static inline void fs_unlock(struct fs_littlefs *fs)
-{
-	k_mutex_unlock(&fs->mutex);
-}
-
 static int lfs_to_errno(int error)
 {
 	if (error >= 0) {
@@ -158,6 +149,347 @@ static int errno_to_lfs(int error)
 	}
 }
 
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT
+/* The allocation map has one bit per block, set for each block that may be
+ * in use. It is built by traversing the file system, or loaded from flash
+ * at mount, and each erased block is added to it, so it stays a superset of
+ * the blocks in use. When littlefs has exhausted its lookahead window, the
+ * next window is filled from the map instead of by a traversal.
+ *
+ * The traversal is done by a work item once the file system is idle, never
+ * from a file system call, which lets littlefs scan for free blocks itself
+ * until the map is built.
+ */
+#define ALLOC_MAP_RETRY K_MSEC(10)
+
+static inline size_t alloc_map_len(lfs_block_t block_count)
+{
+	return DIV_ROUND_UP(block_count, 32) * sizeof(uint32_t);
+}
+
+static inline bool alloc_map_test(const struct fs_littlefs *fs,
+				  lfs_block_t block)
+{
+	return (fs->alloc_map[block / 32] & BIT(block % 32)) != 0;
+}
+
+static int alloc_map_mark(void *data, lfs_block_t block)
+{
+	struct fs_littlefs *fs = data;
+
+	if (block < fs->cfg.block_count) {
+		fs->alloc_map[block / 32] |= BIT(block % 32);
+	}
+
+	return 0;
+}
+
+static int alloc_map_rebuild(struct fs_littlefs *fs)
+{
+	int ret;
+
+	memset(fs->alloc_map, 0, sizeof(fs->alloc_map));
+	ret = lfs_fs_traverse(&fs->lfs, alloc_map_mark, fs);
+	fs->alloc_map_valid = (ret == 0);
+	fs->alloc_stats.map_rebuilds++;
+
+	return lfs_to_errno(ret);
+}
+
+static void alloc_map_work(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct fs_littlefs *fs = CONTAINER_OF(dwork, struct fs_littlefs,
+					      alloc_work);
+
+	/* Try again later rather than delay a file system call */
+	if (k_mutex_lock(&fs->mutex, K_NO_WAIT) != 0) {
+		(void)k_work_schedule(dwork, ALLOC_MAP_RETRY);
+		return;
+	}
+
+	if ((fs->backend != NULL) && fs->alloc_map_enabled &&
+	    !fs->alloc_map_valid) {
+		(void)alloc_map_rebuild(fs);
+	}
+
+	k_mutex_unlock(&fs->mutex);
+}
+
+/* Find the first block not in the map, starting from block start. */
+static bool alloc_map_find_free(const struct fs_littlefs *fs,
+				lfs_block_t start, lfs_block_t *block)
+{
+	lfs_block_t count = fs->cfg.block_count;
+
+	for (lfs_block_t n = 0; n < count; n++) {
+		lfs_block_t b = (start + n) % count;
+
+		if (!alloc_map_test(fs, b)) {
+			*block = b;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Fill the lookahead window of littlefs from the map if it is exhausted.
+ * Must be called with the file system locked, between littlefs calls.
+ */
+static void alloc_hint_fill(struct fs_littlefs *fs)
+{
+	struct lfs *lfs = &fs->lfs;
+	lfs_block_t count = fs->cfg.block_count;
+	lfs_block_t start, size;
+
+	if (!fs->alloc_map_enabled || (fs->backend == NULL) ||
+	    (lfs->free.i < lfs->free.size) || (lfs->free.ack == 0)) {
+		return;
+	}
+
+	start = (lfs->free.off + lfs->free.size) % count;
+	if (!fs->alloc_map_valid || !alloc_map_find_free(fs, start, &start)) {
+		/* Blocks are never removed from the map, a full one has to
+		 * drop the blocks freed since it was built.
+		 */
+		fs->alloc_map_valid = false;
+		(void)k_work_schedule(&fs->alloc_work, K_NO_WAIT);
+		return;
+	}
+
+	size = MIN(8U * fs->cfg.lookahead_size, lfs->free.ack);
+	memset(lfs->free.buffer, 0, fs->cfg.lookahead_size);
+	for (lfs_block_t n = 0; n < size; n++) {
+		if (alloc_map_test(fs, (start + n) % count)) {
+			lfs->free.buffer[n / 32] |= BIT(n % 32);
+		}
+	}
+
+	lfs->free.off = start;
+	lfs->free.size = size;
+	lfs->free.i = 0;
+
+	fs->alloc_off = start;
+	fs->alloc_size = size;
+	fs->alloc_stats.hint_fills++;
+}
+
+/* Count the lookahead windows filled by littlefs itself. */
+static void alloc_hint_account(struct fs_littlefs *fs)
+{
+	struct lfs *lfs = &fs->lfs;
+
+	if (fs->backend == NULL) {
+		return;
+	}
+
+	if ((lfs->free.size != 0) && ((lfs->free.off != fs->alloc_off) ||
+				      (lfs->free.size != fs->alloc_size))) {
+		fs->alloc_stats.lookahead_scans++;
+	}
+
+	fs->alloc_off = lfs->free.off;
+	fs->alloc_size = lfs->free.size;
+}
+
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST
+/* The map is stored in a flash area of its own: a header, followed at
+ * ALLOC_HINT_MAP_OFF by the map itself. The header is written last, and
+ * the stored map is erased before the first block erase that follows its
+ * store or load, so that it is never older than the file system.
+ */
+#define ALLOC_HINT_MAGIC 0x4c464148
+#define ALLOC_HINT_MAP_OFF 32
+
+struct alloc_hint_hdr {
+	uint32_t magic;
+	uint32_t block_count;
+	uint32_t block_size;
+	uint32_t crc;
+};
+
+BUILD_ASSERT(sizeof(struct alloc_hint_hdr) <= ALLOC_HINT_MAP_OFF);
+
+static int alloc_hint_erase(struct fs_littlefs *fs)
+{
+	const struct flash_area *fa = fs->alloc_hint_fa;
+
+	return flash_area_erase(fa, 0, fa->fa_size);
+}
+
+/* Open the flash area of the map of a file system of block_count blocks,
+ * leaving alloc_hint_fa NULL if it cannot hold the map.
+ */
+static void alloc_hint_open(struct fs_littlefs *fs, lfs_block_t block_count)
+{
+	const struct flash_area *fa;
+	size_t align;
+	int rc;
+
+	if (fs->alloc_hint_area_id ==
+	    ((const struct flash_area *)fs->backend)->fa_id) {
+		LOG_WRN("allocation map area is the file system partition");
+		return;
+	}
+
+	rc = flash_area_open(fs->alloc_hint_area_id, &fa);
+	if (rc < 0) {
+		LOG_WRN("can't open allocation map area %u (%d)",
+			fs->alloc_hint_area_id, rc);
+		return;
+	}
+
+	align = flash_area_align(fa);
+	if ((align > ALLOC_HINT_MAP_OFF) ||
+	    (ALLOC_HINT_MAP_OFF + ROUND_UP(alloc_map_len(block_count), align) >
+	     fa->fa_size)) {
+		LOG_WRN("allocation map area %u can't hold the map",
+			fs->alloc_hint_area_id);
+		flash_area_close(fa);
+		return;
+	}
+
+	fs->alloc_hint_fa = fa;
+}
+
+static void alloc_hint_close(struct fs_littlefs *fs)
+{
+	if (fs->alloc_hint_fa != NULL) {
+		flash_area_close(fs->alloc_hint_fa);
+		fs->alloc_hint_fa = NULL;
+	}
+}
+
+static int alloc_hint_load(struct fs_littlefs *fs)
+{
+	const struct flash_area *fa = fs->alloc_hint_fa;
+	size_t len = alloc_map_len(fs->cfg.block_count);
+	struct alloc_hint_hdr hdr;
+	int rc;
+
+	rc = flash_area_read(fa, 0, &hdr, sizeof(hdr));
+	if (rc < 0) {
+		return rc;
+	}
+
+	if ((hdr.magic != ALLOC_HINT_MAGIC) ||
+	    (hdr.block_count != fs->cfg.block_count) ||
+	    (hdr.block_size != fs->cfg.block_size)) {
+		return -ENOENT;
+	}
+
+	rc = flash_area_read(fa, ALLOC_HINT_MAP_OFF, fs->alloc_map, len);
+	if (rc < 0) {
+		return rc;
+	}
+
+	if (crc32_ieee((const uint8_t *)fs->alloc_map, len) != hdr.crc) {
+		LOG_WRN("allocation map corrupted");
+		return -EFAULT;
+	}
+
+	fs->alloc_map_valid = true;
+	fs->alloc_hint_stored = true;
+	fs->alloc_stats.hint_loaded = true;
+
+	return 0;
+}
+
+static int alloc_hint_store(struct fs_littlefs *fs)
+{
+	const struct flash_area *fa = fs->alloc_hint_fa;
+	size_t align = flash_area_align(fa);
+	size_t len = alloc_map_len(fs->cfg.block_count);
+	size_t head = ROUND_DOWN(len, align);
+	uint8_t buf[ALLOC_HINT_MAP_OFF];
+	struct alloc_hint_hdr hdr = {
+		.magic = ALLOC_HINT_MAGIC,
+		.block_count = fs->cfg.block_count,
+		.block_size = fs->cfg.block_size,
+	};
+	int rc;
+
+	if (fs->alloc_hint_stored) {
+		return 0;
+	}
+
+	/* Stored on request or on unmount, it can wait for a traversal */
+	if (!fs->alloc_map_valid) {
+		rc = alloc_map_rebuild(fs);
+		if (rc < 0) {
+			return rc;
+		}
+	}
+
+	rc = alloc_hint_erase(fs);
+	if (rc < 0) {
+		return rc;
+	}
+
+	/* The map first, the header makes it valid */
+	rc = flash_area_write(fa, ALLOC_HINT_MAP_OFF, fs->alloc_map, head);
+	if ((rc == 0) && (head < len)) {
+		memset(buf, 0xff, sizeof(buf));
+		memcpy(buf, (const uint8_t *)fs->alloc_map + head, len - head);
+		rc = flash_area_write(fa, ALLOC_HINT_MAP_OFF + head, buf, align);
+	}
+	if (rc < 0) {
+		return rc;
+	}
+
+	hdr.crc = crc32_ieee((const uint8_t *)fs->alloc_map, len);
+	memset(buf, 0xff, sizeof(buf));
+	memcpy(buf, &hdr, sizeof(hdr));
+	rc = flash_area_write(fa, 0, buf, ROUND_UP(sizeof(hdr), align));
+	if (rc < 0) {
+		return rc;
+	}
+
+	fs->alloc_hint_stored = true;
+
+	return 0;
+}
+#endif /* CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST */
+
+/* Called before erasing block */
+static int alloc_hint_erased(struct fs_littlefs *fs, lfs_block_t block)
+{
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST
+	if (fs->alloc_hint_stored) {
+		int rc = alloc_hint_erase(fs);
+
+		if (rc < 0) {
+			return rc;
+		}
+		fs->alloc_hint_stored = false;
+	}
+#endif
+
+	if (fs->alloc_map_valid) {
+		(void)alloc_map_mark(fs, block);
+	}
+
+	return 0;
+}
+#endif /* CONFIG_FS_LITTLEFS_ALLOC_HINT */
+
+static inline void fs_lock(struct fs_littlefs *fs)
+{
+	k_mutex_lock(&fs->mutex, K_FOREVER);
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT
+	alloc_hint_fill(fs);
+#endif
+}
+
+static inline void fs_unlock(struct fs_littlefs *fs)
+{
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT
+	alloc_hint_account(fs);
+#endif
+	k_mutex_unlock(&fs->mutex);
+}
+
 
 static int lfs_api_read(const struct lfs_config *c, lfs_block_t block,
 			lfs_off_t off, void *buffer, lfs_size_t size)
@@ -185,8 +517,14 @@ static int lfs_api_erase(const struct lfs_config *c, lfs_block_t block)
 {
 	const struct flash_area *fa = c->context;
 	size_t offset = block * c->block_size;
+	int rc = 0;
 
-	int rc = flash_area_erase(fa, offset, c->block_size);
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT
+	rc = alloc_hint_erased(CONTAINER_OF(c, struct fs_littlefs, cfg), block);
+#endif
+	if (rc == 0) {
+		rc = flash_area_erase(fa, offset, c->block_size);
+	}
 
 	return errno_to_lfs(rc);
 }
@@ -662,6 +1000,17 @@ static int littlefs_mount(struct fs_mount_t *mountp)
 		return -EBUSY;
 	}
 
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT
+	memset(&fs->alloc_stats, 0, sizeof(fs->alloc_stats));
+	fs->alloc_map_enabled = false;
+	fs->alloc_map_valid = false;
+	k_work_init_delayable(&fs->alloc_work, alloc_map_work);
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST
+	fs->alloc_hint_fa = NULL;
+	fs->alloc_hint_stored = false;
+#endif
+#endif
+
 	/* Create and take mutex. */
 	k_mutex_init(&fs->mutex);
 	fs_lock(fs);
@@ -767,6 +1116,19 @@ static int littlefs_mount(struct fs_mount_t *mountp)
 	} else {
 		block_count = ((struct flash_area *)fs->backend)->fa_size
 			/ block_size;
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT
+		fs->alloc_map_enabled =
+			(block_count <= CONFIG_FS_LITTLEFS_ALLOC_HINT_MAX_BLOCKS);
+		if (!fs->alloc_map_enabled) {
+			LOG_WRN("too many blocks for the allocation map");
+		}
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST
+		if (fs->alloc_map_enabled && fs->alloc_hint_area_set &&
+		    ((mountp->flags & FS_MOUNT_FLAG_READ_ONLY) == 0)) {
+			alloc_hint_open(fs, block_count);
+		}
+#endif
+#endif
 		const struct device *dev =
 			flash_area_get_device((struct flash_area *)fs->backend);
 		LOG_INF("FS at %s:0x%x is %u 0x%x-byte blocks with %u cycle",
@@ -822,12 +1184,25 @@ static int littlefs_mount(struct fs_mount_t *mountp)
 	lcp->block_count = block_count;
 	lcp->block_cycles = block_cycles;
 
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST
+	if ((fs->alloc_hint_fa != NULL) && (alloc_hint_load(fs) == 0)) {
+		LOG_INF("allocation map loaded");
+	}
+#endif
+
 	/* Mount it, formatting if needed. */
 	ret = lfs_mount(&fs->lfs, &fs->cfg);
 	if (ret < 0 &&
 	    (mountp->flags & FS_MOUNT_FLAG_NO_FORMAT) == 0) {
 		LOG_WRN("can't mount (LFS %d); formatting", ret);
 		if ((mountp->flags & FS_MOUNT_FLAG_READ_ONLY) == 0) {
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT
+			/* Drop the map of a previous file system, the stored
+			 * one is erased with the first block.
+			 */
+			fs->alloc_map_valid = false;
+			fs->alloc_stats.hint_loaded = false;
+#endif
 			ret = lfs_format(&fs->lfs, &fs->cfg);
 			if (ret < 0) {
 				LOG_ERR("format failed (LFS %d)", ret);
@@ -848,10 +1223,18 @@ static int littlefs_mount(struct fs_mount_t *mountp)
 		}
 	}
 
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT
+	fs->alloc_off = fs->lfs.free.off;
+	fs->alloc_size = fs->lfs.free.size;
+#endif
+
 	LOG_INF("%s mounted", mountp->mnt_point);
 
 out:
 	if (ret < 0) {
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST
+		alloc_hint_close(fs);
+#endif
 		fs->backend = NULL;
 	}
 
@@ -866,6 +1249,23 @@ static int littlefs_unmount(struct fs_mount_t *mountp)
 
 	fs_lock(fs);
 
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT
+	/* The work item never waits for the mutex, it cannot block here */
+	(void)k_work_cancel_delayable_sync(&fs->alloc_work,
+					   &fs->alloc_work_sync);
+#endif
+
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST
+	if (fs->alloc_hint_fa != NULL) {
+		int rc = alloc_hint_store(fs);
+
+		if (rc < 0) {
+			LOG_WRN("can't store allocation map (%d)", rc);
+		}
+		alloc_hint_close(fs);
+	}
+#endif
+
 	lfs_unmount(&fs->lfs);
 
 	if (!littlefs_on_blkdev(mountp)) {
@@ -880,6 +1280,47 @@ static int littlefs_unmount(struct fs_mount_t *mountp)
 	return 0;
 }
 
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST
+int fs_littlefs_alloc_hint_save(struct fs_littlefs *fs)
+{
+	int rc;
+
+	fs_lock(fs);
+
+	if (fs->backend == NULL) {
+		rc = -EINVAL;
+	} else if (fs->alloc_hint_fa == NULL) {
+		rc = -ENOTSUP;
+	} else {
+		rc = alloc_hint_store(fs);
+	}
+
+	fs_unlock(fs);
+
+	return rc;
+}
+#endif /* CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST */
+
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT
+int fs_littlefs_alloc_stats_get(struct fs_littlefs *fs,
+				struct fs_littlefs_alloc_stats *stats)
+{
+	int rc = 0;
+
+	fs_lock(fs);
+
+	if (fs->backend == NULL) {
+		rc = -EINVAL;
+	} else {
+		*stats = fs->alloc_stats;
+	}
+
+	fs_unlock(fs);
+
+	return rc;
+}
+#endif /* CONFIG_FS_LITTLEFS_ALLOC_HINT */
+
 /* File system interface */
 static const struct fs_file_system_t littlefs_fs = {
 	.open = littlefs_open,
@@ -906,6 +1347,17 @@ static const struct fs_file_system_t littlefs_fs = {
 #define FS_PARTITION(inst) DT_PHANDLE_BY_IDX(DT_DRV_INST(inst), partition, 0)
 #define FS_PARTITION_LABEL(inst) DT_STRING_TOKEN(FS_PARTITION(inst), label)
 
+#if defined(CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST)
+#define FS_ALLOC_HINT_AREA(inst) \
+	COND_CODE_1(DT_INST_NODE_HAS_PROP(inst, alloc_hint_partition), \
+		    (.alloc_hint_area_id = DT_FIXED_PARTITION_ID( \
+			DT_INST_PHANDLE(inst, alloc_hint_partition)), \
+		     .alloc_hint_area_set = true,), \
+		    ())
+#else
+#define FS_ALLOC_HINT_AREA(inst)
+#endif
+
 #define DEFINE_FS(inst) \
 static uint8_t __aligned(4) \
 	read_buffer_##inst[DT_INST_PROP(inst, cache_size)]; \
@@ -932,6 +1384,7 @@ static struct fs_littlefs fs_data_##inst = { \
 		.prog_buffer = prog_buffer_##inst, \
 		.lookahead_buffer = lookahead_buffer_##inst, \
 	}, \
+	FS_ALLOC_HINT_AREA(inst) \
 }; \
 struct fs_mount_t FS_FSTAB_ENTRY(DT_DRV_INST(inst)) = { \
 	.type = FS_LITTLEFS, \
@@ -18,6 +18,12 @@ LOG_MODULE_REGISTER(fs_nvs, CONFIG_NVS_LOG_LEVEL);
 
 static int nvs_prev_ate(struct nvs_fs *fs, uint32_t *addr, struct nvs_ate *ate);
 static int nvs_ate_valid(struct nvs_fs *fs, const struct nvs_ate *entry);
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+static int nvs_sector_summary_ate_valid(struct nvs_fs *fs,
+					const struct nvs_ate *entry);
+static int nvs_sector_summary_load(struct nvs_fs *fs, uint32_t addr,
+				   const struct nvs_ate *entry);
+#endif
 
 #ifdef CONFIG_NVS_LOOKUP_CACHE
 
@@ -46,6 +52,9 @@ static int nvs_lookup_cache_rebuild(struct nvs_fs *fs)
 	uint32_t addr, ate_addr;
 	uint32_t *cache_entry;
 	struct nvs_ate ate;
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+	bool use_summary = true;
+#endif
 
 	memset(fs->lookup_cache, 0xff, sizeof(fs->lookup_cache));
 	addr = fs->ate_wra;
@@ -59,6 +68,27 @@ static int nvs_lookup_cache_rebuild(struct nvs_fs *fs)
 			return rc;
 		}
 
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+		/* Only a summary of the write sector is used: the sectors gc-ed
+		 * since an older summary was stored are not reflected by it.
+		 */
+		if (use_summary &&
+		    ((ate_addr & ADDR_SECT_MASK) == (fs->ate_wra & ADDR_SECT_MASK)) &&
+		    nvs_sector_summary_ate_valid(fs, &ate)) {
+			rc = nvs_sector_summary_load(fs, ate_addr, &ate);
+			if (rc <= 0) {
+				return rc;
+			}
+
+			/* The summary is not usable, scan all the sectors */
+			LOG_WRN("Invalid sector summary, rebuilding cache");
+			memset(fs->lookup_cache, 0xff, sizeof(fs->lookup_cache));
+			use_summary = false;
+			addr = fs->ate_wra;
+			continue;
+		}
+#endif
+
 		cache_entry = &fs->lookup_cache[nvs_lookup_cache_pos(ate.id)];
 
 		if (ate.id != 0xFFFF && *cache_entry == NVS_LOOKUP_CACHE_NO_ADDR &&
@@ -402,6 +432,171 @@ static int nvs_close_ate_valid(struct nvs_fs *fs, const struct nvs_ate *entry)
 	return 1;
 }
 
+/* nvs_sector_summary_ate_valid validates a sector summary ate:
+ * - valid ate
+ * - id = 0xFFFF and part = NVS_SECTOR_SUMMARY_PART
+ * return 1 if valid, 0 otherwise
+ */
+static int nvs_sector_summary_ate_valid(struct nvs_fs *fs,
+					const struct nvs_ate *entry)
+{
+	if ((!nvs_ate_valid(fs, entry)) || (entry->id != 0xFFFF) ||
+	    (entry->part != NVS_SECTOR_SUMMARY_PART)) {
+		return 0;
+	}
+
+	return 1;
+}
+
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+/* store a copy of the lookup cache in the write sector. This is done after gc,
+ * when the cache reflects all the sectors, and only when there is room left for
+ * the summary, its ate and the ate reserved for a delete, plus reserve bytes.
+ */
+static int nvs_sector_summary_wrt(struct nvs_fs *fs, size_t reserve)
+{
+	int rc;
+	struct nvs_ate entry;
+	size_t ate_size, len;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+	len = sizeof(fs->lookup_cache);
+
+	if (fs->ate_wra < (fs->data_wra + nvs_al_size(fs, len) + ate_size +
+			   reserve)) {
+		LOG_DBG("No room for sector summary");
+		return 0;
+	}
+
+	entry.id = 0xFFFF;
+	entry.offset = (uint16_t)(fs->data_wra & ADDR_OFFS_MASK);
+	entry.len = (uint16_t)len;
+	entry.part = NVS_SECTOR_SUMMARY_PART;
+
+	nvs_ate_crc8_update(&entry);
+
+	rc = nvs_flash_data_wrt(fs, fs->lookup_cache, len);
+	if (rc) {
+		return rc;
+	}
+
+	return nvs_flash_ate_wrt(fs, &entry);
+}
+
+/* fill the lookup cache positions for which no newer ate was found with the
+ * content of the summary stored at addr.
+ * returns 0 if OK, 1 if the summary is not usable, errcode on error
+ */
+static int nvs_sector_summary_load(struct nvs_fs *fs, uint32_t addr,
+				   const struct nvs_ate *entry)
+{
+	int rc;
+	uint32_t buf[NVS_BLOCK_SIZE / sizeof(uint32_t)];
+	uint32_t *cache_entry = fs->lookup_cache;
+	size_t count;
+
+	if (entry->len != sizeof(fs->lookup_cache)) {
+		return 1;
+	}
+
+	addr &= ADDR_SECT_MASK;
+	addr += entry->offset;
+
+	for (size_t pos = 0; pos < CONFIG_NVS_LOOKUP_CACHE_SIZE; pos += count) {
+		count = MIN(ARRAY_SIZE(buf), CONFIG_NVS_LOOKUP_CACHE_SIZE - pos);
+		rc = nvs_flash_rd(fs, addr, buf, count * sizeof(uint32_t));
+		if (rc) {
+			return rc;
+		}
+		addr += count * sizeof(uint32_t);
+
+		for (size_t i = 0; i < count; i++, cache_entry++) {
+			if ((buf[i] != NVS_LOOKUP_CACHE_NO_ADDR) &&
+			    ((buf[i] >> ADDR_SECT_SHIFT) >= fs->sector_count)) {
+				return 1;
+			}
+			if (*cache_entry == NVS_LOOKUP_CACHE_NO_ADDR) {
+				*cache_entry = buf[i];
+			}
+		}
+	}
+
+	return 0;
+}
+#endif /* CONFIG_NVS_SECTOR_SUMMARY */
+
+/* nvs_multi_member: ate written by nvs_write_multi(), valid once committed */
+static inline bool nvs_multi_member(const struct nvs_ate *entry)
+{
+	return (entry->id != 0xFFFF) && (entry->part == NVS_MULTI_PART);
+}
+
+/* nvs_multi_committed checks that the ate at addr, when written by
+ * nvs_write_multi(), is followed by the commit ate of its update: going to the
+ * newer ates of the sector, over the other members of the update and the ates
+ * of interrupted writes, the first ate must be the commit ate.
+ * return 1 if committed or not written by nvs_write_multi(), 0 if not
+ * committed, errcode on error
+ */
+static int nvs_multi_committed(struct nvs_fs *fs, uint32_t addr,
+			       const struct nvs_ate *entry)
+{
+	int rc;
+	struct nvs_ate ate;
+	uint32_t low;
+	size_t ate_size;
+
+	if (!nvs_multi_member(entry)) {
+		return 1;
+	}
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+
+	/* lowest address of the ates written in the sector */
+	low = addr & ADDR_SECT_MASK;
+	if (low == (fs->ate_wra & ADDR_SECT_MASK)) {
+		low = fs->ate_wra + ate_size;
+	} else {
+		rc = nvs_flash_ate_rd(fs, low + fs->sector_size - ate_size, &ate);
+		if (rc) {
+			return rc;
+		}
+		if (nvs_close_ate_valid(fs, &ate)) {
+			low += ate.offset;
+		}
+	}
+
+	while (addr >= (low + ate_size)) {
+		addr -= ate_size;
+		rc = nvs_flash_ate_rd(fs, addr, &ate);
+		if (rc) {
+			return rc;
+		}
+		if (!nvs_ate_cmp_const(&ate, fs->flash_parameters->erase_value)) {
+			break;
+		}
+		if (!nvs_ate_valid(fs, &ate) || nvs_multi_member(&ate)) {
+			continue;
+		}
+		return (ate.id == 0xFFFF) && (ate.part == NVS_MULTI_COMMIT_PART);
+	}
+
+	return 0;
+}
+
+/* nvs_ate_match: the ate at addr is a valid entry of id
+ * return 1 if it is, 0 if not, errcode on error
+ */
+static int nvs_ate_match(struct nvs_fs *fs, uint32_t addr,
+			 const struct nvs_ate *entry, uint16_t id)
+{
+	if ((entry->id != id) || !nvs_ate_valid(fs, entry)) {
+		return 0;
+	}
+
+	return nvs_multi_committed(fs, addr, entry);
+}
+
 /* store an entry in flash */
 static int nvs_flash_wrt_entry(struct nvs_fs *fs, uint16_t id, const void *data,
 				size_t len)
@@ -547,6 +742,7 @@ static int nvs_sector_close(struct nvs_fs *fs)
 
 	close_ate.id = 0xFFFF;
 	close_ate.len = 0U;
+	close_ate.part = 0xff;
 	close_ate.offset = (uint16_t)((fs->ate_wra + ate_size) & ADDR_OFFS_MASK);
 
 	fs->ate_wra &= ADDR_SECT_MASK;
@@ -570,6 +766,7 @@ static int nvs_add_gc_done_ate(struct nvs_fs *fs)
 	LOG_DBG("Adding gc done ate at %x", fs->ate_wra & ADDR_OFFS_MASK);
 	gc_done_ate.id = 0xffff;
 	gc_done_ate.len = 0U;
+	gc_done_ate.part = 0xff;
 	gc_done_ate.offset = (uint16_t)(fs->data_wra & ADDR_OFFS_MASK);
 	nvs_ate_crc8_update(&gc_done_ate);
 
@@ -625,7 +822,17 @@ static int nvs_gc(struct nvs_fs *fs)
 			return rc;
 		}
 
-		if (!nvs_ate_valid(fs, &gc_ate)) {
+		/* a sector summary only describes the sector it is stored in */
+		if (!nvs_ate_valid(fs, &gc_ate) ||
+		    nvs_sector_summary_ate_valid(fs, &gc_ate)) {
+			continue;
+		}
+
+		rc = nvs_multi_committed(fs, gc_prev_addr, &gc_ate);
+		if (rc < 0) {
+			return rc;
+		}
+		if (!rc) {
 			continue;
 		}
 
@@ -641,8 +848,11 @@ static int nvs_gc(struct nvs_fs *fs)
 			 * have been written that has the same ate but is
 			 * invalid, don't consider these as a match.
 			 */
-			if ((wlk_ate.id == gc_ate.id) &&
-			    (nvs_ate_valid(fs, &wlk_ate))) {
+			rc = nvs_ate_match(fs, wlk_prev_addr, &wlk_ate, gc_ate.id);
+			if (rc < 0) {
+				return rc;
+			}
+			if (rc) {
 				break;
 			}
 		} while (wlk_addr != fs->ate_wra);
@@ -658,6 +868,8 @@ static int nvs_gc(struct nvs_fs *fs)
 			data_addr += gc_ate.offset;
 
 			gc_ate.offset = (uint16_t)(fs->data_wra & ADDR_OFFS_MASK);
+			/* a copy is no member of an uncommitted multi write */
+			gc_ate.part = 0xff;
 			nvs_ate_crc8_update(&gc_ate);
 
 			rc = nvs_flash_block_move(fs, data_addr, gc_ate.len);
@@ -695,6 +907,350 @@ gc_done:
 	return 0;
 }
 
+#ifdef CONFIG_NVS_BACKGROUND_GC
+static K_THREAD_STACK_DEFINE(nvs_gc_stack, CONFIG_NVS_BACKGROUND_GC_STACK_SIZE);
+static struct k_work_q nvs_gc_work_q;
+
+static inline bool nvs_gc_below_threshold(struct nvs_fs *fs)
+{
+	return (fs->ate_wra - fs->data_wra) <
+	       (fs->sector_size * CONFIG_NVS_BACKGROUND_GC_THRESHOLD / 100U);
+}
+
+/* When the live data does not leave enough free space after gc, gc would be
+ * restarted after every write: stay with gc on demand until the next gc.
+ */
+static inline void nvs_gc_saturation_update(struct nvs_fs *fs)
+{
+	fs->gc_saturated = nvs_gc_below_threshold(fs);
+}
+
+static void nvs_gc_work_handler(struct k_work *work)
+{
+	struct nvs_fs *fs = CONTAINER_OF(work, struct nvs_fs, gc_work);
+	int rc;
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	/* a write might have done gc since the work was submitted */
+	if (!fs->ready || fs->gc_saturated || !nvs_gc_below_threshold(fs)) {
+		goto end;
+	}
+
+	LOG_DBG("Background gc, sector %d", fs->ate_wra >> ADDR_SECT_SHIFT);
+
+	rc = nvs_sector_close(fs);
+	if (!rc) {
+		rc = nvs_gc(fs);
+	}
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+	if (!rc) {
+		rc = nvs_sector_summary_wrt(fs, 0);
+	}
+#endif
+	if (rc) {
+		LOG_ERR("Background gc failed: %d", rc);
+	}
+
+	nvs_gc_saturation_update(fs);
+end:
+	k_mutex_unlock(&fs->nvs_lock);
+}
+
+static int nvs_gc_work_q_init(const struct device *dev)
+{
+	struct k_work_queue_config cfg = {
+		.name = "nvs_gc",
+	};
+
+	ARG_UNUSED(dev);
+
+	k_work_queue_start(&nvs_gc_work_q, nvs_gc_stack,
+			   K_THREAD_STACK_SIZEOF(nvs_gc_stack),
+			   CONFIG_NVS_BACKGROUND_GC_PRIORITY, &cfg);
+
+	return 0;
+}
+
+SYS_INIT(nvs_gc_work_q_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif /* CONFIG_NVS_BACKGROUND_GC */
+
+#ifdef CONFIG_NVS_WRITE_MULTI
+/* Data of the entries written by nvs_write_multi(), gathered in blocks */
+struct nvs_multi_blk {
+	uint8_t buf[NVS_BLOCK_SIZE];
+	size_t len;
+};
+
+static int nvs_multi_blk_flush(struct nvs_fs *fs, struct nvs_multi_blk *blk)
+{
+	int rc;
+
+	rc = nvs_flash_data_wrt(fs, blk->buf, blk->len);
+	blk->len = 0;
+
+	return rc;
+}
+
+/* add the data of an entry, padded to the write block size so that the data of
+ * the next entry is aligned. Large data bypasses the block.
+ */
+static int nvs_multi_blk_add(struct nvs_fs *fs, struct nvs_multi_blk *blk,
+			     const void *data, size_t len)
+{
+	const uint8_t *data8 = (const uint8_t *)data;
+	size_t blen, pad;
+	int rc;
+
+	if ((blk->len == 0U) && (len >= sizeof(blk->buf))) {
+		blen = len & ~(fs->flash_parameters->write_block_size - 1U);
+		rc = nvs_flash_data_wrt(fs, data8, blen);
+		if (rc) {
+			return rc;
+		}
+		len -= blen;
+		data8 += blen;
+	}
+
+	while (len) {
+		blen = MIN(len, sizeof(blk->buf) - blk->len);
+		memcpy(&blk->buf[blk->len], data8, blen);
+		blk->len += blen;
+		len -= blen;
+		data8 += blen;
+
+		if (blk->len == sizeof(blk->buf)) {
+			rc = nvs_multi_blk_flush(fs, blk);
+			if (rc) {
+				return rc;
+			}
+		}
+	}
+
+	pad = nvs_al_size(fs, blk->len) - blk->len;
+	(void)memset(&blk->buf[blk->len], fs->flash_parameters->erase_value, pad);
+	blk->len += pad;
+
+	return 0;
+}
+
+/* find the most recent valid ate of id, walking from addr.
+ * returns 1 with the ate and the address of its data if found, 0 if not found,
+ * errcode on error
+ */
+static int nvs_multi_find(struct nvs_fs *fs, uint32_t addr, uint16_t id,
+			  struct nvs_ate *ate, uint32_t *data_addr)
+{
+	int rc;
+	uint32_t rd_addr;
+
+	if (addr == NVS_LOOKUP_CACHE_NO_ADDR) {
+		return 0;
+	}
+
+	do {
+		rd_addr = addr;
+		rc = nvs_prev_ate(fs, &addr, ate);
+		if (rc) {
+			return rc;
+		}
+		rc = nvs_ate_match(fs, rd_addr, ate, id);
+		if (rc < 0) {
+			return rc;
+		}
+		if (rc) {
+			*data_addr = (rd_addr & ADDR_SECT_MASK) + ate->offset;
+			return 1;
+		}
+	} while (addr != fs->ate_wra);
+
+	return 0;
+}
+
+/* compare an entry to the data stored for its id.
+ * returns 1 if the entry changes the stored data, 0 if not, errcode on error
+ */
+static int nvs_multi_changed(struct nvs_fs *fs, const struct nvs_entry *entry)
+{
+	int rc;
+	struct nvs_ate ate;
+	uint32_t addr, data_addr = 0U;
+	size_t prev_len;
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	addr = fs->lookup_cache[nvs_lookup_cache_pos(entry->id)];
+#else
+	addr = fs->ate_wra;
+#endif
+
+	rc = nvs_multi_find(fs, addr, entry->id, &ate, &data_addr);
+	if (rc < 0) {
+		return rc;
+	}
+
+	prev_len = rc ? ate.len : 0U;
+	if ((prev_len == 0U) || (entry->len != prev_len)) {
+		return (entry->len != prev_len) ? 1 : 0;
+	}
+
+	return nvs_flash_block_cmp(fs, data_addr, entry->data, entry->len);
+}
+
+static int nvs_multi_commit_wrt(struct nvs_fs *fs)
+{
+	struct nvs_ate commit_ate;
+
+	commit_ate.id = 0xFFFF;
+	commit_ate.offset = (uint16_t)(fs->data_wra & ADDR_OFFS_MASK);
+	commit_ate.len = 0U;
+	commit_ate.part = NVS_MULTI_COMMIT_PART;
+	nvs_ate_crc8_update(&commit_ate);
+
+	return nvs_flash_ate_wrt(fs, &commit_ate);
+}
+
+/* write the data gathered so far, then the cnt ates of buf referring to it */
+static int nvs_multi_ate_flush(struct nvs_fs *fs, struct nvs_multi_blk *blk,
+			       const uint8_t *buf, size_t cnt)
+{
+	int rc;
+	size_t ate_size;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+
+	rc = nvs_multi_blk_flush(fs, blk);
+	if (rc) {
+		return rc;
+	}
+
+	/* the first ate of buf is the last one of the entry list */
+	fs->ate_wra -= (cnt - 1U) * ate_size;
+	rc = nvs_flash_al_wrt(fs, fs->ate_wra, buf, cnt * ate_size);
+	if (rc) {
+		return rc;
+	}
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	/* from the oldest to the newest ate */
+	for (size_t i = cnt; i-- > 0;) {
+		const struct nvs_ate *ate = (const struct nvs_ate *)&buf[i * ate_size];
+
+		fs->lookup_cache[nvs_lookup_cache_pos(ate->id)] =
+			fs->ate_wra + i * ate_size;
+	}
+#endif
+	fs->ate_wra -= ate_size;
+
+	return 0;
+}
+
+/* write the entries that change the stored data, their data back to back and
+ * their ates in blocks, followed by the commit ate. An ate is only written
+ * once its data is in flash.
+ */
+static int nvs_multi_wrt(struct nvs_fs *fs, const struct nvs_entry *entries,
+			 size_t count)
+{
+	int rc;
+	struct nvs_multi_blk blk = { .len = 0U };
+	uint8_t ate_buf[NVS_BLOCK_SIZE];
+	struct nvs_ate ate;
+	size_t ate_size, ate_max, ate_cnt;
+	uint8_t *slot;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+	ate_max = sizeof(ate_buf) / ate_size;
+	ate_cnt = 0U;
+
+	for (size_t i = 0; i < count; i++) {
+		rc = nvs_multi_changed(fs, &entries[i]);
+		if (rc < 0) {
+			return rc;
+		}
+		if (!rc) {
+			continue;
+		}
+
+		ate.id = entries[i].id;
+		ate.offset = (uint16_t)((fs->data_wra + blk.len) & ADDR_OFFS_MASK);
+		ate.len = (uint16_t)entries[i].len;
+		ate.part = NVS_MULTI_PART;
+		nvs_ate_crc8_update(&ate);
+
+		rc = nvs_multi_blk_add(fs, &blk, entries[i].data, entries[i].len);
+		if (rc) {
+			return rc;
+		}
+
+		/* ates are written downwards, fill the buffer from its end */
+		slot = &ate_buf[(ate_max - 1U - ate_cnt) * ate_size];
+		memcpy(slot, &ate, sizeof(ate));
+		(void)memset(slot + sizeof(ate), fs->flash_parameters->erase_value,
+			     ate_size - sizeof(ate));
+		ate_cnt++;
+
+		if (ate_cnt == ate_max) {
+			rc = nvs_multi_ate_flush(fs, &blk, ate_buf, ate_cnt);
+			if (rc) {
+				return rc;
+			}
+			ate_cnt = 0U;
+		}
+	}
+
+	if (ate_cnt) {
+		rc = nvs_multi_ate_flush(fs, &blk,
+					 &ate_buf[(ate_max - ate_cnt) * ate_size],
+					 ate_cnt);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return nvs_multi_commit_wrt(fs);
+}
+
+/* an update interrupted before its commit ate is followed by the ates written
+ * after mount, unless that is another update: separate them by an abort ate.
+ * Without room for it, the next write is a delete or closes the sector.
+ */
+static int nvs_multi_abort_wrt(struct nvs_fs *fs)
+{
+	int rc;
+	struct nvs_ate ate;
+	uint32_t addr, end;
+	size_t ate_size;
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+	end = (fs->ate_wra & ADDR_SECT_MASK) + fs->sector_size - ate_size;
+
+	for (addr = fs->ate_wra + ate_size; addr < end; addr += ate_size) {
+		rc = nvs_flash_ate_rd(fs, addr, &ate);
+		if (rc) {
+			return rc;
+		}
+		if (nvs_ate_valid(fs, &ate)) {
+			break;
+		}
+	}
+
+	if ((addr == end) || !nvs_multi_member(&ate) ||
+	    (fs->ate_wra < (fs->data_wra + ate_size))) {
+		return 0;
+	}
+
+	LOG_INF("Interrupted multi write found");
+
+	ate.id = 0xFFFF;
+	ate.offset = (uint16_t)(fs->data_wra & ADDR_OFFS_MASK);
+	ate.len = 0U;
+	ate.part = NVS_MULTI_ABORT_PART;
+	nvs_ate_crc8_update(&ate);
+
+	return nvs_flash_ate_wrt(fs, &ate);
+}
+#endif /* CONFIG_NVS_WRITE_MULTI */
+
 static int nvs_startup(struct nvs_fs *fs)
 {
 	int rc;
@@ -887,8 +1443,8 @@ static int nvs_startup(struct nvs_fs *fs)
 		fs->data_wra = fs->ate_wra & ADDR_SECT_MASK;
 	}
 
-#ifdef CONFIG_NVS_LOOKUP_CACHE
-	rc = nvs_lookup_cache_rebuild(fs);
+#ifdef CONFIG_NVS_WRITE_MULTI
+	rc = nvs_multi_abort_wrt(fs);
 #endif
 
 end:
@@ -900,6 +1456,13 @@ end:
 
 		rc = nvs_add_gc_done_ate(fs);
 	}
+
+#ifdef CONFIG_NVS_LOOKUP_CACHE
+	/* Rebuilt last, so that it also covers a gc that was completed above */
+	if (!rc) {
+		rc = nvs_lookup_cache_rebuild(fs);
+	}
+#endif
 	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
 }
@@ -908,12 +1471,19 @@ int nvs_clear(struct nvs_fs *fs)
 {
 	int rc;
 	uint32_t addr;
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	struct k_work_sync sync;
+#endif
 
 	if (!fs->ready) {
 		LOG_ERR("NVS not initialized");
 		return -EACCES;
 	}
 
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	(void)k_work_cancel_sync(&fs->gc_work, &sync);
+#endif
+
 	for (uint16_t i = 0; i < fs->sector_count; i++) {
 		addr = i << ADDR_SECT_SHIFT;
 		rc = nvs_flash_erase_sector(fs, addr);
@@ -934,6 +1504,16 @@ int nvs_mount(struct nvs_fs *fs)
 	int rc;
 	struct flash_pages_info info;
 	size_t write_block_size;
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	struct k_work_sync sync;
+#endif
+
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	/* the file system might be mounted again while gc is pending */
+	(void)k_work_cancel_sync(&fs->gc_work, &sync);
+	k_work_init(&fs->gc_work, nvs_gc_work_handler);
+	fs->gc_saturated = false;
+#endif
 
 	k_mutex_init(&fs->nvs_lock);
 
@@ -1013,6 +1593,9 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		return -EINVAL;
 	}
 
+	/* the walk below must not run concurrently with gc */
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
 	/* find latest entry with same id */
 	wlk_addr = fs->ate_wra;
 	rd_addr = wlk_addr;
@@ -1021,9 +1604,13 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		rd_addr = wlk_addr;
 		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
 		if (rc) {
-			return rc;
+			goto end;
+		}
+		rc = nvs_ate_match(fs, rd_addr, &wlk_ate, id);
+		if (rc < 0) {
+			goto end;
 		}
-		if ((wlk_ate.id == id) && (nvs_ate_valid(fs, &wlk_ate))) {
+		if (rc) {
 			prev_found = true;
 			break;
 		}
@@ -1043,20 +1630,22 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 				/* skip delete entry as it is already the
 				 * last one
 				 */
-				return 0;
+				rc = 0;
+				goto end;
 			}
 		} else if (len == wlk_ate.len) {
 			/* do not try to compare if lengths are not equal */
 			/* compare the data and if equal return 0 */
 			rc = nvs_flash_block_cmp(fs, rd_addr, data, len);
 			if (rc <= 0) {
-				return rc;
+				goto end;
 			}
 		}
 	} else {
 		/* skip delete entry for non-existing entry */
 		if (len == 0) {
-			return 0;
+			rc = 0;
+			goto end;
 		}
 	}
 
@@ -1066,8 +1655,6 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		required_space = data_size + ate_size;
 	}
 
-	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
-
 	gc_count = 0;
 	while (1) {
 		if (gc_count == fs->sector_count) {
@@ -1097,9 +1684,25 @@ ssize_t nvs_write(struct nvs_fs *fs, uint16_t id, const void *data, size_t len)
 		if (rc) {
 			goto end;
 		}
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+		/* keep room for the entry being written */
+		rc = nvs_sector_summary_wrt(fs, required_space);
+		if (rc) {
+			goto end;
+		}
+#endif
+#ifdef CONFIG_NVS_BACKGROUND_GC
+		nvs_gc_saturation_update(fs);
+#endif
 		gc_count++;
 	}
 	rc = len;
+
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	if (!fs->gc_saturated && nvs_gc_below_threshold(fs)) {
+		(void)k_work_submit_to_queue(&nvs_gc_work_q, &fs->gc_work);
+	}
+#endif
 end:
 	k_mutex_unlock(&fs->nvs_lock);
 	return rc;
@@ -1110,6 +1713,111 @@ int nvs_delete(struct nvs_fs *fs, uint16_t id)
 	return nvs_write(fs, id, NULL, 0);
 }
 
+#ifdef CONFIG_NVS_WRITE_MULTI
+int nvs_write_multi(struct nvs_fs *fs, const struct nvs_entry *entries,
+		    size_t count)
+{
+	int rc, gc_count;
+	size_t ate_size, cnt, data_size, required_space;
+
+	if (!fs->ready) {
+		LOG_ERR("NVS not initialized");
+		return -EACCES;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		/* 0xFFFF is a special-purpose identifier */
+		if ((entries[i].id == 0xFFFF) ||
+		    ((entries[i].len > 0) && (entries[i].data == NULL))) {
+			return -EINVAL;
+		}
+		/* each entry is compared to the stored data before and while
+		 * the update is written, a repeated id would change the outcome
+		 */
+		for (size_t j = 0; j < i; j++) {
+			if (entries[j].id == entries[i].id) {
+				return -EINVAL;
+			}
+		}
+	}
+
+	ate_size = nvs_al_size(fs, sizeof(struct nvs_ate));
+
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+
+	cnt = 0U;
+	data_size = 0U;
+	for (size_t i = 0; i < count; i++) {
+		rc = nvs_multi_changed(fs, &entries[i]);
+		if (rc < 0) {
+			goto end;
+		}
+		if (rc) {
+			cnt++;
+			data_size += nvs_al_size(fs, entries[i].len);
+		}
+	}
+
+	if (!cnt) {
+		rc = 0;
+		goto end;
+	}
+
+	/* the whole update and its commit ate are in the same sector */
+	required_space = data_size + (cnt + 1) * ate_size;
+
+	/* 1 ate for sector close, 1 ate for gc done and 1 ate to always allow a
+	 * delete.
+	 */
+	if (required_space > (fs->sector_size - 3 * ate_size)) {
+		rc = -EINVAL;
+		goto end;
+	}
+
+	gc_count = 0;
+	while (fs->ate_wra < (fs->data_wra + required_space)) {
+		if (gc_count == fs->sector_count) {
+			rc = -ENOSPC;
+			goto end;
+		}
+
+		rc = nvs_sector_close(fs);
+		if (rc) {
+			goto end;
+		}
+
+		rc = nvs_gc(fs);
+		if (rc) {
+			goto end;
+		}
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+		rc = nvs_sector_summary_wrt(fs, required_space);
+		if (rc) {
+			goto end;
+		}
+#endif
+#ifdef CONFIG_NVS_BACKGROUND_GC
+		nvs_gc_saturation_update(fs);
+#endif
+		gc_count++;
+	}
+
+	rc = nvs_multi_wrt(fs, entries, count);
+	if (rc) {
+		goto end;
+	}
+
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	if (!fs->gc_saturated && nvs_gc_below_threshold(fs)) {
+		(void)k_work_submit_to_queue(&nvs_gc_work_q, &fs->gc_work);
+	}
+#endif
+end:
+	k_mutex_unlock(&fs->nvs_lock);
+	return rc;
+}
+#endif /* CONFIG_NVS_WRITE_MULTI */
+
 ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 		      uint16_t cnt)
 {
@@ -1132,12 +1840,17 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 
 	cnt_his = 0U;
 
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	/* background gc may erase the sector being walked */
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+#endif
+
 #ifdef CONFIG_NVS_LOOKUP_CACHE
 	wlk_addr = fs->lookup_cache[nvs_lookup_cache_pos(id)];
 
 	if (wlk_addr == NVS_LOOKUP_CACHE_NO_ADDR) {
 		rc = -ENOENT;
-		goto err;
+		goto end;
 	}
 #else
 	wlk_addr = fs->ate_wra;
@@ -1148,9 +1861,13 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 		rd_addr = wlk_addr;
 		rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
 		if (rc) {
-			goto err;
+			goto end;
+		}
+		rc = nvs_ate_match(fs, rd_addr, &wlk_ate, id);
+		if (rc < 0) {
+			goto end;
 		}
-		if ((wlk_ate.id == id) &&  (nvs_ate_valid(fs, &wlk_ate))) {
+		if (rc) {
 			cnt_his++;
 		}
 		if (wlk_addr == fs->ate_wra) {
@@ -1158,21 +1875,24 @@ ssize_t nvs_read_hist(struct nvs_fs *fs, uint16_t id, void *data, size_t len,
 		}
 	}
 
-	if (((wlk_addr == fs->ate_wra) && (wlk_ate.id != id)) ||
-	    (wlk_ate.len == 0U) || (cnt_his < cnt)) {
-		return -ENOENT;
+	if ((cnt_his <= cnt) || (wlk_ate.len == 0U)) {
+		rc = -ENOENT;
+		goto end;
 	}
 
 	rd_addr &= ADDR_SECT_MASK;
 	rd_addr += wlk_ate.offset;
 	rc = nvs_flash_rd(fs, rd_addr, data, MIN(len, wlk_ate.len));
 	if (rc) {
-		goto err;
+		goto end;
 	}
 
-	return wlk_ate.len;
+	rc = wlk_ate.len;
 
-err:
+end:
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	k_mutex_unlock(&fs->nvs_lock);
+#endif
 	return rc;
 }
 
@@ -1204,12 +1924,16 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 		free_space += (fs->sector_size - ate_size);
 	}
 
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	k_mutex_lock(&fs->nvs_lock, K_FOREVER);
+#endif
+
 	step_addr = fs->ate_wra;
 
 	while (1) {
 		rc = nvs_prev_ate(fs, &step_addr, &step_ate);
 		if (rc) {
-			return rc;
+			goto end;
 		}
 
 		wlk_addr = fs->ate_wra;
@@ -1217,7 +1941,7 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 		while (1) {
 			rc = nvs_prev_ate(fs, &wlk_addr, &wlk_ate);
 			if (rc) {
-				return rc;
+				goto end;
 			}
 			if ((wlk_ate.id == step_ate.id) ||
 			    (wlk_addr == fs->ate_wra)) {
@@ -1236,5 +1960,11 @@ ssize_t nvs_calc_free_space(struct nvs_fs *fs)
 			break;
 		}
 	}
-	return free_space;
+	rc = free_space;
+
+end:
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	k_mutex_unlock(&fs->nvs_lock);
+#endif
+	return rc;
 }
@@ -30,6 +30,22 @@ extern "C" {
 
 #define NVS_LOOKUP_CACHE_NO_ADDR 0xFFFFFFFF
 
+/*
+ * A sector summary is a copy of the lookup cache, stored after gc as data with
+ * an id of 0xFFFF and tagged with this value in the part field.
+ */
+#define NVS_SECTOR_SUMMARY_PART 0xFE
+
+/*
+ * The ates written by nvs_write_multi() are tagged with NVS_MULTI_PART and only
+ * valid when followed by a commit ate: id 0xFFFF, len 0 and
+ * NVS_MULTI_COMMIT_PART. On mount, an update interrupted before its commit is
+ * followed by an abort ate, tagged with NVS_MULTI_ABORT_PART.
+ */
+#define NVS_MULTI_COMMIT_PART 0xFD
+#define NVS_MULTI_PART 0xFC
+#define NVS_MULTI_ABORT_PART 0xFB
+
 /* Allocation Table Entry */
 struct nvs_ate {
 	uint16_t id;	/* data id */
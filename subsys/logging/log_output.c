@@ -13,6 +13,7 @@
 #include <time.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 
 #define LOG_COLOR_CODE_DEFAULT "\x1B[0m"
 #define LOG_COLOR_CODE_RED     "\x1B[1;31m"
@@ -97,6 +98,18 @@ static int level_to_rfc5424_severity(uint32_t level)
 	return ret;
 }
 
+static void buffer_write(log_output_func_t outf, uint8_t *buf, size_t len,
+			 void *ctx)
+{
+	int processed;
+
+	do {
+		processed = outf(buf, len, ctx);
+		len -= processed;
+		buf += processed;
+	} while (len != 0);
+}
+
 static int out_func(int c, void *ctx)
 {
 	const struct log_output *out_ctx = (const struct log_output *)ctx;
@@ -123,6 +136,41 @@ static int out_func(int c, void *ctx)
 	return 0;
 }
 
+/* Span counterpart of out_func(), copying the span at once. */
+static int out_span_func(const void *buf, size_t len, void *ctx)
+{
+	const struct log_output *out_ctx = (const struct log_output *)ctx;
+	const uint8_t *data = buf;
+	size_t total = len;
+
+	if (IS_ENABLED(CONFIG_LOG_MODE_IMMEDIATE)) {
+		/* Backend must be thread safe in synchronous operation. */
+		buffer_write(out_ctx->func, (uint8_t *)data, len,
+			     out_ctx->control_block->ctx);
+		return (int)total;
+	}
+
+	while (len > 0) {
+		size_t chunk;
+		int idx;
+
+		if (out_ctx->control_block->offset == out_ctx->size) {
+			log_output_flush(out_ctx);
+		}
+
+		chunk = MIN(len, out_ctx->size - out_ctx->control_block->offset);
+		idx = atomic_add(&out_ctx->control_block->offset, chunk);
+		memcpy(&out_ctx->buf[idx], data, chunk);
+
+		data += chunk;
+		len -= chunk;
+	}
+
+	__ASSERT_NO_MSG(out_ctx->control_block->offset <= out_ctx->size);
+
+	return (int)total;
+}
+
 static int cr_out_func(int c, void *ctx)
 {
 	out_func(c, ctx);
@@ -140,24 +188,12 @@ static int print_formatted(const struct log_output *output,
 	int length = 0;
 
 	va_start(args, fmt);
-	length = cbvprintf(out_func, (void *)output, fmt, args);
+	length = cbvprintf_span(out_span_func, (void *)output, fmt, args);
 	va_end(args);
 
 	return length;
 }
 
-static void buffer_write(log_output_func_t outf, uint8_t *buf, size_t len,
-			 void *ctx)
-{
-	int processed;
-
-	do {
-		processed = outf(buf, len, ctx);
-		len -= processed;
-		buf += processed;
-	} while (len != 0);
-}
-
 
 void log_output_flush(const struct log_output *output)
 {
@@ -497,8 +533,17 @@ void log_output_msg_process(const struct log_output *output,
 	uint8_t *data = log_msg_get_package(msg, &len);
 
 	if (len) {
-		int err = cbpprintf(raw_string ? cr_out_func :  out_func,
-				    (void *)output, data);
+		int err;
+
+		/* Raw strings need their new lines translated a character
+		 * at a time.
+		 */
+		if (raw_string) {
+			err = cbpprintf(cr_out_func, (void *)output, data);
+		} else {
+			err = cbpprintf_span(out_span_func, (void *)output,
+					     data);
+		}
 
 		(void)err;
 		__ASSERT_NO_MSG(err >= 0);
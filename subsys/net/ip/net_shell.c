@@ -2274,6 +2274,93 @@ static int cmd_net_dns_query(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+static void dns_cache_entry_cb(const char *query, enum dns_query_type type,
+			       int status, const struct sockaddr *addrs,
+			       int num_addrs, uint32_t ttl, void *user_data)
+{
+	struct net_shell_user_data *data = user_data;
+	const struct shell *shell = data->shell;
+	int *count = data->user_data;
+	int i;
+
+	PR("\t%s %s ttl %u", query,
+	   type == DNS_QUERY_TYPE_AAAA ? "AAAA" : "A", ttl);
+
+	if (num_addrs == 0) {
+		PR(" no address (%d)\n", status);
+	} else {
+		PR("\n");
+	}
+
+	for (i = 0; i < num_addrs; i++) {
+		if (addrs[i].sa_family == AF_INET) {
+			PR("\t\t%s\n", net_sprint_ipv4_addr(
+				   &net_sin(&addrs[i])->sin_addr));
+		} else if (addrs[i].sa_family == AF_INET6) {
+			PR("\t\t%s\n", net_sprint_ipv6_addr(
+				   &net_sin6(&addrs[i])->sin6_addr));
+		}
+	}
+
+	(*count)++;
+}
+#endif
+
+static int cmd_net_dns_cache(const struct shell *shell, size_t argc,
+			     char *argv[])
+{
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	struct dns_resolve_cache_stats stats;
+	struct net_shell_user_data user_data;
+	int count = 0;
+#endif
+
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	user_data.shell = shell;
+	user_data.user_data = &count;
+
+	PR("Cached names:\n");
+
+	dns_resolve_cache_foreach(dns_cache_entry_cb, &user_data);
+
+	if (count == 0) {
+		PR("\tNone\n");
+	}
+
+	dns_resolve_cache_stats_get(&stats);
+
+	PR("Hits %u misses %u evictions %u\n", stats.hits, stats.misses,
+	   stats.evictions);
+#else
+	PR_INFO("Set %s to enable %s support.\n", "CONFIG_DNS_RESOLVER_CACHE",
+		"DNS resolver cache");
+#endif
+
+	return 0;
+}
+
+static int cmd_net_dns_cache_flush(const struct shell *shell, size_t argc,
+				   char *argv[])
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	dns_resolve_cache_flush();
+
+	PR("DNS cache flushed.\n");
+#else
+	PR_INFO("Set %s to enable %s support.\n", "CONFIG_DNS_RESOLVER_CACHE",
+		"DNS resolver cache");
+#endif
+
+	return 0;
+}
+
 static int cmd_net_dns(const struct shell *shell, size_t argc, char *argv[])
 {
 #if defined(CONFIG_DNS_RESOLVER)
@@ -5689,7 +5776,16 @@ SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_capture,
 	SHELL_SUBCMD_SET_END
 );
 
+SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_dns_cache,
+	SHELL_CMD(flush, NULL, "Remove all the cached names.",
+		  cmd_net_dns_cache_flush),
+	SHELL_SUBCMD_SET_END
+);
+
 SHELL_STATIC_SUBCMD_SET_CREATE(net_cmd_dns,
+	SHELL_CMD(cache, &net_cmd_dns_cache,
+		  "Show the cached names and cache statistics.",
+		  cmd_net_dns_cache),
 	SHELL_CMD(cancel, NULL, "Cancel all pending requests.",
 		  cmd_net_dns_cancel),
 	SHELL_CMD(query, NULL,
@@ -283,6 +283,10 @@ int coap_packet_append_option(struct coap_packet *cpkt, uint16_t code,
 	cpkt->opt_len += r;
 	cpkt->delta += code;
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	cpkt->opt_indexed = false;
+#endif
+
 	return 0;
 }
 
@@ -545,6 +549,97 @@ static int parse_option(uint8_t *data, uint16_t offset, uint16_t *pos,
 	return r;
 }
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+/* Option numbers with a presence bit in coap_packet::opt_present */
+#define OPTION_INDEX_BITS 64U
+
+static bool option_index_add(struct coap_packet *cpkt, uint16_t code,
+			     uint16_t offset)
+{
+	struct coap_option_index_entry *entry;
+
+	if (cpkt->opt_index_len > 0U) {
+		entry = &cpkt->opt_index[cpkt->opt_index_len - 1U];
+		if (entry->code == code) {
+			if (entry->count == UINT8_MAX) {
+				return false;
+			}
+
+			entry->count++;
+			return true;
+		}
+	}
+
+	if (cpkt->opt_index_len == ARRAY_SIZE(cpkt->opt_index)) {
+		return false;
+	}
+
+	entry = &cpkt->opt_index[cpkt->opt_index_len++];
+	entry->code = code;
+	entry->offset = offset;
+	entry->count = 1U;
+
+	if (code < OPTION_INDEX_BITS) {
+		cpkt->opt_present |= BIT64(code);
+	}
+
+	return true;
+}
+
+static int option_index_find(const struct coap_packet *cpkt, uint16_t code,
+			     struct coap_option *options, uint16_t veclen)
+{
+	const struct coap_option_index_entry *entry;
+	uint16_t opt_len;
+	uint16_t offset;
+	uint16_t delta;
+	uint64_t below;
+	uint16_t num;
+	uint8_t i;
+	int r;
+
+	/* Entries are in option number order, one per option number present,
+	 * so the entry of a small option number is found by counting the
+	 * lower option numbers present.
+	 */
+	if (code < OPTION_INDEX_BITS) {
+		if (!(cpkt->opt_present & BIT64(code))) {
+			return 0;
+		}
+
+		below = cpkt->opt_present & (BIT64(code) - 1U);
+	} else {
+		below = cpkt->opt_present;
+	}
+
+	i = popcount((uint32_t)below) + popcount((uint32_t)(below >> 32));
+
+	while (i < cpkt->opt_index_len && cpkt->opt_index[i].code < code) {
+		i++;
+	}
+
+	if (i == cpkt->opt_index_len || cpkt->opt_index[i].code != code) {
+		return 0;
+	}
+
+	entry = &cpkt->opt_index[i];
+	offset = entry->offset;
+	opt_len = 0U;
+	/* Option deltas are relative to the previous option number */
+	delta = i > 0U ? cpkt->opt_index[i - 1U].code : 0U;
+
+	for (num = 0U; num < entry->count && num < veclen; num++) {
+		r = parse_option(cpkt->data, offset, &offset, cpkt->max_len,
+				 &delta, &opt_len, &options[num]);
+		if (r < 0) {
+			return -EINVAL;
+		}
+	}
+
+	return num;
+}
+#endif /* CONFIG_COAP_OPTION_INDEX */
+
 int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 		      struct coap_option *options, uint8_t opt_num)
 {
@@ -554,6 +649,9 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 	uint8_t num;
 	uint8_t tkl;
 	int ret;
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	bool indexed = true;
+#endif
 
 	if (!cpkt || !data) {
 		return -EINVAL;
@@ -573,6 +671,11 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 	cpkt->opt_len = 0U;
 	cpkt->hdr_len = 0U;
 	cpkt->delta = 0U;
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	cpkt->opt_present = 0U;
+	cpkt->opt_index_len = 0U;
+	cpkt->opt_indexed = false;
+#endif
 
 	/* Token lengths 9-15 are reserved. */
 	tkl = cpkt->data[0] & 0x0f;
@@ -586,6 +689,9 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 	}
 
 	if (cpkt->hdr_len == len) {
+#if defined(CONFIG_COAP_OPTION_INDEX)
+		cpkt->opt_indexed = true;
+#endif
 		return 0;
 	}
 
@@ -596,19 +702,35 @@ int coap_packet_parse(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
 
 	while (1) {
 		struct coap_option *option;
+#if defined(CONFIG_COAP_OPTION_INDEX)
+		uint16_t start = offset;
+		uint16_t prev_len = opt_len;
+#endif
 
 		option = num < opt_num ? &options[num++] : NULL;
 		ret = parse_option(cpkt->data, offset, &offset, cpkt->max_len,
 				   &delta, &opt_len, option);
 		if (ret < 0) {
 			return ret;
-		} else if (ret == 0) {
+		}
+
+#if defined(CONFIG_COAP_OPTION_INDEX)
+		/* The payload marker does not add to the options length */
+		if (indexed && opt_len != prev_len) {
+			indexed = option_index_add(cpkt, delta, start);
+		}
+#endif
+
+		if (ret == 0) {
 			break;
 		}
 	}
 
 	cpkt->opt_len = opt_len;
 	cpkt->delta = delta;
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	cpkt->opt_indexed = indexed;
+#endif
 
 	return 0;
 }
@@ -627,6 +749,12 @@ int coap_find_options(const struct coap_packet *cpkt, uint16_t code,
 		return 0;
 	}
 
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	if (cpkt->opt_indexed) {
+		return option_index_find(cpkt, code, options, veclen);
+	}
+#endif
+
 	offset = cpkt->hdr_len;
 	opt_len = 0U;
 	delta = 0U;
@@ -883,6 +1011,226 @@ int coap_handle_request(struct coap_packet *cpkt,
 	return -ENOENT;
 }
 
+#if defined(CONFIG_COAP_RESOURCE_INDEX)
+static uint32_t index_slot(const struct coap_resource_index *index,
+			   uint16_t parent, const char *segment, uint16_t len)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261U ^ parent;
+
+	for (uint16_t i = 0U; i < len; i++) {
+		hash = (hash ^ (uint8_t)segment[i]) * 16777619U;
+	}
+
+	return hash % (2U * index->max_nodes);
+}
+
+static uint16_t index_find_child(const struct coap_resource_index *index,
+				 uint16_t parent, const char *segment,
+				 uint16_t len)
+{
+	uint32_t slot = index_slot(index, parent, segment, len);
+	const struct coap_resource_index_node *node;
+
+	/* The table is at most half full, there is always an empty slot */
+	while (index->slots[slot] != 0U) {
+		node = &index->nodes[index->slots[slot]];
+		if ((node->parent == parent) && (node->len == len) &&
+		    !memcmp(node->segment, segment, len)) {
+			return index->slots[slot];
+		}
+
+		slot = (slot + 1U) % (2U * index->max_nodes);
+	}
+
+	return 0U;
+}
+
+static uint16_t index_add_node(struct coap_resource_index *index,
+			       uint16_t parent, const char *segment,
+			       uint16_t len)
+{
+	struct coap_resource_index_node *node;
+
+	if (index->num_nodes >= index->max_nodes) {
+		return 0U;
+	}
+
+	node = &index->nodes[index->num_nodes];
+	memset(node, 0, sizeof(*node));
+	node->segment = segment;
+	node->len = len;
+	node->parent = parent;
+
+	return index->num_nodes++;
+}
+
+static void index_insert_child(struct coap_resource_index *index,
+			       uint16_t child)
+{
+	const struct coap_resource_index_node *node = &index->nodes[child];
+	uint32_t slot = index_slot(index, node->parent, node->segment, node->len);
+
+	while (index->slots[slot] != 0U) {
+		slot = (slot + 1U) % (2U * index->max_nodes);
+	}
+
+	index->slots[slot] = child;
+}
+
+int coap_resource_index_init(struct coap_resource_index *index,
+			     struct coap_resource *resources)
+{
+	struct coap_resource *resource;
+
+	if (index->max_nodes == 0U) {
+		return -ENOMEM;
+	}
+
+	memset(index->slots, 0, 2U * index->max_nodes * sizeof(index->slots[0]));
+
+	/* Root node, for resources without path segments */
+	memset(&index->nodes[0], 0, sizeof(index->nodes[0]));
+	index->num_nodes = 1U;
+
+	for (resource = resources; resource && resource->path; resource++) {
+		uint16_t node = 0U;
+		uint16_t child;
+
+		for (size_t i = 0; resource->path[i]; i++) {
+			const char *segment = resource->path[i];
+			uint16_t len = strlen(segment);
+			uint16_t *wildcard = NULL;
+
+#if defined(CONFIG_COAP_URI_WILDCARD)
+			if (len == 1U && *segment == '+') {
+				wildcard = &index->nodes[node].single_wildcard;
+			} else if (len == 1U && *segment == '#') {
+				wildcard = &index->nodes[node].multi_wildcard;
+			}
+#endif
+
+			child = wildcard ? *wildcard :
+				index_find_child(index, node, segment, len);
+			if (child == 0U) {
+				child = index_add_node(index, node, segment, len);
+				if (child == 0U) {
+					NET_ERR("Too many nodes for %p", index);
+					return -ENOMEM;
+				}
+
+				if (wildcard) {
+					*wildcard = child;
+				} else {
+					index_insert_child(index, child);
+				}
+			}
+
+			node = child;
+
+			/* Segments following a multi-level wildcard are ignored */
+			if (IS_ENABLED(CONFIG_COAP_URI_WILDCARD) && len == 1U &&
+			    *segment == '#') {
+				break;
+			}
+		}
+
+		/* When several resources have the same path, the first one
+		 * is used.
+		 */
+		if (index->nodes[node].resource == NULL) {
+			index->nodes[node].resource = resource;
+		}
+	}
+
+	return 0;
+}
+
+static struct coap_resource *first_resource(struct coap_resource *a,
+					    struct coap_resource *b)
+{
+	if (a == NULL || (b != NULL && b < a)) {
+		return b;
+	}
+
+	return a;
+}
+
+/* Find the first resource matching the URI path options from i on, below
+ * the given node. Both a literal and a wildcard child may match, in which
+ * case the resource coming first in the array is returned.
+ */
+static struct coap_resource *index_match(const struct coap_resource_index *index,
+					 uint16_t node,
+					 const struct coap_option *options,
+					 uint8_t opt_num, uint8_t i)
+{
+	const struct coap_resource_index_node *n = &index->nodes[node];
+	struct coap_resource *found = NULL;
+	uint16_t child;
+
+	while (i < opt_num && options[i].delta != COAP_OPTION_URI_PATH) {
+		i++;
+	}
+
+	if (i == opt_num) {
+		return n->resource;
+	}
+
+#if defined(CONFIG_COAP_URI_WILDCARD)
+	if (n->multi_wildcard) {
+		found = index->nodes[n->multi_wildcard].resource;
+	}
+
+	if (n->single_wildcard) {
+		found = first_resource(found,
+				       index_match(index, n->single_wildcard,
+						   options, opt_num, i + 1));
+	}
+#endif
+
+	child = index_find_child(index, node, (const char *)options[i].value,
+				 options[i].len);
+	if (child) {
+		found = first_resource(found,
+				       index_match(index, child, options,
+						   opt_num, i + 1));
+	}
+
+	return found;
+}
+
+int coap_handle_request_index(struct coap_packet *cpkt,
+			      const struct coap_resource_index *index,
+			      struct coap_option *options,
+			      uint8_t opt_num,
+			      struct sockaddr *addr, socklen_t addr_len)
+{
+	struct coap_resource *resource;
+	coap_method_t method;
+
+	if (!is_request(cpkt)) {
+		return 0;
+	}
+
+	if (index->num_nodes == 0U) {
+		return -ENOENT;
+	}
+
+	resource = index_match(index, 0U, options, opt_num, 0U);
+	if (!resource) {
+		return -ENOENT;
+	}
+
+	method = method_from_code(resource, coap_header_get_code(cpkt));
+	if (!method) {
+		return -EPERM;
+	}
+
+	return method(resource, cpkt, addr, addr_len);
+}
+#endif /* CONFIG_COAP_RESOURCE_INDEX */
+
 int coap_block_transfer_init(struct coap_block_context *ctx,
 			      enum coap_block_size block_size,
 			      size_t total_size)
@@ -1307,6 +1655,19 @@ static inline bool is_newer(int v1, int v2)
 	    || (v1 > v2 && v1 - v2 > (1 << 23));
 }
 
+static void reply_handle(const struct coap_packet *response,
+			 const struct sockaddr *from, struct coap_reply *r)
+{
+	int age;
+
+	age = coap_get_option_int(response, COAP_OPTION_OBSERVE);
+	/* handle observed requests only if received in order */
+	if (age == -ENOENT || is_newer(r->age, age)) {
+		r->age = age;
+		r->reply(response, r, from);
+	}
+}
+
 struct coap_reply *coap_response_received(
 	const struct coap_packet *response,
 	const struct sockaddr *from,
@@ -1322,8 +1683,6 @@ struct coap_reply *coap_response_received(
 	tkl = coap_header_get_token(response, token);
 
 	for (i = 0, r = replies; i < len; i++, r++) {
-		int age;
-
 		if ((r->id == 0U) && (r->tkl == 0U)) {
 			continue;
 		}
@@ -1337,12 +1696,7 @@ struct coap_reply *coap_response_received(
 			continue;
 		}
 
-		age = coap_get_option_int(response, COAP_OPTION_OBSERVE);
-		/* handle observed requests only if received in order */
-		if (age == -ENOENT || is_newer(r->age, age)) {
-			r->age = age;
-			r->reply(response, r, from);
-		}
+		reply_handle(response, from, r);
 
 		return r;
 	}
@@ -1384,6 +1738,288 @@ void coap_replies_clear(struct coap_reply *replies, size_t len)
 	}
 }
 
+#if defined(CONFIG_COAP_EXCHANGE_INDEX)
+/* Hash of a token, or of the message ID when the token is empty */
+static uint16_t exchange_bucket(const uint8_t *token, uint8_t tkl, uint16_t id,
+				uint16_t max)
+{
+	/* FNV-1a */
+	uint32_t hash = 2166136261U;
+
+	if (tkl == 0U) {
+		return id % max;
+	}
+
+	for (uint8_t i = 0U; i < tkl; i++) {
+		hash = (hash ^ token[i]) * 16777619U;
+	}
+
+	return hash % max;
+}
+
+/* Remove entry from the hash chain starting at head */
+static void exchange_unlink(uint16_t *head, uint16_t *next, uint16_t entry)
+{
+	uint16_t *link = head;
+
+	while (*link != 0U) {
+		if (*link == entry + 1U) {
+			*link = next[entry];
+			return;
+		}
+
+		link = &next[*link - 1U];
+	}
+}
+
+static uint32_t pending_expiry(const struct coap_pending_index *index,
+			       uint16_t pos)
+{
+	const struct coap_pending *p = &index->pendings[index->heap[pos]];
+
+	return p->t0 + p->timeout;
+}
+
+static bool pending_heap_less(const struct coap_pending_index *index,
+			      uint16_t a, uint16_t b)
+{
+	return (int32_t)(pending_expiry(index, a) -
+			 pending_expiry(index, b)) < 0;
+}
+
+static void pending_heap_swap(struct coap_pending_index *index, uint16_t a,
+			      uint16_t b)
+{
+	uint16_t entry = index->heap[a];
+
+	index->heap[a] = index->heap[b];
+	index->heap[b] = entry;
+	index->heap_pos[index->heap[a]] = a + 1U;
+	index->heap_pos[index->heap[b]] = b + 1U;
+}
+
+/* Move the pending at pos to its place in the heap */
+static void pending_heap_fix(struct coap_pending_index *index, uint16_t pos)
+{
+	uint16_t child;
+
+	while (pos > 0U && pending_heap_less(index, pos, (pos - 1U) / 2U)) {
+		pending_heap_swap(index, pos, (pos - 1U) / 2U);
+		pos = (pos - 1U) / 2U;
+	}
+
+	while ((child = 2U * pos + 1U) < index->heap_len) {
+		if (child + 1U < index->heap_len &&
+		    pending_heap_less(index, child + 1U, child)) {
+			child++;
+		}
+
+		if (!pending_heap_less(index, child, pos)) {
+			break;
+		}
+
+		pending_heap_swap(index, pos, child);
+		pos = child;
+	}
+}
+
+static void pending_heap_insert(struct coap_pending_index *index,
+				uint16_t entry)
+{
+	index->heap[index->heap_len] = entry;
+	index->heap_pos[entry] = ++index->heap_len;
+	pending_heap_fix(index, index->heap_len - 1U);
+}
+
+static void pending_heap_remove(struct coap_pending_index *index,
+				uint16_t entry)
+{
+	uint16_t pos = index->heap_pos[entry] - 1U;
+
+	index->heap_pos[entry] = 0U;
+	if (--index->heap_len == pos) {
+		return;
+	}
+
+	index->heap[pos] = index->heap[index->heap_len];
+	index->heap_pos[index->heap[pos]] = pos + 1U;
+	pending_heap_fix(index, pos);
+}
+
+static int pending_entry(const struct coap_pending_index *index,
+			 const struct coap_pending *pending)
+{
+	if (pending < index->pendings || pending >= index->pendings + index->max) {
+		return -EINVAL;
+	}
+
+	return pending - index->pendings;
+}
+
+int coap_pending_index_add(struct coap_pending_index *index,
+			   struct coap_pending *pending)
+{
+	int entry = pending_entry(index, pending);
+	uint16_t *head;
+
+	if (entry < 0) {
+		return entry;
+	}
+
+	head = &index->buckets[pending->id % index->max];
+	index->next[entry] = *head;
+	*head = entry + 1U;
+
+	if (pending->timeout) {
+		pending_heap_insert(index, entry);
+	}
+
+	return 0;
+}
+
+bool coap_pending_index_cycle(struct coap_pending_index *index,
+			      struct coap_pending *pending)
+{
+	uint16_t entry = pending - index->pendings;
+
+	if (!coap_pending_cycle(pending)) {
+		return false;
+	}
+
+	if (index->heap_pos[entry]) {
+		pending_heap_fix(index, index->heap_pos[entry] - 1U);
+	} else {
+		pending_heap_insert(index, entry);
+	}
+
+	return true;
+}
+
+void coap_pending_index_clear(struct coap_pending_index *index,
+			      struct coap_pending *pending)
+{
+	uint16_t entry = pending - index->pendings;
+
+	exchange_unlink(&index->buckets[pending->id % index->max], index->next,
+			entry);
+
+	if (index->heap_pos[entry]) {
+		pending_heap_remove(index, entry);
+	}
+
+	coap_pending_clear(pending);
+}
+
+void coap_pending_index_clear_all(struct coap_pending_index *index)
+{
+	coap_pendings_clear(index->pendings, index->max);
+	memset(index->buckets, 0, index->max * sizeof(index->buckets[0]));
+	memset(index->heap_pos, 0, index->max * sizeof(index->heap_pos[0]));
+	index->heap_len = 0U;
+}
+
+struct coap_pending *coap_pending_received_index(
+	const struct coap_packet *response,
+	const struct coap_pending_index *index)
+{
+	uint16_t resp_id = coap_header_get_id(response);
+	uint16_t entry = index->buckets[resp_id % index->max];
+	struct coap_pending *p;
+
+	for (; entry != 0U; entry = index->next[entry - 1U]) {
+		p = &index->pendings[entry - 1U];
+		if (p->timeout && p->id == resp_id) {
+			return p;
+		}
+	}
+
+	return NULL;
+}
+
+struct coap_pending *coap_pending_next_to_expire_index(
+	const struct coap_pending_index *index)
+{
+	if (index->heap_len == 0U) {
+		return NULL;
+	}
+
+	return &index->pendings[index->heap[0]];
+}
+
+static uint16_t *reply_bucket(const struct coap_reply_index *index,
+			      const struct coap_reply *reply)
+{
+	return &index->buckets[exchange_bucket(reply->token, reply->tkl,
+					       reply->id, index->max)];
+}
+
+int coap_reply_index_add(struct coap_reply_index *index,
+			 struct coap_reply *reply)
+{
+	uint16_t *head;
+	int entry;
+
+	if (reply < index->replies || reply >= index->replies + index->max) {
+		return -EINVAL;
+	}
+
+	entry = reply - index->replies;
+	head = reply_bucket(index, reply);
+	index->next[entry] = *head;
+	*head = entry + 1U;
+
+	return 0;
+}
+
+void coap_reply_index_clear(struct coap_reply_index *index,
+			    struct coap_reply *reply)
+{
+	exchange_unlink(reply_bucket(index, reply), index->next,
+			reply - index->replies);
+	coap_reply_clear(reply);
+}
+
+void coap_reply_index_clear_all(struct coap_reply_index *index)
+{
+	coap_replies_clear(index->replies, index->max);
+	memset(index->buckets, 0, index->max * sizeof(index->buckets[0]));
+}
+
+struct coap_reply *coap_response_received_index(
+	const struct coap_packet *response,
+	const struct sockaddr *from,
+	const struct coap_reply_index *index)
+{
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	struct coap_reply *r;
+	uint16_t entry;
+	uint16_t id;
+	uint8_t tkl;
+
+	id = coap_header_get_id(response);
+	tkl = coap_header_get_token(response, token);
+
+	entry = index->buckets[exchange_bucket(token, tkl, id, index->max)];
+	for (; entry != 0U; entry = index->next[entry - 1U]) {
+		r = &index->replies[entry - 1U];
+
+		if (r->tkl != tkl) {
+			continue;
+		}
+
+		if ((tkl == 0U) ? (r->id != id) : memcmp(r->token, token, tkl)) {
+			continue;
+		}
+
+		reply_handle(response, from, r);
+
+		return r;
+	}
+
+	return NULL;
+}
+#endif /* CONFIG_COAP_EXCHANGE_INDEX */
+
 int coap_resource_notify(struct coap_resource *resource)
 {
 	struct coap_observer *o;
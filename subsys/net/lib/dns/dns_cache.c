@@ -0,0 +1,207 @@
+/** @file
+ * @brief DNS resolver cache
+ *
+ * Answers of the DNS resolver, kept until their TTL expires.
+ */
+
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(net_dns_resolve, CONFIG_DNS_RESOLVER_LOG_LEVEL);
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <strings.h>
+
+#include <zephyr/net/dns_resolve.h>
+#include "dns_internal.h"
+
+struct dns_cache_entry {
+	/** Resolved name, empty if the entry is free */
+	char query[CONFIG_DNS_RESOLVER_CACHE_MAX_NAME_LEN + 1];
+
+	/** Addresses of the name, none for a negative entry */
+	struct sockaddr addr[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+
+	/** Uptime in ms at which the entry expires */
+	int64_t expiry;
+
+	/** Value of cache_seq when the entry was last used */
+	uint32_t last_used;
+
+	/** Final status of the resolution */
+	int status;
+
+	/** Query type */
+	enum dns_query_type type;
+
+	/** Number of addresses */
+	uint8_t num_addrs;
+};
+
+static struct dns_cache_entry cache[CONFIG_DNS_RESOLVER_CACHE_MAX_ENTRIES];
+static struct dns_resolve_cache_stats cache_stats;
+static uint32_t cache_seq;
+
+static K_MUTEX_DEFINE(cache_lock);
+
+static bool entry_is_free(const struct dns_cache_entry *entry)
+{
+	return entry->query[0] == '\0';
+}
+
+static bool entry_is_expired(const struct dns_cache_entry *entry, int64_t now)
+{
+	return entry->expiry <= now;
+}
+
+/* Must be invoked with cache lock held */
+static struct dns_cache_entry *entry_find(const char *query,
+					  enum dns_query_type type)
+{
+	for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (!entry_is_free(&cache[i]) && cache[i].type == type &&
+		    strncasecmp(cache[i].query, query,
+				sizeof(cache[i].query)) == 0) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Must be invoked with cache lock held */
+static struct dns_cache_entry *entry_alloc(int64_t now)
+{
+	struct dns_cache_entry *lru = &cache[0];
+
+	for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (entry_is_free(&cache[i]) ||
+		    entry_is_expired(&cache[i], now)) {
+			return &cache[i];
+		}
+
+		if ((int32_t)(cache[i].last_used - lru->last_used) < 0) {
+			lru = &cache[i];
+		}
+	}
+
+	NET_DBG("Evicting %s from cache", lru->query);
+	cache_stats.evictions++;
+
+	return lru;
+}
+
+bool dns_cache_find(const char *query, enum dns_query_type type,
+		    struct sockaddr *addrs, int *num_addrs, int *status)
+{
+	struct dns_cache_entry *entry;
+	bool found = false;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	entry = entry_find(query, type);
+	if (entry && entry_is_expired(entry, k_uptime_get())) {
+		entry->query[0] = '\0';
+		entry = NULL;
+	}
+
+	if (entry) {
+		memcpy(addrs, entry->addr, entry->num_addrs * sizeof(addrs[0]));
+		*num_addrs = entry->num_addrs;
+		*status = entry->status;
+
+		entry->last_used = ++cache_seq;
+		cache_stats.hits++;
+		found = true;
+	} else {
+		cache_stats.misses++;
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	return found;
+}
+
+void dns_cache_add(const char *query, enum dns_query_type type,
+		   const struct sockaddr *addrs, int num_addrs, int status,
+		   uint32_t ttl)
+{
+	struct dns_cache_entry *entry;
+	int64_t now;
+
+	if (ttl == 0U || strlen(query) >= sizeof(entry->query)) {
+		return;
+	}
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	now = k_uptime_get();
+
+	entry = entry_find(query, type);
+	if (!entry) {
+		entry = entry_alloc(now);
+		strcpy(entry->query, query);
+		entry->type = type;
+	}
+
+	num_addrs = MIN(num_addrs, ARRAY_SIZE(entry->addr));
+	if (num_addrs > 0) {
+		memcpy(entry->addr, addrs, num_addrs * sizeof(addrs[0]));
+	}
+
+	entry->num_addrs = num_addrs;
+	entry->status = status;
+	entry->expiry = now + (int64_t)ttl * MSEC_PER_SEC;
+	entry->last_used = ++cache_seq;
+
+	NET_DBG("Caching %s type %d (%d addresses) for %u s", query, type,
+		num_addrs, ttl);
+
+	k_mutex_unlock(&cache_lock);
+}
+
+void dns_resolve_cache_foreach(dns_resolve_cache_cb_t cb, void *user_data)
+{
+	int64_t now;
+
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	now = k_uptime_get();
+
+	for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (entry_is_free(&cache[i]) ||
+		    entry_is_expired(&cache[i], now)) {
+			continue;
+		}
+
+		cb(cache[i].query, cache[i].type, cache[i].status,
+		   cache[i].addr, cache[i].num_addrs,
+		   (uint32_t)((cache[i].expiry - now) / MSEC_PER_SEC),
+		   user_data);
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
+
+void dns_resolve_cache_flush(void)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	for (int i = 0; i < ARRAY_SIZE(cache); i++) {
+		cache[i].query[0] = '\0';
+	}
+
+	k_mutex_unlock(&cache_lock);
+}
+
+void dns_resolve_cache_stats_get(struct dns_resolve_cache_stats *stats)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+	*stats = cache_stats;
+	k_mutex_unlock(&cache_lock);
+}
@@ -18,3 +18,17 @@ int dns_validate_msg(struct dns_resolve_context *ctx,
 		     struct net_buf *dns_cname,
 		     uint16_t *query_hash);
 #endif
+
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Get the cached result of resolving a name. Returns false if the result
+ * is not cached, otherwise the addresses, possibly none, and the final
+ * status that the resolution returned.
+ */
+bool dns_cache_find(const char *query, enum dns_query_type type,
+		    struct sockaddr *addrs, int *num_addrs, int *status);
+
+/* Cache the result of resolving a name for ttl seconds */
+void dns_cache_add(const char *query, enum dns_query_type type,
+		   const struct sockaddr *addrs, int num_addrs, int status,
+		   uint32_t ttl);
+#endif
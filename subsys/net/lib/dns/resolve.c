@@ -460,6 +460,87 @@ static inline int get_slot_by_id(struct dns_resolve_context *ctx,
 	return -ENOENT;
 }
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+/* Must be invoked with context lock held */
+static void cache_collect(struct dns_pending_query *pending_query,
+			  const struct dns_addrinfo *info, uint32_t ttl)
+{
+	if (pending_query->cache_num_addrs == 0U ||
+	    ttl < pending_query->cache_ttl) {
+		pending_query->cache_ttl = ttl;
+	}
+
+	if (pending_query->cache_num_addrs <
+	    ARRAY_SIZE(pending_query->cache_addr)) {
+		pending_query->cache_addr[pending_query->cache_num_addrs++] =
+			info->ai_addr;
+	}
+}
+
+/* Cache the final status of a query, with the response it was derived
+ * from if any.
+ *
+ * Must be invoked with context lock held.
+ */
+static void cache_result(struct dns_pending_query *pending_query, int status,
+			 uint8_t *msg)
+{
+	if (pending_query->query == NULL) {
+		return;
+	}
+
+	if (status == DNS_EAI_ALLDONE && pending_query->cache_num_addrs > 0U) {
+		dns_cache_add(pending_query->query, pending_query->query_type,
+			      pending_query->cache_addr,
+			      pending_query->cache_num_addrs, status,
+			      pending_query->cache_ttl);
+		return;
+	}
+
+	/* The name does not exist, or has no record of the queried type */
+	if ((status == DNS_EAI_NODATA || status == DNS_EAI_FAIL) && msg &&
+	    dns_header_qr(msg) == DNS_RESPONSE &&
+	    (dns_header_rcode(msg) == DNS_HEADER_NAMEERROR ||
+	     (dns_header_rcode(msg) == DNS_HEADER_NOERROR &&
+	      dns_header_ancount(msg) == 0))) {
+		dns_cache_add(pending_query->query, pending_query->query_type,
+			      NULL, 0, status,
+			      CONFIG_DNS_RESOLVER_CACHE_NEGATIVE_TTL);
+	}
+}
+
+static bool resolve_from_cache(const char *query, enum dns_query_type type,
+			       dns_resolve_cb_t cb, void *user_data)
+{
+	struct sockaddr addrs[CONFIG_DNS_RESOLVER_AI_MAX_ENTRIES];
+	int num_addrs;
+	int status;
+	int i;
+
+	if (!dns_cache_find(query, type, addrs, &num_addrs, &status)) {
+		return false;
+	}
+
+	for (i = 0; i < num_addrs; i++) {
+		struct dns_addrinfo info = { 0 };
+
+		info.ai_addr = addrs[i];
+		info.ai_family = addrs[i].sa_family;
+		if (info.ai_family == AF_INET6) {
+			info.ai_addrlen = sizeof(struct sockaddr_in6);
+		} else {
+			info.ai_addrlen = sizeof(struct sockaddr_in);
+		}
+
+		cb(DNS_EAI_INPROGRESS, &info, user_data);
+	}
+
+	cb(status, NULL, user_data);
+
+	return true;
+}
+#endif /* CONFIG_DNS_RESOLVER_CACHE */
+
 /* Unit test needs to be able to call this function */
 #if !defined(CONFIG_NET_TEST)
 static
@@ -633,6 +714,10 @@ query_known:
 			src = dns_msg->msg + dns_msg->response_position;
 			memcpy(addr, src, address_size);
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+			cache_collect(&ctx->queries[*query_idx], &info, ttl);
+#endif
+
 			invoke_query_callback(DNS_EAI_INPROGRESS, &info,
 					      &ctx->queries[*query_idx]);
 			items++;
@@ -736,6 +821,7 @@ static int dns_read(struct dns_resolve_context *ctx,
 
 	dns_msg.msg = dns_data->data;
 	dns_msg.msg_size = data_len;
+	dns_msg.response_type = DNS_RESPONSE_INVALID;
 
 	ret = dns_validate_msg(ctx, &dns_msg, dns_id, &query_idx,
 			       dns_cname, query_hash);
@@ -852,6 +938,10 @@ quit:
 		goto free_buf;
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	cache_result(&ctx->queries[i], ret, dns_data ? dns_data->data : NULL);
+#endif
+
 	invoke_query_callback(ret, NULL, &ctx->queries[i]);
 
 	/* Marks the end of the results */
@@ -1188,6 +1278,18 @@ try_resolve:
 		goto fail;
 	}
 
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	if (resolve_from_cache(query, type, cb, user_data)) {
+		if (dns_id) {
+			*dns_id = 0U;
+		}
+
+		k_mutex_unlock(&ctx->lock);
+
+		return 0;
+	}
+#endif
+
 	i = get_cb_slot(ctx);
 	if (i < 0) {
 		ret = -EAGAIN;
@@ -1201,6 +1303,9 @@ try_resolve:
 	ctx->queries[i].user_data = user_data;
 	ctx->queries[i].ctx = ctx;
 	ctx->queries[i].query_hash = 0;
+#if defined(CONFIG_DNS_RESOLVER_CACHE)
+	ctx->queries[i].cache_num_addrs = 0U;
+#endif
 
 	k_work_init_delayable(&ctx->queries[i].timer, query_timeout);
 
@@ -1413,6 +1518,11 @@ int dns_resolve_reconfigure(struct dns_resolve_context *ctx,
 
 	err = dns_resolve_init_locked(ctx, servers, servers_sa);
 
+	/* Answers from the previous servers are no longer relevant */
+	if (IS_ENABLED(CONFIG_DNS_RESOLVER_CACHE)) {
+		dns_resolve_cache_flush();
+	}
+
 unlock:
 	k_mutex_unlock(&ctx->lock);
 
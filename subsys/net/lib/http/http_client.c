@@ -45,6 +45,38 @@ static int sendall(int sock, const void *buf, size_t len)
 	return 0;
 }
 
+static int sendmsg_all(int sock, struct iovec *iov, size_t iovlen)
+{
+	struct msghdr msg = {
+		.msg_iov = iov,
+		.msg_iovlen = iovlen,
+	};
+
+	while (msg.msg_iovlen > 0) {
+		ssize_t out_len = zsock_sendmsg(sock, &msg, 0);
+
+		if (out_len < 0) {
+			return -errno;
+		}
+
+		/* Skip what was sent */
+		while (msg.msg_iovlen > 0 &&
+		       out_len >= msg.msg_iov->iov_len) {
+			out_len -= msg.msg_iov->iov_len;
+			msg.msg_iov++;
+			msg.msg_iovlen--;
+		}
+
+		if (out_len > 0) {
+			msg.msg_iov->iov_base =
+				(uint8_t *)msg.msg_iov->iov_base + out_len;
+			msg.msg_iov->iov_len -= out_len;
+		}
+	}
+
+	return 0;
+}
+
 static int http_send_data(int sock, char *send_buf,
 			  size_t send_buf_max_len, size_t *send_buf_pos,
 			  ...)
@@ -272,6 +304,17 @@ static int on_body(struct http_parser *parser, const char *at, size_t length)
 		req->internal.response.http_cb->on_body(parser, at, length);
 	}
 
+	if (req->body_cb) {
+		int ret = req->body_cb(&req->internal.response,
+				       (const uint8_t *)at, length,
+				       req->internal.user_data);
+		if (ret < 0) {
+			NET_DBG("Body callback failed (%d)", ret);
+			req->internal.body_err = ret;
+			return 1;
+		}
+	}
+
 	/* Reset the body_frag_start pointer for each fragment. */
 	if (!req->internal.response.body_frag_start) {
 		req->internal.response.body_frag_start = (uint8_t *)at;
@@ -295,7 +338,9 @@ static int on_headers_complete(struct http_parser *parser)
 		req->internal.response.http_cb->on_headers_complete(parser);
 	}
 
-	if (parser->status_code >= 500 && parser->status_code < 600) {
+	/* In a session, the body must be read to find the next response */
+	if (parser->status_code >= 500 && parser->status_code < 600 &&
+	    req->internal.session == NULL) {
 		NET_DBG("Status %d, skipping body", parser->status_code);
 		return 1;
 	}
@@ -344,6 +389,9 @@ static int on_message_complete(struct http_parser *parser)
 
 	req->internal.response.message_complete = 1;
 
+	/* Stop before the next response, if already received */
+	http_parser_pause(parser, 1);
+
 	return 0;
 }
 
@@ -392,55 +440,102 @@ static void http_client_init_parser(struct http_parser *parser,
 	settings->on_url = on_url;
 }
 
-static int http_wait_data(int sock, struct http_request *req)
+static void http_report_null_response(struct http_request *req)
+{
+	if (req->internal.response.cb == NULL) {
+		return;
+	}
+
+	NET_DBG("Calling callback for closed connection "
+		"(NULL HTTP response)");
+
+	/* Status code 0 representing a null response */
+	req->internal.response.http_status_code = 0;
+
+	/* Zero out related response metrics */
+	req->internal.response.processed = 0;
+	req->internal.response.data_len = 0;
+	req->internal.response.content_length = 0;
+	req->internal.response.body_frag_start = NULL;
+	memset(req->internal.response.http_status, 0, HTTP_STATUS_STR_SIZE);
+
+	req->internal.response.cb(&req->internal.response, HTTP_DATA_FINAL,
+				  req->internal.user_data);
+}
+
+/* The response is parsed from the bytes already in the receive buffer, if
+ * pending is not zero, then from the socket. When the response is complete,
+ * the bytes received after it are moved to the start of the buffer and
+ * their number is returned in pending.
+ */
+static int http_wait_data(int sock, struct http_request *req, size_t *pending)
 {
 	int total_received = 0;
 	size_t offset = 0;
+	size_t next = 0;
 	int received, ret;
 
 	do {
-		received = zsock_recv(sock, req->internal.response.recv_buf + offset,
-				      req->internal.response.recv_buf_len - offset,
-				      0);
+		if (*pending > 0) {
+			received = *pending;
+			*pending = 0;
+		} else {
+			received = zsock_recv(sock,
+				req->internal.response.recv_buf + offset,
+				req->internal.response.recv_buf_len - offset,
+				0);
+		}
+
 		if (received == 0) {
 			/* Connection closed */
 			LOG_DBG("Connection closed");
 			ret = total_received;
 
-			if (req->internal.response.cb) {
-				NET_DBG("Calling callback for closed connection "
-					"(NULL HTTP response)");
-
-				/* Status code 0 representing a null response */
-				req->internal.response.http_status_code = 0;
-
-				/* Zero out related response metrics */
-				req->internal.response.processed = 0;
-				req->internal.response.data_len = 0;
-				req->internal.response.content_length = 0;
-				req->internal.response.body_frag_start = NULL;
-				memset(req->internal.response.http_status, 0,
-				       HTTP_STATUS_STR_SIZE);
-
-				req->internal.response.cb(&req->internal.response,
-							  HTTP_DATA_FINAL,
-							  req->internal.user_data);
+			/* The body may last until the connection is closed */
+			(void)http_parser_execute(&req->internal.parser,
+						  &req->internal.parser_settings,
+						  NULL, 0);
+			if (!req->internal.response.message_complete) {
+				http_report_null_response(req);
+				break;
 			}
-
-			break;
 		} else if (received < 0) {
 			/* Socket error */
 			LOG_DBG("Connection error (%d)", errno);
 			ret = -errno;
 			break;
 		} else {
+			size_t parsed;
+
 			req->internal.response.data_len += received;
 
-			(void)http_parser_execute(
+			parsed = http_parser_execute(
 				&req->internal.parser,
 				&req->internal.parser_settings,
 				req->internal.response.recv_buf + offset,
 				received);
+
+			if (req->internal.body_err < 0) {
+				ret = req->internal.body_err;
+				break;
+			}
+
+			if (HTTP_PARSER_ERRNO(&req->internal.parser) != HPE_OK &&
+			    HTTP_PARSER_ERRNO(&req->internal.parser) !=
+								HPE_PAUSED) {
+				NET_DBG("HTTP parser error %s",
+					http_errno_name(HTTP_PARSER_ERRNO(
+						&req->internal.parser)));
+				ret = -EBADMSG;
+				break;
+			}
+
+			/* Keep what belongs to the next response aside */
+			if (parsed < received) {
+				next = received - parsed;
+				received = parsed;
+				req->internal.response.data_len -= next;
+			}
 		}
 
 		total_received += received;
@@ -487,6 +582,12 @@ static int http_wait_data(int sock, struct http_request *req)
 
 	} while (true);
 
+	if (next > 0 && ret >= 0) {
+		memmove(req->internal.response.recv_buf,
+			req->internal.response.recv_buf + offset, next);
+		*pending = next;
+	}
+
 	return ret;
 }
 
@@ -499,32 +600,55 @@ static void http_timeout(struct k_work *work)
 	(void)zsock_shutdown(data->sock, ZSOCK_SHUT_RD);
 }
 
-int http_client_req(int sock, struct http_request *req,
-		    int32_t timeout, void *user_data)
+/* Send the body of a chunked request, each chunk with a single sendmsg() */
+static int http_send_chunks(int sock, struct http_request *req,
+			    void *user_data)
+{
+	char chunk_size[sizeof("ffffffff" HTTP_CRLF)];
+	struct iovec iov[3];
+	const uint8_t *data;
+	int total_sent = 0;
+	int len, ret;
+
+	do {
+		data = NULL;
+
+		len = req->chunk_cb(req, &data, user_data);
+		if (len < 0) {
+			return len;
+		}
+
+		/* The last chunk has no data, which ends the body */
+		iov[0].iov_base = chunk_size;
+		iov[0].iov_len = snprintk(chunk_size, sizeof(chunk_size),
+					  "%x" HTTP_CRLF, len);
+		iov[1].iov_base = (void *)data;
+		iov[1].iov_len = len;
+		iov[2].iov_base = (void *)HTTP_CRLF;
+		iov[2].iov_len = sizeof(HTTP_CRLF) - 1;
+
+		ret = sendmsg_all(sock, iov, ARRAY_SIZE(iov));
+		if (ret < 0) {
+			return ret;
+		}
+
+		total_sent += iov[0].iov_len + len + iov[2].iov_len;
+	} while (len > 0);
+
+	return total_sent;
+}
+
+static int http_send_request(int sock, struct http_request *req,
+			     void *user_data)
 {
 	/* Utilize the network usage by sending data in bigger blocks */
 	char send_buf[MAX_SEND_BUF_LEN];
 	const size_t send_buf_max_len = sizeof(send_buf);
 	size_t send_buf_pos = 0;
 	int total_sent = 0;
-	int ret, total_recv, i;
+	int ret, i;
 	const char *method;
 
-	if (sock < 0 || req == NULL || req->response == NULL ||
-	    req->recv_buf == NULL || req->recv_buf_len == 0) {
-		return -EINVAL;
-	}
-
-	memset(&req->internal.response, 0, sizeof(req->internal.response));
-
-	req->internal.response.http_cb = req->http_cb;
-	req->internal.response.cb = req->response;
-	req->internal.response.recv_buf = req->recv_buf;
-	req->internal.response.recv_buf_len = req->recv_buf_len;
-	req->internal.user_data = user_data;
-	req->internal.sock = sock;
-	req->internal.timeout = SYS_TIMEOUT_MS(timeout);
-
 	method = http_method_str(req->method);
 
 	ret = http_send_data(sock, send_buf, send_buf_max_len, &send_buf_pos,
@@ -609,7 +733,31 @@ int http_client_req(int sock, struct http_request *req,
 		total_sent += ret;
 	}
 
-	if (req->payload || req->payload_cb) {
+	if (req->chunk_cb) {
+		ret = http_send_data(sock, send_buf, send_buf_max_len,
+				     &send_buf_pos, "Transfer-Encoding", ": ",
+				     "chunked", HTTP_CRLF, HTTP_CRLF, NULL);
+		if (ret < 0) {
+			goto out;
+		}
+
+		total_sent += ret;
+
+		ret = http_flush_data(sock, send_buf, send_buf_pos);
+		if (ret < 0) {
+			goto out;
+		}
+
+		send_buf_pos = 0;
+		total_sent += ret;
+
+		ret = http_send_chunks(sock, req, user_data);
+		if (ret < 0) {
+			goto out;
+		}
+
+		total_sent += ret;
+	} else if (req->payload || req->payload_cb) {
 		if (req->payload_len) {
 			char content_len_str[HTTP_CONTENT_LEN_SIZE];
 
@@ -687,8 +835,35 @@ int http_client_req(int sock, struct http_request *req,
 
 	NET_DBG("Sent %d bytes", total_sent);
 
+	return total_sent;
+
+out:
+	return ret;
+}
+
+static void http_req_init(int sock, struct http_request *req,
+			  int32_t timeout, void *user_data)
+{
+	memset(&req->internal.response, 0, sizeof(req->internal.response));
+
+	req->internal.response.http_cb = req->http_cb;
+	req->internal.response.cb = req->response;
+	req->internal.response.recv_buf = req->recv_buf;
+	req->internal.response.recv_buf_len = req->recv_buf_len;
+	req->internal.user_data = user_data;
+	req->internal.sock = sock;
+	req->internal.timeout = SYS_TIMEOUT_MS(timeout);
+	req->internal.session = NULL;
+	req->internal.body_err = 0;
+
 	http_client_init_parser(&req->internal.parser,
 				&req->internal.parser_settings);
+}
+
+static int http_wait_response(int sock, struct http_request *req,
+			      size_t *pending)
+{
+	int total_recv;
 
 	if (!K_TIMEOUT_EQ(req->internal.timeout, K_FOREVER) &&
 	    !K_TIMEOUT_EQ(req->internal.timeout, K_NO_WAIT)) {
@@ -697,8 +872,7 @@ int http_client_req(int sock, struct http_request *req,
 					req->internal.timeout);
 	}
 
-	/* Request is sent, now wait data to be received */
-	total_recv = http_wait_data(sock, req);
+	total_recv = http_wait_data(sock, req, pending);
 	if (total_recv < 0) {
 		NET_DBG("Wait data failure (%d)", total_recv);
 	} else {
@@ -710,8 +884,232 @@ int http_client_req(int sock, struct http_request *req,
 		(void)k_work_cancel_delayable(&req->internal.work);
 	}
 
+	return total_recv;
+}
+
+int http_client_req(int sock, struct http_request *req,
+		    int32_t timeout, void *user_data)
+{
+	size_t pending = 0;
+	int total_sent;
+
+	if (sock < 0 || req == NULL || req->response == NULL ||
+	    req->recv_buf == NULL || req->recv_buf_len == 0) {
+		return -EINVAL;
+	}
+
+	http_req_init(sock, req, timeout, user_data);
+
+	total_sent = http_send_request(sock, req, user_data);
+	if (total_sent < 0) {
+		return total_sent;
+	}
+
+	/* Request is sent, now wait data to be received */
+	(void)http_wait_response(sock, req, &pending);
+
 	return total_sent;
+}
+
+void http_session_init(struct http_session *session)
+{
+	memset(session, 0, sizeof(*session));
+
+	session->sock = -1;
+}
+
+static int http_session_connect(struct http_session *session)
+{
+	int proto = IPPROTO_TCP;
+	int sock, ret;
+
+#if defined(CONFIG_NET_SOCKETS_SOCKOPT_TLS)
+	if (session->sec_tag_count > 0) {
+		proto = IPPROTO_TLS_1_2;
+	}
+#endif
+
+	sock = zsock_socket(session->addr->sa_family, SOCK_STREAM, proto);
+	if (sock < 0) {
+		return -errno;
+	}
+
+#if defined(CONFIG_NET_SOCKETS_SOCKOPT_TLS)
+	if (proto == IPPROTO_TLS_1_2) {
+		ret = zsock_setsockopt(sock, SOL_TLS, TLS_SEC_TAG_LIST,
+				       session->sec_tag_list,
+				       sizeof(sec_tag_t) *
+				       session->sec_tag_count);
+		if (ret < 0) {
+			goto error;
+		}
+
+		if (session->tls_hostname) {
+			ret = zsock_setsockopt(sock, SOL_TLS, TLS_HOSTNAME,
+					       session->tls_hostname,
+					       strlen(session->tls_hostname));
+			if (ret < 0) {
+				goto error;
+			}
+		}
+	}
+#endif
+
+	ret = zsock_connect(sock, session->addr, session->addrlen);
+	if (ret < 0) {
+		goto error;
+	}
+
+	NET_DBG("Session %p connected (sock %d)", session, sock);
+
+	session->sock = sock;
+
+	return 0;
+
+error:
+	ret = -errno;
+	(void)zsock_close(sock);
 
-out:
 	return ret;
 }
+
+/* The server may have closed the connection since the last response. */
+static bool http_session_is_connected(struct http_session *session)
+{
+	struct zsock_pollfd fds = {
+		.fd = session->sock,
+		.events = ZSOCK_POLLIN,
+	};
+
+	if (session->sock < 0) {
+		return false;
+	}
+
+	if (session->pending_count > 0) {
+		return true;
+	}
+
+	/* Nothing is expected from the server, anything is an end or an
+	 * error.
+	 */
+	return session->recv_pending == 0 && zsock_poll(&fds, 1, 0) == 0;
+}
+
+void http_session_close(struct http_session *session)
+{
+	struct http_request *req;
+
+	if (session->sock >= 0) {
+		NET_DBG("Session %p closed (sock %d)", session, session->sock);
+
+		(void)zsock_close(session->sock);
+		session->sock = -1;
+	}
+
+	session->recv_pending = 0;
+
+	while (session->pending_count > 0) {
+		req = session->pending[0];
+
+		session->pending_count--;
+		memmove(&session->pending[0], &session->pending[1],
+			session->pending_count * sizeof(session->pending[0]));
+
+		http_report_null_response(req);
+	}
+}
+
+int http_session_send(struct http_session *session, struct http_request *req,
+		      int32_t timeout, void *user_data)
+{
+	int ret;
+
+	if (session == NULL || session->addr == NULL ||
+	    session->recv_buf == NULL || session->recv_buf_len == 0 ||
+	    req == NULL || req->response == NULL) {
+		return -EINVAL;
+	}
+
+	if (session->pending_count >= ARRAY_SIZE(session->pending)) {
+		return -ENOBUFS;
+	}
+
+	if (!http_session_is_connected(session)) {
+		http_session_close(session);
+
+		ret = http_session_connect(session);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	http_req_init(session->sock, req, timeout, user_data);
+
+	req->internal.response.recv_buf = session->recv_buf;
+	req->internal.response.recv_buf_len = session->recv_buf_len;
+	req->internal.session = session;
+
+	ret = http_send_request(session->sock, req, user_data);
+	if (ret < 0) {
+		/* The server cannot tell where the request ended */
+		http_session_close(session);
+		return ret;
+	}
+
+	session->pending[session->pending_count++] = req;
+
+	return ret;
+}
+
+int http_session_recv(struct http_session *session)
+{
+	struct http_request *req;
+	int ret;
+
+	if (session->pending_count == 0) {
+		return -ENOENT;
+	}
+
+	req = session->pending[0];
+
+	ret = http_wait_response(session->sock, req, &session->recv_pending);
+
+	session->pending_count--;
+	memmove(&session->pending[0], &session->pending[1],
+		session->pending_count * sizeof(session->pending[0]));
+
+	if (ret >= 0 && !req->internal.response.message_complete) {
+		ret = -ECONNRESET;
+	}
+
+	if (ret < 0 || !http_should_keep_alive(&req->internal.parser)) {
+		http_session_close(session);
+	}
+
+	return ret;
+}
+
+int http_session_req(struct http_session *session, struct http_request *req,
+		     int32_t timeout, void *user_data)
+{
+	int total_sent;
+	bool last;
+	int ret;
+
+	total_sent = http_session_send(session, req, timeout, user_data);
+	if (total_sent < 0) {
+		return total_sent;
+	}
+
+	/* The responses to the requests sent before come first */
+	do {
+		last = (session->pending[0] == req);
+
+		ret = http_session_recv(session);
+		if (ret < 0) {
+			return ret;
+		}
+	} while (!last);
+
+	return total_sent;
+}
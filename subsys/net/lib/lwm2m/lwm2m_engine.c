@@ -83,6 +83,8 @@ LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 struct observe_node {
 	sys_snode_t node;
+	sys_snode_t due_node;		/* Entry in the context due list */
+	struct lwm2m_ctx *ctx;		/* Context the observer belongs to */
 	sys_slist_t path_list;		/* List of Observation path */
 	uint8_t token[MAX_TOKEN_LEN];	/* Observation Token */
 	int64_t event_timestamp;	/* Timestamp for trig next Notify  */
@@ -93,6 +95,9 @@ struct observe_node {
 	bool resource_update : 1;	/* Resource is updated */
 	bool composite : 1;		/* Composite Observation */
 	bool active_tx_operation : 1;	/* Active Notification  process ongoing */
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+	uint32_t notify_seq;		/* Last lookup which matched the observer */
+#endif
 };
 
 struct notification_attrs {
@@ -113,6 +118,10 @@ struct notification_attrs {
 static struct lwm2m_obj_path_list observe_paths[LWM2M_ENGINE_MAX_OBSERVER_PATH];
 static sys_slist_t obs_obj_path_list;
 static struct observe_node observe_node_data[CONFIG_LWM2M_ENGINE_MAX_OBSERVER];
+/* Observers whose event_timestamp changed, to be moved in their context due
+ * list by the engine thread. Set from any thread updating a resource.
+ */
+static ATOMIC_DEFINE(observe_due_changed, CONFIG_LWM2M_ENGINE_MAX_OBSERVER);
 
 #define MAX_PERIODIC_SERVICE	10
 
@@ -129,6 +138,36 @@ static sys_slist_t engine_obj_list;
 static sys_slist_t engine_obj_inst_list;
 static sys_slist_t engine_service_list;
 
+/* Changed when objects or object instances are added or removed, so that
+ * resource handles are looked up again.
+ */
+static uint32_t engine_obj_gen;
+
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+#define INDEX_BUCKETS CONFIG_LWM2M_ENGINE_INDEX_BUCKETS
+
+/* Observed paths of resource level and below, by their resource */
+struct observe_path_ref {
+	sys_snode_t node;
+	struct observe_node *obs;
+};
+
+static struct observe_path_ref observe_path_refs[LWM2M_ENGINE_MAX_OBSERVER_PATH];
+
+static sys_slist_t obj_index[INDEX_BUCKETS];
+static sys_slist_t obj_inst_index[INDEX_BUCKETS];
+static sys_slist_t observe_index[INDEX_BUCKETS];
+static uint32_t observe_notify_seq;
+
+static inline sys_slist_t *index_bucket(sys_slist_t *index, uint16_t obj_id,
+					uint16_t obj_inst_id, uint16_t res_id)
+{
+	uint32_t hash = ((uint32_t)obj_id * 31U + obj_inst_id) * 31U + res_id;
+
+	return &index[(hash ^ (hash >> 16)) % INDEX_BUCKETS];
+}
+#endif
+
 #define LWM2M_DP_CLIENT_URI "dp"
 
 static K_KERNEL_STACK_DEFINE(engine_thread_stack,
@@ -158,6 +197,8 @@ static struct lwm2m_attr write_attr_pool[CONFIG_LWM2M_NUM_ATTR];
 static struct lwm2m_engine_obj *get_engine_obj(int obj_id);
 static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 							 int obj_inst_id);
+static struct lwm2m_engine_res *engine_get_res(struct lwm2m_engine_obj_inst *obj_inst,
+					       int res_id);
 
 /* Shared set of in-flight LwM2M messages */
 static struct lwm2m_message messages[CONFIG_LWM2M_ENGINE_MAX_MESSAGES];
@@ -449,8 +490,9 @@ static int engine_observe_get_attributes(struct lwm2m_obj_path *path,
 	struct lwm2m_engine_obj *obj;
 	struct lwm2m_engine_obj_field *obj_field = NULL;
 	struct lwm2m_engine_obj_inst *obj_inst = NULL;
+	struct lwm2m_engine_res *res;
 	struct lwm2m_engine_res_inst *res_inst = NULL;
-	int ret, i;
+	int ret;
 
 	/* defaults from server object */
 	attrs->pmin = lwm2m_server_get_pmin(srv_obj_inst);
@@ -487,13 +529,8 @@ static int engine_observe_get_attributes(struct lwm2m_obj_path *path,
 
 	/* check if resource exists */
 	if (path->level >= LWM2M_PATH_LEVEL_RESOURCE) {
-		for (i = 0; i < obj_inst->resource_count; i++) {
-			if (obj_inst->resources[i].res_id == path->res_id) {
-				break;
-			}
-		}
-
-		if (i == obj_inst->resource_count) {
+		res = engine_get_res(obj_inst, path->res_id);
+		if (!res) {
 			LOG_ERR("unable to find res_id: %u/%u/%u",
 				path->obj_id, path->obj_inst_id,
 				path->res_id);
@@ -501,8 +538,7 @@ static int engine_observe_get_attributes(struct lwm2m_obj_path *path,
 		}
 
 		/* load object field data */
-		obj_field = lwm2m_get_engine_obj_field(obj,
-				obj_inst->resources[i].res_id);
+		obj_field = lwm2m_get_engine_obj_field(obj, res->res_id);
 		if (!obj_field) {
 			LOG_ERR("unable to find obj_field: %u/%u/%u",
 				path->obj_id, path->obj_inst_id,
@@ -515,7 +551,7 @@ static int engine_observe_get_attributes(struct lwm2m_obj_path *path,
 			return -EPERM;
 		}
 
-		ret = update_attrs(&obj_inst->resources[i], attrs);
+		ret = update_attrs(res, attrs);
 		if (ret < 0) {
 			return ret;
 		}
@@ -584,51 +620,158 @@ int engine_observe_attribute_list_get(sys_slist_t *path_list, struct notificatio
 	return 0;
 }
 
-int lwm2m_notify_observer_path(struct lwm2m_obj_path *path)
+static void engine_observe_due_changed(struct observe_node *obs)
+{
+	atomic_set_bit(observe_due_changed, obs - observe_node_data);
+}
+
+static int engine_observer_resource_update(struct observe_node *obs, struct lwm2m_ctx *ctx,
+					   struct lwm2m_obj_path *path)
 {
-	struct observe_node *obs;
 	struct notification_attrs nattrs = { 0 };
 	int64_t timestamp;
-	int ret = 0;
-	int i;
+	int ret;
+
+	/* update the event time for this observer */
+	ret = engine_observe_attribute_list_get(&obs->path_list, &nattrs, ctx->srv_obj_inst);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (nattrs.pmin) {
+		timestamp = obs->last_timestamp + MSEC_PER_SEC * nattrs.pmin;
+	} else {
+		/* Trig immediately */
+		timestamp = k_uptime_get();
+	}
+
+#if defined(CONFIG_LWM2M_ENGINE_NOTIFY_STATS)
+	if (obs->resource_update) {
+		/* Sent with the notification already pending */
+		ctx->notify_stats.coalesced++;
+	}
+#endif
+
+	if (!obs->event_timestamp || obs->event_timestamp > timestamp) {
+		obs->resource_update = true;
+		obs->event_timestamp = timestamp;
+		engine_observe_due_changed(obs);
+	}
+
+	LOG_DBG("NOTIFY EVENT %u/%u/%u", path->obj_id, path->obj_inst_id, path->res_id);
+
+	return 0;
+}
+
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+static bool engine_ctx_is_active(struct lwm2m_ctx *ctx)
+{
+	for (int i = 0; i < sock_nfds; ++i) {
+		if (sock_ctx[i] == ctx) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* An updated resource can only match observed paths of resource level and
+ * below with the same object, object instance and resource ID, which are
+ * all in the same bucket.
+ */
+static int engine_notify_observer_index(struct lwm2m_obj_path *path)
+{
+	struct observe_path_ref *ref;
+	struct lwm2m_obj_path_list *o_p;
+	int count = 0;
+	int ret;
+
+	/* Observers with several matching paths are updated once */
+	observe_notify_seq++;
 
+	SYS_SLIST_FOR_EACH_CONTAINER(index_bucket(observe_index, path->obj_id,
+						  path->obj_inst_id, path->res_id),
+				     ref, node) {
+		o_p = &observe_paths[ref - observe_path_refs];
+
+		if (ref->obs->notify_seq == observe_notify_seq ||
+		    !lwm2m_observer_path_compare(&o_p->path, path) ||
+		    !engine_ctx_is_active(ref->obs->ctx)) {
+			continue;
+		}
+
+		ref->obs->notify_seq = observe_notify_seq;
+
+		ret = engine_observer_resource_update(ref->obs, ref->obs->ctx, path);
+		if (ret < 0) {
+			return ret;
+		}
+
+		count++;
+	}
+
+	return count;
+}
+
+static void engine_observe_index_add(struct observe_node *obs, struct lwm2m_obj_path_list *o_p)
+{
+	struct observe_path_ref *ref = &observe_path_refs[o_p - observe_paths];
+
+	if (o_p->path.level < LWM2M_PATH_LEVEL_RESOURCE) {
+		return;
+	}
+
+	ref->obs = obs;
+	sys_slist_append(index_bucket(observe_index, o_p->path.obj_id, o_p->path.obj_inst_id,
+				      o_p->path.res_id),
+			 &ref->node);
+}
+
+static void engine_observe_index_remove(struct lwm2m_obj_path_list *o_p)
+{
+	struct observe_path_ref *ref = &observe_path_refs[o_p - observe_paths];
+
+	if (ref->obs == NULL) {
+		return;
+	}
+
+	(void)sys_slist_find_and_remove(index_bucket(observe_index, o_p->path.obj_id,
+						     o_p->path.obj_inst_id, o_p->path.res_id),
+					&ref->node);
+	ref->obs = NULL;
+}
+#endif
+
+int lwm2m_notify_observer_path(struct lwm2m_obj_path *path)
+{
 	if (path->level < LWM2M_PATH_LEVEL_RESOURCE) {
 		return 0;
 	}
 
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+	return engine_notify_observer_index(path);
+#else
+	struct observe_node *obs;
+	int count = 0;
+	int ret;
+	int i;
+
 	/* look for observers which match our resource */
 	for (i = 0; i < sock_nfds; ++i) {
 		SYS_SLIST_FOR_EACH_CONTAINER(&sock_ctx[i]->observer, obs, node) {
 			if (lwm2m_notify_observer_list(&obs->path_list, path)) {
-				/* update the event time for this observer */
-				ret = engine_observe_attribute_list_get(&obs->path_list, &nattrs,
-								    sock_ctx[i]->srv_obj_inst);
+				ret = engine_observer_resource_update(obs, sock_ctx[i], path);
 				if (ret < 0) {
 					return ret;
 				}
 
-				if (nattrs.pmin) {
-					timestamp =
-						obs->last_timestamp + MSEC_PER_SEC * nattrs.pmin;
-				} else {
-					/* Trig immediately */
-					timestamp = k_uptime_get();
-				}
-
-				if (!obs->event_timestamp || obs->event_timestamp > timestamp) {
-					obs->resource_update = true;
-					obs->event_timestamp = timestamp;
-				}
-
-				LOG_DBG("NOTIFY EVENT %u/%u/%u", path->obj_id, path->obj_inst_id,
-					path->res_id);
-				ret++;
+				count++;
 			}
 		}
 	}
 
-	return ret;
-
+	return count;
+#endif
 }
 
 static struct observe_node *engine_allocate_observer(sys_slist_t *path_list, bool composite)
@@ -691,10 +834,19 @@ static void engine_observe_node_init(struct observe_node *obs, const uint8_t *to
 	obs->active_tx_operation = false;
 	obs->format = format;
 	obs->counter = OBSERVE_COUNTER_START;
+	obs->ctx = ctx;
 	sys_slist_append(&ctx->observer,
 			 &obs->node);
+	engine_observe_due_changed(obs);
+
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+	obs->notify_seq = observe_notify_seq;
+#endif
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&obs->path_list, tmp, node) {
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+		engine_observe_index_add(obs, tmp);
+#endif
 		LOG_DBG("OBSERVER ADDED %u/%u/%u/%u(%u)", tmp->path.obj_id, tmp->path.obj_inst_id,
 			tmp->path.res_id, tmp->path.res_inst_id, tmp->path.level);
 
@@ -716,6 +868,9 @@ static void remove_observer_path_from_list(struct lwm2m_ctx *ctx, struct observe
 	if (ctx->observe_cb) {
 		ctx->observe_cb(LWM2M_OBSERVE_EVENT_OBSERVER_REMOVED, &o_p->path, NULL);
 	}
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+	engine_observe_index_remove(o_p);
+#endif
 	/* Remove from the list and add to free list */
 	sys_slist_remove(&obs->path_list, prev_node, &o_p->node);
 	sys_slist_append(&obs_obj_path_list, &o_p->node);
@@ -939,6 +1094,7 @@ static void remove_observer_from_list(struct lwm2m_ctx *ctx, sys_snode_t *prev_n
 		remove_observer_path_from_list(ctx, obs, o_p, NULL);
 	}
 	sys_slist_remove(&ctx->observer, prev_node, &obs->node);
+	(void)sys_slist_find_and_remove(&ctx->observe_due, &obs->due_node);
 	(void)memset(obs, 0, sizeof(*obs));
 }
 
@@ -1086,24 +1242,48 @@ static void engine_remove_observer_by_id(uint16_t obj_id, int32_t obj_inst_id)
 
 void lwm2m_register_obj(struct lwm2m_engine_obj *obj)
 {
+	obj->fields_sorted = true;
+	for (int i = 1; i < obj->field_count; i++) {
+		if (obj->fields[i - 1].res_id >= obj->fields[i].res_id) {
+			obj->fields_sorted = false;
+			break;
+		}
+	}
+
 	sys_slist_append(&engine_obj_list, &obj->node);
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+	sys_slist_append(index_bucket(obj_index, obj->obj_id, 0, 0), &obj->index_node);
+#endif
+	engine_obj_gen++;
 }
 
 void lwm2m_unregister_obj(struct lwm2m_engine_obj *obj)
 {
 	engine_remove_observer_by_id(obj->obj_id, -1);
 	sys_slist_find_and_remove(&engine_obj_list, &obj->node);
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+	sys_slist_find_and_remove(index_bucket(obj_index, obj->obj_id, 0, 0), &obj->index_node);
+#endif
+	engine_obj_gen++;
 }
 
 static struct lwm2m_engine_obj *get_engine_obj(int obj_id)
 {
 	struct lwm2m_engine_obj *obj;
 
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+	SYS_SLIST_FOR_EACH_CONTAINER(index_bucket(obj_index, obj_id, 0, 0), obj, index_node) {
+		if (obj->obj_id == obj_id) {
+			return obj;
+		}
+	}
+#else
 	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_list, obj, node) {
 		if (obj->obj_id == obj_id) {
 			return obj;
 		}
 	}
+#endif
 
 	return NULL;
 }
@@ -1113,12 +1293,32 @@ struct lwm2m_engine_obj_field *lwm2m_get_engine_obj_field(struct lwm2m_engine_ob
 {
 	int i;
 
-	if (obj && obj->fields && obj->field_count > 0) {
-		for (i = 0; i < obj->field_count; i++) {
+	if (!obj || !obj->fields || obj->field_count == 0) {
+		return NULL;
+	}
+
+	if (obj->fields_sorted) {
+		int lo = 0;
+		int hi = obj->field_count - 1;
+
+		while (lo <= hi) {
+			i = (lo + hi) / 2;
 			if (obj->fields[i].res_id == res_id) {
 				return &obj->fields[i];
+			} else if (obj->fields[i].res_id < res_id) {
+				lo = i + 1;
+			} else {
+				hi = i - 1;
 			}
 		}
+
+		return NULL;
+	}
+
+	for (i = 0; i < obj->field_count; i++) {
+		if (obj->fields[i].res_id == res_id) {
+			return &obj->fields[i];
+		}
 	}
 
 	return NULL;
@@ -1128,7 +1328,21 @@ struct lwm2m_engine_obj_field *lwm2m_get_engine_obj_field(struct lwm2m_engine_ob
 
 static void engine_register_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 {
+	obj_inst->resources_sorted = true;
+	for (int i = 1; i < obj_inst->resource_count; i++) {
+		if (obj_inst->resources[i - 1].res_id >= obj_inst->resources[i].res_id) {
+			obj_inst->resources_sorted = false;
+			break;
+		}
+	}
+
 	sys_slist_append(&engine_obj_inst_list, &obj_inst->node);
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+	sys_slist_append(index_bucket(obj_inst_index, obj_inst->obj->obj_id,
+				      obj_inst->obj_inst_id, 0),
+			 &obj_inst->index_node);
+#endif
+	engine_obj_gen++;
 }
 
 static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
@@ -1136,6 +1350,12 @@ static void engine_unregister_obj_inst(struct lwm2m_engine_obj_inst *obj_inst)
 	engine_remove_observer_by_id(
 			obj_inst->obj->obj_id, obj_inst->obj_inst_id);
 	sys_slist_find_and_remove(&engine_obj_inst_list, &obj_inst->node);
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+	sys_slist_find_and_remove(index_bucket(obj_inst_index, obj_inst->obj->obj_id,
+					       obj_inst->obj_inst_id, 0),
+				  &obj_inst->index_node);
+#endif
+	engine_obj_gen++;
 }
 
 static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
@@ -1143,6 +1363,15 @@ static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 {
 	struct lwm2m_engine_obj_inst *obj_inst;
 
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+	SYS_SLIST_FOR_EACH_CONTAINER(index_bucket(obj_inst_index, obj_id, obj_inst_id, 0),
+				     obj_inst, index_node) {
+		if (obj_inst->obj->obj_id == obj_id &&
+		    obj_inst->obj_inst_id == obj_inst_id) {
+			return obj_inst;
+		}
+	}
+#else
 	SYS_SLIST_FOR_EACH_CONTAINER(&engine_obj_inst_list, obj_inst,
 				     node) {
 		if (obj_inst->obj->obj_id == obj_id &&
@@ -1150,6 +1379,43 @@ static struct lwm2m_engine_obj_inst *get_engine_obj_inst(int obj_id,
 			return obj_inst;
 		}
 	}
+#endif
+
+	return NULL;
+}
+
+static struct lwm2m_engine_res *engine_get_res(struct lwm2m_engine_obj_inst *obj_inst,
+					       int res_id)
+{
+	int i;
+
+	if (!obj_inst->resources || obj_inst->resource_count == 0U) {
+		return NULL;
+	}
+
+	if (obj_inst->resources_sorted) {
+		int lo = 0;
+		int hi = obj_inst->resource_count - 1;
+
+		while (lo <= hi) {
+			i = (lo + hi) / 2;
+			if (obj_inst->resources[i].res_id == res_id) {
+				return &obj_inst->resources[i];
+			} else if (obj_inst->resources[i].res_id < res_id) {
+				lo = i + 1;
+			} else {
+				hi = i - 1;
+			}
+		}
+
+		return NULL;
+	}
+
+	for (i = 0; i < obj_inst->resource_count; i++) {
+		if (obj_inst->resources[i].res_id == res_id) {
+			return &obj_inst->resources[i];
+		}
+	}
 
 	return NULL;
 }
@@ -1787,7 +2053,7 @@ static int path_to_objs(const struct lwm2m_obj_path *path,
 {
 	struct lwm2m_engine_obj_inst *oi;
 	struct lwm2m_engine_obj_field *of;
-	struct lwm2m_engine_res *r = NULL;
+	struct lwm2m_engine_res *r;
 	struct lwm2m_engine_res_inst *ri = NULL;
 	int i;
 
@@ -1813,13 +2079,7 @@ static int path_to_objs(const struct lwm2m_obj_path *path,
 		return -ENOENT;
 	}
 
-	for (i = 0; i < oi->resource_count; i++) {
-		if (oi->resources[i].res_id == path->res_id) {
-			r = &oi->resources[i];
-			break;
-		}
-	}
-
+	r = engine_get_res(oi, path->res_id);
 	if (!r) {
 		if (LWM2M_HAS_PERM(of, BIT(LWM2M_FLAG_OPTIONAL))) {
 			LOG_DBG("resource %d not found", path->res_id);
@@ -1994,46 +2254,89 @@ int lwm2m_engine_set_res_data(const char *pathstr, void *data_ptr, uint16_t data
 	return lwm2m_engine_set_res_buf(pathstr, data_ptr, data_len, data_len, data_flags);
 }
 
-static int lwm2m_engine_set(const char *pathstr, void *value, uint16_t len)
+static int engine_res_handle_resolve(struct lwm2m_res_handle *handle)
 {
-	struct lwm2m_obj_path path;
-	struct lwm2m_engine_obj_inst *obj_inst;
-	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res *res = NULL;
 	struct lwm2m_engine_res_inst *res_inst = NULL;
-	void *data_ptr = NULL;
-	size_t max_data_len = 0;
-	int ret = 0;
-	bool changed = false;
+	int ret;
 
-	LOG_DBG("path:%s, value:%p, len:%d", pathstr, value, len);
+	handle->obj_inst = NULL;
+	handle->res_inst = NULL;
+
+	/* look up resource obj */
+	ret = path_to_objs(&handle->path, &handle->obj_inst, &handle->obj_field,
+			   &handle->res, &res_inst);
+	if (ret < 0) {
+		return ret;
+	}
+
+	if (!res_inst) {
+		LOG_ERR("res instance %d not found", handle->path.res_inst_id);
+		return -ENOENT;
+	}
+
+	handle->res_inst = res_inst;
+	handle->gen = engine_obj_gen;
+
+	return 0;
+}
+
+/* Resource instances can be deleted without objects instances changing */
+static int engine_res_handle_check(struct lwm2m_res_handle *handle)
+{
+	if (handle->gen == engine_obj_gen && handle->res_inst &&
+	    handle->res_inst->res_inst_id == handle->path.res_inst_id) {
+		return 0;
+	}
+
+	return engine_res_handle_resolve(handle);
+}
+
+int lwm2m_engine_get_res_handle(const char *pathstr, struct lwm2m_res_handle *handle)
+{
+	int ret;
+
+	(void)memset(handle, 0, sizeof(*handle));
 
 	/* translate path -> path_obj */
-	ret = lwm2m_string_to_path(pathstr, &path, '/');
+	ret = lwm2m_string_to_path(pathstr, &handle->path, '/');
 	if (ret < 0) {
 		return ret;
 	}
 
-	if (path.level < 3) {
+	if (handle->path.level < 3) {
 		LOG_ERR("path must have at least 3 parts");
 		return -EINVAL;
 	}
 
-	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res, &res_inst);
+	return engine_res_handle_resolve(handle);
+}
+
+int lwm2m_engine_set_by_handle(struct lwm2m_res_handle *handle, void *value, uint16_t len)
+{
+	struct lwm2m_obj_path *path = &handle->path;
+	struct lwm2m_engine_obj_inst *obj_inst;
+	struct lwm2m_engine_obj_field *obj_field;
+	struct lwm2m_engine_res *res;
+	struct lwm2m_engine_res_inst *res_inst;
+	void *data_ptr = NULL;
+	size_t max_data_len = 0;
+	int ret = 0;
+	bool changed = false;
+
+	ret = engine_res_handle_check(handle);
 	if (ret < 0) {
 		return ret;
 	}
 
-	if (!res_inst) {
-		LOG_ERR("res instance %d not found", path.res_inst_id);
-		return -ENOENT;
-	}
+	obj_inst = handle->obj_inst;
+	obj_field = handle->obj_field;
+	res = handle->res;
+	res_inst = handle->res_inst;
 
 	if (LWM2M_HAS_RES_FLAG(res_inst, LWM2M_RES_DATA_FLAG_RO)) {
 		LOG_ERR("res instance data pointer is read-only "
-			"[%u/%u/%u/%u:%u]", path.obj_id, path.obj_inst_id,
-			path.res_id, path.res_inst_id, path.level);
+			"[%u/%u/%u/%u:%u]", path->obj_id, path->obj_inst_id,
+			path->res_id, path->res_inst_id, path->level);
 		return -EACCES;
 	}
 
@@ -2050,8 +2353,8 @@ static int lwm2m_engine_set(const char *pathstr, void *value, uint16_t len)
 
 	if (!data_ptr) {
 		LOG_ERR("res instance data pointer is NULL [%u/%u/%u/%u:%u]",
-			path.obj_id, path.obj_inst_id, path.res_id,
-			path.res_inst_id, path.level);
+			path->obj_id, path->obj_inst_id, path->res_id,
+			path->res_inst_id, path->level);
 		return -EINVAL;
 	}
 
@@ -2059,7 +2362,7 @@ static int lwm2m_engine_set(const char *pathstr, void *value, uint16_t len)
 	if (len > max_data_len -
 		(obj_field->data_type == LWM2M_RES_TYPE_STRING ? 1 : 0)) {
 		LOG_ERR("length %u is too long for res instance %d data",
-			len, path.res_id);
+			len, path->res_id);
 		return -ENOMEM;
 	}
 
@@ -2146,12 +2449,27 @@ static int lwm2m_engine_set(const char *pathstr, void *value, uint16_t len)
 	}
 
 	if (changed && LWM2M_HAS_PERM(obj_field, LWM2M_PERM_R)) {
-		NOTIFY_OBSERVER_PATH(&path);
+		NOTIFY_OBSERVER_PATH(path);
 	}
 
 	return ret;
 }
 
+static int lwm2m_engine_set(const char *pathstr, void *value, uint16_t len)
+{
+	struct lwm2m_res_handle handle;
+	int ret;
+
+	LOG_DBG("path:%s, value:%p, len:%d", pathstr, value, len);
+
+	ret = lwm2m_engine_get_res_handle(pathstr, &handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return lwm2m_engine_set_by_handle(&handle, value, len);
+}
+
 int lwm2m_engine_set_opaque(const char *pathstr, char *data_ptr, uint16_t data_len)
 {
 	return lwm2m_engine_set(pathstr, data_ptr, data_len);
@@ -2288,40 +2606,25 @@ int lwm2m_engine_get_res_data(const char *pathstr, void **data_ptr, uint16_t *da
 }
 
 
-static int lwm2m_engine_get(const char *pathstr, void *buf, uint16_t buflen)
+int lwm2m_engine_get_by_handle(struct lwm2m_res_handle *handle, void *buf, uint16_t buflen)
 {
 	int ret = 0;
-	struct lwm2m_obj_path path;
 	struct lwm2m_engine_obj_inst *obj_inst;
 	struct lwm2m_engine_obj_field *obj_field;
-	struct lwm2m_engine_res *res = NULL;
-	struct lwm2m_engine_res_inst *res_inst = NULL;
+	struct lwm2m_engine_res *res;
+	struct lwm2m_engine_res_inst *res_inst;
 	void *data_ptr = NULL;
 	size_t data_len = 0;
 
-	LOG_DBG("path:%s, buf:%p, buflen:%d", pathstr, buf, buflen);
-
-	/* translate path -> path_obj */
-	ret = lwm2m_string_to_path(pathstr, &path, '/');
-	if (ret < 0) {
-		return ret;
-	}
-
-	if (path.level < 3) {
-		LOG_ERR("path must have at least 3 parts");
-		return -EINVAL;
-	}
-
-	/* look up resource obj */
-	ret = path_to_objs(&path, &obj_inst, &obj_field, &res, &res_inst);
+	ret = engine_res_handle_check(handle);
 	if (ret < 0) {
 		return ret;
 	}
 
-	if (!res_inst) {
-		LOG_ERR("res instance %d not found", path.res_inst_id);
-		return -ENOENT;
-	}
+	obj_inst = handle->obj_inst;
+	obj_field = handle->obj_field;
+	res = handle->res;
+	res_inst = handle->res_inst;
 
 	/* setup initial data elements */
 	data_ptr = res_inst->data_ptr;
@@ -2404,6 +2707,21 @@ static int lwm2m_engine_get(const char *pathstr, void *buf, uint16_t buflen)
 	return 0;
 }
 
+static int lwm2m_engine_get(const char *pathstr, void *buf, uint16_t buflen)
+{
+	struct lwm2m_res_handle handle;
+	int ret;
+
+	LOG_DBG("path:%s, buf:%p, buflen:%d", pathstr, buf, buflen);
+
+	ret = lwm2m_engine_get_res_handle(pathstr, &handle);
+	if (ret < 0) {
+		return ret;
+	}
+
+	return lwm2m_engine_get_by_handle(&handle, buf, buflen);
+}
+
 int lwm2m_engine_get_opaque(const char *pathstr, void *buf, uint16_t buflen)
 {
 	return lwm2m_engine_get(pathstr, buf, buflen);
@@ -2582,6 +2900,7 @@ static int lwm2m_engine_observer_timestamp_update(sys_slist_t *observer,
 			timestamp = 0;
 		}
 		obs->event_timestamp = timestamp;
+		engine_observe_due_changed(obs);
 
 		(void)memset(&nattrs, 0, sizeof(nattrs));
 	}
@@ -5374,6 +5693,18 @@ static int notify_message_reply_cb(const struct coap_packet *response,
 	return 0;
 }
 
+#if defined(CONFIG_LWM2M_ENGINE_NOTIFY_STATS)
+static void notify_stats_update(struct lwm2m_ctx *ctx, uint32_t encode_cycles)
+{
+	uint32_t encode_us = k_cyc_to_us_ceil32(encode_cycles);
+
+	ctx->notify_stats.sent++;
+	ctx->notify_stats.encode_time_us += encode_us;
+	ctx->notify_stats.encode_time_max_us =
+		MAX(ctx->notify_stats.encode_time_max_us, encode_us);
+}
+#endif
+
 static int generate_notify_message(struct lwm2m_ctx *ctx,
 				   struct observe_node *obs,
 				   void *user_data)
@@ -5381,6 +5712,9 @@ static int generate_notify_message(struct lwm2m_ctx *ctx,
 	struct lwm2m_message *msg;
 	struct lwm2m_engine_obj_inst *obj_inst;
 	struct lwm2m_obj_path *path;
+#if defined(CONFIG_LWM2M_ENGINE_NOTIFY_STATS)
+	uint32_t start;
+#endif
 	int ret = 0;
 
 	msg = lwm2m_get_message(ctx);
@@ -5450,6 +5784,9 @@ static int generate_notify_message(struct lwm2m_ctx *ctx,
 
 	/* set the output writer */
 	select_writer(&msg->out, obs->format);
+#if defined(CONFIG_LWM2M_ENGINE_NOTIFY_STATS)
+	start = k_cycle_get_32();
+#endif
 	if (obs->composite) {
 		/* Use do send which actually do Composite read operation */
 		ret = do_send_op(msg, obs->format, &obs->path_list);
@@ -5462,6 +5799,10 @@ static int generate_notify_message(struct lwm2m_ctx *ctx,
 		goto cleanup;
 	}
 
+#if defined(CONFIG_LWM2M_ENGINE_NOTIFY_STATS)
+	notify_stats_update(ctx, k_cycle_get_32() - start);
+#endif
+
 	obs->active_tx_operation = true;
 	obs->resource_update = false;
 	lwm2m_information_interface_send(msg);
@@ -5639,6 +5980,7 @@ void lwm2m_engine_context_init(struct lwm2m_ctx *client_ctx)
 {
 	sys_slist_init(&client_ctx->pending_sends);
 	sys_slist_init(&client_ctx->observer);
+	sys_slist_init(&client_ctx->observe_due);
 #if defined(CONFIG_LWM2M_QUEUE_MODE_ENABLED)
 	client_ctx->buffer_client_messages = true;
 	client_ctx->connection_suspended = false;
@@ -5704,36 +6046,123 @@ static int64_t engine_observe_shedule_next_event(struct observe_node *obs, uint1
 	return t_s;
 }
 
-static void check_notifications(struct lwm2m_ctx *ctx,
-				const int64_t timestamp)
+/* Keep the due lists ordered by event_timestamp, observers without a
+ * scheduled notification are not in the list.
+ */
+static void engine_observe_due_update(void)
+{
+	struct observe_node *obs, *entry;
+	sys_snode_t *prev;
+
+	for (int i = 0; i < CONFIG_LWM2M_ENGINE_MAX_OBSERVER; i++) {
+		if (!atomic_test_and_clear_bit(observe_due_changed, i)) {
+			continue;
+		}
+
+		obs = &observe_node_data[i];
+		if (!obs->tkl) {
+			/* Removed since */
+			continue;
+		}
+
+		(void)sys_slist_find_and_remove(&obs->ctx->observe_due, &obs->due_node);
+		if (!obs->event_timestamp) {
+			continue;
+		}
+
+		prev = NULL;
+		SYS_SLIST_FOR_EACH_CONTAINER(&obs->ctx->observe_due, entry, due_node) {
+			if (entry->event_timestamp > obs->event_timestamp) {
+				break;
+			}
+			prev = &entry->due_node;
+		}
+
+		sys_slist_insert(&obs->ctx->observe_due, prev, &obs->due_node);
+	}
+}
+
+/* Return the time in ms until a notification should be checked again */
+static int32_t check_notifications(struct lwm2m_ctx *ctx,
+				   const int64_t timestamp)
 {
 	struct observe_node *obs;
 	int rc;
 
-	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->observer, obs, node) {
-		if (!obs->event_timestamp || timestamp < obs->event_timestamp) {
-			continue;
+	if (!lwm2m_rd_client_is_registred(ctx)) {
+		return ENGINE_UPDATE_INTERVAL_MS;
+	}
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->observe_due, obs, due_node) {
+		if (timestamp < obs->event_timestamp) {
+			return MIN(obs->event_timestamp - timestamp, ENGINE_UPDATE_INTERVAL_MS);
 		}
-		/* Check That There is not pending process and client is registred */
-		if (obs->active_tx_operation || !lwm2m_rd_client_is_registred(ctx)) {
+		/* Check That There is not pending process */
+		if (obs->active_tx_operation) {
 			continue;
 		}
 
 		rc = generate_notify_message(ctx, obs, NULL);
 		if (rc == -ENOMEM) {
 			/* no memory/messages available, retry later */
-			return;
+			return ENGINE_UPDATE_INTERVAL_MS;
 		}
 		obs->event_timestamp =
 			engine_observe_shedule_next_event(obs, ctx->srv_obj_inst, timestamp);
 		obs->last_timestamp = timestamp;
+		engine_observe_due_changed(obs);
 		if (!rc) {
 			/* create at most one notification */
-			return;
+			return 0;
 		}
 	}
+
+	return ENGINE_UPDATE_INTERVAL_MS;
 }
 
+#if defined(CONFIG_NET_TEST)
+int lwm2m_engine_observe_test_add(struct lwm2m_ctx *ctx, const char *pathstr,
+				  const uint8_t *token, uint8_t tkl)
+{
+	struct lwm2m_message msg = { .ctx = ctx };
+	int ret;
+
+	ret = lwm2m_string_to_path(pathstr, &msg.path, '/');
+	if (ret < 0) {
+		return ret;
+	}
+
+	return engine_add_observer(&msg, token, tkl, LWM2M_FORMAT_PLAIN_TEXT);
+}
+
+int lwm2m_engine_observe_test_remove(struct lwm2m_ctx *ctx, const uint8_t *token,
+				     uint8_t tkl)
+{
+	return engine_remove_observer_by_token(ctx, token, tkl);
+}
+
+int lwm2m_engine_observe_test_due_get(struct lwm2m_ctx *ctx, uint8_t *tokens,
+				      int64_t *due, int max)
+{
+	struct observe_node *obs;
+	int count = 0;
+
+	engine_observe_due_update();
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&ctx->observe_due, obs, due_node) {
+		if (count == max) {
+			break;
+		}
+
+		tokens[count] = obs->token[0];
+		due[count] = obs->event_timestamp;
+		count++;
+	}
+
+	return count;
+}
+#endif /* CONFIG_NET_TEST */
+
 static int socket_recv_message(struct lwm2m_ctx *client_ctx)
 {
 	static uint8_t in_buf[NET_IPV6_MTU];
@@ -5794,11 +6223,12 @@ static void socket_loop(void)
 {
 	int i, rc;
 	int64_t timestamp;
-	int32_t timeout, next_retransmit;
+	int32_t timeout, next_retransmit, next_notify;
 
 	while (1) {
 		timestamp = k_uptime_get();
 		timeout = lwm2m_engine_service(timestamp);
+		engine_observe_due_update();
 
 		/* wait for sockets */
 		if (sock_nfds < 1) {
@@ -5814,7 +6244,10 @@ static void socket_loop(void)
 				}
 			}
 			if (sys_slist_is_empty(&sock_ctx[i]->pending_sends)) {
-				check_notifications(sock_ctx[i], timestamp);
+				next_notify = check_notifications(sock_ctx[i], timestamp);
+				if (next_notify < timeout) {
+					timeout = next_notify;
+				}
 			}
 		}
 
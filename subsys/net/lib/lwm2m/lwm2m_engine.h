@@ -203,4 +203,18 @@ int lwm2m_push_queued_buffers(struct lwm2m_ctx *client_ctx);
 #endif
 int  lwm2m_parse_peerinfo(char *url, struct lwm2m_ctx *client_ctx, bool is_firmware_uri);
 
+#if defined(CONFIG_NET_TEST)
+/* Observer scheduling, for the engine tests. Observers are identified by the
+ * first byte of their token. lwm2m_engine_observe_test_due_get() applies the
+ * pending due time changes, as the engine thread does, and returns the
+ * observers of the due list in order.
+ */
+int lwm2m_engine_observe_test_add(struct lwm2m_ctx *ctx, const char *pathstr,
+				  const uint8_t *token, uint8_t tkl);
+int lwm2m_engine_observe_test_remove(struct lwm2m_ctx *ctx, const uint8_t *token,
+				     uint8_t tkl);
+int lwm2m_engine_observe_test_due_get(struct lwm2m_ctx *ctx, uint8_t *tokens,
+				      int64_t *due, int max);
+#endif
+
 #endif /* LWM2M_ENGINE_H */
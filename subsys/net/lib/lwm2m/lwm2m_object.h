@@ -185,6 +185,11 @@ struct lwm2m_engine_obj {
 	/* object list */
 	sys_snode_t node;
 
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+	/* object lookup table */
+	sys_snode_t index_node;
+#endif
+
 	/* object field definitions */
 	struct lwm2m_engine_obj_field *fields;
 
@@ -206,6 +211,9 @@ struct lwm2m_engine_obj {
 
 	/* Object is a core object (defined in the official LwM2M spec.) */
 	bool is_core : 1;
+
+	/* Field res_ids are in ascending order, set on registration */
+	bool fields_sorted : 1;
 };
 
 /* Resource instances with this value are considered "not created" yet */
@@ -405,12 +413,20 @@ struct lwm2m_engine_obj_inst {
 	/* instance list */
 	sys_snode_t node;
 
+#if defined(CONFIG_LWM2M_ENGINE_INDEX)
+	/* instance lookup table */
+	sys_snode_t index_node;
+#endif
+
 	struct lwm2m_engine_obj *obj;
 	struct lwm2m_engine_res *resources;
 
 	/* object instance member data */
 	uint16_t obj_inst_id;
 	uint16_t resource_count;
+
+	/* Resource res_ids are in ascending order, set on registration */
+	bool resources_sorted;
 };
 
 /* Initialize resource instances prior to use */
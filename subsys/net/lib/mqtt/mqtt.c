@@ -25,6 +25,9 @@ static void client_reset(struct mqtt_client *client)
 	client->internal.last_activity = 0U;
 	client->internal.rx_buf_datalen = 0U;
 	client->internal.remaining_payload = 0U;
+#if defined(CONFIG_MQTT_TX_COALESCE)
+	client->internal.tx_pending = 0U;
+#endif
 }
 
 /** @brief Initialize tx buffer. */
@@ -167,6 +170,75 @@ static int client_write_msg(struct mqtt_client *client,
 	return 0;
 }
 
+static int verify_tx_state(const struct mqtt_client *client)
+{
+	if (!MQTT_HAS_STATE(client, MQTT_STATE_CONNECTED)) {
+		return -ENOTCONN;
+	}
+
+	return 0;
+}
+
+static uint32_t tx_pending_get(const struct mqtt_client *client)
+{
+#if defined(CONFIG_MQTT_TX_COALESCE)
+	return client->internal.tx_pending;
+#else
+	return 0U;
+#endif
+}
+
+/** @brief Send the coalesced PUBLISH packets, if any. */
+static int client_flush(struct mqtt_client *client)
+{
+	uint32_t pending = tx_pending_get(client);
+
+	if (pending == 0U) {
+		return 0;
+	}
+
+#if defined(CONFIG_MQTT_TX_COALESCE)
+	client->internal.tx_pending = 0U;
+#endif
+
+	return client_write(client, client->tx_buf, pending);
+}
+
+#if defined(CONFIG_MQTT_TX_COALESCE)
+static uint32_t tx_pending_time_left(const struct mqtt_client *client)
+{
+	uint32_t elapsed_time = mqtt_elapsed_time_in_ms_get(
+					client->internal.tx_pending_since);
+
+	if (elapsed_time >= CONFIG_MQTT_TX_COALESCE_DELAY) {
+		return 0U;
+	}
+
+	return CONFIG_MQTT_TX_COALESCE_DELAY - elapsed_time;
+}
+#endif /* CONFIG_MQTT_TX_COALESCE */
+
+/** @brief Check the state and prepare the tx buffer for a new packet. */
+static int tx_packet_init(struct mqtt_client *client, struct buf_ctx *buf)
+{
+	int err_code;
+
+	err_code = verify_tx_state(client);
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	/* Coalesced PUBLISH packets are sent first to keep the order. */
+	err_code = client_flush(client);
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	tx_buf_init(client, buf);
+
+	return 0;
+}
+
 void mqtt_client_init(struct mqtt_client *client)
 {
 	NULL_PARAM_CHECK_VOID(client);
@@ -227,22 +299,111 @@ error:
 	return err_code;
 }
 
-static int verify_tx_state(const struct mqtt_client *client)
+/** @brief Encode and send a PUBLISH packet, or queue it with
+ *         CONFIG_MQTT_TX_COALESCE.
+ */
+static int client_publish(struct mqtt_client *client,
+			  const struct mqtt_publish_param *param)
 {
-	if (!MQTT_HAS_STATE(client, MQTT_STATE_CONNECTED)) {
-		return -ENOTCONN;
+	const struct mqtt_binstr *payload = &param->message.payload;
+	uint32_t pending = tx_pending_get(client);
+	struct iovec io_vector[3];
+	struct buf_ctx packet;
+	struct msghdr msg;
+	uint32_t header_len;
+	int err_code;
+	int i = 0;
+
+	/* Encode after the PUBLISH packets waiting to be sent. */
+	packet.cur = client->tx_buf + pending;
+	packet.end = client->tx_buf + client->tx_buf_size;
+
+	err_code = publish_encode(param, &packet);
+	if (err_code == -ENOMEM && pending > 0U) {
+		err_code = client_flush(client);
+		if (err_code < 0) {
+			return err_code;
+		}
+
+		pending = 0U;
+		tx_buf_init(client, &packet);
+
+		err_code = publish_encode(param, &packet);
 	}
 
-	return 0;
+	if (err_code < 0) {
+		return err_code;
+	}
+
+	header_len = packet.end - packet.cur;
+
+#if defined(CONFIG_MQTT_INFLIGHT)
+	if (param->message.topic.qos > MQTT_QOS_0_AT_MOST_ONCE) {
+		err_code = mqtt_inflight_add(client, param->message_id,
+					     param->message.topic.qos,
+					     packet.cur, header_len, payload);
+		if (err_code == -EAGAIN) {
+			/* Let the waiting messages out to get acknowledged. */
+			int flush_err = client_flush(client);
+
+			return flush_err < 0 ? flush_err : err_code;
+		}
+
+		if (err_code < 0) {
+			return err_code;
+		}
+	}
+#endif
+
+#if defined(CONFIG_MQTT_TX_COALESCE)
+	if (header_len + payload->len <= client->tx_buf_size - pending) {
+		memmove(client->tx_buf + pending, packet.cur, header_len);
+		memcpy(client->tx_buf + pending + header_len, payload->data,
+		       payload->len);
+
+		if (pending == 0U) {
+			client->internal.tx_pending_since =
+						mqtt_sys_tick_in_ms_get();
+		}
+
+		client->internal.tx_pending = pending + header_len +
+					      payload->len;
+
+		NET_DBG("[CID %p]: %u bytes waiting to be sent", client,
+			client->internal.tx_pending);
+
+		return 0;
+	}
+
+	/* Too big to wait, send it along with the waiting packets. */
+	client->internal.tx_pending = 0U;
+#endif
+
+	if (pending > 0U) {
+		io_vector[i].iov_base = client->tx_buf;
+		io_vector[i].iov_len = pending;
+		i++;
+	}
+
+	io_vector[i].iov_base = packet.cur;
+	io_vector[i].iov_len = header_len;
+	i++;
+	io_vector[i].iov_base = payload->data;
+	io_vector[i].iov_len = payload->len;
+	i++;
+
+	memset(&msg, 0, sizeof(msg));
+
+	msg.msg_iov = io_vector;
+	msg.msg_iovlen = i;
+
+	return client_write_msg(client, &msg);
 }
 
 int mqtt_publish(struct mqtt_client *client,
 		 const struct mqtt_publish_param *param)
 {
 	int err_code;
-	struct buf_ctx packet;
-	struct iovec io_vector[2];
-	struct msghdr msg;
 
 	NULL_PARAM_CHECK(client);
 	NULL_PARAM_CHECK(param);
@@ -254,29 +415,12 @@ int mqtt_publish(struct mqtt_client *client,
 
 	mqtt_mutex_lock(client);
 
-	tx_buf_init(client, &packet);
-
 	err_code = verify_tx_state(client);
 	if (err_code < 0) {
 		goto error;
 	}
 
-	err_code = publish_encode(param, &packet);
-	if (err_code < 0) {
-		goto error;
-	}
-
-	io_vector[0].iov_base = packet.cur;
-	io_vector[0].iov_len = packet.end - packet.cur;
-	io_vector[1].iov_base = param->message.payload.data;
-	io_vector[1].iov_len = param->message.payload.len;
-
-	memset(&msg, 0, sizeof(msg));
-
-	msg.msg_iov = io_vector;
-	msg.msg_iovlen = ARRAY_SIZE(io_vector);
-
-	err_code = client_write_msg(client, &msg);
+	err_code = client_publish(client, param);
 
 error:
 	NET_DBG("[CID %p]:[State 0x%02x]: << result 0x%08x",
@@ -301,9 +445,7 @@ int mqtt_publish_qos1_ack(struct mqtt_client *client,
 
 	mqtt_mutex_lock(client);
 
-	tx_buf_init(client, &packet);
-
-	err_code = verify_tx_state(client);
+	err_code = tx_packet_init(client, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
@@ -338,9 +480,7 @@ int mqtt_publish_qos2_receive(struct mqtt_client *client,
 
 	mqtt_mutex_lock(client);
 
-	tx_buf_init(client, &packet);
-
-	err_code = verify_tx_state(client);
+	err_code = tx_packet_init(client, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
@@ -375,9 +515,7 @@ int mqtt_publish_qos2_release(struct mqtt_client *client,
 
 	mqtt_mutex_lock(client);
 
-	tx_buf_init(client, &packet);
-
-	err_code = verify_tx_state(client);
+	err_code = tx_packet_init(client, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
@@ -412,9 +550,7 @@ int mqtt_publish_qos2_complete(struct mqtt_client *client,
 
 	mqtt_mutex_lock(client);
 
-	tx_buf_init(client, &packet);
-
-	err_code = verify_tx_state(client);
+	err_code = tx_packet_init(client, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
@@ -447,9 +583,7 @@ int mqtt_disconnect(struct mqtt_client *client)
 
 	mqtt_mutex_lock(client);
 
-	tx_buf_init(client, &packet);
-
-	err_code = verify_tx_state(client);
+	err_code = tx_packet_init(client, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
@@ -487,9 +621,7 @@ int mqtt_subscribe(struct mqtt_client *client,
 
 	mqtt_mutex_lock(client);
 
-	tx_buf_init(client, &packet);
-
-	err_code = verify_tx_state(client);
+	err_code = tx_packet_init(client, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
@@ -521,9 +653,7 @@ int mqtt_unsubscribe(struct mqtt_client *client,
 
 	mqtt_mutex_lock(client);
 
-	tx_buf_init(client, &packet);
-
-	err_code = verify_tx_state(client);
+	err_code = tx_packet_init(client, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
@@ -550,9 +680,7 @@ int mqtt_ping(struct mqtt_client *client)
 
 	mqtt_mutex_lock(client);
 
-	tx_buf_init(client, &packet);
-
-	err_code = verify_tx_state(client);
+	err_code = tx_packet_init(client, &packet);
 	if (err_code < 0) {
 		goto error;
 	}
@@ -601,6 +729,17 @@ int mqtt_live(struct mqtt_client *client)
 
 	mqtt_mutex_lock(client);
 
+#if defined(CONFIG_MQTT_TX_COALESCE)
+	if (client->internal.tx_pending > 0U &&
+	    tx_pending_time_left(client) == 0U) {
+		err_code = client_flush(client);
+		if (err_code < 0) {
+			mqtt_mutex_unlock(client);
+			return err_code;
+		}
+	}
+#endif
+
 	elapsed_time = mqtt_elapsed_time_in_ms_get(
 				client->internal.last_activity);
 	if ((client->keepalive > 0) &&
@@ -623,17 +762,27 @@ int mqtt_keepalive_time_left(const struct mqtt_client *client)
 	uint32_t elapsed_time = mqtt_elapsed_time_in_ms_get(
 					client->internal.last_activity);
 	uint32_t keepalive_ms = 1000U * client->keepalive;
+	int time_left = -1;
 
-	if (client->keepalive == 0) {
-		/* Keep alive not enabled. */
-		return -1;
+	if (client->keepalive > 0) {
+		if (keepalive_ms <= elapsed_time) {
+			time_left = 0;
+		} else {
+			time_left = keepalive_ms - elapsed_time;
+		}
 	}
 
-	if (keepalive_ms <= elapsed_time) {
-		return 0;
+#if defined(CONFIG_MQTT_TX_COALESCE)
+	if (client->internal.tx_pending > 0U) {
+		uint32_t tx_time_left = tx_pending_time_left(client);
+
+		if (time_left < 0 || (int)tx_time_left < time_left) {
+			time_left = tx_time_left;
+		}
 	}
+#endif
 
-	return keepalive_ms - elapsed_time;
+	return time_left;
 }
 
 int mqtt_input(struct mqtt_client *client)
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/** @file mqtt_inflight.c
+ *
+ * @brief Tracking of the QoS 1 and QoS 2 messages published by the client.
+ *
+ * Messages are kept oldest first. Their PUBLISH packets are stored back to
+ * back in the in-flight buffer of the client, in the same order, so that
+ * they can be sent again when the client reconnects.
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_mqtt_inflight, CONFIG_MQTT_LOG_LEVEL);
+
+#include "mqtt_internal.h"
+#include "mqtt_transport.h"
+#include "mqtt_os.h"
+
+static uint32_t inflight_offset(const struct mqtt_client *client, int idx)
+{
+	uint32_t offset = 0U;
+
+	for (int i = 0; i < idx; i++) {
+		offset += client->internal.inflight[i].len;
+	}
+
+	return offset;
+}
+
+static int inflight_find(const struct mqtt_client *client, uint16_t message_id)
+{
+	for (int i = 0; i < client->internal.inflight_count; i++) {
+		if (client->internal.inflight[i].message_id == message_id) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+/* Drop the stored packet of a message, keeping the others back to back. */
+static void inflight_drop_packet(struct mqtt_client *client, int idx)
+{
+	struct mqtt_inflight_msg *msg = &client->internal.inflight[idx];
+	uint32_t offset, used;
+
+	if (msg->len == 0U) {
+		return;
+	}
+
+	offset = inflight_offset(client, idx);
+	used = inflight_offset(client, client->internal.inflight_count);
+
+	memmove(client->inflight_buf + offset,
+		client->inflight_buf + offset + msg->len,
+		used - offset - msg->len);
+
+	msg->len = 0U;
+}
+
+static void inflight_remove(struct mqtt_client *client, int idx)
+{
+	inflight_drop_packet(client, idx);
+
+	client->internal.inflight_count--;
+
+	memmove(&client->internal.inflight[idx],
+		&client->internal.inflight[idx + 1],
+		(client->internal.inflight_count - idx) *
+		sizeof(client->internal.inflight[0]));
+}
+
+int mqtt_inflight_add(struct mqtt_client *client, uint16_t message_id,
+		      uint8_t qos, const uint8_t *header, uint32_t header_len,
+		      const struct mqtt_binstr *payload)
+{
+	struct mqtt_inflight_msg *msg;
+	uint32_t len = header_len + payload->len;
+	uint32_t used;
+
+	/* Sent again by the application, the message is already tracked. */
+	if (inflight_find(client, message_id) >= 0) {
+		return 0;
+	}
+
+	if (client->internal.inflight_count >=
+	    ARRAY_SIZE(client->internal.inflight)) {
+		NET_DBG("[CID %p]: In-flight window full", client);
+		return -EAGAIN;
+	}
+
+	used = inflight_offset(client, client->internal.inflight_count);
+
+	msg = &client->internal.inflight[client->internal.inflight_count++];
+	msg->message_id = message_id;
+	msg->qos = qos;
+	msg->released = 0U;
+	msg->len = 0U;
+
+	if (client->inflight_buf == NULL) {
+		return 0;
+	}
+
+	if (len > UINT16_MAX || len > client->inflight_buf_size - used) {
+		NET_WARN("[CID %p]: No room to store message 0x%04x, it will "
+			 "not be sent again", client, message_id);
+		return 0;
+	}
+
+	memcpy(client->inflight_buf + used, header, header_len);
+	memcpy(client->inflight_buf + used + header_len, payload->data,
+	       payload->len);
+	msg->len = len;
+
+	return 0;
+}
+
+void mqtt_inflight_ack(struct mqtt_client *client, uint8_t type,
+		       uint16_t message_id)
+{
+	struct mqtt_inflight_msg *msg;
+	int idx;
+
+	idx = inflight_find(client, message_id);
+	if (idx < 0) {
+		return;
+	}
+
+	msg = &client->internal.inflight[idx];
+
+	switch (type) {
+	case MQTT_PKT_TYPE_PUBACK:
+		if (msg->qos == MQTT_QOS_1_AT_LEAST_ONCE) {
+			inflight_remove(client, idx);
+		}
+
+		break;
+
+	case MQTT_PKT_TYPE_PUBREC:
+		/* From now on PUBREL is sent again instead of PUBLISH. */
+		if (msg->qos == MQTT_QOS_2_EXACTLY_ONCE && !msg->released) {
+			inflight_drop_packet(client, idx);
+			msg->released = 1U;
+		}
+
+		break;
+
+	case MQTT_PKT_TYPE_PUBCOMP:
+		if (msg->released) {
+			inflight_remove(client, idx);
+		}
+
+		break;
+	}
+}
+
+int mqtt_inflight_resend(struct mqtt_client *client)
+{
+	uint8_t pubrel[MQTT_FIXED_HEADER_MAX_SIZE + sizeof(uint16_t)];
+	struct mqtt_pubrel_param param;
+	struct buf_ctx packet;
+	uint32_t offset = 0U;
+	int err_code;
+	int i = 0;
+
+	if (client->clean_session) {
+		/* The session and its messages are gone. */
+		client->internal.inflight_count = 0U;
+		return 0;
+	}
+
+	while (i < client->internal.inflight_count) {
+		struct mqtt_inflight_msg *msg = &client->internal.inflight[i];
+
+		if (msg->released) {
+			param.message_id = msg->message_id;
+			packet.cur = pubrel;
+			packet.end = pubrel + sizeof(pubrel);
+
+			err_code = publish_release_encode(&param, &packet);
+			if (err_code == 0) {
+				err_code = mqtt_transport_write(client,
+						packet.cur,
+						packet.end - packet.cur);
+			}
+		} else if (msg->len > 0U) {
+			client->inflight_buf[offset] |= MQTT_HEADER_DUP_MASK;
+
+			err_code = mqtt_transport_write(client,
+						client->inflight_buf + offset,
+						msg->len);
+		} else {
+			NET_WARN("[CID %p]: Message 0x%04x was not stored, "
+				 "dropping it", client, msg->message_id);
+			inflight_remove(client, i);
+			continue;
+		}
+
+		if (err_code < 0) {
+			return err_code;
+		}
+
+		NET_DBG("[CID %p]: Sent message 0x%04x again", client,
+			msg->message_id);
+
+		offset += msg->len;
+		i++;
+	}
+
+	return 0;
+}
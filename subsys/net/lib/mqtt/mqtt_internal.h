@@ -393,6 +393,39 @@ int subscribe_ack_decode(struct buf_ctx *buf,
 int unsubscribe_ack_decode(struct buf_ctx *buf,
 			   struct mqtt_unsuback_param *param);
 
+/**@brief Add a QoS 1 or QoS 2 message to the in-flight window.
+ *
+ * @param[in] client Identifies the client publishing the message.
+ * @param[in] message_id Message id of the message.
+ * @param[in] qos QoS of the message.
+ * @param[in] header Encoded PUBLISH packet, without the payload.
+ * @param[in] header_len Length of the encoded PUBLISH packet.
+ * @param[in] payload Payload of the message.
+ *
+ * @return 0 if the procedure is successful, -EAGAIN if the window is full.
+ */
+int mqtt_inflight_add(struct mqtt_client *client, uint16_t message_id,
+		      uint8_t qos, const uint8_t *header, uint32_t header_len,
+		      const struct mqtt_binstr *payload);
+
+/**@brief Update the in-flight window on a PUBACK, PUBREC or PUBCOMP.
+ *
+ * @param[in] client Identifies the client receiving the acknowledgment.
+ * @param[in] type Packet type of the acknowledgment.
+ * @param[in] message_id Message id being acknowledged.
+ */
+void mqtt_inflight_ack(struct mqtt_client *client, uint8_t type,
+		       uint16_t message_id);
+
+/**@brief Send the messages in flight again after reconnecting, or forget
+ *        them if the client started a clean session.
+ *
+ * @param[in] client Identifies the client that reconnected.
+ *
+ * @return 0 if the procedure is successful, an error code otherwise.
+ */
+int mqtt_inflight_resend(struct mqtt_client *client);
+
 #ifdef __cplusplus
 }
 #endif
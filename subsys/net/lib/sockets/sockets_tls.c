@@ -48,8 +48,15 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 #include <mbedtls/debug.h>
 #include <mbedtls/platform.h>
 #include <mbedtls/ssl_cache.h>
+#include <mbedtls/ssl_ticket.h>
 #endif /* CONFIG_MBEDTLS */
 
+#if defined(CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_SETTINGS)
+#include <stdlib.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/byteorder.h>
+#endif
+
 #include "sockets_internal.h"
 #include "tls_internal.h"
 
@@ -61,6 +68,19 @@ LOG_MODULE_REGISTER(net_sock_tls, CONFIG_NET_SOCKETS_LOG_LEVEL);
 
 static const struct socket_op_vtable tls_sock_fd_op_vtable;
 
+#if defined(CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS) && \
+	defined(MBEDTLS_SSL_TICKET_C)
+#define TLS_SERVER_TICKETS
+
+#if defined(MBEDTLS_GCM_C)
+#define TLS_TICKET_CIPHER MBEDTLS_CIPHER_AES_256_GCM
+#elif defined(MBEDTLS_CCM_C)
+#define TLS_TICKET_CIPHER MBEDTLS_CIPHER_AES_256_CCM
+#else
+#define TLS_TICKET_CIPHER MBEDTLS_CIPHER_CHACHA20_POLY1305
+#endif
+#endif /* CONFIG_NET_SOCKETS_TLS_SESSION_TICKETS && MBEDTLS_SSL_TICKET_C */
+
 #ifndef MBEDTLS_ERR_SSL_PEER_VERIFY_FAILED
 #define MBEDTLS_ERR_SSL_PEER_VERIFY_FAILED MBEDTLS_ERR_SSL_UNEXPECTED_MESSAGE
 #endif
@@ -98,6 +118,17 @@ struct tls_session_cache {
 	/** Peer address. */
 	struct sockaddr peer_addr;
 
+	/** Hash of the peer address, see peer_addr_hash(). */
+	uint32_t hash;
+
+#if defined(CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_SETTINGS)
+	/** Information whether the session is in the settings storage. */
+	bool stored;
+
+	/** Remaining lifetime stored with the session [s]. */
+	uint32_t stored_lifetime;
+#endif
+
 	/** Session buffer. */
 	uint8_t *session;
 
@@ -134,6 +165,20 @@ __net_socket struct tls_context {
 	/** Information whether TLS handshake is complete or not. */
 	struct k_sem tls_established;
 
+	/** Information whether the current handshake is being timed. */
+	bool handshake_timed;
+
+	/** Start time of the current handshake. */
+	uint32_t handshake_start;
+
+	/** Handshake statistics, reported with TLS_HANDSHAKE_STATS. */
+	struct tls_handshake_stats stats;
+
+#if defined(TLS_SERVER_TICKETS)
+	/** Information whether the context uses the shared ticket keys. */
+	bool tickets_used;
+#endif
+
 	/** TLS specific option values. */
 	struct {
 		/** Select which credentials to use with TLS. */
@@ -217,15 +262,153 @@ static struct tls_session_cache client_cache[CONFIG_NET_SOCKETS_TLS_MAX_CLIENT_S
 static mbedtls_ssl_cache_context server_cache;
 #endif
 
+#if defined(TLS_SERVER_TICKETS)
+/* Ticket keys shared by all the server sockets, set up on first use.
+ * They are only freed once no context uses them anymore, a purge while
+ * they are in use marks them stale instead. Protected by context_lock.
+ */
+static mbedtls_ssl_ticket_context ticket_ctx;
+static bool ticket_ctx_ready;
+static bool ticket_ctx_stale;
+static int ticket_ctx_users;
+#endif
+
 /* A mutex for protecting TLS context allocation. */
 static struct k_mutex context_lock;
 
+#if defined(CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_SETTINGS)
+#define TLS_SESSION_SETTINGS_ROOT "tls_sess"
+#define TLS_SESSION_SETTINGS_KEY_LEN (sizeof(TLS_SESSION_SETTINGS_ROOT) + 11)
+
+static void tls_session_settings_key(const struct tls_session_cache *entry,
+				     char *key)
+{
+	snprintk(key, TLS_SESSION_SETTINGS_KEY_LEN,
+		 TLS_SESSION_SETTINGS_ROOT "/%u",
+		 (unsigned int)(entry - client_cache));
+}
+
+#define TLS_SESSION_LIFETIME_MS \
+	((int64_t)CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_LIFETIME * MSEC_PER_SEC)
+
+/* Stored sessions only age while the system is running: there is no clock
+ * to tell how long it was off.
+ */
+static uint32_t tls_session_lifetime_left(const struct tls_session_cache *entry)
+{
+	int64_t left;
+
+	if (CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_LIFETIME == 0) {
+		return 0;
+	}
+
+	left = TLS_SESSION_LIFETIME_MS - (k_uptime_get() - entry->timestamp);
+	if (left <= 0) {
+		return 0;
+	}
+
+	return DIV_ROUND_UP(left, MSEC_PER_SEC);
+}
+
+/* Sessions are stored as the peer address, then the remaining lifetime in
+ * seconds, then the session data.
+ */
+static void tls_session_persist(struct tls_session_cache *entry)
+{
+	char key[TLS_SESSION_SETTINGS_KEY_LEN];
+	uint32_t lifetime = tls_session_lifetime_left(entry);
+	size_t len = sizeof(entry->peer_addr) + sizeof(lifetime) +
+		     entry->session_len;
+	uint8_t *value;
+	int ret;
+
+	value = mbedtls_calloc(1, len);
+	if (value == NULL) {
+		NET_WARN("No memory to store the session");
+		return;
+	}
+
+	memcpy(value, &entry->peer_addr, sizeof(entry->peer_addr));
+	sys_put_le32(lifetime, value + sizeof(entry->peer_addr));
+	memcpy(value + sizeof(entry->peer_addr) + sizeof(lifetime),
+	       entry->session, entry->session_len);
+
+	tls_session_settings_key(entry, key);
+
+	ret = settings_save_one(key, value, len);
+	if (ret < 0) {
+		NET_WARN("Failed to store the session (%d)", ret);
+	} else {
+		entry->stored = true;
+		entry->stored_lifetime = lifetime;
+	}
+
+	mbedtls_free(value);
+}
+
+/* Store the remaining lifetime again once it is an eighth of the lifetime
+ * below the stored one, so that restarts do not keep renewing the session
+ * while it is only written a few times over its lifetime.
+ */
+static void tls_session_persist_lifetime(struct tls_session_cache *entry)
+{
+	uint32_t left = tls_session_lifetime_left(entry);
+
+	if (CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_LIFETIME == 0 ||
+	    !entry->stored || entry->stored_lifetime <= left) {
+		return;
+	}
+
+	if (entry->stored_lifetime - left >=
+	    CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_LIFETIME / 8) {
+		tls_session_persist(entry);
+	}
+}
+
+static void tls_session_unpersist(struct tls_session_cache *entry)
+{
+	char key[TLS_SESSION_SETTINGS_KEY_LEN];
+
+	if (!entry->stored) {
+		return;
+	}
+
+	tls_session_settings_key(entry, key);
+
+	(void)settings_delete(key);
+	entry->stored = false;
+}
+#else
+static inline void tls_session_persist(struct tls_session_cache *entry)
+{
+	ARG_UNUSED(entry);
+}
+
+static inline void tls_session_persist_lifetime(struct tls_session_cache *entry)
+{
+	ARG_UNUSED(entry);
+}
+
+static inline void tls_session_unpersist(struct tls_session_cache *entry)
+{
+	ARG_UNUSED(entry);
+}
+#endif /* CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_SETTINGS */
+
+static void tls_session_free(struct tls_session_cache *entry)
+{
+	if (entry->session != NULL) {
+		mbedtls_free(entry->session);
+		entry->session = NULL;
+	}
+
+	tls_session_unpersist(entry);
+}
+
 static void tls_session_cache_reset(void)
 {
 	for (int i = 0; i < ARRAY_SIZE(client_cache); i++) {
-		if (client_cache[i].session != NULL) {
-			mbedtls_free(client_cache[i].session);
-		}
+		tls_session_free(&client_cache[i]);
 	}
 
 	(void)memset(client_cache, 0, sizeof(client_cache));
@@ -342,6 +525,10 @@ static int tls_init(const struct device *unused)
 	mbedtls_ssl_cache_init(&server_cache);
 #endif
 
+#if defined(TLS_SERVER_TICKETS)
+	mbedtls_ssl_ticket_init(&ticket_ctx);
+#endif
+
 	return 0;
 }
 
@@ -477,6 +664,73 @@ static struct tls_context *tls_clone(struct tls_context *source_tls)
 	return target_tls;
 }
 
+#if defined(TLS_SERVER_TICKETS)
+static void tls_session_tickets_reset(void)
+{
+	mbedtls_ssl_ticket_free(&ticket_ctx);
+	mbedtls_ssl_ticket_init(&ticket_ctx);
+	ticket_ctx_ready = false;
+	ticket_ctx_stale = false;
+}
+
+/* Take a reference to the ticket keys, setting them up if needed. Stale
+ * keys are not handed out, so that the tickets issued before a purge are
+ * only accepted by the contexts already using them.
+ */
+static int tls_session_tickets_get(struct tls_context *context)
+{
+	int ret = 0;
+
+	k_mutex_lock(&context_lock, K_FOREVER);
+
+	if (context->tickets_used) {
+		goto out;
+	}
+
+	if (ticket_ctx_stale) {
+		ret = -EBUSY;
+		goto out;
+	}
+
+	if (!ticket_ctx_ready) {
+		ret = mbedtls_ssl_ticket_setup(
+				&ticket_ctx, tls_ctr_drbg_random, NULL,
+				TLS_TICKET_CIPHER,
+				CONFIG_NET_SOCKETS_TLS_SESSION_TICKET_LIFETIME);
+		if (ret != 0) {
+			tls_session_tickets_reset();
+			goto out;
+		}
+
+		ticket_ctx_ready = true;
+	}
+
+	context->tickets_used = true;
+	ticket_ctx_users++;
+
+out:
+	k_mutex_unlock(&context_lock);
+
+	return ret;
+}
+
+static void tls_session_tickets_put(struct tls_context *context)
+{
+	k_mutex_lock(&context_lock, K_FOREVER);
+
+	if (context->tickets_used) {
+		context->tickets_used = false;
+		ticket_ctx_users--;
+
+		if (ticket_ctx_users == 0 && ticket_ctx_stale) {
+			tls_session_tickets_reset();
+		}
+	}
+
+	k_mutex_unlock(&context_lock);
+}
+#endif /* TLS_SERVER_TICKETS */
+
 /* Release TLS context. */
 static int tls_release(struct tls_context *tls)
 {
@@ -492,6 +746,9 @@ static int tls_release(struct tls_context *tls)
 
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	mbedtls_ssl_cookie_free(&tls->cookie);
+#endif
+#if defined(TLS_SERVER_TICKETS)
+	tls_session_tickets_put(tls);
 #endif
 	mbedtls_ssl_config_free(&tls->config);
 	mbedtls_ssl_free(&tls->ssl);
@@ -530,80 +787,167 @@ static bool peer_addr_cmp(const struct sockaddr *addr,
 	return false;
 }
 
-static int tls_session_save(const struct sockaddr *peer_addr,
-			    mbedtls_ssl_session *session)
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t len)
 {
-	struct tls_session_cache *entry = NULL;
-	size_t session_len;
-	int ret;
+	const uint8_t *p = data;
+
+	for (size_t i = 0; i < len; i++) {
+		hash = (hash ^ p[i]) * 16777619U;
+	}
+
+	return hash;
+}
+
+static uint32_t peer_addr_hash(const struct sockaddr *addr)
+{
+	uint32_t hash = fnv1a(2166136261U, &addr->sa_family,
+			      sizeof(addr->sa_family));
+
+	if (IS_ENABLED(CONFIG_NET_IPV6) && addr->sa_family == AF_INET6) {
+		hash = fnv1a(hash, &net_sin6(addr)->sin6_port,
+			     sizeof(net_sin6(addr)->sin6_port));
+		hash = fnv1a(hash, &net_sin6(addr)->sin6_addr,
+			     sizeof(net_sin6(addr)->sin6_addr));
+	} else if (IS_ENABLED(CONFIG_NET_IPV4) && addr->sa_family == AF_INET) {
+		hash = fnv1a(hash, &net_sin(addr)->sin_port,
+			     sizeof(net_sin(addr)->sin_port));
+		hash = fnv1a(hash, &net_sin(addr)->sin_addr,
+			     sizeof(net_sin(addr)->sin_addr));
+	}
+
+	return hash;
+}
+
+static bool tls_session_expired(const struct tls_session_cache *entry,
+				int64_t now)
+{
+	return CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_LIFETIME > 0 &&
+	       now - entry->timestamp >=
+	       (int64_t)CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_LIFETIME *
+	       MSEC_PER_SEC;
+}
+
+/* Sessions are placed starting from the slot picked by the peer address
+ * hash, so a lookup usually ends at the first slot it probes. The hash is
+ * compared before the address itself.
+ */
+static struct tls_session_cache *tls_session_find(
+		const struct sockaddr *peer_addr, uint32_t hash)
+{
+	struct tls_session_cache *entry;
+	size_t slot = hash % ARRAY_SIZE(client_cache);
 
 	for (int i = 0; i < ARRAY_SIZE(client_cache); i++) {
-		if (client_cache[i].session == NULL) {
-			/* New entry. */
-			if (entry == NULL || entry->session != NULL) {
-				entry = &client_cache[i];
-			}
-		} else {
-			if (peer_addr_cmp(&client_cache[i].peer_addr, peer_addr)) {
-				/* Reuse old entry for given address. */
-				entry = &client_cache[i];
-				break;
-			}
+		entry = &client_cache[(slot + i) % ARRAY_SIZE(client_cache)];
 
-			/* Remember the oldest entry and reuse if needed. */
-			if (entry == NULL ||
-			    (entry->session != NULL &&
-			     entry->timestamp < client_cache[i].timestamp)) {
-				entry = &client_cache[i];
-			}
+		if (entry->session == NULL || entry->hash != hash ||
+		    !peer_addr_cmp(&entry->peer_addr, peer_addr)) {
+			continue;
+		}
+
+		if (tls_session_expired(entry, k_uptime_get())) {
+			tls_session_free(entry);
+			return NULL;
 		}
+
+		return entry;
 	}
 
-	/* Allocate session and save */
+	return NULL;
+}
 
-	if (entry->session != NULL) {
-		mbedtls_free(entry->session);
-		entry->session = NULL;
+static struct tls_session_cache *tls_session_slot(
+		const struct sockaddr *peer_addr, uint32_t hash)
+{
+	struct tls_session_cache *entry, *oldest = NULL;
+	size_t slot = hash % ARRAY_SIZE(client_cache);
+	int64_t now = k_uptime_get();
+
+	/* Reuse old entry for given address. */
+	entry = tls_session_find(peer_addr, hash);
+	if (entry != NULL) {
+		return entry;
 	}
 
+	for (int i = 0; i < ARRAY_SIZE(client_cache); i++) {
+		entry = &client_cache[(slot + i) % ARRAY_SIZE(client_cache)];
+
+		if (entry->session == NULL || tls_session_expired(entry, now)) {
+			return entry;
+		}
+
+		/* Remember the oldest entry and reuse if needed. */
+		if (oldest == NULL || entry->timestamp < oldest->timestamp) {
+			oldest = entry;
+		}
+	}
+
+	return oldest;
+}
+
+static int tls_session_save(const struct sockaddr *peer_addr,
+			    mbedtls_ssl_session *session)
+{
+	struct tls_session_cache *entry;
+	uint32_t hash = peer_addr_hash(peer_addr);
+	size_t session_len;
+	uint8_t *buf;
+	int ret;
+
+	entry = tls_session_slot(peer_addr, hash);
+
+	/* Serialize session */
+
 	(void)mbedtls_ssl_session_save(session, NULL, 0, &session_len);
 
-	entry->session = mbedtls_calloc(1, session_len);
-	if (entry->session == NULL) {
+	buf = mbedtls_calloc(1, session_len);
+	if (buf == NULL) {
 		NET_ERR("Failed to allocate session buffer.");
 		return -ENOMEM;
 	}
 
-	ret = mbedtls_ssl_session_save(session, entry->session, session_len,
+	ret = mbedtls_ssl_session_save(session, buf, session_len,
 				       &session_len);
 	if (ret < 0) {
 		NET_ERR("Failed to serialize session, err: 0x%x.", -ret);
-		mbedtls_free(entry->session);
-		entry->session = NULL;
+		mbedtls_free(buf);
 		return -ENOMEM;
 	}
 
+	/* A resumed session is saved unchanged unless the server issued a
+	 * new ticket. Keep it as is then: its lifetime still counts from the
+	 * full handshake, like the lifetime of its ticket.
+	 */
+	if (entry->session != NULL && entry->hash == hash &&
+	    peer_addr_cmp(&entry->peer_addr, peer_addr) &&
+	    entry->session_len == session_len &&
+	    memcmp(entry->session, buf, session_len) == 0) {
+		mbedtls_free(buf);
+		return 0;
+	}
+
+	if (entry->session != NULL) {
+		mbedtls_free(entry->session);
+	}
+
+	entry->session = buf;
 	entry->session_len = session_len;
 	entry->timestamp = k_uptime_get();
+	entry->hash = hash;
 	memcpy(&entry->peer_addr, peer_addr, sizeof(*peer_addr));
 
+	tls_session_persist(entry);
+
 	return 0;
 }
 
 static int tls_session_get(const struct sockaddr *peer_addr,
 			   mbedtls_ssl_session *session)
 {
-	struct tls_session_cache *entry = NULL;
+	struct tls_session_cache *entry;
 	int ret;
 
-	for (int i = 0; i < ARRAY_SIZE(client_cache); i++) {
-		if (client_cache[i].session != NULL &&
-		    peer_addr_cmp(&client_cache[i].peer_addr, peer_addr)) {
-			entry = &client_cache[i];
-			break;
-		}
-	}
-
+	entry = tls_session_find(peer_addr, peer_addr_hash(peer_addr));
 	if (entry == NULL) {
 		return -ENOENT;
 	}
@@ -612,14 +956,90 @@ static int tls_session_get(const struct sockaddr *peer_addr,
 				       entry->session_len);
 	if (ret < 0) {
 		/* Discard corrupted session data. */
+		tls_session_free(entry);
+		return -EIO;
+	}
+
+	tls_session_persist_lifetime(entry);
+
+	return 0;
+}
+
+#if defined(CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_SETTINGS)
+static int tls_session_settings_set(const char *name, size_t len,
+				    settings_read_cb read_cb, void *cb_arg)
+{
+	struct tls_session_cache *entry;
+	size_t hdr_len = sizeof(entry->peer_addr) + sizeof(uint32_t);
+	unsigned long slot;
+	uint32_t lifetime;
+	uint8_t *value;
+	char *end;
+	ssize_t ret;
+
+	slot = strtoul(name, &end, 10);
+	if (end == name || *end != '\0' ||
+	    slot >= ARRAY_SIZE(client_cache) || len <= hdr_len) {
+		/* Stored with a different configuration, ignore. */
+		return 0;
+	}
+
+	value = mbedtls_calloc(1, len);
+	if (value == NULL) {
+		return -ENOMEM;
+	}
+
+	ret = read_cb(cb_arg, value, len);
+	if (ret != (ssize_t)len) {
+		mbedtls_free(value);
+		return ret < 0 ? ret : -EIO;
+	}
+
+	entry = &client_cache[slot];
+	if (entry->session != NULL) {
 		mbedtls_free(entry->session);
 		entry->session = NULL;
-		return -EIO;
+	}
+
+	/* Deleted along with the next session stored in the slot, or on
+	 * purge.
+	 */
+	entry->stored = true;
+
+	lifetime = sys_get_le32(value + sizeof(entry->peer_addr));
+	if (CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_LIFETIME > 0) {
+		if (lifetime == 0) {
+			/* Expired, drop it */
+			mbedtls_free(value);
+			return 0;
+		}
+
+		lifetime = MIN(lifetime,
+			       CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_LIFETIME);
+	}
+
+	memcpy(&entry->peer_addr, value, sizeof(entry->peer_addr));
+	entry->session_len = len - hdr_len;
+	memmove(value, value + hdr_len, entry->session_len);
+
+	entry->session = value;
+	entry->hash = peer_addr_hash(&entry->peer_addr);
+	entry->stored_lifetime = lifetime;
+
+	/* Age the session by the lifetime it already used */
+	entry->timestamp = k_uptime_get();
+	if (CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_LIFETIME > 0) {
+		entry->timestamp -= TLS_SESSION_LIFETIME_MS -
+				    (int64_t)lifetime * MSEC_PER_SEC;
 	}
 
 	return 0;
 }
 
+SETTINGS_STATIC_HANDLER_DEFINE(tls_sess, TLS_SESSION_SETTINGS_ROOT, NULL,
+			       tls_session_settings_set, NULL, NULL);
+#endif /* CONFIG_NET_SOCKETS_TLS_CLIENT_SESSION_SETTINGS */
+
 static void tls_session_store(struct tls_context *context,
 			      const struct sockaddr *addr,
 			      socklen_t addrlen)
@@ -658,6 +1078,8 @@ static void tls_session_restore(struct tls_context *context,
 	struct sockaddr peer_addr = { 0 };
 	int ret;
 
+	context->stats.session_offered = 0U;
+
 	if (!context->options.cache_enabled) {
 		return;
 	}
@@ -674,12 +1096,63 @@ static void tls_session_restore(struct tls_context *context,
 	ret = mbedtls_ssl_set_session(&context->ssl, &session);
 	if (ret < 0) {
 		NET_ERR("Failed to set session for %p", context);
+	} else {
+		context->stats.session_offered = 1U;
 	}
 
 exit:
 	mbedtls_ssl_session_free(&session);
 }
 
+#if defined(TLS_SERVER_TICKETS)
+static int tls_ticket_write(void *p_ticket, const mbedtls_ssl_session *session,
+			    unsigned char *start, const unsigned char *end,
+			    size_t *tlen, uint32_t *lifetime)
+{
+	ARG_UNUSED(p_ticket);
+
+	return mbedtls_ssl_ticket_write(&ticket_ctx, session, start, end,
+					tlen, lifetime);
+}
+
+/* A ticket that parses fine resumes the session. */
+static int tls_ticket_parse(void *p_ticket, mbedtls_ssl_session *session,
+			    unsigned char *buf, size_t len)
+{
+	struct tls_context *context = p_ticket;
+	int ret;
+
+	ret = mbedtls_ssl_ticket_parse(&ticket_ctx, session, buf, len);
+	if (ret == 0) {
+		context->stats.session_resumed = 1U;
+	}
+
+	return ret;
+}
+#endif /* TLS_SERVER_TICKETS */
+
+#if defined(MBEDTLS_SSL_CACHE_C)
+static int tls_server_cache_get(void *data, mbedtls_ssl_session *session)
+{
+	struct tls_context *context = data;
+	int ret;
+
+	ret = mbedtls_ssl_cache_get(&server_cache, session);
+	if (ret == 0) {
+		context->stats.session_resumed = 1U;
+	}
+
+	return ret;
+}
+
+static int tls_server_cache_set(void *data, const mbedtls_ssl_session *session)
+{
+	ARG_UNUSED(data);
+
+	return mbedtls_ssl_cache_set(&server_cache, session);
+}
+#endif /* MBEDTLS_SSL_CACHE_C */
+
 static void tls_session_purge(void)
 {
 	tls_session_cache_reset();
@@ -688,6 +1161,20 @@ static void tls_session_purge(void)
 	mbedtls_ssl_cache_free(&server_cache);
 	mbedtls_ssl_cache_init(&server_cache);
 #endif
+
+#if defined(TLS_SERVER_TICKETS)
+	/* New ticket keys are generated on next use, so that the tickets
+	 * issued so far cannot be used anymore. Keys still in use are freed
+	 * by the last context releasing them.
+	 */
+	k_mutex_lock(&context_lock, K_FOREVER);
+	if (ticket_ctx_users == 0) {
+		tls_session_tickets_reset();
+	} else {
+		ticket_ctx_stale = true;
+	}
+	k_mutex_unlock(&context_lock);
+#endif
 }
 
 static inline int time_left(uint32_t start, uint32_t timeout)
@@ -1125,6 +1612,12 @@ static int tls_mbedtls_handshake(struct tls_context *context, bool block)
 
 	context->handshake_in_progress = true;
 
+	if (!context->handshake_timed) {
+		context->handshake_timed = true;
+		context->handshake_start = k_uptime_get_32();
+		context->stats.session_resumed = 0U;
+	}
+
 	while ((ret = mbedtls_ssl_handshake(&context->ssl)) != 0) {
 		if (ret == MBEDTLS_ERR_SSL_WANT_READ ||
 		    ret == MBEDTLS_ERR_SSL_WANT_WRITE ||
@@ -1179,9 +1672,17 @@ static int tls_mbedtls_handshake(struct tls_context *context, bool block)
 	}
 
 	if (ret == 0) {
+		context->stats.duration_ms =
+			k_uptime_get_32() - context->handshake_start;
+		context->stats.count++;
+
 		k_sem_give(&context->tls_established);
 	}
 
+	if (ret != -EAGAIN) {
+		context->handshake_timed = false;
+	}
+
 	context->handshake_in_progress = false;
 
 	return ret;
@@ -1304,9 +1805,33 @@ static int tls_mbedtls_init(struct tls_context *context, bool is_server)
 
 #if defined(MBEDTLS_SSL_CACHE_C)
 	if (is_server && context->options.cache_enabled) {
-		mbedtls_ssl_conf_session_cache(&context->config, &server_cache,
-					       mbedtls_ssl_cache_get,
-					       mbedtls_ssl_cache_set);
+		mbedtls_ssl_conf_session_cache(&context->config, context,
+					       tls_server_cache_get,
+					       tls_server_cache_set);
+	}
+#endif
+
+#if defined(TLS_SERVER_TICKETS)
+	if (is_server && context->options.cache_enabled) {
+		ret = tls_session_tickets_get(context);
+		if (ret == 0) {
+			mbedtls_ssl_conf_session_tickets_cb(&context->config,
+							    tls_ticket_write,
+							    tls_ticket_parse,
+							    context);
+		} else if (ret != -EBUSY) {
+			NET_WARN("Failed to set up session tickets");
+		}
+	}
+#endif
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_CLI_C)
+	if (!is_server) {
+		/* Tickets would not be stored anyway. */
+		mbedtls_ssl_conf_session_tickets(&context->config,
+				context->options.cache_enabled ?
+				MBEDTLS_SSL_SESSION_TICKETS_ENABLED :
+				MBEDTLS_SSL_SESSION_TICKETS_DISABLED);
 	}
 #endif
 
@@ -1624,6 +2149,18 @@ static int tls_opt_session_cache_get(struct tls_context *context,
 	return 0;
 }
 
+static int tls_opt_handshake_stats_get(struct tls_context *context,
+				       void *optval, socklen_t *optlen)
+{
+	if (*optlen != sizeof(context->stats)) {
+		return -EINVAL;
+	}
+
+	memcpy(optval, &context->stats, sizeof(context->stats));
+
+	return 0;
+}
+
 static int tls_opt_session_cache_purge_set(struct tls_context *context,
 					   const void *optval, socklen_t optlen)
 {
@@ -2796,6 +3333,10 @@ int ztls_getsockopt_ctx(struct tls_context *ctx, int level, int optname,
 		err = tls_opt_session_cache_get(ctx, optval, optlen);
 		break;
 
+	case TLS_HANDSHAKE_STATS:
+		err = tls_opt_handshake_stats_get(ctx, optval, optlen);
+		break;
+
 #if defined(CONFIG_NET_SOCKETS_ENABLE_DTLS)
 	case TLS_DTLS_HANDSHAKE_TIMEOUT_MIN:
 		err = tls_opt_dtls_handshake_timeout_get(ctx, optval,
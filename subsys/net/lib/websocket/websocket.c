@@ -54,7 +54,7 @@ static struct k_sem contexts_lock;
 static const struct socket_op_vtable websocket_fd_op_vtable;
 
 #if defined(CONFIG_NET_TEST)
-int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg);
+int verify_sent_and_received_msg(struct msghdr *msg);
 #endif
 
 static const char *opcode2str(enum websocket_opcode opcode)
@@ -570,16 +570,22 @@ static int websocket_prepare_and_send(struct websocket_context *ctx,
 {
 	struct iovec io_vector[2];
 	struct msghdr msg;
+	int i = 0;
 
-	io_vector[0].iov_base = header;
-	io_vector[0].iov_len = header_len;
-	io_vector[1].iov_base = payload;
-	io_vector[1].iov_len = payload_len;
+	if (header_len > 0) {
+		io_vector[i].iov_base = header;
+		io_vector[i].iov_len = header_len;
+		i++;
+	}
+
+	io_vector[i].iov_base = payload;
+	io_vector[i].iov_len = payload_len;
+	i++;
 
 	memset(&msg, 0, sizeof(msg));
 
 	msg.msg_iov = io_vector;
-	msg.msg_iovlen = ARRAY_SIZE(io_vector);
+	msg.msg_iovlen = i;
 
 	if (HEXDUMP_SENT_PACKETS) {
 		LOG_HEXDUMP_DBG(header, header_len, "Header");
@@ -587,10 +593,10 @@ static int websocket_prepare_and_send(struct websocket_context *ctx,
 	}
 
 #if defined(CONFIG_NET_TEST)
-	/* Simulate a case where the payload is split to two. The unit test
-	 * does not set mask bit in this case.
+	/* The unit test collects the frame and feeds it to the receive
+	 * function once it is complete.
 	 */
-	return verify_sent_and_received_msg(&msg, !(header[1] & BIT(7)));
+	return verify_sent_and_received_msg(&msg);
 #else
 	k_timeout_t tout = K_FOREVER;
 
@@ -603,13 +609,87 @@ static int websocket_prepare_and_send(struct websocket_context *ctx,
 #endif /* CONFIG_NET_TEST */
 }
 
+/* XOR len bytes of src with the masking key into dst, which may be src.
+ * The pos is the offset of src[0] in the payload, it selects the byte of
+ * the key that src[0] is masked with.
+ */
+static void websocket_mask(uint8_t *dst, const uint8_t *src, size_t len,
+			   uint32_t mask, size_t pos)
+{
+	union {
+		uint8_t bytes[sizeof(uintptr_t)];
+		uintptr_t word;
+	} key;
+	size_t i = 0;
+	int j;
+
+	/* Mask byte by byte until dst is word aligned */
+	while (i < len && !IS_PTR_ALIGNED(&dst[i], uintptr_t)) {
+		dst[i] = src[i] ^ (uint8_t)(mask >> (8 * (3 - (pos + i) % 4)));
+		i++;
+	}
+
+	/* The word size is a multiple of the key size, so the same key word
+	 * lines up with every remaining word of the data.
+	 */
+	for (j = 0; j < sizeof(key.bytes); j++) {
+		key.bytes[j] = mask >> (8 * (3 - (pos + i + j) % 4));
+	}
+
+	while (len - i >= sizeof(uintptr_t)) {
+		*(uintptr_t *)&dst[i] =
+			UNALIGNED_GET((const uintptr_t *)&src[i]) ^ key.word;
+		i += sizeof(uintptr_t);
+	}
+
+	while (i < len) {
+		dst[i] = src[i] ^ (uint8_t)(mask >> (8 * (3 - (pos + i) % 4)));
+		i++;
+	}
+}
+
+/* Mask the payload into a scratch buffer and send it a chunk at a time, the
+ * header goes out together with the first chunk.
+ */
+static int websocket_send_masked(struct websocket_context *ctx,
+				 uint8_t *header, size_t header_len,
+				 const uint8_t *payload, size_t payload_len,
+				 int32_t timeout)
+{
+	uint8_t chunk[CONFIG_WEBSOCKET_MASK_BUF_SIZE] __aligned(sizeof(uintptr_t));
+	size_t pos = 0;
+	size_t len;
+	int ret;
+
+	do {
+		len = MIN(payload_len - pos, sizeof(chunk));
+
+		websocket_mask(chunk, &payload[pos], len, ctx->masking_value,
+			       pos);
+
+		ret = websocket_prepare_and_send(ctx, header, header_len,
+						 chunk, len, timeout);
+		if (ret < 0) {
+			return ret;
+		}
+
+		/* Once part of the frame is out, the rest of it must follow
+		 * or the peer loses track of the frame boundaries.
+		 */
+		header_len = 0;
+		timeout = SYS_FOREVER_MS;
+		pos += len;
+	} while (pos < payload_len);
+
+	return 0;
+}
+
 int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		       enum websocket_opcode opcode, bool mask, bool final,
 		       int32_t timeout)
 {
 	struct websocket_context *ctx;
 	uint8_t header[MAX_HEADER_LEN], hdr_len = 2;
-	uint8_t *data_to_send = (uint8_t *)payload;
 	int ret;
 
 	if (opcode != WEBSOCKET_OPCODE_DATA_TEXT &&
@@ -673,8 +753,6 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 
 	/* Add masking value if needed */
 	if (mask) {
-		int i;
-
 		ctx->masking_value = sys_rand32_get();
 
 		header[hdr_len++] |= ctx->masking_value >> 24;
@@ -682,32 +760,20 @@ int websocket_send_msg(int ws_sock, const uint8_t *payload, size_t payload_len,
 		header[hdr_len++] |= ctx->masking_value >> 8;
 		header[hdr_len++] |= ctx->masking_value;
 
-		data_to_send = k_malloc(payload_len);
-		if (!data_to_send) {
-			return -ENOMEM;
-		}
-
-		memcpy(data_to_send, payload, payload_len);
-
-		for (i = 0; i < payload_len; i++) {
-			data_to_send[i] ^=
-				ctx->masking_value >> (8 * (3 - i % 4));
-		}
+		ret = websocket_send_masked(ctx, header, hdr_len, payload,
+					    payload_len, timeout);
+	} else {
+		ret = websocket_prepare_and_send(ctx, header, hdr_len,
+						 (uint8_t *)payload,
+						 payload_len, timeout);
 	}
 
-	ret = websocket_prepare_and_send(ctx, header, hdr_len,
-					 data_to_send, payload_len, timeout);
 	if (ret < 0) {
-		NET_DBG("Cannot send ws msg (%d)", -errno);
-		goto quit;
-	}
-
-quit:
-	if (data_to_send != payload) {
-		k_free(data_to_send);
+		NET_DBG("Cannot send ws msg (%d)", ret);
+		return ret;
 	}
 
-	return ret - hdr_len;
+	return payload_len;
 }
 
 static bool websocket_parse_header(uint8_t *buf, size_t buf_len, bool *masked,
@@ -959,13 +1025,11 @@ int websocket_recv_msg(int ws_sock, uint8_t *buf, size_t buf_len,
 		 * which byte from masking value to take. The mask_shift will
 		 * tell that.
 		 */
-		int mask_shift = (ctx->total_read - recv_len) % sizeof(uint32_t);
-		int i;
+		size_t mask_shift = (ctx->total_read - recv_len) %
+							sizeof(uint32_t);
 
-		for (i = 0; i < recv_len; i++) {
-			buf[i] ^= ctx->masking_value >>
-				(8 * (3 - (i + mask_shift) % 4));
-		}
+		websocket_mask(buf, buf, recv_len, ctx->masking_value,
+			       mask_shift);
 	}
 
 #if HEXDUMP_RECV_PACKETS
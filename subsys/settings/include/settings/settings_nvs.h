@@ -33,11 +33,36 @@ extern "C" {
 #define NVS_NAMECNT_ID 0x8000
 #define NVS_NAME_ID_OFFSET 0x4000
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+/* The name index keeps, for every name ID in use, a hash of the setting's
+ * name, so the ID of a setting can be found without reading every name
+ * entry from flash. Slots are indexed by name ID and chained per hash
+ * bucket, NVS_NAMECNT_ID terminates a chain.
+ */
+#define SETTINGS_NVS_NAME_INDEX_BUCKETS \
+	MAX(CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE / 4, 1)
+
+struct settings_nvs_name_index_entry {
+	/* Hash of the full name, 0 if the name ID is not in use */
+	uint32_t hash;
+	/* Next name ID in the same bucket */
+	uint16_t next;
+	/* Hash of the first name component, used to filter subtree loads */
+	uint16_t top_hash;
+};
+#endif
+
 struct settings_nvs {
 	struct settings_store cf_store;
 	struct nvs_fs cf_nvs;
 	uint16_t last_name_id;
 	const char *flash_dev_name;
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+	bool name_index_valid;
+	uint16_t name_index_buckets[SETTINGS_NVS_NAME_INDEX_BUCKETS];
+	struct settings_nvs_name_index_entry
+		name_index[CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE];
+#endif
 };
 
 /* register nvs to be a source of settings */
@@ -27,11 +27,105 @@ K_MUTEX_DEFINE(settings_lock);
 
 void settings_store_init(void);
 
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+#define HANDLER_INDEX_SIZE CONFIG_SETTINGS_HANDLER_INDEX_SIZE
+
+BUILD_ASSERT((HANDLER_INDEX_SIZE & (HANDLER_INDEX_SIZE - 1)) == 0,
+	     "CONFIG_SETTINGS_HANDLER_INDEX_SIZE must be a power of two");
+
+#define HANDLER_HASH_INIT  2166136261U
+#define HANDLER_HASH_PRIME 16777619U
+
+struct settings_handler_index_entry {
+	struct settings_handler_static *handler;
+	uint32_t hash;
+	uint16_t len;
+};
+
+static struct settings_handler_index_entry handler_index[HANDLER_INDEX_SIZE];
+/* Set when a handler did not fit, lookups then use linear search */
+static bool handler_index_full;
+
+static inline uint32_t handler_hash_step(uint32_t hash, char c)
+{
+	return (hash ^ (uint8_t)c) * HANDLER_HASH_PRIME;
+}
+
+static void settings_handler_index_add(struct settings_handler_static *handler)
+{
+	size_t len = strlen(handler->name);
+	uint32_t hash = HANDLER_HASH_INIT;
+	uint32_t idx;
+
+	for (size_t i = 0; i < len; i++) {
+		hash = handler_hash_step(hash, handler->name[i]);
+	}
+
+	idx = hash & (HANDLER_INDEX_SIZE - 1);
+	for (size_t n = 0; n < HANDLER_INDEX_SIZE; n++) {
+		struct settings_handler_index_entry *e = &handler_index[idx];
+
+		/* Same name registered twice: the last one wins, as it does
+		 * for the linear search.
+		 */
+		if (e->handler == NULL ||
+		    (e->hash == hash && e->len == len &&
+		     strcmp(e->handler->name, handler->name) == 0)) {
+			e->handler = handler;
+			e->hash = hash;
+			e->len = len;
+			return;
+		}
+
+		idx = (idx + 1U) & (HANDLER_INDEX_SIZE - 1);
+	}
+
+	LOG_WRN("handler index full, falling back to linear lookup");
+	handler_index_full = true;
+}
+
+static struct settings_handler_static *
+settings_handler_index_find(const char *name, size_t len, uint32_t hash)
+{
+	uint32_t idx = hash & (HANDLER_INDEX_SIZE - 1);
+
+	for (size_t n = 0; n < HANDLER_INDEX_SIZE; n++) {
+		struct settings_handler_index_entry *e = &handler_index[idx];
+
+		if (e->handler == NULL) {
+			break;
+		}
+
+		if (e->hash == hash && e->len == len &&
+		    strncmp(e->handler->name, name, len) == 0) {
+			return e->handler;
+		}
+
+		idx = (idx + 1U) & (HANDLER_INDEX_SIZE - 1);
+	}
+
+	return NULL;
+}
+
+static void settings_handler_index_init(void)
+{
+	memset(handler_index, 0, sizeof(handler_index));
+	handler_index_full = false;
+
+	STRUCT_SECTION_FOREACH(settings_handler_static, ch) {
+		settings_handler_index_add(ch);
+	}
+}
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
+
 void settings_init(void)
 {
 #if defined(CONFIG_SETTINGS_DYNAMIC_HANDLERS)
 	sys_slist_init(&settings_handlers);
 #endif /* CONFIG_SETTINGS_DYNAMIC_HANDLERS */
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+	settings_handler_index_init();
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
 	settings_store_init();
 }
 
@@ -56,6 +150,9 @@ int settings_register(struct settings_handler *handler)
 		}
 	}
 	sys_slist_append(&settings_handlers, &handler->node);
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+	settings_handler_index_add((struct settings_handler_static *)handler);
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
 
 end:
 	k_mutex_unlock(&settings_lock);
@@ -134,6 +231,44 @@ int settings_name_next(const char *name, const char **next)
 	return rc;
 }
 
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+/* Probe the index with every prefix of the name ending at a component
+ * boundary, the longest registered prefix is the best match.
+ */
+static struct settings_handler_static *
+settings_index_lookup(const char *name, const char **next)
+{
+	struct settings_handler_static *bestmatch = NULL;
+	struct settings_handler_static *ch;
+	uint32_t hash = HANDLER_HASH_INIT;
+	const char *p;
+
+	for (p = name; ; p++) {
+		char c = *p;
+
+		if ((c == SETTINGS_NAME_SEPARATOR) || (c == SETTINGS_NAME_END) ||
+		    (c == '\0')) {
+			ch = settings_handler_index_find(name, p - name, hash);
+			if (ch) {
+				bestmatch = ch;
+				if (next) {
+					*next = (c == SETTINGS_NAME_SEPARATOR) ?
+						p + 1 : NULL;
+				}
+			}
+
+			if (c != SETTINGS_NAME_SEPARATOR) {
+				break;
+			}
+		}
+
+		hash = handler_hash_step(hash, c);
+	}
+
+	return bestmatch;
+}
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
+
 struct settings_handler_static *settings_parse_and_lookup(const char *name,
 							const char **next)
 {
@@ -145,6 +280,12 @@ struct settings_handler_static *settings_parse_and_lookup(const char *name,
 		*next = NULL;
 	}
 
+#if defined(CONFIG_SETTINGS_HANDLER_INDEX)
+	if (!handler_index_full) {
+		return name ? settings_index_lookup(name, next) : NULL;
+	}
+#endif /* CONFIG_SETTINGS_HANDLER_INDEX */
+
 	STRUCT_SECTION_FOREACH(settings_handler_static, ch) {
 		if (!settings_name_steq(name, ch->name, &tmpnext)) {
 			continue;
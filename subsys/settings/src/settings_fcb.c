@@ -32,18 +32,78 @@ static int settings_fcb_load(struct settings_store *cs,
 			     const struct settings_load_arg *arg);
 static int settings_fcb_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len);
+#ifdef CONFIG_SETTINGS_TXN
+static int settings_fcb_save_batch(struct settings_store *cs,
+				   const uint8_t *buf, size_t len);
+#endif
 
 static const struct settings_store_itf settings_fcb_itf = {
 	.csi_load = settings_fcb_load,
 	.csi_save = settings_fcb_save,
+#ifdef CONFIG_SETTINGS_TXN
+	.csi_save_batch = settings_fcb_save_batch,
+#endif
 };
 
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+/* Entries are read in bulk into these buffers, for loading and for the
+ * duplicate check, under the settings lock. load_buf is not used by loads
+ * nested in a handler.
+ */
+static uint8_t load_buf[CONFIG_SETTINGS_FCB_BULK_READ_SIZE];
+static uint8_t dup_buf[CONFIG_SETTINGS_FCB_BULK_READ_SIZE];
+static bool load_busy;
+
+/* Data of the entry being loaded, served by read_handler() for any context
+ * of that entry, including the records of a batch.
+ */
+static struct {
+	const struct fcb_entry_ctx *entry_ctx;
+	const uint8_t *data;
+} bulk_entry;
+
+/* FNV-1a hash of the name of an entry, up to the '=' separator */
+static uint32_t settings_fcb_name_hash(const char *name, size_t len)
+{
+	uint32_t hash = 2166136261U;
+
+	for (size_t i = 0; (i < len) && (name[i] != '='); i++) {
+		hash = (hash ^ (uint8_t)name[i]) * 16777619U;
+	}
+
+	return (hash != FCB_KEY_HASH_ANY) ? hash : 1U;
+}
+
+static uint32_t settings_fcb_key_hash(const struct fcb_entry_ctx *entry_ctx)
+{
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t len = MIN(sizeof(name), entry_ctx->loc.fe_data_len);
+
+	if (flash_area_read(entry_ctx->fap,
+			    FCB_ENTRY_FA_DATA_OFF(entry_ctx->loc), name, len)) {
+		return FCB_KEY_HASH_ANY;
+	}
+
+	/* A batch holds the keys of all its records */
+	if ((len > sizeof(SETTINGS_TXN_BATCH_NAME) - 1) &&
+	    (name[sizeof(SETTINGS_TXN_BATCH_NAME) - 1] == '=') &&
+	    settings_line_is_batch(name, sizeof(SETTINGS_TXN_BATCH_NAME) - 1)) {
+		return FCB_KEY_HASH_ANY;
+	}
+
+	return settings_fcb_name_hash(name, len);
+}
+#endif /* CONFIG_SETTINGS_FCB_INDEX */
+
 int settings_fcb_src(struct settings_fcb *cf)
 {
 	int rc;
 
 	cf->cf_fcb.f_version = SETTINGS_FCB_VERS;
 	cf->cf_fcb.f_scratch_cnt = 1;
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+	cf->cf_fcb.f_key_hash = settings_fcb_key_hash;
+#endif
 
 	while (1) {
 		rc = fcb_init(SETTINGS_PARTITION, &cf->cf_fcb);
@@ -84,6 +144,93 @@ int settings_fcb_dst(struct settings_fcb *cf)
 	return 0;
 }
 
+struct settings_fcb_batch_name_arg {
+	struct fcb_entry_ctx *entry_ctx;
+	const char *name;
+	size_t name_len;
+};
+
+static int settings_fcb_batch_name_cb(off_t off, size_t len, void *cb_arg)
+{
+	struct settings_fcb_batch_name_arg *arg = cb_arg;
+	struct fcb_entry_ctx rec_ctx = *arg->entry_ctx;
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name_len;
+
+	rec_ctx.loc.fe_data_off += off;
+	rec_ctx.loc.fe_data_len = len;
+
+	if (settings_line_name_read(name, sizeof(name), &name_len, &rec_ctx)) {
+		return 0;
+	}
+
+	return (name_len == arg->name_len) &&
+	       !memcmp(name, arg->name, name_len);
+}
+
+/* Check whether the entry is of the name, or is a batch holding a record of
+ * the name.
+ */
+static bool settings_fcb_entry_has_name(struct fcb_entry_ctx *entry_ctx,
+					const char *name, size_t name_len)
+{
+	char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name2_len;
+
+	if (settings_line_name_read(name2, sizeof(name2), &name2_len,
+				    entry_ctx)) {
+		LOG_ERR("failed to load line");
+		return false;
+	}
+
+	if (settings_line_is_batch(name2, name2_len)) {
+		struct settings_fcb_batch_name_arg arg = {
+			.entry_ctx = entry_ctx,
+			.name = name,
+			.name_len = name_len,
+		};
+
+		return settings_line_batch_walk(entry_ctx, name2_len + 1,
+						settings_fcb_batch_name_cb,
+						&arg) == 1;
+	}
+
+	return (name2_len == name_len) && !memcmp(name2, name, name_len);
+}
+
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+struct settings_fcb_dup_arg {
+	const char *name;
+	size_t name_len;
+	/* Last entry checked in the sector of the entry */
+	struct fcb_entry last;
+	bool found;
+};
+
+/* Returns 1 on the first entry of the next sector, which is left unchecked */
+static int settings_fcb_dup_cb(struct fcb_entry_ctx *entry_ctx,
+			       const uint8_t *data, void *cb_arg)
+{
+	struct settings_fcb_dup_arg *arg = cb_arg;
+
+	if (entry_ctx->loc.fe_sector != arg->last.fe_sector) {
+		return 1;
+	}
+	arg->last = entry_ctx->loc;
+
+	if (data != NULL) {
+		arg->found = settings_line_buf_has_name(data,
+						entry_ctx->loc.fe_data_len,
+						arg->name, arg->name_len);
+	} else {
+		arg->found = settings_fcb_entry_has_name(entry_ctx, arg->name,
+							 arg->name_len);
+	}
+
+	return arg->found ? 2 : 0;
+}
+#endif /* CONFIG_SETTINGS_FCB_INDEX */
+
 /**
  * @brief Check if there is any duplicate of the current setting
  *
@@ -101,18 +248,38 @@ static bool settings_fcb_check_duplicate(struct settings_fcb *cf,
 					const char * const name)
 {
 	struct fcb_entry_ctx entry2_ctx = *entry_ctx;
+	size_t name_len = strlen(name);
 
-	while (fcb_getnext(&cf->cf_fcb, &entry2_ctx.loc) == 0) {
-		char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
-		size_t name2_len;
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+	struct settings_fcb_dup_arg arg = {
+		.name = name,
+		.name_len = name_len,
+		.last = entry_ctx->loc,
+	};
+	uint32_t hash = settings_fcb_name_hash(name, name_len);
+	int rc;
 
-		if (settings_line_name_read(name2, sizeof(name2), &name2_len,
-					    &entry2_ctx)) {
-			LOG_ERR("failed to load line");
-			continue;
-		}
-		name2[name2_len] = '\0';
-		if (!strcmp(name, name2)) {
+	/* The rest of the sector of the entry, in bulk */
+	do {
+		rc = fcb_bulk_read(&cf->cf_fcb, &entry2_ctx.loc, dup_buf,
+				   sizeof(dup_buf), settings_fcb_dup_cb, &arg);
+	} while (rc == 0);
+
+	if (arg.found) {
+		return true;
+	}
+	if (rc != 1) {
+		/* No entry left */
+		return false;
+	}
+
+	/* The following sectors, only if they may hold the name */
+	entry2_ctx.loc = arg.last;
+	while (fcb_getnext_key(&cf->cf_fcb, &entry2_ctx.loc, hash) == 0) {
+#else
+	while (fcb_getnext(&cf->cf_fcb, &entry2_ctx.loc) == 0) {
+#endif
+		if (settings_fcb_entry_has_name(&entry2_ctx, name, name_len)) {
 			return true;
 		}
 	}
@@ -127,6 +294,116 @@ static int read_entry_len(const struct fcb_entry_ctx *entry_ctx, off_t off)
 	return entry_ctx->loc.fe_data_len - off;
 }
 
+struct settings_fcb_batch_load_arg {
+	struct settings_fcb *cf;
+	struct fcb_entry_ctx *entry_ctx;
+	line_load_cb cb;
+	void *cb_arg;
+	bool filter_duplicates;
+};
+
+static void settings_fcb_load_line(struct settings_fcb *cf,
+				   struct fcb_entry_ctx *entry_ctx,
+				   struct fcb_entry_ctx *line_ctx,
+				   line_load_cb cb, void *cb_arg,
+				   bool filter_duplicates);
+
+static int settings_fcb_batch_load_cb(off_t off, size_t len, void *cb_arg)
+{
+	struct settings_fcb_batch_load_arg *arg = cb_arg;
+	struct fcb_entry_ctx rec_ctx = *arg->entry_ctx;
+
+	rec_ctx.loc.fe_data_off += off;
+	rec_ctx.loc.fe_data_len = len;
+	settings_fcb_load_line(arg->cf, arg->entry_ctx, &rec_ctx, arg->cb,
+			       arg->cb_arg, arg->filter_duplicates);
+
+	return 0;
+}
+
+/* Load the line at line_ctx, which is either the entry at entry_ctx or a
+ * record of that entry when it is a batch.
+ */
+static void settings_fcb_load_line(struct settings_fcb *cf,
+				   struct fcb_entry_ctx *entry_ctx,
+				   struct fcb_entry_ctx *line_ctx,
+				   line_load_cb cb, void *cb_arg,
+				   bool filter_duplicates)
+{
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name_len;
+	int rc;
+	bool pass_entry = true;
+
+	rc = settings_line_name_read(name, sizeof(name), &name_len,
+				     (void *)line_ctx);
+	if (rc) {
+		LOG_ERR("Failed to load line name: %d", rc);
+		return;
+	}
+	name[name_len] = '\0';
+
+	if ((line_ctx == entry_ctx) && settings_line_is_batch(name, name_len)) {
+		struct settings_fcb_batch_load_arg arg = {
+			.cf = cf,
+			.entry_ctx = entry_ctx,
+			.cb = cb,
+			.cb_arg = cb_arg,
+			.filter_duplicates = filter_duplicates,
+		};
+
+		rc = settings_line_batch_walk(entry_ctx, name_len + 1,
+					      settings_fcb_batch_load_cb, &arg);
+		if (rc) {
+			LOG_ERR("Failed to load batch: %d", rc);
+		}
+		return;
+	}
+
+	if (filter_duplicates &&
+	    (!read_entry_len(line_ctx, name_len+1) ||
+	     settings_fcb_check_duplicate(cf, entry_ctx, name))) {
+		pass_entry = false;
+	}
+	/*name, val-read_cb-ctx, val-off*/
+	/* take into account '=' separator after the name */
+	if (pass_entry) {
+		cb(name, line_ctx, name_len + 1, cb_arg);
+	}
+}
+
+static void settings_fcb_load_entry(struct settings_fcb *cf,
+				    struct fcb_entry_ctx *entry_ctx,
+				    line_load_cb cb, void *cb_arg,
+				    bool filter_duplicates)
+{
+	settings_fcb_load_line(cf, entry_ctx, entry_ctx, cb, cb_arg,
+			       filter_duplicates);
+}
+
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+struct settings_fcb_load_arg {
+	struct settings_fcb *cf;
+	line_load_cb cb;
+	void *cb_arg;
+	bool filter_duplicates;
+};
+
+static int settings_fcb_load_cb(struct fcb_entry_ctx *entry_ctx,
+				const uint8_t *data, void *cb_arg)
+{
+	struct settings_fcb_load_arg *arg = cb_arg;
+
+	bulk_entry.entry_ctx = entry_ctx;
+	bulk_entry.data = data;
+	settings_fcb_load_entry(arg->cf, entry_ctx, arg->cb, arg->cb_arg,
+				arg->filter_duplicates);
+	bulk_entry.data = NULL;
+
+	return 0;
+}
+#endif /* CONFIG_SETTINGS_FCB_INDEX */
+
 static int settings_fcb_load_priv(struct settings_store *cs,
 				  line_load_cb cb,
 				  void *cb_arg,
@@ -139,30 +416,31 @@ static int settings_fcb_load_priv(struct settings_store *cs,
 	};
 	int rc;
 
-	while ((rc = fcb_getnext(&cf->cf_fcb, &entry_ctx.loc)) == 0) {
-		char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
-		size_t name_len;
-		int rc;
-		bool pass_entry = true;
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+	if (!load_busy) {
+		struct settings_fcb_load_arg arg = {
+			.cf = cf,
+			.cb = cb,
+			.cb_arg = cb_arg,
+			.filter_duplicates = filter_duplicates,
+		};
+
+		/* Nested loads, from a handler, read entries one by one */
+		load_busy = true;
+		do {
+			rc = fcb_bulk_read(&cf->cf_fcb, &entry_ctx.loc, load_buf,
+					   sizeof(load_buf), settings_fcb_load_cb,
+					   &arg);
+		} while (rc == 0);
+		load_busy = false;
 
-		rc = settings_line_name_read(name, sizeof(name), &name_len,
-					     (void *)&entry_ctx);
-		if (rc) {
-			LOG_ERR("Failed to load line name: %d", rc);
-			continue;
-		}
-		name[name_len] = '\0';
+		return 0;
+	}
+#endif
 
-		if (filter_duplicates &&
-		    (!read_entry_len(&entry_ctx, name_len+1) ||
-		     settings_fcb_check_duplicate(cf, &entry_ctx, name))) {
-			pass_entry = false;
-		}
-		/*name, val-read_cb-ctx, val-off*/
-		/* take into account '=' separator after the name */
-		if (pass_entry) {
-			cb(name, &entry_ctx, name_len + 1, cb_arg);
-		}
+	while ((rc = fcb_getnext(&cf->cf_fcb, &entry_ctx.loc)) == 0) {
+		settings_fcb_load_entry(cf, &entry_ctx, cb, cb_arg,
+					filter_duplicates);
 	}
 	if (rc == -ENOTSUP) {
 		rc = 0;
@@ -193,28 +471,67 @@ static int read_handler(void *ctx, off_t off, char *buf, size_t *len)
 		*len = entry_ctx->loc.fe_data_len - off;
 	}
 
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+	if ((bulk_entry.data != NULL) &&
+	    (entry_ctx->loc.fe_sector == bulk_entry.entry_ctx->loc.fe_sector) &&
+	    (entry_ctx->loc.fe_elem_off ==
+	     bulk_entry.entry_ctx->loc.fe_elem_off)) {
+		off += entry_ctx->loc.fe_data_off -
+		       bulk_entry.entry_ctx->loc.fe_data_off;
+		memcpy(buf, bulk_entry.data + off, *len);
+		return 0;
+	}
+#endif
+
 	return flash_area_read(entry_ctx->fap,
 			       FCB_ENTRY_FA_DATA_OFF(entry_ctx->loc) + off, buf,
 			       *len);
 }
 
+/* Copy a line, an entry or a record of a batch, to the active sector */
+static void settings_fcb_copy_line(struct settings_fcb *cf,
+				   struct fcb_entry_ctx *line_ctx)
+{
+	struct fcb_entry_ctx loc2;
+	int rc;
+
+	loc2.fap = cf->cf_fcb.fap;
+
+	rc = fcb_append(&cf->cf_fcb, line_ctx->loc.fe_data_len, &loc2.loc);
+	if (rc) {
+		return;
+	}
+
+	rc = settings_line_entry_copy(&loc2, 0, line_ctx, 0,
+				      line_ctx->loc.fe_data_len);
+	if (rc) {
+		return;
+	}
+	rc = fcb_append_finish(&cf->cf_fcb, &loc2.loc);
+
+	if (rc != 0) {
+		LOG_ERR("Failed to finish fcb_append (%d)", rc);
+	}
+}
+
+static int settings_fcb_compress_cb(const char *name, void *val_read_cb_ctx,
+				    off_t off, void *cb_arg)
+{
+	settings_fcb_copy_line(cb_arg, val_read_cb_ctx);
+
+	return 0;
+}
+
 static void settings_fcb_compress(struct settings_fcb *cf)
 {
 	int rc;
 	struct fcb_entry_ctx loc1;
-	struct fcb_entry_ctx loc2;
-	char name1[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
-	char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
-	int copy;
-	uint8_t rbs;
 
 	rc = fcb_append_to_scratch(&cf->cf_fcb);
 	if (rc) {
 		return; /* XXX */
 	}
 
-	rbs = flash_area_align(cf->cf_fcb.fap);
-
 	loc1.fap = cf->cf_fcb.fap;
 
 	loc1.loc.fe_sector = NULL;
@@ -225,61 +542,13 @@ static void settings_fcb_compress(struct settings_fcb *cf)
 			break;
 		}
 
-		size_t val1_off;
-
-		rc = settings_line_name_read(name1, sizeof(name1), &val1_off,
-					     &loc1);
-		if (rc) {
-			continue;
-		}
-
-		if (val1_off + 1 == loc1.loc.fe_data_len) {
-			/* Lack of a value so the record is a deletion-record */
-			/* No sense to copy empty entry from */
-			/* the oldest sector */
-			continue;
-		}
-
-		loc2 = loc1;
-		copy = 1;
-
-		while (fcb_getnext(&cf->cf_fcb, &loc2.loc) == 0) {
-			size_t val2_off;
-
-			rc = settings_line_name_read(name2, sizeof(name2),
-						     &val2_off, &loc2);
-			if (rc) {
-				continue;
-			}
-
-			if ((val1_off == val2_off) &&
-			    !memcmp(name1, name2, val1_off)) {
-				copy = 0;
-				break;
-			}
-		}
-		if (!copy) {
-			continue;
-		}
-
 		/*
-		 * Can't find one. Must copy.
+		 * Lines which are neither deletion-records nor overwritten by
+		 * a newer line must be copied, records of a batch are copied
+		 * as single lines.
 		 */
-		rc = fcb_append(&cf->cf_fcb, loc1.loc.fe_data_len, &loc2.loc);
-		if (rc) {
-			continue;
-		}
-
-		rc = settings_line_entry_copy(&loc2, 0, &loc1, 0,
-					      loc1.loc.fe_data_len);
-		if (rc) {
-			continue;
-		}
-		rc = fcb_append_finish(&cf->cf_fcb, &loc2.loc);
-
-		if (rc != 0) {
-			LOG_ERR("Failed to finish fcb_append (%d)", rc);
-		}
+		settings_fcb_load_entry(cf, &loc1, settings_fcb_compress_cb,
+					cf, true);
 	}
 	rc = fcb_rotate(&cf->cf_fcb);
 
@@ -373,6 +642,18 @@ static int settings_fcb_save(struct settings_store *cs, const char *name,
 	return settings_fcb_save_priv(cs, name, (char *)value, val_len);
 }
 
+#ifdef CONFIG_SETTINGS_TXN
+/* ::csi_save_batch implementation, the batch is a single entry whose CRC
+ * commits all its records.
+ */
+static int settings_fcb_save_batch(struct settings_store *cs,
+				   const uint8_t *buf, size_t len)
+{
+	return settings_fcb_save_priv(cs, SETTINGS_TXN_BATCH_NAME,
+				      (const char *)buf, len);
+}
+#endif
+
 void settings_mount_fcb_backend(struct settings_fcb *cf)
 {
 	uint8_t rbs;
@@ -386,9 +667,16 @@ int settings_backend_init(void)
 {
 	static struct flash_sector
 		settings_fcb_area[CONFIG_SETTINGS_FCB_NUM_AREAS + 1];
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+	static struct fcb_sector_index
+		settings_fcb_index[CONFIG_SETTINGS_FCB_NUM_AREAS + 1];
+#endif
 	static struct settings_fcb config_init_settings_fcb = {
 		.cf_fcb.f_magic = CONFIG_SETTINGS_FCB_MAGIC,
 		.cf_fcb.f_sectors = settings_fcb_area,
+#ifdef CONFIG_SETTINGS_FCB_INDEX
+		.cf_fcb.f_index = settings_fcb_index,
+#endif
 	};
 	uint32_t cnt = sizeof(settings_fcb_area) /
 		    sizeof(settings_fcb_area[0]);
@@ -26,10 +26,17 @@ static int settings_file_load(struct settings_store *cs,
 			      const struct settings_load_arg *arg);
 static int settings_file_save(struct settings_store *cs, const char *name,
 			      const char *value, size_t val_len);
+#ifdef CONFIG_SETTINGS_TXN
+static int settings_file_save_batch(struct settings_store *cs,
+				    const uint8_t *buf, size_t len);
+#endif
 
 static const struct settings_store_itf settings_file_itf = {
 	.csi_load = settings_file_load,
 	.csi_save = settings_file_save,
+#ifdef CONFIG_SETTINGS_TXN
+	.csi_save_batch = settings_file_save_batch,
+#endif
 };
 
 /*
@@ -60,6 +67,29 @@ int settings_file_dst(struct settings_file *cf)
 	return 0;
 }
 
+struct settings_file_batch_name_arg {
+	const struct line_entry_ctx *entry_ctx;
+	const char *name;
+};
+
+static int settings_file_batch_name_cb(off_t off, size_t len, void *cb_arg)
+{
+	struct settings_file_batch_name_arg *arg = cb_arg;
+	struct line_entry_ctx rec_ctx = *arg->entry_ctx;
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name_len;
+
+	rec_ctx.seek += off;
+	rec_ctx.len = len;
+
+	if (settings_line_name_read(name, sizeof(name), &name_len, &rec_ctx)) {
+		return 0;
+	}
+	name[name_len] = '\0';
+
+	return !strcmp(name, arg->name);
+}
+
 /**
  * @brief Check if there is any duplicate of the current setting
  *
@@ -92,6 +122,20 @@ static bool settings_file_check_duplicate(
 		}
 		name2[name2_len] = '\0';
 
+		if (settings_line_is_batch(name2, name2_len)) {
+			struct settings_file_batch_name_arg arg = {
+				.entry_ctx = &entry2_ctx,
+				.name = name,
+			};
+
+			if (settings_line_batch_walk(&entry2_ctx, name2_len + 1,
+					settings_file_batch_name_cb,
+					&arg) == 1) {
+				return true;
+			}
+			continue;
+		}
+
 		if (!strcmp(name, name2)) {
 			return true;
 		}
@@ -107,6 +151,40 @@ static int read_entry_len(const struct line_entry_ctx *entry_ctx, off_t off)
 	return entry_ctx->len - off;
 }
 
+struct settings_file_batch_load_arg {
+	struct line_entry_ctx *entry_ctx;
+	line_load_cb cb;
+	void *cb_arg;
+	bool filter_duplicates;
+};
+
+static int settings_file_batch_load_cb(off_t off, size_t len, void *cb_arg)
+{
+	struct settings_file_batch_load_arg *arg = cb_arg;
+	struct line_entry_ctx rec_ctx = *arg->entry_ctx;
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	size_t name_len;
+
+	rec_ctx.seek += off;
+	rec_ctx.len = len;
+
+	if (settings_line_name_read(name, sizeof(name), &name_len, &rec_ctx) ||
+	    (name_len == 0)) {
+		return 0;
+	}
+	name[name_len] = '\0';
+
+	if (arg->filter_duplicates &&
+	    (!read_entry_len(&rec_ctx, name_len + 1) ||
+	     settings_file_check_duplicate(arg->entry_ctx, name))) {
+		return 0;
+	}
+
+	arg->cb(name, (void *)&rec_ctx, name_len + 1, arg->cb_arg);
+
+	return 0;
+}
+
 static int settings_file_load_priv(struct settings_store *cs, line_load_cb cb,
 				   void *cb_arg, bool filter_duplicates)
 {
@@ -148,6 +226,21 @@ static int settings_file_load_priv(struct settings_store *cs, line_load_cb cb,
 		}
 		name[name_len] = '\0';
 
+		if (settings_line_is_batch(name, name_len)) {
+			struct settings_file_batch_load_arg arg = {
+				.entry_ctx = &entry_ctx,
+				.cb = cb,
+				.cb_arg = cb_arg,
+				.filter_duplicates = filter_duplicates,
+			};
+
+			/* An interrupted batch is ignored */
+			(void)settings_line_batch_walk(&entry_ctx, name_len + 1,
+					settings_file_batch_load_cb, &arg);
+			lines++;
+			continue;
+		}
+
 		if (filter_duplicates &&
 		    (!read_entry_len(&entry_ctx, name_len+1) ||
 		     settings_file_check_duplicate(&entry_ctx, name))) {
@@ -212,6 +305,54 @@ static int settings_file_create_or_replace(struct fs_file_t *zfp,
 	return fs_open(zfp, file_name, FS_O_CREATE | FS_O_RDWR);
 }
 
+struct settings_file_compress_arg {
+	struct line_entry_ctx *entry_ctx;
+	struct line_entry_ctx *dst_ctx;
+	const char *new_name;
+	int lines;
+	int rc;
+};
+
+/* Copy the records of a batch which are still in use as single lines */
+static int settings_file_compress_cb(off_t off, size_t len, void *cb_arg)
+{
+	struct settings_file_compress_arg *arg = cb_arg;
+	struct line_entry_ctx rec_ctx = *arg->entry_ctx;
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	uint16_t len_field = len;
+	size_t name_len;
+	ssize_t rc;
+
+	rec_ctx.seek += off;
+	rec_ctx.len = len;
+
+	if (settings_line_name_read(name, sizeof(name), &name_len, &rec_ctx)) {
+		return 0;
+	}
+	name[name_len] = '\0';
+
+	/* deletion-record, or overwritten by the new or a newer value */
+	if ((name_len + 1 == len) || !strcmp(name, arg->new_name) ||
+	    settings_file_check_duplicate(arg->entry_ctx, name)) {
+		return 0;
+	}
+
+	rc = fs_write(arg->dst_ctx->stor_ctx, &len_field, sizeof(len_field));
+	if (rc != sizeof(len_field)) {
+		arg->rc = -EIO;
+		return arg->rc;
+	}
+
+	arg->rc = settings_line_entry_copy(arg->dst_ctx, 0, &rec_ctx, 0, len);
+	if (arg->rc) {
+		return arg->rc;
+	}
+
+	arg->lines++;
+
+	return 0;
+}
+
 /*
  * Try to compress configuration file by keeping unique names only.
  */
@@ -223,8 +364,7 @@ static int settings_file_save_and_compress(struct settings_file *cf,
 	struct fs_file_t rf;
 	struct fs_file_t wf;
 	char tmp_file[SETTINGS_FILE_NAME_MAX];
-	char name1[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
-	char name2[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN];
+	char name1[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
 	struct line_entry_ctx loc1 = {
 		.stor_ctx = &rf,
 		.seek = 0,
@@ -237,7 +377,6 @@ static int settings_file_save_and_compress(struct settings_file *cf,
 		.stor_ctx = &wf
 	};
 
-	int copy;
 	int lines;
 	size_t new_name_len;
 	size_t val1_off;
@@ -274,6 +413,24 @@ static int settings_file_save_and_compress(struct settings_file *cf,
 			continue;
 		}
 
+		if (settings_line_is_batch(name1, val1_off)) {
+			struct settings_file_compress_arg arg = {
+				.entry_ctx = &loc1,
+				.dst_ctx = &loc3,
+				.new_name = name,
+			};
+
+			(void)settings_line_batch_walk(&loc1, val1_off + 1,
+					settings_file_compress_cb, &arg);
+			if (arg.rc) {
+				/* compressed file might be corrupted */
+				goto end_rolback;
+			}
+
+			lines += arg.lines;
+			continue;
+		}
+
 		if (val1_off + 1 == loc1.len) {
 			/* Lack of a value so the record is a deletion-record */
 			/* No sense to copy empty entry from */
@@ -287,33 +444,9 @@ static int settings_file_save_and_compress(struct settings_file *cf,
 			continue;
 		}
 
-		loc2 = loc1;
-
-		copy = 1;
-		while (1) {
-			size_t val2_off;
-
-			rc = settings_next_line_ctx(&loc2);
-
-			if (rc || loc2.len == 0) {
-				/* try to amend new value to */
-				/* the compressed file */
-				break;
-			}
-
-			rc = settings_line_name_read(name2, sizeof(name2),
-						     &val2_off, &loc2);
-			if (rc) {
-				/* try to process next line */
-				continue;
-			}
-			if ((val1_off == val2_off) &&
-			    !memcmp(name1, name2, val1_off)) {
-				copy = 0; /* newer version doesn't exist */
-				break;
-			}
-		}
-		if (!copy) {
+		/* newer version, also within a batch, exists */
+		name1[val1_off] = '\0';
+		if (settings_file_check_duplicate(&loc1, name1)) {
 			continue;
 		}
 
@@ -435,6 +568,18 @@ static int settings_file_save(struct settings_store *cs, const char *name,
 	return settings_file_save_priv(cs, name, (char *)value, val_len);
 }
 
+#ifdef CONFIG_SETTINGS_TXN
+/* ::csi_save_batch implementation, the batch is a single line which is
+ * ignored unless it ends with its commit record.
+ */
+static int settings_file_save_batch(struct settings_store *cs,
+				    const uint8_t *buf, size_t len)
+{
+	return settings_file_save_priv(cs, SETTINGS_TXN_BATCH_NAME,
+				       (const char *)buf, len);
+}
+#endif
+
 static int read_handler(void *ctx, off_t off, char *buf, size_t *len)
 {
 	struct line_entry_ctx *entry_ctx = ctx;
@@ -13,6 +13,7 @@
 
 #include <zephyr/settings/settings.h>
 #include "settings/settings_file.h"
+#include "settings_priv.h"
 #include <zephyr/zephyr.h>
 
 
@@ -35,6 +36,13 @@ int settings_subsys_init(void)
 
 	err = settings_backend_init(); /* func rises kernel panic once error */
 
+#if defined(CONFIG_SETTINGS_TXN_JOURNAL)
+	if (!err) {
+		/* A failed replay is retried on next init */
+		(void)settings_txn_replay();
+	}
+#endif
+
 	if (!err) {
 		settings_subsys_initialized = true;
 	}
@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include <zephyr/settings/settings.h>
+#include <zephyr/sys/byteorder.h>
 #include "settings_priv.h"
 
 #include <zephyr/logging/log.h>
@@ -316,6 +317,174 @@ int settings_line_entry_copy(void *dst_ctx, off_t dst_off, void *src_ctx,
 	return rc;
 }
 
+int settings_batch_rec_get(const uint8_t *buf, size_t len, size_t off,
+			   struct settings_batch_rec *rec)
+{
+	const char *sep;
+	size_t line_len;
+
+	if (off + SETTINGS_BATCH_HDR_LEN > len) {
+		return -EINVAL;
+	}
+
+	line_len = sys_get_le16(&buf[off]);
+	if (line_len == 0U) {
+		return 0;
+	}
+
+	off += SETTINGS_BATCH_HDR_LEN;
+	if (off + line_len > len) {
+		return -EINVAL;
+	}
+
+	rec->name = (const char *)&buf[off];
+	sep = memchr(rec->name, '=', MIN(line_len, SETTINGS_MAX_NAME_LEN + 1));
+	if ((sep == NULL) || (sep == rec->name)) {
+		return -EINVAL;
+	}
+
+	rec->name_len = sep - rec->name;
+	rec->value = sep + 1;
+	rec->val_len = line_len - rec->name_len - 1;
+
+	return SETTINGS_BATCH_HDR_LEN + line_len;
+}
+
+int settings_batch_check(const uint8_t *buf, size_t len)
+{
+	struct settings_batch_rec rec;
+	size_t off = 0;
+	size_t cnt = 0;
+	int rc;
+
+	while ((rc = settings_batch_rec_get(buf, len, off, &rec)) > 0) {
+		off += rc;
+		cnt++;
+	}
+
+	if (rc < 0) {
+		return rc;
+	}
+
+	if ((off + SETTINGS_BATCH_COMMIT_LEN != len) ||
+	    (sys_get_le16(&buf[off + SETTINGS_BATCH_HDR_LEN]) != cnt)) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+bool settings_line_buf_has_name(const uint8_t *line, size_t len,
+				const char *name, size_t name_len)
+{
+	const size_t batch_name_len = sizeof(SETTINGS_TXN_BATCH_NAME) - 1;
+	struct settings_batch_rec rec;
+	size_t off = 0;
+	int rc;
+
+	if ((len <= batch_name_len) || (line[batch_name_len] != '=') ||
+	    !settings_line_is_batch((const char *)line, batch_name_len)) {
+		return (len > name_len) && (line[name_len] == '=') &&
+		       !memcmp(line, name, name_len);
+	}
+
+	line += batch_name_len + 1;
+	len -= batch_name_len + 1;
+	if (settings_batch_check(line, len)) {
+		return false;
+	}
+
+	while ((rc = settings_batch_rec_get(line, len, off, &rec)) > 0) {
+		if ((rec.name_len == name_len) &&
+		    !memcmp(rec.name, name, name_len)) {
+			return true;
+		}
+		off += rc;
+	}
+
+	return false;
+}
+
+static int settings_line_batch_le16(void *read_cb_ctx, off_t val_off,
+				    off_t off, uint16_t *val)
+{
+	uint8_t buf[sizeof(*val)];
+	size_t len_read;
+	int rc;
+
+	rc = settings_line_val_read(val_off, off, (char *)buf, sizeof(buf),
+				    &len_read, read_cb_ctx);
+	if (rc) {
+		return rc;
+	}
+
+	if (len_read != sizeof(buf)) {
+		return -EINVAL;
+	}
+
+	*val = sys_get_le16(buf);
+
+	return 0;
+}
+
+int settings_line_batch_walk(void *read_cb_ctx, off_t val_off,
+			     settings_line_batch_cb cb, void *cb_arg)
+{
+	size_t len = settings_line_val_get_len(val_off, read_cb_ctx);
+	uint16_t line_len;
+	uint16_t cnt = 0;
+	uint16_t recs;
+	off_t off = 0;
+	int rc;
+
+	/* Only a complete batch is passed on */
+	while (1) {
+		rc = settings_line_batch_le16(read_cb_ctx, val_off, off,
+					      &line_len);
+		if (rc) {
+			return rc;
+		}
+
+		off += SETTINGS_BATCH_HDR_LEN;
+		if (line_len == 0U) {
+			break;
+		}
+
+		off += line_len;
+		if ((size_t)off > len) {
+			return -EINVAL;
+		}
+		cnt++;
+	}
+
+	rc = settings_line_batch_le16(read_cb_ctx, val_off, off, &recs);
+	if (rc) {
+		return rc;
+	}
+
+	if ((recs != cnt) || (off + sizeof(recs) != len)) {
+		return -EINVAL;
+	}
+
+	off = 0;
+	while (cnt--) {
+		rc = settings_line_batch_le16(read_cb_ctx, val_off, off,
+					      &line_len);
+		if (rc) {
+			return rc;
+		}
+
+		off += SETTINGS_BATCH_HDR_LEN;
+		rc = cb(val_off + off, line_len, cb_arg);
+		if (rc) {
+			return rc;
+		}
+		off += line_len;
+	}
+
+	return 0;
+}
+
 void settings_line_io_init(int (*read_cb)(void *ctx, off_t off, char *buf,
 					  size_t *len),
 			  int (*write_cb)(void *ctx, off_t off, char const *buf,
@@ -31,10 +31,17 @@ static int settings_nvs_load(struct settings_store *cs,
 			     const struct settings_load_arg *arg);
 static int settings_nvs_save(struct settings_store *cs, const char *name,
 			     const char *value, size_t val_len);
+#ifdef CONFIG_SETTINGS_TXN
+static int settings_nvs_save_batch(struct settings_store *cs,
+				   const uint8_t *buf, size_t len);
+#endif
 
 static struct settings_store_itf settings_nvs_itf = {
 	.csi_load = settings_nvs_load,
 	.csi_save = settings_nvs_save,
+#ifdef CONFIG_SETTINGS_TXN
+	.csi_save_batch = settings_nvs_save_batch,
+#endif
 };
 
 static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
@@ -54,6 +61,175 @@ static ssize_t settings_nvs_read_fn(void *back_end, void *data, size_t len)
 	return rc;
 }
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+#define NAME_HASH_INIT  2166136261U
+#define NAME_HASH_PRIME 16777619U
+
+static uint32_t settings_nvs_name_hash(const char *name)
+{
+	uint32_t hash = NAME_HASH_INIT;
+
+	while (*name != '\0') {
+		hash = (hash ^ (uint8_t)*name++) * NAME_HASH_PRIME;
+	}
+
+	/* 0 marks a free slot */
+	return hash ? hash : 1U;
+}
+
+static uint16_t settings_nvs_top_hash(const char *name)
+{
+	uint32_t hash = NAME_HASH_INIT;
+
+	while ((*name != '\0') && (*name != SETTINGS_NAME_SEPARATOR)) {
+		hash = (hash ^ (uint8_t)*name++) * NAME_HASH_PRIME;
+	}
+
+	return (uint16_t)(hash ^ (hash >> 16));
+}
+
+static inline struct settings_nvs_name_index_entry *
+settings_nvs_index_slot(struct settings_nvs *cf, uint16_t name_id)
+{
+	return &cf->name_index[name_id - NVS_NAMECNT_ID - 1];
+}
+
+static inline uint16_t *settings_nvs_index_bucket(struct settings_nvs *cf,
+						  uint32_t hash)
+{
+	return &cf->name_index_buckets[hash % SETTINGS_NVS_NAME_INDEX_BUCKETS];
+}
+
+static void settings_nvs_index_add(struct settings_nvs *cf, uint16_t name_id,
+				   const char *name)
+{
+	struct settings_nvs_name_index_entry *slot;
+	uint16_t *bucket;
+
+	if (!cf->name_index_valid) {
+		return;
+	}
+
+	if (name_id - NVS_NAMECNT_ID > CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE) {
+		LOG_WRN("name index full, falling back to flash scan");
+		cf->name_index_valid = false;
+		return;
+	}
+
+	slot = settings_nvs_index_slot(cf, name_id);
+	slot->hash = settings_nvs_name_hash(name);
+	slot->top_hash = settings_nvs_top_hash(name);
+
+	bucket = settings_nvs_index_bucket(cf, slot->hash);
+	slot->next = *bucket;
+	*bucket = name_id;
+}
+
+static void settings_nvs_index_remove(struct settings_nvs *cf,
+				      uint16_t name_id)
+{
+	struct settings_nvs_name_index_entry *slot;
+	uint16_t *link;
+
+	if (!cf->name_index_valid) {
+		return;
+	}
+
+	slot = settings_nvs_index_slot(cf, name_id);
+	if (slot->hash == 0U) {
+		return;
+	}
+
+	link = settings_nvs_index_bucket(cf, slot->hash);
+	while (*link != NVS_NAMECNT_ID) {
+		if (*link == name_id) {
+			*link = slot->next;
+			break;
+		}
+		link = &settings_nvs_index_slot(cf, *link)->next;
+	}
+
+	slot->hash = 0U;
+}
+
+/* Return the name ID of the setting, or NVS_NAMECNT_ID if it is not stored.
+ * Only names whose hash matches are read back from flash.
+ */
+static uint16_t settings_nvs_index_find(struct settings_nvs *cf,
+					const char *name)
+{
+	char rdname[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	uint32_t hash = settings_nvs_name_hash(name);
+	uint16_t name_id = *settings_nvs_index_bucket(cf, hash);
+	ssize_t rc;
+
+	while (name_id != NVS_NAMECNT_ID) {
+		struct settings_nvs_name_index_entry *slot =
+			settings_nvs_index_slot(cf, name_id);
+
+		if (slot->hash == hash) {
+			rc = nvs_read(&cf->cf_nvs, name_id, &rdname,
+				      sizeof(rdname));
+			if (rc >= 0) {
+				rdname[MIN(rc, sizeof(rdname) - 1)] = '\0';
+				if (strcmp(name, rdname) == 0) {
+					return name_id;
+				}
+			}
+		}
+
+		name_id = slot->next;
+	}
+
+	return NVS_NAMECNT_ID;
+}
+
+/* Lowest name ID not in use, as picked by the flash scan */
+static uint16_t settings_nvs_index_free_id(struct settings_nvs *cf)
+{
+	uint16_t name_id;
+
+	for (name_id = NVS_NAMECNT_ID + 1; name_id <= cf->last_name_id;
+	     name_id++) {
+		if (settings_nvs_index_slot(cf, name_id)->hash == 0U) {
+			break;
+		}
+	}
+
+	return name_id;
+}
+
+static void settings_nvs_index_build(struct settings_nvs *cf)
+{
+	char name[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
+	uint16_t name_id;
+	ssize_t rc;
+
+	memset(cf->name_index, 0, sizeof(cf->name_index));
+	for (size_t i = 0; i < ARRAY_SIZE(cf->name_index_buckets); i++) {
+		cf->name_index_buckets[i] = NVS_NAMECNT_ID;
+	}
+
+	cf->name_index_valid = (cf->last_name_id - NVS_NAMECNT_ID <=
+				CONFIG_SETTINGS_NVS_NAME_INDEX_SIZE);
+	if (!cf->name_index_valid) {
+		LOG_WRN("too many settings for the name index");
+		return;
+	}
+
+	for (name_id = NVS_NAMECNT_ID + 1; name_id <= cf->last_name_id;
+	     name_id++) {
+		rc = nvs_read(&cf->cf_nvs, name_id, &name, sizeof(name));
+		if (rc <= 0) {
+			continue;
+		}
+
+		name[MIN(rc, sizeof(name) - 1)] = '\0';
+		settings_nvs_index_add(cf, name_id, name);
+	}
+}
+#endif /* CONFIG_SETTINGS_NVS_NAME_INDEX */
+
 int settings_nvs_src(struct settings_nvs *cf)
 {
 	cf->cf_store.cs_itf = &settings_nvs_itf;
@@ -80,6 +256,14 @@ static int settings_nvs_load(struct settings_store *cs,
 	char buf;
 	ssize_t rc1, rc2;
 	uint16_t name_id = NVS_NAMECNT_ID;
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+	bool use_index = cf->name_index_valid;
+	uint16_t subtree_hash = 0U;
+
+	if (use_index && arg && arg->subtree) {
+		subtree_hash = settings_nvs_top_hash(arg->subtree);
+	}
+#endif
 
 	name_id = cf->last_name_id + 1;
 
@@ -90,6 +274,22 @@ static int settings_nvs_load(struct settings_store *cs,
 			break;
 		}
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+		if (use_index) {
+			struct settings_nvs_name_index_entry *slot =
+				settings_nvs_index_slot(cf, name_id);
+
+			/* Skip unused IDs and names outside of the subtree
+			 * without touching the flash.
+			 */
+			if ((slot->hash == 0U) ||
+			    (arg && arg->subtree &&
+			     slot->top_hash != subtree_hash)) {
+				continue;
+			}
+		}
+#endif
+
 		/* In the NVS backend, each setting item is stored in two NVS
 		 * entries one for the setting's name and one with the
 		 * setting's value.
@@ -115,6 +315,9 @@ static int settings_nvs_load(struct settings_store *cs,
 			}
 			nvs_delete(&cf->cf_nvs, name_id);
 			nvs_delete(&cf->cf_nvs, name_id + NVS_NAME_ID_OFFSET);
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+			settings_nvs_index_remove(cf, name_id);
+#endif
 			continue;
 		}
 
@@ -134,25 +337,19 @@ static int settings_nvs_load(struct settings_store *cs,
 	return ret;
 }
 
-static int settings_nvs_save(struct settings_store *cs, const char *name,
-			     const char *value, size_t val_len)
+/* Find the name ID of a setting by reading every name entry. Returns
+ * NVS_NAMECNT_ID if the setting is not stored, in which case free_id is set
+ * to the lowest unused name ID.
+ */
+static uint16_t settings_nvs_scan_name(struct settings_nvs *cf,
+				       const char *name, uint16_t *free_id)
 {
-	struct settings_nvs *cf = (struct settings_nvs *)cs;
 	char rdname[SETTINGS_MAX_NAME_LEN + SETTINGS_EXTRA_LEN + 1];
-	uint16_t name_id, write_name_id;
-	bool delete, write_name;
-	int rc = 0;
-
-	if (!name) {
-		return -EINVAL;
-	}
-
-	/* Find out if we are doing a delete */
-	delete = ((value == NULL) || (val_len == 0));
+	uint16_t name_id;
+	int rc;
 
 	name_id = cf->last_name_id + 1;
-	write_name_id = cf->last_name_id + 1;
-	write_name = true;
+	*free_id = cf->last_name_id + 1;
 
 	while (1) {
 		name_id--;
@@ -165,7 +362,7 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 		if (rc < 0) {
 			/* Error or entry not found */
 			if (rc == -ENOENT) {
-				write_name_id = name_id;
+				*free_id = name_id;
 			}
 			continue;
 		}
@@ -176,6 +373,40 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 			continue;
 		}
 
+		return name_id;
+	}
+
+	return NVS_NAMECNT_ID;
+}
+
+static int settings_nvs_save(struct settings_store *cs, const char *name,
+			     const char *value, size_t val_len)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+	uint16_t name_id, write_name_id;
+	bool delete, write_name;
+	int rc = 0;
+
+	if (!name) {
+		return -EINVAL;
+	}
+
+	/* Find out if we are doing a delete */
+	delete = ((value == NULL) || (val_len == 0));
+
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+	if (cf->name_index_valid) {
+		name_id = settings_nvs_index_find(cf, name);
+		write_name_id = settings_nvs_index_free_id(cf);
+	} else
+#endif
+	{
+		name_id = settings_nvs_scan_name(cf, name, &write_name_id);
+	}
+
+	write_name = true;
+
+	if (name_id != NVS_NAMECNT_ID) {
 		if ((delete) && (name_id == cf->last_name_id)) {
 			cf->last_name_id--;
 			rc = nvs_write(&cf->cf_nvs, NVS_NAMECNT_ID,
@@ -200,11 +431,13 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 				return rc;
 			}
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+			settings_nvs_index_remove(cf, name_id);
+#endif
 			return 0;
 		}
 		write_name_id = name_id;
 		write_name = false;
-		break;
 	}
 
 	if (delete) {
@@ -229,6 +462,9 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 		if (rc < 0) {
 			return rc;
 		}
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+		settings_nvs_index_add(cf, write_name_id, name);
+#endif
 	}
 
 	/* update the last_name_id and write to flash if required*/
@@ -245,6 +481,185 @@ static int settings_nvs_save(struct settings_store *cs, const char *name,
 	return 0;
 }
 
+#ifdef CONFIG_SETTINGS_TXN
+/* Entries of the batch being saved, under the settings lock */
+static struct nvs_entry batch_entries[CONFIG_SETTINGS_NVS_TXN_ENTRIES];
+
+static bool settings_nvs_batch_has_id(size_t cnt, uint16_t id)
+{
+	for (size_t i = 0; i < cnt; i++) {
+		if (batch_entries[i].id == id) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Lowest name ID above prev_id neither in use nor written by the batch */
+static uint16_t settings_nvs_batch_free_id(struct settings_nvs *cf,
+					   size_t cnt, uint16_t prev_id)
+{
+	uint16_t name_id;
+	char c;
+
+	for (name_id = prev_id + 1;
+	     name_id < NVS_NAMECNT_ID + NVS_NAME_ID_OFFSET; name_id++) {
+		if (settings_nvs_batch_has_id(cnt, name_id)) {
+			continue;
+		}
+
+		if (name_id > cf->last_name_id) {
+			break;
+		}
+
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+		if (cf->name_index_valid) {
+			if (settings_nvs_index_slot(cf, name_id)->hash == 0U) {
+				break;
+			}
+			continue;
+		}
+#endif
+		if (nvs_read(&cf->cf_nvs, name_id, &c, sizeof(c)) == -ENOENT) {
+			break;
+		}
+	}
+
+	return name_id;
+}
+
+static int settings_nvs_batch_add(size_t *cnt, uint16_t id, const void *data,
+				  size_t len)
+{
+	if (*cnt == ARRAY_SIZE(batch_entries)) {
+		return -ENOMEM;
+	}
+
+	batch_entries[*cnt].id = id;
+	batch_entries[*cnt].data = data;
+	batch_entries[*cnt].len = len;
+	(*cnt)++;
+
+	return 0;
+}
+
+/* ::csi_save_batch implementation, the name and value entries of all
+ * records are written by a single nvs_write_multi().
+ */
+static int settings_nvs_save_batch(struct settings_store *cs,
+				   const uint8_t *buf, size_t len)
+{
+	struct settings_nvs *cf = (struct settings_nvs *)cs;
+	char name[SETTINGS_MAX_NAME_LEN + 1];
+	struct settings_batch_rec rec;
+	uint16_t last_name_id = cf->last_name_id;
+	uint16_t free_id = NVS_NAMECNT_ID;
+	uint16_t name_id;
+	size_t cnt = 0;
+	size_t off = 0;
+	int rc;
+
+	while ((rc = settings_batch_rec_get(buf, len, off, &rec)) > 0) {
+		off += rc;
+
+		memcpy(name, rec.name, rec.name_len);
+		name[rec.name_len] = '\0';
+
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+		if (cf->name_index_valid) {
+			name_id = settings_nvs_index_find(cf, name);
+		} else
+#endif
+		{
+			uint16_t unused;
+
+			name_id = settings_nvs_scan_name(cf, name, &unused);
+		}
+
+		if (rec.val_len == 0U) {
+			if (name_id == NVS_NAMECNT_ID) {
+				continue;
+			}
+
+			rc = settings_nvs_batch_add(&cnt, name_id, NULL, 0);
+			if (rc == 0) {
+				rc = settings_nvs_batch_add(&cnt,
+					name_id + NVS_NAME_ID_OFFSET, NULL, 0);
+			}
+		} else if (name_id != NVS_NAMECNT_ID) {
+			rc = settings_nvs_batch_add(&cnt,
+						    name_id + NVS_NAME_ID_OFFSET,
+						    rec.value, rec.val_len);
+		} else {
+			free_id = settings_nvs_batch_free_id(cf, cnt, free_id);
+			if (free_id == NVS_NAMECNT_ID + NVS_NAME_ID_OFFSET) {
+				/* No free IDs left. */
+				return -ENOMEM;
+			}
+
+			rc = settings_nvs_batch_add(&cnt,
+						    free_id + NVS_NAME_ID_OFFSET,
+						    rec.value, rec.val_len);
+			if (rc == 0) {
+				rc = settings_nvs_batch_add(&cnt, free_id,
+							    rec.name,
+							    rec.name_len);
+			}
+			last_name_id = MAX(last_name_id, free_id);
+		}
+
+		if (rc) {
+			return rc;
+		}
+	}
+
+	if (rc < 0) {
+		return rc;
+	}
+
+	/* The largest name ID is not lowered on deletions, deleted IDs are
+	 * reused by later settings.
+	 */
+	if (last_name_id != cf->last_name_id) {
+		rc = settings_nvs_batch_add(&cnt, NVS_NAMECNT_ID,
+					    &last_name_id,
+					    sizeof(last_name_id));
+		if (rc) {
+			return rc;
+		}
+	}
+
+	rc = nvs_write_multi(&cf->cf_nvs, batch_entries, cnt);
+	if (rc < 0) {
+		return rc;
+	}
+
+	cf->last_name_id = last_name_id;
+
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+	for (size_t i = 0; i < cnt; i++) {
+		name_id = batch_entries[i].id;
+		if ((name_id <= NVS_NAMECNT_ID) ||
+		    (name_id >= NVS_NAMECNT_ID + NVS_NAME_ID_OFFSET)) {
+			continue;
+		}
+
+		if (batch_entries[i].len == 0U) {
+			settings_nvs_index_remove(cf, name_id);
+		} else {
+			memcpy(name, batch_entries[i].data,
+			       batch_entries[i].len);
+			name[batch_entries[i].len] = '\0';
+			settings_nvs_index_add(cf, name_id, name);
+		}
+	}
+#endif
+
+	return 0;
+}
+#endif /* CONFIG_SETTINGS_TXN */
+
 /* Initialize the nvs backend. */
 int settings_nvs_backend_init(struct settings_nvs *cf)
 {
@@ -269,6 +684,10 @@ int settings_nvs_backend_init(struct settings_nvs *cf)
 		cf->last_name_id = last_name_id;
 	}
 
+#ifdef CONFIG_SETTINGS_NVS_NAME_INDEX
+	settings_nvs_index_build(cf);
+#endif
+
 	LOG_DBG("Initialized");
 	return 0;
 }
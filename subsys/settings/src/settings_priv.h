@@ -9,6 +9,7 @@
 #define __SETTINGS_PRIV_H_
 
 #include <sys/types.h>
+#include <string.h>
 #include <zephyr/sys/slist.h>
 #include <errno.h>
 #include <zephyr/settings/settings.h>
@@ -113,6 +114,80 @@ size_t settings_line_val_get_len(off_t val_off, void *read_cb_ctx);
 int settings_line_entry_copy(void *dst_ctx, off_t dst_off, void *src_ctx,
 			off_t src_off, size_t len);
 
+/*
+ * Line holding the records of a settings transaction saved as one batch by
+ * a line based back-end, see settings_store_itf::csi_save_batch. Its value
+ * is the batch: every record is a line length (2 bytes, little endian) and
+ * the line "name=value". A zero line length starts the commit record, which
+ * holds the number of records (2 bytes, little endian) and ends the batch.
+ */
+#define SETTINGS_TXN_BATCH_NAME ".txnb"
+
+#define SETTINGS_BATCH_HDR_LEN 2
+#define SETTINGS_BATCH_COMMIT_LEN 4
+
+struct settings_batch_rec {
+	const char *name;
+	size_t name_len;
+	const char *value;
+	size_t val_len;
+};
+
+static inline bool settings_line_is_batch(const char *name, size_t name_len)
+{
+	return (name_len == sizeof(SETTINGS_TXN_BATCH_NAME) - 1) &&
+	       !memcmp(name, SETTINGS_TXN_BATCH_NAME, name_len);
+}
+
+/**
+ * Get a record of a batch held in RAM.
+ *
+ * @param buf batch
+ * @param len length of the batch
+ * @param off offset of the record in the batch
+ * @param[out] rec record
+ *
+ * @retval size of the record on success,
+ * 0 on the commit record,
+ * -EINVAL on a malformed record
+ */
+int settings_batch_rec_get(const uint8_t *buf, size_t len, size_t off,
+			   struct settings_batch_rec *rec);
+
+/* Check that a batch held in RAM is complete, returns 0 or -EINVAL */
+int settings_batch_check(const uint8_t *buf, size_t len);
+
+/* Check whether a line held in RAM is of the name, or is a batch holding a
+ * record of the name.
+ */
+bool settings_line_buf_has_name(const uint8_t *line, size_t len,
+				const char *name, size_t name_len);
+
+/*
+ * @param off offset of the record line from the beginning of the batch line
+ * @param len length of the record line
+ * @return 0 to continue, non-zero to stop the walk and return that value
+ */
+typedef int (*settings_line_batch_cb)(off_t off, size_t len, void *cb_arg);
+
+/**
+ * Walk the records of a batch line in storage.
+ *
+ * The records are passed to the callback only if the batch ends with its
+ * commit record, so a batch interrupted while it was written is ignored.
+ *
+ * @param read_cb_ctx settings line storage context of the batch line
+ * @param val_off offset of the batch in the line
+ * @param cb called for every record
+ * @param cb_arg argument for <p>cb</p>
+ *
+ * @retval 0 on success or the value returned by <p>cb</p> to stop,
+ * -EINVAL on an incomplete batch,
+ * -ERCODE on storage errors
+ */
+int settings_line_batch_walk(void *read_cb_ctx, off_t val_off,
+			     settings_line_batch_cb cb, void *cb_arg);
+
 void settings_line_io_init(int (*read_cb)(void *ctx, off_t off, char *buf,
 					  size_t *len),
 			  int (*write_cb)(void *ctx, off_t off, char const *buf,
@@ -125,6 +200,9 @@ extern sys_slist_t settings_load_srcs;
 extern sys_slist_t settings_handlers;
 extern struct settings_store *settings_save_dst;
 
+/* Complete a transaction interrupted while it was committed */
+int settings_txn_replay(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <zephyr/settings/settings.h>
+#include "settings_priv.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(settings, CONFIG_SETTINGS_LOG_LEVEL);
+
+extern struct k_mutex settings_lock;
+
+/* Staged records are packed in the buffer in the batch layout of
+ * settings_store_itf::csi_save_batch: a line length (2 bytes, little endian)
+ * and the line "name=value", an empty value being a deletion. The commit
+ * record ending the batch is appended on commit. The same layout is stored
+ * as the journal value when CONFIG_SETTINGS_TXN_JOURNAL is used.
+ */
+static struct {
+	uint8_t buf[CONFIG_SETTINGS_TXN_BUF_SIZE];
+	size_t len;
+	uint16_t cnt;
+	k_tid_t owner;
+	bool active;
+} txn;
+
+static int txn_apply(struct settings_store *cs, const uint8_t *buf, size_t len)
+{
+	char name[SETTINGS_MAX_NAME_LEN + 1];
+	struct settings_batch_rec rec;
+	size_t off = 0;
+	int rc;
+
+	while ((rc = settings_batch_rec_get(buf, len, off, &rec)) > 0) {
+		off += rc;
+
+		memcpy(name, rec.name, rec.name_len);
+		name[rec.name_len] = '\0';
+
+		rc = cs->cs_itf->csi_save(cs, name, rec.value, rec.val_len);
+		if (rc) {
+			LOG_ERR("txn: failed to save %s (err %d)", name, rc);
+			return rc;
+		}
+	}
+
+	return rc;
+}
+
+static inline bool txn_is_owner(void)
+{
+	return txn.active && (txn.owner == k_current_get());
+}
+
+int settings_txn_begin(void)
+{
+	if (!settings_save_dst) {
+		return -ENOENT;
+	}
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	if (txn.active) {
+		/* Only the owner can get here, the lock is held until the
+		 * transaction ends.
+		 */
+		k_mutex_unlock(&settings_lock);
+		return -EALREADY;
+	}
+
+	txn.len = 0;
+	txn.cnt = 0;
+	txn.owner = k_current_get();
+	txn.active = true;
+
+	return 0;
+}
+
+int settings_txn_set(const char *name, const void *value, size_t val_len)
+{
+	struct settings_batch_rec rec;
+	size_t name_len;
+	size_t line_len;
+	size_t off = 0;
+	int rc;
+
+	if (!txn_is_owner()) {
+		return -EINVAL;
+	}
+
+	if (!name || (val_len > UINT16_MAX) || (val_len > 0 && !value)) {
+		return -EINVAL;
+	}
+
+	name_len = strlen(name);
+	if ((name_len == 0) || (name_len > SETTINGS_MAX_NAME_LEN) ||
+	    (memchr(name, '=', name_len) != NULL)) {
+		return -EINVAL;
+	}
+
+	/* Coalesce: only the last value staged for a name is committed */
+	while ((rc = settings_batch_rec_get(txn.buf, txn.len, off, &rec)) > 0) {
+		if ((rec.name_len == name_len) &&
+		    (memcmp(rec.name, name, name_len) == 0)) {
+			memmove(&txn.buf[off], &txn.buf[off + rc],
+				txn.len - off - rc);
+			txn.len -= rc;
+			txn.cnt--;
+			break;
+		}
+		off += rc;
+	}
+
+	/* Room is kept for the commit record */
+	line_len = name_len + 1 + val_len;
+	if (txn.len + SETTINGS_BATCH_HDR_LEN + line_len +
+	    SETTINGS_BATCH_COMMIT_LEN > sizeof(txn.buf)) {
+		return -ENOMEM;
+	}
+
+	sys_put_le16(line_len, &txn.buf[txn.len]);
+	txn.len += SETTINGS_BATCH_HDR_LEN;
+	memcpy(&txn.buf[txn.len], name, name_len);
+	txn.buf[txn.len + name_len] = '=';
+	if (val_len) {
+		memcpy(&txn.buf[txn.len + name_len + 1], value, val_len);
+	}
+	txn.len += line_len;
+	txn.cnt++;
+
+	return 0;
+}
+
+int settings_txn_delete(const char *name)
+{
+	return settings_txn_set(name, NULL, 0);
+}
+
+static void txn_end(void)
+{
+	txn.active = false;
+	txn.len = 0;
+	txn.cnt = 0;
+	txn.owner = NULL;
+	k_mutex_unlock(&settings_lock);
+}
+
+int settings_txn_commit(void)
+{
+	struct settings_store *cs = settings_save_dst;
+	int rc = 0;
+
+	if (!txn_is_owner()) {
+		return -EINVAL;
+	}
+
+	if (txn.len == 0) {
+		txn_end();
+		return 0;
+	}
+
+	sys_put_le16(0, &txn.buf[txn.len]);
+	sys_put_le16(txn.cnt, &txn.buf[txn.len + SETTINGS_BATCH_HDR_LEN]);
+	txn.len += SETTINGS_BATCH_COMMIT_LEN;
+
+	if (cs->cs_itf->csi_save_start) {
+		cs->cs_itf->csi_save_start(cs);
+	}
+
+	if (cs->cs_itf->csi_save_batch) {
+		/* The back-end stores the batch atomically */
+		rc = cs->cs_itf->csi_save_batch(cs, txn.buf, txn.len);
+		goto end;
+	}
+
+#if defined(CONFIG_SETTINGS_TXN_JOURNAL)
+	/* Writing the journal is the commit point: once it is stored, the
+	 * transaction is completed by settings_txn_replay() if the records
+	 * below could not all be written.
+	 */
+	rc = cs->cs_itf->csi_save(cs, SETTINGS_TXN_JOURNAL_NAME,
+				  (const char *)txn.buf, txn.len);
+#endif
+
+	if (rc == 0) {
+		rc = txn_apply(cs, txn.buf, txn.len);
+	}
+
+#if defined(CONFIG_SETTINGS_TXN_JOURNAL)
+	if (rc == 0) {
+		rc = cs->cs_itf->csi_save(cs, SETTINGS_TXN_JOURNAL_NAME,
+					  NULL, 0);
+	}
+#endif
+
+end:
+	if (cs->cs_itf->csi_save_end) {
+		cs->cs_itf->csi_save_end(cs);
+	}
+
+	txn_end();
+
+	return rc;
+}
+
+void settings_txn_abort(void)
+{
+	if (txn_is_owner()) {
+		txn_end();
+	}
+}
+
+#if defined(CONFIG_SETTINGS_TXN_JOURNAL)
+static int txn_journal_load_cb(const char *key, size_t len,
+			       settings_read_cb read_cb, void *cb_arg,
+			       void *param)
+{
+	ssize_t rc;
+
+	ARG_UNUSED(param);
+
+	/* Only the journal itself, not names below it */
+	if (key != NULL) {
+		return 0;
+	}
+
+	if (len > sizeof(txn.buf)) {
+		LOG_ERR("txn: journal too large (%zu)", len);
+		return 0;
+	}
+
+	rc = read_cb(cb_arg, txn.buf, len);
+	txn.len = (rc > 0) ? rc : 0;
+
+	return 0;
+}
+
+int settings_txn_replay(void)
+{
+	struct settings_store *cs = settings_save_dst;
+	int rc;
+
+	if (!cs) {
+		return 0;
+	}
+
+	k_mutex_lock(&settings_lock, K_FOREVER);
+
+	txn.len = 0;
+	(void)settings_load_subtree_direct(SETTINGS_TXN_JOURNAL_NAME,
+					   txn_journal_load_cb, NULL);
+	if (txn.len == 0) {
+		k_mutex_unlock(&settings_lock);
+		return 0;
+	}
+
+	LOG_INF("txn: completing interrupted transaction");
+
+	rc = settings_batch_check(txn.buf, txn.len);
+	if (rc) {
+		LOG_ERR("txn: corrupted journal, discarding it");
+	} else {
+		rc = txn_apply(cs, txn.buf, txn.len);
+		if (rc) {
+			/* Keep the journal, it is retried on next init */
+			LOG_ERR("txn: replay failed (err %d)", rc);
+			goto out;
+		}
+	}
+
+	rc = cs->cs_itf->csi_save(cs, SETTINGS_TXN_JOURNAL_NAME, NULL, 0);
+
+out:
+	txn.len = 0;
+	k_mutex_unlock(&settings_lock);
+
+	return rc;
+}
+#endif /* CONFIG_SETTINGS_TXN_JOURNAL */
@@ -74,7 +74,7 @@ static int settings_direct_loader(const char *key, size_t len,
 
 #ifdef CONFIG_STREAM_FLASH_ERASE
 
-int stream_flash_erase_page(struct stream_flash_ctx *ctx, off_t off)
+static int erase_page(struct stream_flash_ctx *ctx, off_t off)
 {
 	int rc;
 	struct flash_pages_info page;
@@ -104,7 +104,9 @@ int stream_flash_erase_page(struct stream_flash_ctx *ctx, off_t off)
 
 #endif /* CONFIG_STREAM_FLASH_ERASE */
 
-static int flash_sync(struct stream_flash_ctx *ctx)
+/* Write bytes of buf at the current write position */
+static int flash_buf_write(struct stream_flash_ctx *ctx, uint8_t *buf,
+			   size_t bytes)
 {
 	int rc = 0;
 	size_t write_addr = ctx->offset + ctx->bytes_written;
@@ -112,34 +114,27 @@ static int flash_sync(struct stream_flash_ctx *ctx)
 	size_t fill_length;
 	uint8_t filler;
 
-
-	if (ctx->buf_bytes == 0) {
-		return 0;
-	}
-
-	if (IS_ENABLED(CONFIG_STREAM_FLASH_ERASE)) {
-
-		rc = stream_flash_erase_page(ctx,
-					     write_addr + ctx->buf_bytes - 1);
-		if (rc < 0) {
-			LOG_ERR("stream_flash_erase_page err %d offset=0x%08zx",
-				rc, write_addr);
-			return rc;
-		}
+#ifdef CONFIG_STREAM_FLASH_ERASE
+	rc = erase_page(ctx, write_addr + bytes - 1);
+	if (rc < 0) {
+		LOG_ERR("stream_flash_erase_page err %d offset=0x%08zx",
+			rc, write_addr);
+		return rc;
 	}
+#endif
 
 	fill_length = flash_get_write_block_size(ctx->fdev);
-	if (ctx->buf_bytes % fill_length) {
-		fill_length -= ctx->buf_bytes % fill_length;
+	if (bytes % fill_length) {
+		fill_length -= bytes % fill_length;
 		filler = flash_get_parameters(ctx->fdev)->erase_value;
 
-		memset(ctx->buf + ctx->buf_bytes, filler, fill_length);
+		memset(buf + bytes, filler, fill_length);
 	} else {
 		fill_length = 0;
 	}
 
-	buf_bytes_aligned = ctx->buf_bytes + fill_length;
-	rc = flash_write(ctx->fdev, write_addr, ctx->buf, buf_bytes_aligned);
+	buf_bytes_aligned = bytes + fill_length;
+	rc = flash_write(ctx->fdev, write_addr, buf, buf_bytes_aligned);
 
 	if (rc != 0) {
 		LOG_ERR("flash_write error %d offset=0x%08zx", rc,
@@ -151,24 +146,190 @@ static int flash_sync(struct stream_flash_ctx *ctx)
 		/* Invert to ensure that caller is able to discover a faulty
 		 * flash_read() even if no error code is returned.
 		 */
-		for (int i = 0; i < ctx->buf_bytes; i++) {
-			ctx->buf[i] = ~ctx->buf[i];
+		for (int i = 0; i < bytes; i++) {
+			buf[i] = ~buf[i];
 		}
 
-		rc = flash_read(ctx->fdev, write_addr, ctx->buf,
-				ctx->buf_bytes);
+		rc = flash_read(ctx->fdev, write_addr, buf, bytes);
 		if (rc != 0) {
 			LOG_ERR("flash read failed: %d", rc);
 			return rc;
 		}
 
-		rc = ctx->callback(ctx->buf, ctx->buf_bytes, write_addr);
+		rc = ctx->callback(buf, bytes, write_addr);
 		if (rc != 0) {
 			LOG_ERR("callback failed: %d", rc);
 			return rc;
 		}
 	}
 
+	return rc;
+}
+
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+static K_THREAD_STACK_DEFINE(stream_flash_stack,
+			     CONFIG_STREAM_FLASH_ASYNC_STACK_SIZE);
+static struct k_work_q stream_flash_work_q;
+
+static void flush_work_handler(struct k_work *work)
+{
+	struct stream_flash_ctx *ctx =
+		CONTAINER_OF(work, struct stream_flash_ctx, flush_work);
+
+	ctx->flush_rc = flash_buf_write(ctx, ctx->flush_buf, ctx->flush_bytes);
+
+#ifdef CONFIG_STREAM_FLASH_ERASE
+	/* Erase ahead the page in which the data already known to follow
+	 * ends. On failure, the erase is retried when writing it.
+	 */
+	if ((ctx->flush_rc == 0) && (ctx->flush_next > 0)) {
+		(void)erase_page(ctx, ctx->offset + ctx->bytes_written +
+				 ctx->flush_bytes + ctx->flush_next - 1);
+	}
+#endif
+
+	k_sem_give(&ctx->flush_sem);
+}
+
+static int stream_flash_work_q_init(const struct device *dev)
+{
+	struct k_work_queue_config cfg = {
+		.name = "stream_flash",
+	};
+
+	ARG_UNUSED(dev);
+
+	k_work_queue_start(&stream_flash_work_q, stream_flash_stack,
+			   K_THREAD_STACK_SIZEOF(stream_flash_stack),
+			   CONFIG_STREAM_FLASH_ASYNC_PRIORITY, &cfg);
+
+	return 0;
+}
+
+SYS_INIT(stream_flash_work_q_init, POST_KERNEL,
+	 CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+
+/*
+ * Wait for the flush in progress, if any, and account for the bytes it
+ * wrote. The flush semaphore is held on return, so no flush is started
+ * until it is given back.
+ */
+static int flush_wait(struct stream_flash_ctx *ctx)
+{
+	int rc;
+
+	(void)k_sem_take(&ctx->flush_sem, K_FOREVER);
+
+	rc = ctx->flush_rc;
+	if (rc == 0) {
+		ctx->bytes_written += ctx->flush_bytes;
+	}
+	ctx->flush_bytes = 0U;
+	ctx->flush_rc = 0;
+
+	return rc;
+}
+
+/* Hand the write buffer over to the work queue and fill the other one,
+ * with at least next_bytes more bytes.
+ */
+static int flash_sync_async(struct stream_flash_ctx *ctx, size_t next_bytes)
+{
+	uint8_t *buf;
+	int rc;
+
+	rc = flush_wait(ctx);
+	if (rc != 0) {
+		k_sem_give(&ctx->flush_sem);
+		return rc;
+	}
+
+	buf = ctx->flush_buf;
+	ctx->flush_buf = ctx->buf;
+	ctx->flush_bytes = ctx->buf_bytes;
+	ctx->flush_next = MIN(next_bytes, ctx->buf_len);
+	ctx->buf = buf;
+	ctx->buf_bytes = 0U;
+
+	(void)k_work_submit_to_queue(&stream_flash_work_q, &ctx->flush_work);
+
+	return 0;
+}
+
+int stream_flash_async_enable(struct stream_flash_ctx *ctx)
+{
+	size_t half;
+
+	if (!ctx) {
+		return -EFAULT;
+	}
+
+	half = ctx->buf_len / 2;
+	if (ctx->async || ctx->buf_bytes != 0 || half == 0 ||
+	    half % flash_get_write_block_size(ctx->fdev)) {
+		return -EINVAL;
+	}
+
+	ctx->buf_len = half;
+	ctx->flush_buf = ctx->buf + half;
+	ctx->flush_bytes = 0U;
+	ctx->flush_rc = 0;
+	k_work_init(&ctx->flush_work, flush_work_handler);
+	k_sem_init(&ctx->flush_sem, 1, 1);
+	ctx->async = true;
+
+	return 0;
+}
+
+#endif /* CONFIG_STREAM_FLASH_ASYNC */
+
+#ifdef CONFIG_STREAM_FLASH_ERASE
+
+int stream_flash_erase_page(struct stream_flash_ctx *ctx, off_t off)
+{
+	int rc;
+
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	if (ctx->async) {
+		rc = flush_wait(ctx);
+		if (rc == 0) {
+			rc = erase_page(ctx, off);
+		}
+		k_sem_give(&ctx->flush_sem);
+
+		return rc;
+	}
+#endif
+
+	rc = erase_page(ctx, off);
+
+	return rc;
+}
+
+#endif /* CONFIG_STREAM_FLASH_ERASE */
+
+/* Write the buffer to flash, next_bytes is the number of bytes known to
+ * follow it.
+ */
+static int flash_sync(struct stream_flash_ctx *ctx, size_t next_bytes)
+{
+	int rc;
+
+	if (ctx->buf_bytes == 0) {
+		return 0;
+	}
+
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	if (ctx->async) {
+		return flash_sync_async(ctx, next_bytes);
+	}
+#endif
+
+	rc = flash_buf_write(ctx, ctx->buf, ctx->buf_bytes);
+	if (rc != 0) {
+		return rc;
+	}
+
 	ctx->bytes_written += ctx->buf_bytes;
 	ctx->buf_bytes = 0U;
 
@@ -181,12 +342,18 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 	int processed = 0;
 	int rc = 0;
 	int buf_empty_bytes;
+	size_t pending;
 
 	if (!ctx) {
 		return -EFAULT;
 	}
 
-	if (ctx->bytes_written + ctx->buf_bytes + len > ctx->available) {
+	pending = ctx->buf_bytes;
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	pending += ctx->flush_bytes;
+#endif
+
+	if (ctx->bytes_written + pending + len > ctx->available) {
 		return -ENOMEM;
 	}
 
@@ -196,7 +363,7 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 		       buf_empty_bytes);
 
 		ctx->buf_bytes = ctx->buf_len;
-		rc = flash_sync(ctx);
+		rc = flash_sync(ctx, len - processed - buf_empty_bytes);
 
 		if (rc != 0) {
 			return rc;
@@ -213,9 +380,16 @@ int stream_flash_buffered_write(struct stream_flash_ctx *ctx, const uint8_t *dat
 	}
 
 	if (flush && ctx->buf_bytes > 0) {
-		rc = flash_sync(ctx);
+		rc = flash_sync(ctx, 0);
 	}
 
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	if (flush && ctx->async && rc == 0) {
+		rc = flush_wait(ctx);
+		k_sem_give(&ctx->flush_sem);
+	}
+#endif
+
 	return rc;
 }
 
@@ -299,6 +473,10 @@ int stream_flash_init(struct stream_flash_ctx *ctx, const struct device *fdev,
 #ifdef CONFIG_STREAM_FLASH_ERASE
 	ctx->last_erased_page_start_offset = -1;
 #endif
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	ctx->flush_bytes = 0U;
+	ctx->async = false;
+#endif
 
 	return 0;
 }
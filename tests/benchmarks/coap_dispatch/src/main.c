@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/coap.h>
+#include <stdio.h>
+#include <string.h>
+
+#define NUM_GROUPS    10
+#define NUM_PER_GROUP 20
+#define NUM_RESOURCES (NUM_GROUPS * NUM_PER_GROUP)
+#define NUM_ROUNDS    50
+#define MAX_OPTIONS   4
+
+static char group_names[NUM_GROUPS][4];
+static char leaf_names[NUM_PER_GROUP][4];
+static const char *paths[NUM_RESOURCES][3];
+static struct coap_resource resources[NUM_RESOURCES + 1];
+
+/* Root, groups and resources */
+COAP_RESOURCE_INDEX_DEFINE(res_index, 1 + NUM_GROUPS + NUM_RESOURCES);
+
+static uint8_t request_data[NUM_RESOURCES][32];
+static struct coap_packet requests[NUM_RESOURCES];
+static struct coap_option options[NUM_RESOURCES][MAX_OPTIONS];
+
+static struct sockaddr_in6 peer_addr = {
+	.sin6_family = AF_INET6,
+};
+
+static uint32_t dispatched;
+
+static int bench_get(struct coap_resource *resource,
+		     struct coap_packet *request,
+		     struct sockaddr *addr, socklen_t addr_len)
+{
+	dispatched++;
+
+	return 0;
+}
+
+static void resources_init(void)
+{
+	for (int i = 0; i < NUM_GROUPS; i++) {
+		snprintf(group_names[i], sizeof(group_names[i]), "g%d", i);
+	}
+
+	for (int i = 0; i < NUM_PER_GROUP; i++) {
+		snprintf(leaf_names[i], sizeof(leaf_names[i]), "r%d", i);
+	}
+
+	for (int i = 0; i < NUM_RESOURCES; i++) {
+		paths[i][0] = group_names[i / NUM_PER_GROUP];
+		paths[i][1] = leaf_names[i % NUM_PER_GROUP];
+		paths[i][2] = NULL;
+		resources[i].path = (const char * const *)paths[i];
+		resources[i].get = bench_get;
+	}
+}
+
+static int requests_init(void)
+{
+	int rc;
+
+	for (int i = 0; i < NUM_RESOURCES; i++) {
+		struct coap_packet *req = &requests[i];
+
+		rc = coap_packet_init(req, request_data[i],
+				      sizeof(request_data[i]), COAP_VERSION_1,
+				      COAP_TYPE_CON, 0, NULL, COAP_METHOD_GET,
+				      coap_next_id());
+		for (int j = 0; rc == 0 && paths[i][j]; j++) {
+			rc = coap_packet_append_option(req, COAP_OPTION_URI_PATH,
+						       paths[i][j],
+						       strlen(paths[i][j]));
+		}
+
+		if (rc == 0) {
+			rc = coap_packet_parse(req, request_data[i], req->offset,
+					       options[i], MAX_OPTIONS);
+		}
+
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+static int bench(const char *name, bool use_index)
+{
+	uint32_t start, cycles, us;
+	int rc;
+
+	dispatched = 0U;
+	start = k_cycle_get_32();
+
+	for (int round = 0; round < NUM_ROUNDS; round++) {
+		for (int i = 0; i < NUM_RESOURCES; i++) {
+			if (use_index) {
+				rc = coap_handle_request_index(
+					&requests[i], &res_index, options[i],
+					MAX_OPTIONS, (struct sockaddr *)&peer_addr,
+					sizeof(peer_addr));
+			} else {
+				rc = coap_handle_request(
+					&requests[i], resources, options[i],
+					MAX_OPTIONS, (struct sockaddr *)&peer_addr,
+					sizeof(peer_addr));
+			}
+
+			if (rc) {
+				return rc;
+			}
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+	us = MAX((uint32_t)k_cyc_to_us_floor64(cycles), 1U);
+
+	printk("%-6s %9u req/s\n", name,
+	       (uint32_t)((uint64_t)dispatched * USEC_PER_SEC / us));
+
+	return 0;
+}
+
+void main(void)
+{
+	int rc;
+
+	resources_init();
+
+	rc = coap_resource_index_init(&res_index, resources);
+	if (rc == 0) {
+		rc = requests_init();
+	}
+	if (rc) {
+		printk("Unable to set up the requests (err %d)\n", rc);
+		return;
+	}
+
+	printk("%u resources, %u nodes\n", NUM_RESOURCES, res_index.num_nodes);
+
+	rc = bench("linear", false);
+	if (rc == 0) {
+		rc = bench("index", true);
+	}
+	if (rc) {
+		printk("dispatch failed (err %d)\n", rc);
+		return;
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/net/coap.h>
+#include <string.h>
+
+#define NUM_PACKETS 20000
+#define NUM_LOOKUPS 5
+
+static const char * const path[] = { "3303", "0", "5700", NULL };
+static const char * const query[] = { "pmin=10", "pmax=60", NULL };
+
+/* Options queried by a request handler, one of them absent */
+static const uint16_t lookups[NUM_LOOKUPS] = {
+	COAP_OPTION_OBSERVE, COAP_OPTION_CONTENT_FORMAT, COAP_OPTION_ACCEPT,
+	COAP_OPTION_BLOCK2, COAP_OPTION_BLOCK1,
+};
+
+static uint8_t request_data[128];
+static uint16_t request_len;
+
+static int append_strings(struct coap_packet *req, uint16_t code,
+			  const char * const *strings)
+{
+	int rc = 0;
+
+	for (int i = 0; rc == 0 && strings[i]; i++) {
+		rc = coap_packet_append_option(req, code, strings[i],
+					       strlen(strings[i]));
+	}
+
+	return rc;
+}
+
+static int request_init(void)
+{
+	struct coap_packet req;
+	int rc;
+
+	rc = coap_packet_init(&req, request_data, sizeof(request_data),
+			      COAP_VERSION_1, COAP_TYPE_CON, 8,
+			      coap_next_token(), COAP_METHOD_GET,
+			      coap_next_id());
+	if (rc == 0) {
+		rc = coap_append_option_int(&req, COAP_OPTION_OBSERVE, 0);
+	}
+	if (rc == 0) {
+		rc = append_strings(&req, COAP_OPTION_URI_PATH, path);
+	}
+	if (rc == 0) {
+		rc = coap_append_option_int(&req, COAP_OPTION_CONTENT_FORMAT,
+					    COAP_CONTENT_FORMAT_APP_CBOR);
+	}
+	if (rc == 0) {
+		rc = append_strings(&req, COAP_OPTION_URI_QUERY, query);
+	}
+	if (rc == 0) {
+		rc = coap_append_option_int(&req, COAP_OPTION_ACCEPT,
+					    COAP_CONTENT_FORMAT_APP_CBOR);
+	}
+	if (rc == 0) {
+		rc = coap_append_option_int(&req, COAP_OPTION_BLOCK2, 0x06);
+	}
+	if (rc == 0) {
+		rc = coap_append_option_int(&req, COAP_OPTION_SIZE2, 0);
+	}
+
+	request_len = req.offset;
+
+	return rc;
+}
+
+static int bench(const char *name, int num_lookups)
+{
+	struct coap_packet cpkt;
+	uint32_t start, cycles, us;
+	int found = 0;
+	int rc;
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < NUM_PACKETS; i++) {
+		rc = coap_packet_parse(&cpkt, request_data, request_len, NULL, 0);
+		if (rc) {
+			return rc;
+		}
+
+		for (int j = 0; j < num_lookups; j++) {
+			if (coap_get_option_int(&cpkt, lookups[j]) >= 0) {
+				found++;
+			}
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+	us = MAX((uint32_t)k_cyc_to_us_floor64(cycles), 1U);
+
+	if (found != NUM_PACKETS * MAX(num_lookups - 1, 0)) {
+		return -ENOENT;
+	}
+
+	printk("%-7s %9u pkt/s\n", name,
+	       (uint32_t)((uint64_t)NUM_PACKETS * USEC_PER_SEC / us));
+
+	return 0;
+}
+
+void main(void)
+{
+	int rc;
+
+	rc = request_init();
+	if (rc) {
+		printk("Unable to set up the request (err %d)\n", rc);
+		return;
+	}
+
+#if defined(CONFIG_COAP_OPTION_INDEX)
+	printk("%u bytes, option index %u entries\n", request_len,
+	       CONFIG_COAP_OPTION_INDEX_SIZE);
+#else
+	printk("%u bytes, option index off\n", request_len);
+#endif
+
+	rc = bench("parse", 0);
+	if (rc == 0) {
+		rc = bench("lookups", NUM_LOOKUPS);
+	}
+	if (rc) {
+		printk("lookup failed (err %d)\n", rc);
+		return;
+	}
+
+	printk("fin\n");
+}
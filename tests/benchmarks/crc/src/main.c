@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/crc.h>
+
+#define BUF_SIZE 4096
+#define NUM_RUNS 64
+
+/* Size of the tables used by lib/os for each CRC width */
+#if defined(CONFIG_CRC_TABLE_SLICE_BY_8)
+#define CRC32_TABLE_SIZE (8 * 256 * sizeof(uint32_t))
+#define CRC16_TABLE_SIZE (256 * sizeof(uint16_t))
+#define CRC8_TABLE_SIZE 256
+#elif defined(CONFIG_CRC_TABLE_BYTE)
+#define CRC32_TABLE_SIZE (256 * sizeof(uint32_t))
+#define CRC16_TABLE_SIZE (256 * sizeof(uint16_t))
+#define CRC8_TABLE_SIZE 256
+#else
+#define CRC32_TABLE_SIZE (16 * sizeof(uint32_t))
+#define CRC16_TABLE_SIZE 0
+#define CRC8_TABLE_SIZE 16
+#endif
+
+#if defined(CONFIG_CRC_ARCH) && defined(CONFIG_ARCH_HAS_CRC32_IEEE)
+#define CRC32_IEEE_TABLE_SIZE 0
+#else
+#define CRC32_IEEE_TABLE_SIZE CRC32_TABLE_SIZE
+#endif
+
+#if defined(CONFIG_CRC_ARCH) && defined(CONFIG_ARCH_HAS_CRC32C)
+#define CRC32C_TABLE_SIZE 0
+#else
+#define CRC32C_TABLE_SIZE CRC32_TABLE_SIZE
+#endif
+
+struct crc_bench {
+	const char *name;
+	uint32_t (*run)(uint32_t crc, const uint8_t *data, size_t len);
+	size_t table_size;
+};
+
+static uint8_t buf[BUF_SIZE];
+
+static uint32_t run_crc32_ieee(uint32_t crc, const uint8_t *data, size_t len)
+{
+	return crc32_ieee_update(crc, data, len);
+}
+
+static uint32_t run_crc32_c(uint32_t crc, const uint8_t *data, size_t len)
+{
+	return crc32_c(crc, data, len, false, false);
+}
+
+static uint32_t run_crc16_ccitt(uint32_t crc, const uint8_t *data, size_t len)
+{
+	return crc16_ccitt(crc, data, len);
+}
+
+static uint32_t run_crc16_itu_t(uint32_t crc, const uint8_t *data, size_t len)
+{
+	return crc16_itu_t(crc, data, len);
+}
+
+static uint32_t run_crc8_ccitt(uint32_t crc, const uint8_t *data, size_t len)
+{
+	return crc8_ccitt(crc, data, len);
+}
+
+static const struct crc_bench benches[] = {
+	{ "crc32_ieee", run_crc32_ieee, CRC32_IEEE_TABLE_SIZE },
+	{ "crc32_c", run_crc32_c, CRC32C_TABLE_SIZE },
+	{ "crc16_ccitt", run_crc16_ccitt, CRC16_TABLE_SIZE },
+	{ "crc16_itu_t", run_crc16_itu_t, CRC16_TABLE_SIZE },
+	{ "crc8_ccitt", run_crc8_ccitt, CRC8_TABLE_SIZE },
+};
+
+static void bench(const struct crc_bench *b)
+{
+	volatile uint32_t crc = 0U;
+	uint32_t start, cycles;
+	uint32_t us;
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < NUM_RUNS; i++) {
+		crc = b->run(crc, buf, sizeof(buf));
+	}
+
+	cycles = k_cycle_get_32() - start;
+	us = MAX((uint32_t)k_cyc_to_us_floor64(cycles), 1U);
+
+	printk("%-12s %7u KiB/s %5zu bytes\n", b->name,
+	       (uint32_t)((uint64_t)NUM_RUNS * BUF_SIZE * USEC_PER_SEC /
+			  1024U / us),
+	       b->table_size);
+}
+
+void main(void)
+{
+	for (int i = 0; i < sizeof(buf); i++) {
+		buf[i] = i * 37U + 11U;
+	}
+
+#if defined(CONFIG_CRC_TABLE_SLICE_BY_8)
+	printk("slicing-by-8 tables");
+#elif defined(CONFIG_CRC_TABLE_BYTE)
+	printk("256 entry tables");
+#else
+	printk("16 entry tables");
+#endif
+	printk(", CPU instructions %s\n",
+	       IS_ENABLED(CONFIG_CRC_ARCH) ? "on" : "off");
+
+	for (int i = 0; i < ARRAY_SIZE(benches); i++) {
+		bench(&benches[i]);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/storage/disk_access.h>
+#include <zephyr/stats/stats.h>
+#include <string.h>
+
+#define DISK_NAME   CONFIG_DISK_FLASH_VOLUME_NAME
+#define SECTOR_SIZE CONFIG_DISK_FLASH_SECTOR_SIZE
+/* Single sector writes, as issued by a file system */
+#define NUM_WRITES  256
+
+static uint8_t sector[SECTOR_SIZE];
+
+/* Fixed seed, so that every configuration writes the same sectors */
+static uint32_t lcg_next(void)
+{
+	static uint32_t state = 1U;
+
+	state = state * 1664525U + 1013904223U;
+
+	return state >> 8;
+}
+
+struct flash_ops {
+	uint32_t reads;
+	uint32_t erases;
+};
+
+static int flash_ops_walk(struct stats_hdr *hdr, void *arg, const char *name,
+			  uint16_t off)
+{
+	struct flash_ops *ops = arg;
+	uint32_t val = *(uint32_t *)((uint8_t *)hdr + off);
+
+	if (strcmp(name, "flash_read_calls") == 0) {
+		ops->reads = val;
+	} else if (strcmp(name, "flash_erase_calls") == 0) {
+		ops->erases = val;
+	}
+
+	return 0;
+}
+
+static void flash_ops_get(struct flash_ops *ops)
+{
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+
+	memset(ops, 0, sizeof(*ops));
+	if (hdr) {
+		stats_walk(hdr, flash_ops_walk, ops);
+	}
+}
+
+static int bench(const char *name, bool random, uint32_t sector_count)
+{
+	struct flash_ops before, after;
+	uint32_t start, cycles, us;
+	int rc;
+
+	flash_ops_get(&before);
+	start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < NUM_WRITES; i++) {
+		uint32_t lba = random ? lcg_next() % sector_count : i;
+
+		memset(sector, i, sizeof(sector));
+		rc = disk_access_write(DISK_NAME, sector, lba, 1);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	rc = disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL);
+	if (rc) {
+		return rc;
+	}
+
+	cycles = k_cycle_get_32() - start;
+	us = MAX((uint32_t)k_cyc_to_us_floor64(cycles), 1U);
+
+	flash_ops_get(&after);
+
+	printk("%-10s %6u KiB/s erases %6u reads %6u\n", name,
+	       (uint32_t)((uint64_t)NUM_WRITES * SECTOR_SIZE * USEC_PER_SEC /
+			  1024U / us),
+	       after.erases - before.erases, after.reads - before.reads);
+
+	return 0;
+}
+
+void main(void)
+{
+	uint32_t range[2] = { 0 };
+	uint32_t sector_count;
+	int rc;
+
+	rc = disk_access_init(DISK_NAME);
+	if (rc == 0) {
+		rc = disk_access_ioctl(DISK_NAME, DISK_IOCTL_GET_SECTOR_COUNT,
+				       &sector_count);
+	}
+	if (rc) {
+		printk("Unable to access disk (err %d)\n", rc);
+		return;
+	}
+
+#if defined(CONFIG_DISK_FLASH_WRITE_BACK_CACHE)
+	printk("%u sectors, cache %u blocks\n", sector_count,
+	       CONFIG_DISK_FLASH_CACHE_BLOCKS);
+#else
+	printk("%u sectors, cache off\n", sector_count);
+#endif
+
+	rc = bench("sequential", false, sector_count);
+	if (rc == 0) {
+		rc = bench("random", true, sector_count);
+	}
+	if (rc) {
+		printk("write failed (err %d)\n", rc);
+		return;
+	}
+
+	/* Same writes on a disk whose content is no longer in use, as after
+	 * files have been deleted.
+	 */
+	range[1] = sector_count - 1U;
+	rc = disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_TRIM, range);
+	if (rc == 0) {
+		rc = bench("trimmed", true, sector_count);
+	} else if (rc == -EINVAL) {
+		printk("trim not supported\n");
+		rc = 0;
+	}
+	if (rc) {
+		printk("write failed (err %d)\n", rc);
+		return;
+	}
+
+	printk("fin\n");
+}
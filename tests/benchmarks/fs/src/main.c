@@ -0,0 +1,521 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/fs/fs.h>
+#if defined(CONFIG_FLASH_SIMULATOR_STATS)
+#include <zephyr/stats/stats.h>
+#endif
+#include <stdio.h>
+#include <string.h>
+
+#if defined(CONFIG_FILE_SYSTEM_LITTLEFS)
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/storage/flash_map.h>
+
+#define BACKEND "littlefs/flash"
+#define LFS_AREA_ID FLASH_AREA_ID(image_1)
+
+FS_LITTLEFS_DECLARE_DEFAULT_CONFIG(lfs_data);
+
+static struct fs_mount_t mnt = {
+	.type = FS_LITTLEFS,
+	.fs_data = &lfs_data,
+	.storage_dev = (void *)LFS_AREA_ID,
+	.mnt_point = "/lfs",
+};
+#elif defined(CONFIG_FAT_FILESYSTEM_ELM)
+#include <ff.h>
+
+#if defined(CONFIG_DISK_DRIVER_RAM)
+#define BACKEND "fat/ramdisk"
+#define DISK_NAME CONFIG_DISK_RAM_VOLUME_NAME
+#else
+#include <zephyr/drivers/flash.h>
+
+#define BACKEND "fat/flashdisk"
+#define DISK_NAME CONFIG_DISK_FLASH_VOLUME_NAME
+#endif
+
+static FATFS fat_fs;
+
+static struct fs_mount_t mnt = {
+	.type = FS_FATFS,
+	.fs_data = &fat_fs,
+	.mnt_point = "/" DISK_NAME ":",
+};
+#else
+#error "No file system backend selected"
+#endif
+
+/* Sequential and random transfers on one file */
+#define FILE_SIZE   (64 * 1024)
+#define RECORD_SIZE 1024
+#define RAND_SIZE   512
+#define RAND_OPS    64
+/* Small files in a directory */
+#define NUM_FILES   32
+#define SMALL_SIZE  64
+#define LIST_ROUNDS 4
+/* Appends each followed by fs_sync() */
+#define SYNC_OPS    32
+
+static uint8_t record[RECORD_SIZE];
+static char path[64];
+
+struct flash_ops {
+	uint32_t reads;
+	uint32_t writes;
+	uint32_t erases;
+};
+
+static struct {
+	uint32_t start;
+	struct flash_ops ops;
+} bench_state;
+
+/* Fixed seed, so that every backend sees the same accesses */
+static uint32_t lcg_next(void)
+{
+	static uint32_t state = 1U;
+
+	state = state * 1664525U + 1013904223U;
+
+	return state >> 8;
+}
+
+#if defined(CONFIG_FLASH_SIMULATOR_STATS)
+static int flash_ops_walk(struct stats_hdr *hdr, void *arg, const char *name,
+			  uint16_t off)
+{
+	struct flash_ops *ops = arg;
+	uint32_t val = *(uint32_t *)((uint8_t *)hdr + off);
+
+	if (strcmp(name, "flash_read_calls") == 0) {
+		ops->reads = val;
+	} else if (strcmp(name, "flash_write_calls") == 0) {
+		ops->writes = val;
+	} else if (strcmp(name, "flash_erase_calls") == 0) {
+		ops->erases = val;
+	}
+
+	return 0;
+}
+
+static void flash_ops_get(struct flash_ops *ops)
+{
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+
+	memset(ops, 0, sizeof(*ops));
+	if (hdr) {
+		stats_walk(hdr, flash_ops_walk, ops);
+	}
+}
+
+static void flash_ops_print(const struct flash_ops *start)
+{
+	struct flash_ops ops;
+
+	flash_ops_get(&ops);
+
+	printk("reads %6u writes %6u erases %6u\n", ops.reads - start->reads,
+	       ops.writes - start->writes, ops.erases - start->erases);
+}
+#else
+/* No flash simulator statistics, e.g. on a RAM disk */
+static void flash_ops_get(struct flash_ops *ops)
+{
+	memset(ops, 0, sizeof(*ops));
+}
+
+static void flash_ops_print(const struct flash_ops *start)
+{
+	ARG_UNUSED(start);
+
+	printk("reads    n/a writes    n/a erases    n/a\n");
+}
+#endif /* CONFIG_FLASH_SIMULATOR_STATS */
+
+static void bench_start(void)
+{
+	flash_ops_get(&bench_state.ops);
+	bench_state.start = k_cycle_get_32();
+}
+
+static uint32_t bench_us(void)
+{
+	uint32_t cycles = k_cycle_get_32() - bench_state.start;
+
+	return MAX((uint32_t)k_cyc_to_us_floor64(cycles), 1U);
+}
+
+/*
+ * One line per workload: name, elapsed time, rate, then the flash operations
+ * it issued, which do not depend on the speed of the host.
+ */
+static void bench_report(const char *name, uint32_t us, uint32_t rate,
+			 const char *unit)
+{
+	printk("%-10s %9u us %9u %-5s ", name, us, rate, unit);
+	flash_ops_print(&bench_state.ops);
+}
+
+static void bench_end(const char *name, uint32_t count, bool bytes)
+{
+	uint32_t us = bench_us();
+
+	if (bytes) {
+		bench_report(name, us,
+			     (uint32_t)((uint64_t)count * USEC_PER_SEC /
+					1024U / us), "KiB/s");
+	} else {
+		bench_report(name, us,
+			     (uint32_t)((uint64_t)count * USEC_PER_SEC / us),
+			     "ops/s");
+	}
+}
+
+static const char *bench_path(const char *name)
+{
+	snprintf(path, sizeof(path), "%s/%s", mnt.mnt_point, name);
+
+	return path;
+}
+
+static int seq_write(void)
+{
+	struct fs_file_t file;
+	int rc;
+
+	fs_file_t_init(&file);
+
+	bench_start();
+	rc = fs_open(&file, bench_path("bench.dat"), FS_O_CREATE | FS_O_RDWR);
+	if (rc) {
+		return rc;
+	}
+
+	for (uint32_t off = 0; off < FILE_SIZE; off += RECORD_SIZE) {
+		memset(record, off / RECORD_SIZE, sizeof(record));
+		if (fs_write(&file, record, RECORD_SIZE) != RECORD_SIZE) {
+			(void)fs_close(&file);
+			return -EIO;
+		}
+	}
+
+	rc = fs_close(&file);
+	bench_end("seq_write", FILE_SIZE, true);
+
+	return rc;
+}
+
+static int seq_read(void)
+{
+	struct fs_file_t file;
+	int rc;
+
+	fs_file_t_init(&file);
+
+	bench_start();
+	rc = fs_open(&file, bench_path("bench.dat"), FS_O_READ);
+	if (rc) {
+		return rc;
+	}
+
+	for (uint32_t off = 0; off < FILE_SIZE; off += RECORD_SIZE) {
+		if ((fs_read(&file, record, RECORD_SIZE) != RECORD_SIZE) ||
+		    (record[0] != (uint8_t)(off / RECORD_SIZE))) {
+			(void)fs_close(&file);
+			return -EIO;
+		}
+	}
+
+	rc = fs_close(&file);
+	bench_end("seq_read", FILE_SIZE, true);
+
+	return rc;
+}
+
+static int rand_rw(bool write)
+{
+	struct fs_file_t file;
+	ssize_t len;
+	int rc;
+
+	fs_file_t_init(&file);
+
+	bench_start();
+	rc = fs_open(&file, bench_path("bench.dat"), FS_O_RDWR);
+	if (rc) {
+		return rc;
+	}
+
+	for (int i = 0; i < RAND_OPS; i++) {
+		off_t off = (lcg_next() % (FILE_SIZE / RAND_SIZE)) * RAND_SIZE;
+
+		rc = fs_seek(&file, off, FS_SEEK_SET);
+		if (rc) {
+			break;
+		}
+
+		if (write) {
+			memset(record, i, RAND_SIZE);
+			len = fs_write(&file, record, RAND_SIZE);
+		} else {
+			len = fs_read(&file, record, RAND_SIZE);
+		}
+		if (len != RAND_SIZE) {
+			rc = -EIO;
+			break;
+		}
+	}
+
+	if (rc) {
+		(void)fs_close(&file);
+		return rc;
+	}
+
+	rc = fs_close(&file);
+	bench_end(write ? "rand_write" : "rand_read", RAND_OPS * RAND_SIZE,
+		  true);
+
+	return rc;
+}
+
+static const char *small_file_path(int n)
+{
+	snprintf(path, sizeof(path), "%s/d/f%02d.dat", mnt.mnt_point, n);
+
+	return path;
+}
+
+static int small_create(void)
+{
+	struct fs_file_t file;
+	int rc;
+
+	fs_file_t_init(&file);
+
+	bench_start();
+	rc = fs_mkdir(bench_path("d"));
+	if (rc) {
+		return rc;
+	}
+
+	for (int i = 0; i < NUM_FILES; i++) {
+		rc = fs_open(&file, small_file_path(i),
+			     FS_O_CREATE | FS_O_WRITE);
+		if (rc) {
+			return rc;
+		}
+
+		memset(record, i, SMALL_SIZE);
+		if (fs_write(&file, record, SMALL_SIZE) != SMALL_SIZE) {
+			rc = -EIO;
+		}
+
+		rc = fs_close(&file) ? : rc;
+		if (rc) {
+			return rc;
+		}
+	}
+
+	bench_end("create", NUM_FILES, false);
+
+	return 0;
+}
+
+static int small_list(void)
+{
+	struct fs_dirent entry;
+	struct fs_dir_t dir;
+	int entries = 0;
+	int rc;
+
+	fs_dir_t_init(&dir);
+
+	bench_start();
+	for (int i = 0; i < LIST_ROUNDS; i++) {
+		rc = fs_opendir(&dir, bench_path("d"));
+		if (rc) {
+			return rc;
+		}
+
+		while (((rc = fs_readdir(&dir, &entry)) == 0) &&
+		       (entry.name[0] != '\0')) {
+			entries++;
+		}
+
+		rc = fs_closedir(&dir) ? : rc;
+		if (rc) {
+			return rc;
+		}
+	}
+
+	if (entries != LIST_ROUNDS * NUM_FILES) {
+		return -EIO;
+	}
+
+	bench_end("readdir", entries, false);
+
+	return 0;
+}
+
+static int small_delete(void)
+{
+	int rc;
+
+	bench_start();
+	for (int i = 0; i < NUM_FILES; i++) {
+		rc = fs_unlink(small_file_path(i));
+		if (rc) {
+			return rc;
+		}
+	}
+
+	rc = fs_unlink(bench_path("d"));
+	bench_end("delete", NUM_FILES, false);
+
+	return rc;
+}
+
+static int sync_latency(void)
+{
+	struct fs_file_t file;
+	uint32_t total_us = 0;
+	uint32_t max_us = 0;
+	int rc;
+
+	fs_file_t_init(&file);
+
+	rc = fs_open(&file, bench_path("sync.dat"), FS_O_CREATE | FS_O_WRITE);
+	if (rc) {
+		return rc;
+	}
+
+	bench_start();
+	for (int i = 0; i < SYNC_OPS; i++) {
+		uint32_t start = k_cycle_get_32();
+		uint32_t us;
+
+		memset(record, i, SMALL_SIZE);
+		if (fs_write(&file, record, SMALL_SIZE) != SMALL_SIZE) {
+			rc = -EIO;
+			break;
+		}
+
+		rc = fs_sync(&file);
+		if (rc) {
+			break;
+		}
+
+		us = k_cyc_to_us_floor64(k_cycle_get_32() - start);
+		total_us += us;
+		max_us = MAX(max_us, us);
+	}
+
+	if (rc) {
+		(void)fs_close(&file);
+		return rc;
+	}
+
+	bench_report("fsync", bench_us(), total_us / SYNC_OPS, "us/op");
+	printk("%-10s %9u us\n", "fsync_max", max_us);
+
+	return fs_close(&file);
+}
+
+static int wipe(void)
+{
+#if defined(CONFIG_FILE_SYSTEM_LITTLEFS)
+	const struct flash_area *fa;
+	int rc;
+
+	rc = flash_area_open(LFS_AREA_ID, &fa);
+	if (rc) {
+		return rc;
+	}
+
+	rc = flash_area_erase(fa, 0, fa->fa_size);
+	flash_area_close(fa);
+
+	return rc;
+#elif defined(CONFIG_DISK_DRIVER_FLASH)
+	const struct device *dev = device_get_binding(CONFIG_DISK_FLASH_DEV_NAME);
+
+	if (dev == NULL) {
+		return -ENODEV;
+	}
+
+	return flash_erase(dev, CONFIG_DISK_FLASH_START,
+			   CONFIG_DISK_VOLUME_SIZE);
+#else
+	/* The RAM disk starts empty */
+	return 0;
+#endif
+}
+
+static int rand_write(void)
+{
+	return rand_rw(true);
+}
+
+static int rand_read(void)
+{
+	return rand_rw(false);
+}
+
+void main(void)
+{
+	static const struct {
+		const char *name;
+		int (*fn)(void);
+	} steps[] = {
+		{ "seq_write", seq_write },
+		{ "seq_read", seq_read },
+		/* Random transfers on the file written sequentially */
+		{ "rand_write", rand_write },
+		{ "rand_read", rand_read },
+		{ "create", small_create },
+		{ "readdir", small_list },
+		{ "delete", small_delete },
+		{ "fsync", sync_latency },
+	};
+	int rc;
+
+	printk("backend %s\n", BACKEND);
+
+	rc = wipe();
+	if (rc) {
+		printk("wipe failed (err %d)\n", rc);
+		return;
+	}
+
+	rc = fs_mount(&mnt);
+	if (rc) {
+		printk("mount failed (err %d)\n", rc);
+		return;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(steps); i++) {
+		rc = steps[i].fn();
+		if (rc) {
+			printk("%s failed (err %d)\n", steps[i].name, rc);
+			return;
+		}
+	}
+
+	(void)fs_unlink(bench_path("bench.dat"));
+	(void)fs_unlink(bench_path("sync.dat"));
+
+	/* Left mounted for fs.fio when exposed to the host */
+	if (!IS_ENABLED(CONFIG_FUSE_FS_ACCESS)) {
+		(void)fs_unmount(&mnt);
+	}
+
+	printk("fin\n");
+}
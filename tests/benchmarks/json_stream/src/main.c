@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/data/json.h>
+#include <string.h>
+
+#define NUM_ITEMS 450
+#define NUM_RUNS 20
+#define CHUNK_SIZE 1024
+#define PAYLOAD_SIZE (40 * 1024)
+#define STACK_SIZE 4096
+
+struct item {
+	const char *name;
+	int32_t id;
+	int32_t temp;
+	bool online;
+};
+
+struct doc {
+	int32_t count;
+	struct item items[NUM_ITEMS];
+	size_t items_len;
+};
+
+static const struct json_obj_descr item_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct item, name, JSON_TOK_STRING),
+	JSON_OBJ_DESCR_PRIM(struct item, id, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct item, temp, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_PRIM(struct item, online, JSON_TOK_TRUE),
+};
+
+static const struct json_obj_descr doc_descr[] = {
+	JSON_OBJ_DESCR_PRIM(struct doc, count, JSON_TOK_NUMBER),
+	JSON_OBJ_DESCR_OBJ_ARRAY(struct doc, items, NUM_ITEMS, items_len,
+				 item_descr, ARRAY_SIZE(item_descr)),
+};
+
+static char payload[PAYLOAD_SIZE];
+static size_t payload_len;
+
+/* json_obj_parse() writes to the payload, so it parses a copy */
+static char parse_buf[PAYLOAD_SIZE];
+
+/* Decoded strings, for the streaming decoder */
+static char stream_buf[8 * 1024];
+static struct json_obj_stream stream;
+
+static struct doc doc;
+
+K_THREAD_STACK_DEFINE(bench_stack, STACK_SIZE);
+static struct k_thread bench_thread;
+
+static int bench_rc;
+static uint32_t bench_cycles;
+
+static int payload_init(void)
+{
+	int len;
+
+	len = snprintk(payload, sizeof(payload), "{\"count\":%d,\"items\":[",
+		       NUM_ITEMS);
+
+	for (int i = 0; i < NUM_ITEMS; i++) {
+		len += snprintk(payload + len, sizeof(payload) - len,
+				"%s{\"name\":\"sensor-%04d\",\"id\":%d,"
+				"\"temp\":%d,\"online\":%s,\"fw\":\"1.%d.0\"}",
+				i ? "," : "", i, i, i * 7 - 1500,
+				(i % 3) ? "true" : "false", i % 10);
+		if (len >= sizeof(payload) - 2) {
+			return -ENOMEM;
+		}
+	}
+
+	len += snprintk(payload + len, sizeof(payload) - len, "]}");
+	payload_len = len;
+
+	return 0;
+}
+
+static int doc_check(void)
+{
+	if (doc.count != NUM_ITEMS || doc.items_len != NUM_ITEMS ||
+	    strcmp(doc.items[NUM_ITEMS - 1].name, "sensor-0449") != 0 ||
+	    doc.items[NUM_ITEMS - 1].temp != (NUM_ITEMS - 1) * 7 - 1500) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static void bench_parse(void *p1, void *p2, void *p3)
+{
+	uint32_t start;
+	int rc = 0;
+
+	bench_cycles = 0U;
+
+	for (int i = 0; i < NUM_RUNS && rc >= 0; i++) {
+		memcpy(parse_buf, payload, payload_len);
+
+		start = k_cycle_get_32();
+		rc = json_obj_parse(parse_buf, payload_len, doc_descr,
+				    ARRAY_SIZE(doc_descr), &doc);
+		bench_cycles += k_cycle_get_32() - start;
+	}
+
+	bench_rc = rc < 0 ? rc : doc_check();
+}
+
+static void bench_stream(void *p1, void *p2, void *p3)
+{
+	uint32_t start;
+	int rc = 0;
+
+	bench_cycles = 0U;
+
+	for (int i = 0; i < NUM_RUNS && rc >= 0; i++) {
+		start = k_cycle_get_32();
+
+		json_obj_stream_init(&stream, doc_descr, ARRAY_SIZE(doc_descr),
+				     &doc, stream_buf, sizeof(stream_buf));
+
+		for (size_t off = 0; off < payload_len && rc == 0;
+		     off += CHUNK_SIZE) {
+			rc = json_obj_stream_feed(&stream, payload + off,
+						  MIN(CHUNK_SIZE,
+						      payload_len - off));
+		}
+
+		if (rc == 0) {
+			rc = json_obj_stream_finish(&stream);
+		}
+
+		bench_cycles += k_cycle_get_32() - start;
+	}
+
+	bench_rc = rc < 0 ? rc : doc_check();
+}
+
+static size_t strings_size(void)
+{
+	size_t size = 0;
+
+	for (int i = 0; i < doc.items_len; i++) {
+		size += strlen(doc.items[i].name) + 1;
+	}
+
+	return size;
+}
+
+static int bench(const char *name, k_thread_entry_t entry, size_t buffers)
+{
+	size_t unused;
+	uint32_t us;
+	int rc;
+
+	(void)memset(&doc, 0, sizeof(doc));
+
+	k_thread_create(&bench_thread, bench_stack,
+			K_THREAD_STACK_SIZEOF(bench_stack), entry,
+			NULL, NULL, NULL, K_PRIO_PREEMPT(8), 0, K_NO_WAIT);
+	k_thread_join(&bench_thread, K_FOREVER);
+
+	if (bench_rc < 0) {
+		return bench_rc;
+	}
+
+	rc = k_thread_stack_space_get(&bench_thread, &unused);
+	if (rc) {
+		return rc;
+	}
+
+	us = MAX((uint32_t)k_cyc_to_us_floor64(bench_cycles), 1U);
+
+	printk("%-14s %7u KiB/s %7zu bytes\n", name,
+	       (uint32_t)((uint64_t)payload_len * NUM_RUNS * USEC_PER_SEC /
+			  1024U / us),
+	       buffers + K_THREAD_STACK_SIZEOF(bench_stack) - unused);
+
+	return 0;
+}
+
+void main(void)
+{
+	int rc;
+
+	rc = payload_init();
+	if (rc) {
+		printk("Unable to build the payload (err %d)\n", rc);
+		return;
+	}
+
+	printk("%zu bytes, %u items, %u byte chunks\n", payload_len,
+	       NUM_ITEMS, CHUNK_SIZE);
+
+	rc = bench("json_obj_parse", bench_parse, payload_len);
+	if (rc == 0) {
+		/* The decoded strings are only known once parsed */
+		rc = bench("stream", bench_stream,
+			   CHUNK_SIZE + sizeof(stream) + strings_size());
+	}
+	if (rc) {
+		printk("parsing failed (err %d)\n", rc);
+		return;
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/cbprintf.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_backend.h>
+#include <zephyr/logging/log_ctrl.h>
+#include <zephyr/logging/log_output.h>
+#include <string.h>
+
+#if defined(CONFIG_ARCH_POSIX)
+/* Header provided by the host C library. */
+#include <time.h>
+#endif
+
+LOG_MODULE_REGISTER(bench, LOG_LEVEL_INF);
+
+#define NUM_LINES 20000
+#define NUM_LOG_LINES 5000
+#define LOG_BATCH 50
+
+#define LINE_FMT "[%08u] <%s> %s: sensor %d reading %u (0x%08x) %s\n"
+#define LINE_ARGS(i) (i), "inf", "bench", (i) % 16, (i) * 7U, (i), "ok"
+
+/* Stands for the buffer of a log output */
+struct sink {
+	atomic_t offset;
+	size_t bytes;
+	uint8_t buf[128];
+};
+
+static struct sink sink;
+static size_t output_bytes;
+
+static uint64_t time_us(void)
+{
+#if defined(CONFIG_ARCH_POSIX)
+	/* The simulated clock does not advance while the CPU is busy */
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+#else
+	return k_cyc_to_us_floor64(k_cycle_get_64());
+#endif
+}
+
+static void sink_flush(struct sink *s)
+{
+	s->bytes += atomic_set(&s->offset, 0);
+}
+
+/* Same as the character output function of the log output */
+static int char_out(int c, void *ctx)
+{
+	struct sink *s = ctx;
+	int idx;
+
+	if (atomic_get(&s->offset) == sizeof(s->buf)) {
+		sink_flush(s);
+	}
+
+	idx = atomic_inc(&s->offset);
+	s->buf[idx] = (uint8_t)c;
+
+	return 0;
+}
+
+/* Same as the span output function of the log output */
+static int span_out(const void *data, size_t len, void *ctx)
+{
+	struct sink *s = ctx;
+	const uint8_t *p = data;
+	size_t total = len;
+
+	while (len > 0) {
+		size_t chunk;
+		int idx;
+
+		if (atomic_get(&s->offset) == sizeof(s->buf)) {
+			sink_flush(s);
+		}
+
+		chunk = MIN(len, sizeof(s->buf) - atomic_get(&s->offset));
+		idx = atomic_add(&s->offset, chunk);
+		memcpy(&s->buf[idx], p, chunk);
+
+		p += chunk;
+		len -= chunk;
+	}
+
+	return (int)total;
+}
+
+static int format_char(int i, ...)
+{
+	va_list ap;
+	int rc;
+
+	va_start(ap, i);
+	rc = cbvprintf(char_out, &sink, LINE_FMT, ap);
+	va_end(ap);
+
+	return rc;
+}
+
+static int format_span(int i, ...)
+{
+	va_list ap;
+	int rc;
+
+	va_start(ap, i);
+	rc = cbvprintf_span(span_out, &sink, LINE_FMT, ap);
+	va_end(ap);
+
+	return rc;
+}
+
+static int output_func(uint8_t *buf, size_t size, void *ctx)
+{
+	output_bytes += size;
+
+	return size;
+}
+
+static uint8_t output_buf[128];
+LOG_OUTPUT_DEFINE(bench_output, output_func, output_buf, sizeof(output_buf));
+
+static void process(const struct log_backend *const backend,
+		    union log_msg_generic *msg)
+{
+	log_output_msg_process(&bench_output, &msg->log,
+			       LOG_OUTPUT_FLAG_LEVEL | LOG_OUTPUT_FLAG_TIMESTAMP);
+}
+
+static void dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+	printk("%u messages dropped\n", cnt);
+}
+
+static const struct log_backend_api bench_backend_api = {
+	.process = process,
+	.dropped = dropped,
+};
+
+LOG_BACKEND_DEFINE(bench_backend, bench_backend_api, true);
+
+static void report(const char *name, int lines, uint64_t us)
+{
+	us = MAX(us, 1U);
+
+	printk("%-14s %8u lines/s\n", name,
+	       (uint32_t)((uint64_t)lines * USEC_PER_SEC / us));
+}
+
+static int bench_format(const char *name, int (*format)(int i, ...))
+{
+	uint64_t start;
+	int rc = 0;
+
+	start = time_us();
+
+	for (int i = 0; i < NUM_LINES && rc >= 0; i++) {
+		rc = format(i, LINE_ARGS(i));
+	}
+
+	report(name, NUM_LINES, time_us() - start);
+
+	return rc < 0 ? rc : 0;
+}
+
+static void bench_log_output(void)
+{
+	uint64_t us = 0U;
+	uint64_t start;
+
+	for (int i = 0; i < NUM_LOG_LINES; i += LOG_BATCH) {
+		/* Queue a batch, then time how long it takes to drain it */
+		for (int j = i; j < i + LOG_BATCH; j++) {
+			LOG_INF("sensor %d reading %u (0x%08x) %s", j % 16,
+				j * 7U, j, "ok");
+		}
+
+		start = time_us();
+		while (log_process()) {
+		}
+		us += time_us() - start;
+	}
+
+	report("log_output", NUM_LOG_LINES, us);
+}
+
+void main(void)
+{
+	int rc;
+
+	printk("%u lines, %zu byte buffer\n", NUM_LINES, sizeof(sink.buf));
+
+	rc = bench_format("cbvprintf", format_char);
+	if (rc == 0) {
+		rc = bench_format("cbvprintf_span", format_span);
+	}
+	if (rc) {
+		printk("formatting failed (err %d)\n", rc);
+		return;
+	}
+
+	bench_log_output();
+
+	printk("fin\n");
+}
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/mqtt.h>
+#include <string.h>
+
+#define BROKER_PORT 1883
+#define STACK_SIZE 1536
+#define THREAD_PRIORITY K_PRIO_PREEMPT(8)
+
+#define NUM_MSGS 5000
+#define POLL_TIMEOUT 100 /* ms */
+
+static uint8_t rx_buffer[256];
+static uint8_t tx_buffer[1024];
+static uint8_t inflight_buffer[1024];
+static uint8_t broker_buf[256];
+static uint8_t payload[] = "{\"t\":21.5,\"h\":40}";
+
+static struct mqtt_client client_ctx;
+static struct sockaddr_in broker = {
+	.sin_family = AF_INET,
+	.sin_port = htons(BROKER_PORT),
+	.sin_addr = INADDR_LOOPBACK_INIT,
+};
+static int broker_sock = -1;
+static atomic_t broker_publishes;
+static bool connected;
+static int pubacks;
+
+static int broker_recv_all(int sock, uint8_t *buf, size_t len)
+{
+	while (len > 0) {
+		int ret = recv(sock, buf, len, 0);
+
+		if (ret <= 0) {
+			return -ENOTCONN;
+		}
+
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+/* Accept the connection, count the PUBLISH packets and acknowledge the
+ * QoS 1 ones.
+ */
+static void broker_process(void)
+{
+	const uint8_t connack[] = { 0x20, 2U, 0U, 0U };
+	uint8_t puback[] = { 0x40, 2U, 0U, 0U };
+	uint8_t type, byte;
+	uint32_t len, shift;
+	uint16_t topic_len;
+	int sock;
+
+	sock = accept(broker_sock, NULL, NULL);
+	if (sock < 0) {
+		printk("Cannot accept (%d)\n", -errno);
+		return;
+	}
+
+	while (broker_recv_all(sock, &type, 1) == 0) {
+		len = 0U;
+		shift = 0U;
+
+		do {
+			if (broker_recv_all(sock, &byte, 1) < 0) {
+				goto out;
+			}
+
+			len |= (byte & 0x7F) << shift;
+			shift += 7U;
+		} while (byte & 0x80);
+
+		if (len > sizeof(broker_buf) ||
+		    broker_recv_all(sock, broker_buf, len) < 0) {
+			break;
+		}
+
+		if ((type & 0xF0) == 0x10) {
+			(void)send(sock, connack, sizeof(connack), 0);
+		} else if ((type & 0xF0) == 0x30) {
+			atomic_inc(&broker_publishes);
+
+			if ((type & 0x06) == 0x02) {
+				topic_len = sys_get_be16(broker_buf);
+				memcpy(&puback[2],
+				       &broker_buf[sizeof(topic_len) + topic_len],
+				       sizeof(uint16_t));
+				(void)send(sock, puback, sizeof(puback), 0);
+			}
+		}
+	}
+
+out:
+	close(sock);
+}
+
+K_THREAD_DEFINE(broker_thread_id, STACK_SIZE,
+		broker_process, NULL, NULL, NULL,
+		THREAD_PRIORITY, 0, -1);
+
+static void mqtt_evt_handler(struct mqtt_client *const client,
+			     const struct mqtt_evt *evt)
+{
+	if (evt->type == MQTT_EVT_CONNACK) {
+		connected = (evt->result == 0);
+	} else if (evt->type == MQTT_EVT_DISCONNECT) {
+		connected = false;
+	} else if (evt->type == MQTT_EVT_PUBACK) {
+		pubacks++;
+	}
+}
+
+/* Wait for the broker, sending the coalesced messages when they are due */
+static int client_process(void)
+{
+	struct zsock_pollfd fds = {
+		.fd = client_ctx.transport.tcp.sock,
+		.events = ZSOCK_POLLIN,
+	};
+	int timeout = mqtt_keepalive_time_left(&client_ctx);
+	int ret;
+
+	ret = zsock_poll(&fds, 1, MIN(timeout, POLL_TIMEOUT));
+	if (ret < 0) {
+		return -errno;
+	}
+
+	if (ret > 0) {
+		ret = mqtt_input(&client_ctx);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	ret = mqtt_live(&client_ctx);
+
+	return (ret == -EAGAIN) ? 0 : ret;
+}
+
+static int client_connect(void)
+{
+	int ret;
+
+	mqtt_client_init(&client_ctx);
+
+	client_ctx.broker = &broker;
+	client_ctx.evt_cb = mqtt_evt_handler;
+	client_ctx.client_id.utf8 = (uint8_t *)"zephyr_bench";
+	client_ctx.client_id.size = strlen("zephyr_bench");
+	client_ctx.transport.type = MQTT_TRANSPORT_NON_SECURE;
+	client_ctx.rx_buf = rx_buffer;
+	client_ctx.rx_buf_size = sizeof(rx_buffer);
+	client_ctx.tx_buf = tx_buffer;
+	client_ctx.tx_buf_size = sizeof(tx_buffer);
+	client_ctx.inflight_buf = inflight_buffer;
+	client_ctx.inflight_buf_size = sizeof(inflight_buffer);
+
+	ret = mqtt_connect(&client_ctx);
+	while (ret == 0 && !connected) {
+		ret = client_process();
+	}
+
+	return ret;
+}
+
+static int bench(const char *name, enum mqtt_qos qos)
+{
+	struct mqtt_publish_param param = {
+		.message.topic.topic = MQTT_UTF8_LITERAL("sensors/room1"),
+		.message.topic.qos = qos,
+		.message.payload.data = payload,
+		.message.payload.len = sizeof(payload) - 1,
+	};
+	int64_t start;
+	uint32_t ms;
+	int ret;
+
+	atomic_set(&broker_publishes, 0);
+	pubacks = 0;
+
+	start = k_uptime_get();
+
+	for (int i = 0; i < NUM_MSGS; i++) {
+		param.message_id = i + 1;
+
+		ret = mqtt_publish(&client_ctx, &param);
+		while (ret == -EAGAIN) {
+			/* In-flight window full */
+			ret = client_process();
+			if (ret == 0) {
+				ret = mqtt_publish(&client_ctx, &param);
+			}
+		}
+
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	while (atomic_get(&broker_publishes) < NUM_MSGS ||
+	       (qos == MQTT_QOS_1_AT_LEAST_ONCE && pubacks < NUM_MSGS)) {
+		ret = client_process();
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	ms = MAX((uint32_t)(k_uptime_get() - start), 1U);
+
+	printk("%-5s %7u msg/s\n", name,
+	       (uint32_t)((uint64_t)NUM_MSGS * MSEC_PER_SEC / ms));
+
+	return 0;
+}
+
+void main(void)
+{
+	int rc;
+
+	broker_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (broker_sock < 0 ||
+	    bind(broker_sock, (struct sockaddr *)&broker, sizeof(broker)) < 0 ||
+	    listen(broker_sock, 1) < 0) {
+		printk("Unable to start the broker (err %d)\n", -errno);
+		return;
+	}
+
+	k_thread_start(broker_thread_id);
+
+	rc = client_connect();
+	if (rc) {
+		printk("Unable to connect (err %d)\n", rc);
+		return;
+	}
+
+#if defined(CONFIG_MQTT_TX_COALESCE)
+	printk("%u messages, coalescing delay %u ms, window %u\n", NUM_MSGS,
+	       CONFIG_MQTT_TX_COALESCE_DELAY, CONFIG_MQTT_INFLIGHT_MAX_MSGS);
+#else
+	printk("%u messages, coalescing off, window %u\n", NUM_MSGS,
+	       CONFIG_MQTT_INFLIGHT_MAX_MSGS);
+#endif
+
+	rc = bench("qos0", MQTT_QOS_0_AT_MOST_ONCE);
+	if (rc == 0) {
+		rc = bench("qos1", MQTT_QOS_1_AT_LEAST_ONCE);
+	}
+	if (rc) {
+		printk("publish failed (err %d)\n", rc);
+		return;
+	}
+
+	(void)mqtt_disconnect(&client_ctx);
+
+	printk("fin\n");
+}
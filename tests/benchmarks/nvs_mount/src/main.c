@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/stats/stats.h>
+#include <zephyr/fs/nvs.h>
+#include <string.h>
+
+/* A working set of NUM_IDS entries is updated until every sector has been
+ * garbage collected GC_ROUNDS times, then the time taken by nvs_mount() and
+ * by nvs_write() is measured.
+ */
+#define NUM_IDS    32
+#define VALUE_LEN  16
+#define GC_ROUNDS  3
+#define NUM_MOUNTS 10
+#define NUM_WRITES 200
+
+static struct nvs_fs fs;
+static const struct flash_area *fa;
+
+static int read_calls_walk(struct stats_hdr *hdr, void *arg, const char *name,
+			   uint16_t off)
+{
+	if (strcmp(name, "flash_read_calls") == 0) {
+		*(uint32_t *)arg = *(uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static uint32_t read_calls_get(void)
+{
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+	uint32_t calls = 0;
+
+	if (hdr) {
+		stats_walk(hdr, read_calls_walk, &calls);
+	}
+
+	return calls;
+}
+
+static int write_one(uint32_t n)
+{
+	uint8_t value[VALUE_LEN];
+	ssize_t rc;
+
+	memset(value, n, sizeof(value));
+	memcpy(value, &n, sizeof(n));
+
+	rc = nvs_write(&fs, n % NUM_IDS, value, sizeof(value));
+
+	return (rc == sizeof(value)) ? 0 : -EIO;
+}
+
+static int bench(uint16_t sector_count)
+{
+	uint32_t writes, reads, start, cycles, max_cycles, total_cycles;
+	uint32_t n;
+	int rc;
+
+	(void)flash_area_erase(fa, 0, fa->fa_size);
+
+	fs.sector_count = sector_count;
+	rc = nvs_mount(&fs);
+	if (rc) {
+		return rc;
+	}
+
+	writes = GC_ROUNDS * sector_count * fs.sector_size /
+		 (VALUE_LEN + 8);
+	for (n = 0; n < writes; n++) {
+		rc = write_one(n);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	/* Let background gc, if any, complete before mounting */
+	k_msleep(100);
+
+	reads = read_calls_get();
+	start = k_cycle_get_32();
+	for (int i = 0; i < NUM_MOUNTS; i++) {
+		rc = nvs_mount(&fs);
+		if (rc) {
+			return rc;
+		}
+	}
+	cycles = k_cycle_get_32() - start;
+
+	printk("mount sectors %3u reads %6u time %8u us\n", sector_count,
+	       (read_calls_get() - reads) / NUM_MOUNTS,
+	       (uint32_t)(k_cyc_to_us_floor64(cycles) / NUM_MOUNTS));
+
+	max_cycles = 0;
+	total_cycles = 0;
+	for (int i = 0; i < NUM_WRITES; i++, n++) {
+		start = k_cycle_get_32();
+		rc = write_one(n);
+		cycles = k_cycle_get_32() - start;
+		if (rc) {
+			return rc;
+		}
+
+		max_cycles = MAX(max_cycles, cycles);
+		total_cycles += cycles;
+
+		/* Idle time between writes, e.g. waiting for new data */
+		k_msleep(10);
+	}
+
+	printk("write sectors %3u max %8u us avg %8u us\n", sector_count,
+	       (uint32_t)k_cyc_to_us_floor64(max_cycles),
+	       (uint32_t)(k_cyc_to_us_floor64(total_cycles) / NUM_WRITES));
+
+	return 0;
+}
+
+void main(void)
+{
+	struct flash_pages_info info;
+	uint16_t max_sectors;
+	int rc;
+
+	rc = flash_area_open(FLASH_AREA_ID(storage), &fa);
+	if (rc) {
+		printk("flash_area_open failed (err %d)\n", rc);
+		return;
+	}
+
+	fs.flash_device = flash_area_get_device(fa);
+	fs.offset = fa->fa_off;
+	rc = flash_get_page_info_by_offs(fs.flash_device, fs.offset, &info);
+	if (rc) {
+		printk("Unable to get page info (err %d)\n", rc);
+		return;
+	}
+	fs.sector_size = info.size;
+	max_sectors = fa->fa_size / info.size;
+
+	printk("%u ids, sector size %u, summary %s, background gc %s\n",
+	       NUM_IDS, fs.sector_size,
+	       IS_ENABLED(CONFIG_NVS_SECTOR_SUMMARY) ? "on" : "off",
+	       IS_ENABLED(CONFIG_NVS_BACKGROUND_GC) ? "on" : "off");
+
+	for (uint16_t count = 4; count <= max_sectors; count *= 2) {
+		rc = bench(count);
+		if (rc) {
+			printk("%u sectors: failed (err %d)\n", count, rc);
+			return;
+		}
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/stats/stats.h>
+#include <zephyr/settings/settings.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* NUM_ENTRIES settings are stored, then NUM_UPDATES of them are updated,
+ * then the time taken by settings_save_one() of an unchanged value and by
+ * settings_load() is measured.
+ */
+#define NUM_ENTRIES 5000
+#define NUM_UPDATES 1000
+#define NUM_SAVES   10
+#define NUM_LOADS   3
+
+#define SETTINGS_PARTITION \
+	DT_FIXED_PARTITION_ID(DT_CHOSEN(zephyr_settings_partition))
+
+static uint32_t loaded;
+static uint32_t load_errors;
+
+static uint32_t value_of(uint32_t n, bool updated)
+{
+	return updated ? ~n : n;
+}
+
+static int bench_set(const char *key, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	uint32_t n = strtoul(key, NULL, 10);
+	uint32_t value;
+
+	if ((len != sizeof(value)) ||
+	    (read_cb(cb_arg, &value, sizeof(value)) != sizeof(value)) ||
+	    (value != value_of(n, n < NUM_UPDATES))) {
+		load_errors++;
+	}
+	loaded++;
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(bench, "b", NULL, bench_set, NULL, NULL);
+
+static int read_calls_walk(struct stats_hdr *hdr, void *arg, const char *name,
+			   uint16_t off)
+{
+	if (strcmp(name, "flash_read_calls") == 0) {
+		*(uint32_t *)arg = *(uint32_t *)((uint8_t *)hdr + off);
+	}
+
+	return 0;
+}
+
+static uint32_t read_calls_get(void)
+{
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+	uint32_t calls = 0;
+
+	if (hdr) {
+		stats_walk(hdr, read_calls_walk, &calls);
+	}
+
+	return calls;
+}
+
+static int save_one(uint32_t n, bool updated)
+{
+	uint32_t value = value_of(n, updated);
+	char name[16];
+
+	snprintf(name, sizeof(name), "b/%u", n);
+
+	return settings_save_one(name, &value, sizeof(value));
+}
+
+void main(void)
+{
+	const struct flash_area *fa;
+	uint32_t reads, start, cycles;
+	int rc;
+
+	rc = flash_area_open(SETTINGS_PARTITION, &fa);
+	if (rc) {
+		printk("flash_area_open failed (err %d)\n", rc);
+		return;
+	}
+	(void)flash_area_erase(fa, 0, fa->fa_size);
+	flash_area_close(fa);
+
+	rc = settings_subsys_init();
+	if (rc) {
+		printk("settings_subsys_init failed (err %d)\n", rc);
+		return;
+	}
+
+	printk("%u entries, %u updated, index %s\n", NUM_ENTRIES, NUM_UPDATES,
+	       IS_ENABLED(CONFIG_SETTINGS_FCB_INDEX) ? "on" : "off");
+
+	for (uint32_t n = 0; n < NUM_ENTRIES; n++) {
+		rc = save_one(n, false);
+		if (rc) {
+			printk("save %u failed (err %d)\n", n, rc);
+			return;
+		}
+	}
+	for (uint32_t n = 0; n < NUM_UPDATES; n++) {
+		rc = save_one(n, true);
+		if (rc) {
+			printk("update %u failed (err %d)\n", n, rc);
+			return;
+		}
+	}
+
+	reads = read_calls_get();
+	start = k_cycle_get_32();
+	for (uint32_t n = 0; n < NUM_SAVES; n++) {
+		rc = save_one(NUM_ENTRIES - 1 - n, false);
+		if (rc) {
+			printk("save failed (err %d)\n", rc);
+			return;
+		}
+	}
+	cycles = k_cycle_get_32() - start;
+
+	printk("save entries %5u reads %8u time %9u us\n", NUM_ENTRIES,
+	       (read_calls_get() - reads) / NUM_SAVES,
+	       (uint32_t)(k_cyc_to_us_floor64(cycles) / NUM_SAVES));
+
+	reads = read_calls_get();
+	start = k_cycle_get_32();
+	for (int i = 0; i < NUM_LOADS; i++) {
+		loaded = 0U;
+		rc = settings_load();
+		if (rc) {
+			printk("settings_load failed (err %d)\n", rc);
+			return;
+		}
+	}
+	cycles = k_cycle_get_32() - start;
+
+	if ((loaded != NUM_ENTRIES) || (load_errors != 0U)) {
+		printk("loaded %u entries, %u errors\n", loaded, load_errors);
+		return;
+	}
+
+	printk("load entries %5u reads %8u time %9u us\n", NUM_ENTRIES,
+	       (read_calls_get() - reads) / NUM_LOADS,
+	       (uint32_t)(k_cyc_to_us_floor64(cycles) / NUM_LOADS));
+
+	printk("fin\n");
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/settings/settings.h>
+#include <stdio.h>
+
+/* Startup-like workload: every key loaded at boot is dispatched to its
+ * handler through settings_parse_and_lookup().
+ */
+#define MAX_HANDLERS 128
+#define NUM_KEYS     2000
+#define NAME_LEN     24
+
+static const int handler_counts[] = { 4, 16, 64, MAX_HANDLERS };
+
+static struct settings_handler handlers[MAX_HANDLERS];
+static char handler_names[MAX_HANDLERS][NAME_LEN];
+static char keys[NUM_KEYS][2 * NAME_LEN];
+static int registered;
+
+static int bench_set(const char *key, size_t len, settings_read_cb read_cb,
+		     void *cb_arg)
+{
+	return 0;
+}
+
+static void register_handlers(int count)
+{
+	for (; registered < count; registered++) {
+		snprintf(handler_names[registered], NAME_LEN, "bench/m%d",
+			 registered);
+		handlers[registered].name = handler_names[registered];
+		handlers[registered].h_set = bench_set;
+		if (settings_register(&handlers[registered])) {
+			printk("failed to register handler %d\n", registered);
+		}
+	}
+}
+
+static void bench_lookup(int count)
+{
+	const char *next;
+	uint32_t start, cycles;
+	uint64_t ns;
+	int misses = 0;
+
+	for (int i = 0; i < NUM_KEYS; i++) {
+		snprintf(keys[i], sizeof(keys[i]), "bench/m%d/k%d", i % count,
+			 i);
+	}
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < NUM_KEYS; i++) {
+		if (settings_parse_and_lookup(keys[i], &next) == NULL) {
+			misses++;
+		}
+	}
+	cycles = k_cycle_get_32() - start;
+
+	ns = k_cyc_to_ns_floor64(cycles);
+	printk("handlers %3d keys %5d total %8u us (%u ns/key)\n", count,
+	       NUM_KEYS, (uint32_t)(ns / NSEC_PER_USEC),
+	       (uint32_t)(ns / NUM_KEYS));
+
+	if (misses) {
+		printk("%d keys without handler\n", misses);
+	}
+}
+
+void main(void)
+{
+	settings_subsys_init();
+
+	printk("settings handler index: %s\n",
+	       IS_ENABLED(CONFIG_SETTINGS_HANDLER_INDEX) ? "on" : "off");
+
+	for (int i = 0; i < ARRAY_SIZE(handler_counts); i++) {
+		register_handlers(handler_counts[i]);
+		bench_lookup(handler_counts[i]);
+	}
+
+	printk("fin\n");
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/stats/stats.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Saves a configuration of NUM_FIELDS values, either one by one with
+ * settings_save_one() or in a single settings transaction, and reports the
+ * flash operations counted by the flash simulator.
+ */
+#define NUM_FIELDS 40
+#define NUM_ROUNDS 10
+
+struct flash_counters {
+	uint32_t writes;
+	uint32_t bytes;
+	uint32_t erases;
+};
+
+static int counter_walk(struct stats_hdr *hdr, void *arg, const char *name,
+			uint16_t off)
+{
+	struct flash_counters *cnt = arg;
+	uint32_t val = *(uint32_t *)((uint8_t *)hdr + off);
+
+	if (strcmp(name, "flash_write_calls") == 0) {
+		cnt->writes = val;
+	} else if (strcmp(name, "bytes_written") == 0) {
+		cnt->bytes = val;
+	} else if (strcmp(name, "flash_erase_calls") == 0) {
+		cnt->erases = val;
+	}
+
+	return 0;
+}
+
+static void counters_get(struct flash_counters *cnt)
+{
+	struct stats_hdr *hdr = stats_group_find("flash_sim_stats");
+
+	memset(cnt, 0, sizeof(*cnt));
+	if (hdr) {
+		stats_walk(hdr, counter_walk, cnt);
+	}
+}
+
+static void report(const char *label, const struct flash_counters *before,
+		   uint32_t cycles)
+{
+	struct flash_counters after;
+
+	counters_get(&after);
+	printk("%-8s writes %6u bytes %8u erases %4u time %8u us\n", label,
+	       (after.writes - before->writes) / NUM_ROUNDS,
+	       (after.bytes - before->bytes) / NUM_ROUNDS,
+	       (after.erases - before->erases) / NUM_ROUNDS,
+	       (uint32_t)(k_cyc_to_us_floor64(cycles) / NUM_ROUNDS));
+}
+
+static void field_name(char *name, size_t len, int field)
+{
+	snprintf(name, len, "cfg/field%d", field);
+}
+
+static void bench_save_one(void)
+{
+	struct flash_counters before;
+	char name[SETTINGS_MAX_NAME_LEN];
+	uint32_t start;
+
+	counters_get(&before);
+	start = k_cycle_get_32();
+
+	for (uint32_t round = 0; round < NUM_ROUNDS; round++) {
+		for (int i = 0; i < NUM_FIELDS; i++) {
+			uint32_t val = round * NUM_FIELDS + i;
+
+			field_name(name, sizeof(name), i);
+			(void)settings_save_one(name, &val, sizeof(val));
+		}
+	}
+
+	report("save_one", &before, k_cycle_get_32() - start);
+}
+
+static void bench_txn(void)
+{
+	struct flash_counters before;
+	char name[SETTINGS_MAX_NAME_LEN];
+	uint32_t start;
+	int rc;
+
+	counters_get(&before);
+	start = k_cycle_get_32();
+
+	for (uint32_t round = 0; round < NUM_ROUNDS; round++) {
+		rc = settings_txn_begin();
+		for (int i = 0; (rc == 0) && (i < NUM_FIELDS); i++) {
+			/* Values differ from the previous benchmark */
+			uint32_t val = (NUM_ROUNDS + round) * NUM_FIELDS + i;
+
+			field_name(name, sizeof(name), i);
+			rc = settings_txn_set(name, &val, sizeof(val));
+		}
+
+		if (rc == 0) {
+			rc = settings_txn_commit();
+		} else {
+			settings_txn_abort();
+		}
+
+		if (rc) {
+			printk("transaction failed (err %d)\n", rc);
+			return;
+		}
+	}
+
+	report("txn", &before, k_cycle_get_32() - start);
+}
+
+void main(void)
+{
+	const struct flash_area *fa;
+
+	if (flash_area_open(FLASH_AREA_ID(storage), &fa) == 0) {
+		(void)flash_area_erase(fa, 0, fa->fa_size);
+		flash_area_close(fa);
+	}
+
+	if (settings_subsys_init()) {
+		printk("settings init failed\n");
+		return;
+	}
+
+	printk("%d fields\n", NUM_FIELDS);
+
+	bench_save_one();
+	bench_txn();
+
+	printk("fin\n");
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/storage/stream_flash.h>
+#include <string.h>
+
+/* An image of IMAGE_SIZE bytes is received in CHUNK_SIZE chunks, each of
+ * which takes RX_TIME_US to arrive, and is written with stream flash.
+ */
+#define IMAGE_SIZE (64 * 1024)
+#define CHUNK_SIZE 256
+#define RX_TIME_US 500
+#define BUF_SIZE   512
+
+static struct stream_flash_ctx ctx;
+static uint8_t buf[BUF_SIZE];
+static uint8_t chunk[CHUNK_SIZE];
+
+void main(void)
+{
+	const struct flash_area *fa;
+	uint32_t start, cycles, rx_cycles;
+	int rc;
+
+	rc = flash_area_open(FLASH_AREA_ID(image_scratch), &fa);
+	if (rc) {
+		printk("flash_area_open failed (err %d)\n", rc);
+		return;
+	}
+
+	rc = stream_flash_init(&ctx, flash_area_get_device(fa), buf,
+			       sizeof(buf), fa->fa_off, fa->fa_size, NULL);
+	if (rc) {
+		printk("stream_flash_init failed (err %d)\n", rc);
+		return;
+	}
+
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+	rc = stream_flash_async_enable(&ctx);
+	if (rc) {
+		printk("stream_flash_async_enable failed (err %d)\n", rc);
+		return;
+	}
+#endif
+
+	printk("async %s\n", IS_ENABLED(CONFIG_STREAM_FLASH_ASYNC) ?
+	       "on" : "off");
+
+	rx_cycles = 0;
+	start = k_cycle_get_32();
+	for (uint32_t off = 0; off < IMAGE_SIZE; off += CHUNK_SIZE) {
+		uint32_t rx_start = k_cycle_get_32();
+
+		/* Wait for the transport */
+		k_usleep(RX_TIME_US);
+		memset(chunk, off / CHUNK_SIZE, sizeof(chunk));
+		rx_cycles += k_cycle_get_32() - rx_start;
+
+		rc = stream_flash_buffered_write(&ctx, chunk, sizeof(chunk),
+						 off + CHUNK_SIZE >= IMAGE_SIZE);
+		if (rc) {
+			printk("write at %u failed (err %d)\n", off, rc);
+			return;
+		}
+	}
+	cycles = k_cycle_get_32() - start;
+
+	if (stream_flash_bytes_written(&ctx) != IMAGE_SIZE) {
+		printk("%zu bytes written\n", stream_flash_bytes_written(&ctx));
+		return;
+	}
+
+	printk("image %6u bytes chunk %4u time %8u us transport %8u us\n",
+	       IMAGE_SIZE, CHUNK_SIZE, (uint32_t)k_cyc_to_us_floor64(cycles),
+	       (uint32_t)k_cyc_to_us_floor64(rx_cycles));
+
+	printk("fin\n");
+}
@@ -0,0 +1,266 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/base64.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/websocket.h>
+#include <mbedtls/sha1.h>
+#include <string.h>
+
+#define SERVER_PORT 8080
+#define STACK_SIZE 2048
+#define THREAD_PRIORITY K_PRIO_PREEMPT(8)
+
+/* Amount of payload sent for each message size */
+#define TOTAL_LEN (256 * 1024)
+#define MAX_MSG_LEN 4096
+
+#define WS_MAGIC "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+#define WS_KEY_FIELD "Sec-WebSocket-Key: "
+
+static const size_t msg_lens[] = { 64, 1024, MAX_MSG_LEN };
+
+static uint8_t payload[MAX_MSG_LEN];
+static uint8_t client_buf[512];
+static uint8_t server_buf[1024];
+
+static int server_sock = -1;
+static size_t server_expected;
+static K_SEM_DEFINE(server_done, 0, 1);
+
+/* Reply to the upgrade request in server_buf */
+static int server_handshake(int sock, size_t len)
+{
+	char key_accept[64];
+	uint8_t sha1[20];
+	char accept[32];
+	char reply[160];
+	char *key, *end;
+	size_t olen;
+	int ret;
+
+	server_buf[len] = '\0';
+
+	key = strstr((char *)server_buf, WS_KEY_FIELD);
+	if (!key) {
+		return -EINVAL;
+	}
+
+	key += sizeof(WS_KEY_FIELD) - 1;
+	end = strstr(key, "\r\n");
+	if (!end || end - key + sizeof(WS_MAGIC) > sizeof(key_accept)) {
+		return -EINVAL;
+	}
+
+	memcpy(key_accept, key, end - key);
+	memcpy(key_accept + (end - key), WS_MAGIC, sizeof(WS_MAGIC));
+
+	mbedtls_sha1((const unsigned char *)key_accept, strlen(key_accept),
+		     sha1);
+
+	ret = base64_encode(accept, sizeof(accept), &olen, sha1, sizeof(sha1));
+	if (ret) {
+		return ret;
+	}
+
+	snprintk(reply, sizeof(reply),
+		 "HTTP/1.1 101 Switching Protocols\r\n"
+		 "Upgrade: websocket\r\n"
+		 "Connection: Upgrade\r\n"
+		 "Sec-WebSocket-Accept: %s\r\n\r\n", accept);
+
+	ret = send(sock, reply, strlen(reply), 0);
+
+	return ret < 0 ? -errno : 0;
+}
+
+static void server_process(void)
+{
+	size_t received = 0;
+	size_t len = 0;
+	int sock;
+	int ret;
+
+	sock = accept(server_sock, NULL, NULL);
+	if (sock < 0) {
+		printk("Cannot accept (%d)\n", -errno);
+		return;
+	}
+
+	/* Read the upgrade request */
+	do {
+		ret = recv(sock, &server_buf[len], sizeof(server_buf) - len - 1,
+			   0);
+		if (ret <= 0) {
+			goto out;
+		}
+
+		len += ret;
+		server_buf[len] = '\0';
+	} while (!strstr((char *)server_buf, "\r\n\r\n"));
+
+	ret = server_handshake(sock, len);
+	if (ret) {
+		printk("Handshake failed (%d)\n", ret);
+		goto out;
+	}
+
+	/* Then drop the frames, telling the client when all have arrived */
+	while (true) {
+		ret = recv(sock, server_buf, sizeof(server_buf), 0);
+		if (ret <= 0) {
+			break;
+		}
+
+		received += ret;
+		if (server_expected > 0 && received >= server_expected) {
+			received -= server_expected;
+			server_expected = 0;
+			k_sem_give(&server_done);
+		}
+	}
+
+out:
+	close(sock);
+}
+
+K_THREAD_DEFINE(server_thread_id, STACK_SIZE,
+		server_process, NULL, NULL, NULL,
+		THREAD_PRIORITY, 0, -1);
+
+static int server_init(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+
+	server_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (server_sock < 0) {
+		return -errno;
+	}
+
+	if (bind(server_sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+	    listen(server_sock, 1) < 0) {
+		return -errno;
+	}
+
+	k_thread_start(server_thread_id);
+
+	return 0;
+}
+
+static int client_connect(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	struct websocket_request req = {
+		.host = "127.0.0.1",
+		.url = "/",
+		.tmp_buf = client_buf,
+		.tmp_buf_len = sizeof(client_buf),
+	};
+	int sock;
+
+	sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if (sock < 0) {
+		return -errno;
+	}
+
+	if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+		return -errno;
+	}
+
+	return websocket_connect(sock, &req, 3 * MSEC_PER_SEC, NULL);
+}
+
+static size_t frame_len(size_t msg_len)
+{
+	/* Header with the masking key */
+	if (msg_len < 126) {
+		return 6 + msg_len;
+	} else if (msg_len < 65536) {
+		return 8 + msg_len;
+	}
+
+	return 14 + msg_len;
+}
+
+static int bench(int ws_sock, size_t msg_len)
+{
+	int num_msgs = TOTAL_LEN / msg_len;
+	int64_t start;
+	uint32_t ms;
+	int ret;
+
+	server_expected = num_msgs * frame_len(msg_len);
+
+	start = k_uptime_get();
+
+	for (int i = 0; i < num_msgs; i++) {
+		ret = websocket_send_msg(ws_sock, payload, msg_len,
+					 WEBSOCKET_OPCODE_DATA_BINARY,
+					 true, true, SYS_FOREVER_MS);
+		if (ret != msg_len) {
+			return ret < 0 ? ret : -EIO;
+		}
+	}
+
+	ret = k_sem_take(&server_done, K_SECONDS(30));
+	if (ret) {
+		return ret;
+	}
+
+	ms = MAX((uint32_t)(k_uptime_get() - start), 1U);
+
+	printk("%4zu bytes %9u KiB/s\n", msg_len,
+	       (uint32_t)((uint64_t)num_msgs * msg_len * MSEC_PER_SEC /
+			  1024U / ms));
+
+	return 0;
+}
+
+void main(void)
+{
+	int ws_sock;
+	int rc;
+
+	for (int i = 0; i < sizeof(payload); i++) {
+		payload[i] = i;
+	}
+
+	rc = server_init();
+	if (rc) {
+		printk("Unable to start the server (err %d)\n", rc);
+		return;
+	}
+
+	ws_sock = client_connect();
+	if (ws_sock < 0) {
+		printk("Unable to connect (err %d)\n", ws_sock);
+		return;
+	}
+
+	printk("mask buffer %u bytes\n", CONFIG_WEBSOCKET_MASK_BUF_SIZE);
+
+	for (int i = 0; i < ARRAY_SIZE(msg_lens); i++) {
+		rc = bench(ws_sock, msg_lens[i]);
+		if (rc) {
+			printk("send failed (err %d)\n", rc);
+			return;
+		}
+	}
+
+	websocket_disconnect(ws_sock);
+
+	printk("fin\n");
+}
@@ -662,6 +662,270 @@ static void test_json_encode_bounds_check(void)
 	zassert_equal(ret, -ENOMEM, "Bounds check failed");
 }
 
+static char stream_buf[128];
+
+static int stream_parse_chunks(const char *payload, size_t len, size_t chunk,
+			       const struct json_obj_descr *descr,
+			       size_t descr_len, void *val)
+{
+	struct json_obj_stream obj;
+	size_t off;
+	int ret = 0;
+
+	json_obj_stream_init(&obj, descr, descr_len, val, stream_buf,
+			     sizeof(stream_buf));
+
+	for (off = 0; off < len && ret == 0; off += chunk) {
+		ret = json_obj_stream_feed(&obj, payload + off,
+					   MIN(chunk, len - off));
+	}
+
+	if (ret < 0) {
+		return ret;
+	}
+
+	return json_obj_stream_finish(&obj);
+}
+
+static void test_json_stream_decoding(void)
+{
+	const char encoded[] = "{\"some_string\":\"zephyr 123\\uABCD456\","
+		"\"some_int\":\t42\n,"
+		"\"not_in_descr\":{\"a\":[1,{\"b\":null}],\"c\":\"}]\"},"
+		"\"some_bool\":true    \t  \n\r   ,"
+		"\"some_nested_struct\":{    "
+		"\"nested_int\":-1234,\n\n"
+		"\"nested_bool\":false,\t"
+		"\"nested_string\":\"this should be escaped: \\t\"},"
+		"\"some_array\":[11,22, 33,\t45,\n299],"
+		"\"another_b!@l\":true,"
+		"\"if\":false,"
+		"\"another-array\":[2,3,5,7],"
+		"\"4nother_ne$+\":{\"nested_int\":1234,"
+		"\"nested_bool\":true,"
+		"\"nested_string\":\"no escape necessary\"}"
+		"}\n";
+	const int expected_array[] = { 11, 22, 33, 45, 299 };
+	struct test_struct ts;
+	int ret;
+
+	/* Every split of the tokens between chunks */
+	for (size_t chunk = 1; chunk < sizeof(encoded); chunk++) {
+		(void)memset(&ts, 0, sizeof(ts));
+
+		ret = stream_parse_chunks(encoded, sizeof(encoded) - 1, chunk,
+					  test_descr, ARRAY_SIZE(test_descr),
+					  &ts);
+		zassert_equal(ret, (1 << ARRAY_SIZE(test_descr)) - 1,
+			      "Not all fields decoded with %zu byte chunks",
+			      chunk);
+
+		zassert_true(!strcmp(ts.some_string, "zephyr 123\\uABCD456"),
+			     "String not decoded correctly");
+		zassert_equal(ts.some_int, 42,
+			      "Integer not decoded correctly");
+		zassert_true(ts.some_bool, "Boolean not decoded correctly");
+		zassert_equal(ts.some_nested_struct.nested_int, -1234,
+			      "Nested integer not decoded correctly");
+		zassert_true(!strcmp(ts.some_nested_struct.nested_string,
+				     "this should be escaped: \\t"),
+			     "Nested string not decoded correctly");
+		zassert_equal(ts.some_array_len, 5,
+			      "Array doesn't have correct number of items");
+		zassert_true(!memcmp(ts.some_array, expected_array,
+				     sizeof(expected_array)),
+			     "Array not decoded with expected values");
+		zassert_true(ts.another_bxxl,
+			     "Named boolean not decoded correctly");
+		zassert_equal(ts.another_array_len, 4,
+			      "Named array not decoded correctly");
+		zassert_true(!strcmp(ts.xnother_nexx.nested_string,
+				     "no escape necessary"),
+			     "Named nested string not decoded correctly");
+	}
+}
+
+static void test_json_stream_decoding_array_array(void)
+{
+	const char encoded[] = "{\"objects_array\":["
+			       "[{\"height\":168,\"name\":\"Simón Bolívar\"}],"
+			       "[{\"height\":173,\"name\":\"Pelé\"}],"
+			       "[{\"height\":195,\"name\":\"Usain Bolt\"}]]"
+			       "}";
+	struct obj_array_array oaa;
+	int ret;
+
+	ret = stream_parse_chunks(encoded, sizeof(encoded) - 1, 5,
+				  array_array_descr,
+				  ARRAY_SIZE(array_array_descr), &oaa);
+	zassert_equal(ret, 1, "Decoding array of arrays failed");
+	zassert_equal(oaa.objects_array_len, 3,
+		      "Array doesn't have correct number of items");
+	zassert_true(!strcmp(oaa.objects_array[1].objects.name, "Pelé"),
+		     "String not decoded correctly");
+	zassert_equal(oaa.objects_array[2].objects.height, 195,
+		      "Integer not decoded correctly");
+}
+
+struct stream_events {
+	char text[128];
+	size_t len;
+};
+
+/* Record the events as "<depth><type>[key=][value]" lines. */
+static int stream_record(const struct json_stream_event *evt, void *user_data)
+{
+	struct stream_events *events = user_data;
+	int ret;
+
+	ret = snprintk(events->text + events->len,
+		       sizeof(events->text) - events->len, "%u%c%.*s%s%.*s ",
+		       evt->depth, evt->type, (int)evt->key_len,
+		       evt->key ? evt->key : "", evt->key ? "=" : "",
+		       (int)evt->value_len, evt->value ? evt->value : "");
+	events->len += ret;
+
+	return 0;
+}
+
+static void test_json_stream_events(void)
+{
+	const char encoded[] = "{\"a\":[1,-2.5e3,\"x\\\"y\"],\"b\":{\"c\":null},"
+			       "\"d\":true}";
+	const char expected[] = "0{ 1[a= 201 20-2.5e3 2\"x\\\"y 1] "
+				"1{b= 2nc= 1} 1td= 0} ";
+	struct stream_events events;
+	struct json_stream stream;
+	int ret = 0;
+
+	for (size_t chunk = 1; chunk < sizeof(encoded); chunk++) {
+		(void)memset(&events, 0, sizeof(events));
+		json_stream_init(&stream, stream_buf, sizeof(stream_buf),
+				 stream_record, &events);
+
+		for (size_t off = 0; off < sizeof(encoded) - 1; off += chunk) {
+			ret = json_stream_feed(&stream, encoded + off,
+					       MIN(chunk,
+						   sizeof(encoded) - 1 - off));
+			zassert_equal(ret, 0, "Parsing failed");
+		}
+
+		ret = json_stream_finish(&stream);
+		zassert_equal(ret, 0, "Parsing not complete");
+		zassert_true(!strcmp(events.text, expected),
+			     "Wrong events with %zu byte chunks: %s", chunk,
+			     events.text);
+	}
+}
+
+static void test_json_stream_invalid(void)
+{
+	struct encoding_test encoded[] = {
+		{ "{\"some_string\":\"\\uAB@@\"}", -EINVAL },
+		{ "{\"some_string\":\"\\X\"}", -EINVAL },
+		{ "{\"some_bool\":truffle }", -EINVAL },
+		{ "{\"some_string\":null }", -EINVAL },
+		{ "{\"some_string\":false}", -EINVAL },
+		{ "{\"some_int\":-}", -EINVAL },
+		{ "{\"some_int\":1,}", -EINVAL },
+		{ "{\"some_int\" 1}", -EINVAL },
+		{ "{\"some_string\",}", -EINVAL },
+		{ "{\"some_string", -EINVAL },
+		{ "{\"some_array\":[1]]", -EINVAL },
+		{ "{\"some_int\":1}{", -EINVAL },
+		{ "[1]", -EINVAL },
+		{ "{\"some_array\":[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17]}",
+		  -ENOSPC },
+		{ "{\"a\":[[[[[[[[[]]]]]]]]]}", -ENOSPC },
+		{ "{\"some_int\":2147483648}", -ERANGE },
+		{ "{\"key_not_in_descr\":123456}", 0 },
+	};
+	/* Rejected by the tokenizer, with or without a split */
+	struct encoding_test numbers[] = {
+		{ "[1.2.3]", -EINVAL },
+		{ "[01]", -EINVAL },
+		{ "[-01]", -EINVAL },
+		{ "[1e]", -EINVAL },
+		{ "[1e+-5]", -EINVAL },
+		{ "[1.]", -EINVAL },
+		{ "[1.e5]", -EINVAL },
+		{ "[-]", -EINVAL },
+		{ "[-.5]", -EINVAL },
+		{ "[1e5e]", -EINVAL },
+		{ "1e", -EINVAL },
+		{ "[0,-0,0.5,-10.25e+3,1E-2,2e08]", 0 },
+		{ "-0.5e3", 0 },
+	};
+	struct stream_events events;
+	struct json_stream stream;
+	struct test_struct ts;
+	int ret;
+
+	for (int i = 0; i < ARRAY_SIZE(encoded); i++) {
+		ret = stream_parse_chunks(encoded[i].str,
+					  strlen(encoded[i].str), 3,
+					  test_descr, ARRAY_SIZE(test_descr),
+					  &ts);
+		zassert_equal(ret, encoded[i].result,
+			      "Decoding '%s' result %d, expected %d",
+			      encoded[i].str, ret, encoded[i].result);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(numbers); i++) {
+		size_t len = strlen(numbers[i].str);
+
+		for (size_t chunk = 1; chunk <= len; chunk++) {
+			(void)memset(&events, 0, sizeof(events));
+			json_stream_init(&stream, stream_buf,
+					 sizeof(stream_buf), stream_record,
+					 &events);
+
+			ret = 0;
+			for (size_t off = 0; off < len && ret == 0;
+			     off += chunk) {
+				ret = json_stream_feed(&stream,
+						       numbers[i].str + off,
+						       MIN(chunk, len - off));
+			}
+
+			if (ret == 0) {
+				ret = json_stream_finish(&stream);
+			}
+
+			zassert_equal(ret, numbers[i].result,
+				      "Parsing '%s' in %zu byte chunks result "
+				      "%d, expected %d", numbers[i].str, chunk,
+				      ret, numbers[i].result);
+		}
+	}
+}
+
+static void test_json_stream_buf_too_small(void)
+{
+	const char encoded[] = "{\"some_string\":\"this does not fit\"}";
+	struct json_obj_stream obj;
+	struct test_struct ts;
+	char buf[16];
+	int ret;
+
+	/* Strings fully inside a chunk are only copied once decoded */
+	json_obj_stream_init(&obj, test_descr, ARRAY_SIZE(test_descr), &ts,
+			     buf, sizeof(buf));
+	ret = json_obj_stream_feed(&obj, encoded, sizeof(encoded) - 1);
+	zassert_equal(ret, -ENOMEM, "Bounds check failed");
+
+	/* And split ones while they are received */
+	json_obj_stream_init(&obj, test_descr, ARRAY_SIZE(test_descr), &ts,
+			     buf, sizeof(buf));
+	ret = json_obj_stream_feed(&obj, encoded, 20);
+	zassert_equal(ret, 0, "Parsing failed");
+	ret = json_obj_stream_feed(&obj, encoded + 20,
+				   sizeof(encoded) - 1 - 20);
+	zassert_equal(ret, -ENOMEM, "Bounds check failed");
+	ret = json_obj_stream_finish(&obj);
+	zassert_equal(ret, -ENOMEM, "Error not kept");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(lib_json_test,
@@ -686,7 +950,12 @@ void test_main(void)
 			 ztest_unit_test(test_json_encode_bounds_check),
 			 ztest_unit_test(test_json_limits),
 			 ztest_unit_test(test_json_arr_obj_encoding),
-			 ztest_unit_test(test_json_arr_obj_decoding)
+			 ztest_unit_test(test_json_arr_obj_decoding),
+			 ztest_unit_test(test_json_stream_decoding),
+			 ztest_unit_test(test_json_stream_decoding_array_array),
+			 ztest_unit_test(test_json_stream_events),
+			 ztest_unit_test(test_json_stream_invalid),
+			 ztest_unit_test(test_json_stream_buf_too_small)
 			 );
 
 	ztest_run_test_suite(lib_json_test);
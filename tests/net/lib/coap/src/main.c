@@ -963,6 +963,368 @@ static void test_observer_client(void)
 	zassert_not_null(reply, "Couldn't find a matching waiting reply");
 }
 
+#if defined(CONFIG_COAP_RESOURCE_INDEX)
+static int index_get_1(struct coap_resource *resource,
+		       struct coap_packet *request,
+		       struct sockaddr *addr, socklen_t addr_len)
+{
+	return 1;
+}
+
+static int index_get_2(struct coap_resource *resource,
+		       struct coap_packet *request,
+		       struct sockaddr *addr, socklen_t addr_len)
+{
+	return 2;
+}
+
+static int index_get_3(struct coap_resource *resource,
+		       struct coap_packet *request,
+		       struct sockaddr *addr, socklen_t addr_len)
+{
+	return 3;
+}
+
+static int index_get_4(struct coap_resource *resource,
+		       struct coap_packet *request,
+		       struct sockaddr *addr, socklen_t addr_len)
+{
+	return 4;
+}
+
+static const char * const index_path_ab[] = { "a", "b", NULL };
+static const char * const index_path_a_single[] = { "a", "+", NULL };
+static const char * const index_path_a_multi[] = { "a", "#", NULL };
+static const char * const index_path_c[] = { "c", NULL };
+static struct coap_resource index_resources[] = {
+	{ .path = index_path_ab, .get = index_get_1 },
+	{ .path = index_path_a_single, .get = index_get_2 },
+	{ .path = index_path_a_multi, .get = index_get_3 },
+	{ .path = index_path_c, .get = index_get_4 },
+	/* Same path as the first resource, never used */
+	{ .path = index_path_ab, .get = index_get_4 },
+	{ },
+};
+
+COAP_RESOURCE_INDEX_DEFINE(test_index, 8);
+
+static int index_request(const char * const *path, bool use_index)
+{
+	struct coap_packet req;
+	struct coap_option options[4] = {};
+	uint8_t *data = data_buf[0];
+	int r;
+
+	r = coap_packet_init(&req, data, COAP_BUF_SIZE, COAP_VERSION_1,
+			     COAP_TYPE_CON, 0, NULL, COAP_METHOD_GET,
+			     coap_next_id());
+	zassert_equal(r, 0, "Unable to initialize request");
+
+	for (; *path; path++) {
+		r = coap_packet_append_option(&req, COAP_OPTION_URI_PATH,
+					      *path, strlen(*path));
+		zassert_equal(r, 0, "Unable to append option");
+	}
+
+	r = coap_packet_parse(&req, data, req.offset, options,
+			      ARRAY_SIZE(options));
+	zassert_equal(r, 0, "Could not parse packet");
+
+	if (use_index) {
+		return coap_handle_request_index(&req, &test_index, options,
+						 ARRAY_SIZE(options),
+						 (struct sockaddr *)&dummy_addr,
+						 sizeof(dummy_addr));
+	}
+
+	return coap_handle_request(&req, index_resources, options,
+				   ARRAY_SIZE(options),
+				   (struct sockaddr *)&dummy_addr,
+				   sizeof(dummy_addr));
+}
+
+static void test_resource_index(void)
+{
+	static const char * const uri_ab[] = { "a", "b", NULL };
+	static const char * const uri_ax[] = { "a", "x", NULL };
+	static const char * const uri_axy[] = { "a", "x", "y", NULL };
+	static const char * const uri_a[] = { "a", NULL };
+	static const char * const uri_c[] = { "c", NULL };
+	static const char * const uri_cx[] = { "c", "x", NULL };
+	static const char * const uri_d[] = { "d", NULL };
+	static const struct {
+		const char * const *uri;
+		int result;
+	} requests[] = {
+		{ uri_ab, 1 },
+		{ uri_ax, 2 },
+		{ uri_axy, 3 },
+		{ uri_a, -ENOENT },
+		{ uri_c, 4 },
+		{ uri_cx, -ENOENT },
+		{ uri_d, -ENOENT },
+	};
+	int r;
+
+	r = coap_resource_index_init(&test_index, index_resources);
+	zassert_equal(r, 0, "Unable to build index");
+
+	for (size_t i = 0; i < ARRAY_SIZE(requests); i++) {
+		zassert_equal(index_request(requests[i].uri, false),
+			      requests[i].result, "Wrong resource %zu", i);
+		zassert_equal(index_request(requests[i].uri, true),
+			      requests[i].result, "Wrong indexed resource %zu", i);
+	}
+}
+#else
+static void test_resource_index(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_COAP_RESOURCE_INDEX */
+
+#if defined(CONFIG_COAP_OPTION_INDEX)
+/* Option numbers beyond the presence bitmap of the option index */
+#define TEST_OPTION_ECHO 252
+#define TEST_OPTION_NO_RESPONSE 258
+
+static int option_index_packet(struct coap_packet *cpkt, int num_codes)
+{
+	static const uint16_t codes[] = {
+		COAP_OPTION_OBSERVE, COAP_OPTION_URI_PATH,
+		COAP_OPTION_CONTENT_FORMAT, COAP_OPTION_URI_QUERY,
+		COAP_OPTION_ACCEPT, COAP_OPTION_BLOCK2, COAP_OPTION_SIZE2,
+		COAP_OPTION_SIZE1, TEST_OPTION_NO_RESPONSE,
+	};
+	uint8_t *data = data_buf[0];
+	struct coap_packet req;
+	int r;
+
+	zassert_true(num_codes <= ARRAY_SIZE(codes), "Too many options");
+
+	r = coap_packet_init(&req, data, COAP_BUF_SIZE, COAP_VERSION_1,
+			     COAP_TYPE_CON, 0, NULL, COAP_METHOD_GET,
+			     coap_next_id());
+	zassert_equal(r, 0, "Unable to initialize request");
+
+	for (int i = 0; i < num_codes; i++) {
+		/* Repeat some options, as for path segments */
+		for (int j = 0; j <= i % 3; j++) {
+			r = coap_append_option_int(&req, codes[i], i * 10 + j);
+			zassert_equal(r, 0, "Unable to append option");
+		}
+	}
+
+	r = coap_packet_append_payload_marker(&req);
+	zassert_equal(r, 0, "Unable to append payload marker");
+
+	r = coap_packet_append_payload(&req, "payload", strlen("payload"));
+	zassert_equal(r, 0, "Unable to append payload");
+
+	return coap_packet_parse(cpkt, data, req.offset, NULL, 0);
+}
+
+static void option_index_check(struct coap_packet *cpkt)
+{
+	static const uint16_t codes[] = {
+		COAP_OPTION_IF_MATCH, COAP_OPTION_OBSERVE, COAP_OPTION_URI_PATH,
+		COAP_OPTION_CONTENT_FORMAT, COAP_OPTION_URI_QUERY,
+		COAP_OPTION_ACCEPT, COAP_OPTION_BLOCK2, COAP_OPTION_BLOCK1,
+		COAP_OPTION_SIZE2, COAP_OPTION_SIZE1, TEST_OPTION_ECHO,
+		TEST_OPTION_NO_RESPONSE,
+	};
+	struct coap_option indexed[4];
+	struct coap_option options[4];
+	bool was_indexed = cpkt->opt_indexed;
+	int count, indexed_count;
+
+	for (int i = 0; i < ARRAY_SIZE(codes); i++) {
+		for (int veclen = 0; veclen <= ARRAY_SIZE(options); veclen++) {
+			memset(indexed, 0, sizeof(indexed));
+			memset(options, 0, sizeof(options));
+
+			indexed_count = coap_find_options(cpkt, codes[i],
+							  indexed, veclen);
+
+			cpkt->opt_indexed = false;
+			count = coap_find_options(cpkt, codes[i], options,
+						  veclen);
+			cpkt->opt_indexed = was_indexed;
+
+			zassert_equal(indexed_count, count,
+				      "Wrong number of options %u",
+				      codes[i]);
+			zassert_mem_equal(indexed, options,
+					  count * sizeof(options[0]),
+					  "Wrong options %u", codes[i]);
+		}
+	}
+}
+
+static void test_option_index(void)
+{
+	struct coap_packet cpkt;
+	int r;
+
+	r = option_index_packet(&cpkt, 8);
+	zassert_equal(r, 0, "Could not parse packet");
+	zassert_true(cpkt.opt_indexed, "Options not indexed");
+	zassert_equal(coap_get_option_int(&cpkt, COAP_OPTION_BLOCK2), 50,
+		      "Wrong option value");
+	zassert_equal(coap_get_option_int(&cpkt, COAP_OPTION_BLOCK1), -ENOENT,
+		      "Option should not be found");
+	option_index_check(&cpkt);
+
+	/* More option numbers than index entries */
+	r = option_index_packet(&cpkt, CONFIG_COAP_OPTION_INDEX_SIZE + 1);
+	zassert_equal(r, 0, "Could not parse packet");
+	zassert_false(cpkt.opt_indexed, "Options should not be indexed");
+	option_index_check(&cpkt);
+}
+#else
+static void test_option_index(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_COAP_OPTION_INDEX */
+
+#if defined(CONFIG_COAP_EXCHANGE_INDEX)
+COAP_PENDING_INDEX_DEFINE(test_pending_index, 4);
+COAP_REPLY_INDEX_DEFINE(test_reply_index, 4);
+
+static int exchange_reply_cb(const struct coap_packet *response,
+			     struct coap_reply *reply,
+			     const struct sockaddr *from)
+{
+	(*(int *)reply->user_data)++;
+
+	return 0;
+}
+
+static void exchange_packet(struct coap_packet *cpkt, uint8_t *data,
+			    uint8_t type, uint8_t tkl, const uint8_t *token,
+			    uint16_t id)
+{
+	int r;
+
+	r = coap_packet_init(cpkt, data, COAP_BUF_SIZE, COAP_VERSION_1, type,
+			     tkl, token, COAP_METHOD_GET, id);
+	zassert_equal(r, 0, "Could not initialize packet");
+}
+
+static void test_exchange_index(void)
+{
+	static const uint8_t tokens[][2] = { { 1, 2 }, { 2, 1 }, { 3, 3 } };
+	struct coap_pending *sent[ARRAY_SIZE(tokens)];
+	struct coap_pending *pending;
+	struct coap_reply *reply;
+	struct coap_packet cpkt;
+	uint8_t *data = data_buf[0];
+	uint16_t ids[ARRAY_SIZE(tokens)];
+	int calls = 0;
+	int r;
+
+	coap_pending_index_clear_all(&test_pending_index);
+	coap_reply_index_clear_all(&test_reply_index);
+
+	for (int i = 0; i < ARRAY_SIZE(tokens); i++) {
+		ids[i] = coap_next_id();
+		exchange_packet(&cpkt, data, COAP_TYPE_CON, sizeof(tokens[i]),
+				tokens[i], ids[i]);
+
+		pending = coap_pending_next_unused(test_pending_index.pendings,
+						   test_pending_index.max);
+		zassert_not_null(pending, "No free pending");
+		r = coap_pending_init(pending, &cpkt,
+				      (struct sockaddr *)&dummy_addr,
+				      COAP_DEFAULT_MAX_RETRANSMIT);
+		zassert_equal(r, 0, "Could not initialize pending");
+		zassert_equal(coap_pending_index_add(&test_pending_index,
+						     pending), 0,
+			      "Could not add pending");
+		zassert_true(coap_pending_index_cycle(&test_pending_index,
+						      pending),
+			     "Pending expired too early");
+		sent[i] = pending;
+
+		reply = coap_reply_next_unused(test_reply_index.replies,
+					       test_reply_index.max);
+		zassert_not_null(reply, "No free reply");
+		coap_reply_init(reply, &cpkt);
+		reply->reply = exchange_reply_cb;
+		reply->user_data = &calls;
+		zassert_equal(coap_reply_index_add(&test_reply_index, reply), 0,
+			      "Could not add reply");
+	}
+
+	zassert_equal(coap_pending_index_add(&test_pending_index, &pendings[0]),
+		      -EINVAL, "Pending of another array added");
+
+	/* The heap gives the same expiry as a walk of the array */
+	for (int i = 0; i < ARRAY_SIZE(tokens); i++) {
+		struct coap_pending *linear;
+
+		pending = coap_pending_next_to_expire_index(&test_pending_index);
+		linear = coap_pending_next_to_expire(test_pending_index.pendings,
+						     test_pending_index.max);
+		zassert_not_null(pending, "No pending to expire");
+		zassert_equal(pending->t0 + pending->timeout,
+			      linear->t0 + linear->timeout,
+			      "Wrong pending to expire");
+
+		/* Retransmitting it moves it back in the heap */
+		zassert_true(coap_pending_index_cycle(&test_pending_index,
+						      pending),
+			     "Pending expired too early");
+	}
+
+	/* Acknowledged out of order */
+	for (int i = ARRAY_SIZE(tokens) - 1; i >= 0; i--) {
+		exchange_packet(&cpkt, data, COAP_TYPE_ACK, sizeof(tokens[i]),
+				tokens[i], ids[i]);
+
+		pending = coap_pending_received_index(&cpkt,
+						      &test_pending_index);
+		zassert_equal_ptr(pending, sent[i], "Wrong pending %d", i);
+		zassert_equal_ptr(pending,
+				  coap_pending_received(&cpkt,
+						test_pending_index.pendings,
+						test_pending_index.max),
+				  "Lookups disagree %d", i);
+		coap_pending_index_clear(&test_pending_index, pending);
+		zassert_is_null(coap_pending_received_index(
+					&cpkt, &test_pending_index),
+				"Pending %d not cleared", i);
+
+		reply = coap_response_received_index(
+			&cpkt, (const struct sockaddr *)&dummy_addr,
+			&test_reply_index);
+		zassert_not_null(reply, "No reply %d", i);
+		zassert_mem_equal(reply->token, tokens[i], sizeof(tokens[i]),
+				  "Wrong reply %d", i);
+		zassert_equal(calls, ARRAY_SIZE(tokens) - i,
+			      "Reply handler not called");
+		coap_reply_index_clear(&test_reply_index, reply);
+	}
+
+	zassert_is_null(coap_pending_next_to_expire_index(&test_pending_index),
+			"There should be no active pendings");
+
+	/* Unknown token */
+	exchange_packet(&cpkt, data, COAP_TYPE_ACK, sizeof(tokens[0]),
+			tokens[0], ids[0]);
+	zassert_is_null(coap_response_received_index(
+				&cpkt, (const struct sockaddr *)&dummy_addr,
+				&test_reply_index),
+			"Reply should have been cleared");
+}
+#else
+static void test_exchange_index(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_COAP_EXCHANGE_INDEX */
+
 void test_main(void)
 {
 	ztest_test_suite(coap_tests,
@@ -983,7 +1345,10 @@ void test_main(void)
 			 ztest_unit_test(test_block2_size),
 			 ztest_unit_test(test_retransmit_second_round),
 			 ztest_unit_test(test_observer_server),
-			 ztest_unit_test(test_observer_client));
+			 ztest_unit_test(test_observer_client),
+			 ztest_unit_test(test_resource_index),
+			 ztest_unit_test(test_option_index),
+			 ztest_unit_test(test_exchange_index));
 
 	ztest_run_test_suite(coap_tests);
 }
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_DNS_RESOLVER_LOG_LEVEL);
+
+#include <string.h>
+#include <strings.h>
+#include <ztest.h>
+
+#include <zephyr/sys/byteorder.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/dns_resolve.h>
+
+#include "dns_pack.h"
+
+#define SERVER_PORT 15353
+#define MAX_BUF_SIZE 512
+#define STACK_SIZE (1024 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define THREAD_PRIORITY K_PRIO_COOP(2)
+
+#define DNS_TIMEOUT 500 /* ms */
+#define WAIT_TIME K_MSEC(DNS_TIMEOUT + 300)
+
+/* Names known by the stand-in DNS server, all others do not exist */
+static const struct {
+	const char *name;
+	uint32_t ttl;
+	uint8_t addr[4];
+} server_names[] = {
+	{ "broker.zephyr.test", 300, { 192, 0, 2, 10 } },
+	{ "short.zephyr.test", 1, { 192, 0, 2, 11 } },
+	{ "n0.zephyr.test", 300, { 192, 0, 2, 20 } },
+	{ "n1.zephyr.test", 300, { 192, 0, 2, 21 } },
+	{ "n2.zephyr.test", 300, { 192, 0, 2, 22 } },
+	{ "n3.zephyr.test", 300, { 192, 0, 2, 23 } },
+	{ "n4.zephyr.test", 300, { 192, 0, 2, 24 } },
+};
+
+static uint8_t server_buf[MAX_BUF_SIZE];
+static int server_sock = -1;
+static atomic_t queries_received;
+
+struct resolve_result {
+	struct k_sem done;
+	int status;
+	int num_addrs;
+	struct in_addr addr;
+};
+
+static int server_names_find(const char *name)
+{
+	for (int i = 0; i < ARRAY_SIZE(server_names); i++) {
+		if (strncasecmp(server_names[i].name, name,
+				strlen(server_names[i].name) + 1) == 0) {
+			return i;
+		}
+	}
+
+	return -ENOENT;
+}
+
+/* Turn the query in buf into its response, returns the response length */
+static int server_answer(uint8_t *buf, int len)
+{
+	char name[64];
+	int name_len = 0;
+	int pos = DNS_MSG_HEADER_SIZE;
+	int idx;
+
+	while (pos < len && buf[pos] != 0U) {
+		int label_len = buf[pos++];
+
+		if (name_len + label_len + 1 >= sizeof(name) ||
+		    pos + label_len > len) {
+			return -EINVAL;
+		}
+
+		if (name_len > 0) {
+			name[name_len++] = '.';
+		}
+
+		memcpy(&name[name_len], &buf[pos], label_len);
+		name_len += label_len;
+		pos += label_len;
+	}
+
+	name[name_len] = '\0';
+
+	/* Root label, query type and class */
+	pos += 1 + DNS_QTYPE_LEN + DNS_QCLASS_LEN;
+	if (pos > len) {
+		return -EINVAL;
+	}
+
+	/* Response, recursion desired copied from the query, recursion
+	 * available.
+	 */
+	buf[2] = 0x80 | (buf[2] & 0x01);
+	buf[3] = 0x80;
+	memset(&buf[6], 0, 6);
+
+	idx = server_names_find(name);
+	if (idx < 0) {
+		buf[3] |= DNS_HEADER_NAMEERROR;
+		return pos;
+	}
+
+	/* One answer */
+	buf[7] = 1U;
+
+	/* Pointer to the query name, type A, class IN */
+	buf[pos++] = 0xc0;
+	buf[pos++] = DNS_MSG_HEADER_SIZE;
+	sys_put_be16(DNS_RR_TYPE_A, &buf[pos]);
+	pos += 2;
+	sys_put_be16(DNS_CLASS_IN, &buf[pos]);
+	pos += 2;
+	sys_put_be32(server_names[idx].ttl, &buf[pos]);
+	pos += 4;
+	sys_put_be16(sizeof(server_names[idx].addr), &buf[pos]);
+	pos += 2;
+	memcpy(&buf[pos], server_names[idx].addr,
+	       sizeof(server_names[idx].addr));
+	pos += sizeof(server_names[idx].addr);
+
+	return pos;
+}
+
+static void server_process(void)
+{
+	struct sockaddr_in addr;
+	socklen_t addr_len;
+	int len;
+
+	while (true) {
+		addr_len = sizeof(addr);
+		len = recvfrom(server_sock, server_buf, sizeof(server_buf), 0,
+			       (struct sockaddr *)&addr, &addr_len);
+		if (len < DNS_MSG_HEADER_SIZE) {
+			continue;
+		}
+
+		atomic_inc(&queries_received);
+
+		len = server_answer(server_buf, len);
+		if (len < 0) {
+			continue;
+		}
+
+		(void)sendto(server_sock, server_buf, len, 0,
+			     (struct sockaddr *)&addr, addr_len);
+	}
+}
+
+K_THREAD_DEFINE(server_thread_id, STACK_SIZE,
+		server_process, NULL, NULL, NULL,
+		THREAD_PRIORITY, 0, -1);
+
+static void resolve_cb(enum dns_resolve_status status,
+		       struct dns_addrinfo *info, void *user_data)
+{
+	struct resolve_result *result = user_data;
+
+	if (info) {
+		if (status != DNS_EAI_INPROGRESS ||
+		    info->ai_family != AF_INET) {
+			return;
+		}
+
+		result->addr = net_sin(&info->ai_addr)->sin_addr;
+		result->num_addrs++;
+		return;
+	}
+
+	result->status = status;
+	k_sem_give(&result->done);
+}
+
+static void resolve(const char *name, struct resolve_result *result)
+{
+	int ret;
+
+	memset(result, 0, sizeof(*result));
+	k_sem_init(&result->done, 0, 1);
+
+	ret = dns_get_addr_info(name, DNS_QUERY_TYPE_A, NULL, resolve_cb,
+				result, DNS_TIMEOUT);
+	zassert_equal(ret, 0, "Cannot resolve %s", name);
+
+	ret = k_sem_take(&result->done, WAIT_TIME);
+	zassert_equal(ret, 0, "Timeout while resolving %s", name);
+}
+
+static void resolve_expect(const char *name, int expected_queries)
+{
+	struct resolve_result result;
+	int idx = server_names_find(name);
+
+	atomic_set(&queries_received, 0);
+
+	resolve(name, &result);
+
+	zassert_equal(atomic_get(&queries_received), expected_queries,
+		      "Unexpected number of queries for %s", name);
+	zassert_equal(result.status, DNS_EAI_ALLDONE, "Invalid status");
+	zassert_equal(result.num_addrs, 1, "Invalid number of addresses");
+	zassert_mem_equal(&result.addr, server_names[idx].addr,
+			  sizeof(result.addr), "Invalid address");
+}
+
+static void test_setup(void)
+{
+	struct sockaddr_in addr = {
+		.sin_family = AF_INET,
+		.sin_port = htons(SERVER_PORT),
+		.sin_addr = INADDR_LOOPBACK_INIT,
+	};
+	int ret;
+
+	server_sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	zassert_true(server_sock >= 0, "Cannot create socket");
+
+	ret = bind(server_sock, (struct sockaddr *)&addr, sizeof(addr));
+	zassert_equal(ret, 0, "Cannot bind socket");
+
+	k_thread_start(server_thread_id);
+	k_yield();
+}
+
+static void test_positive(void)
+{
+	struct dns_resolve_cache_stats before, after;
+
+	dns_resolve_cache_flush();
+	dns_resolve_cache_stats_get(&before);
+
+	resolve_expect("broker.zephyr.test", 1);
+	resolve_expect("broker.zephyr.test", 0);
+	resolve_expect("BROKER.zephyr.test", 0);
+
+	dns_resolve_cache_stats_get(&after);
+
+	zassert_equal(after.hits - before.hits, 2, "Invalid hit count");
+	zassert_equal(after.misses - before.misses, 1, "Invalid miss count");
+}
+
+static void test_negative(void)
+{
+	struct resolve_result first, cached;
+
+	dns_resolve_cache_flush();
+
+	atomic_set(&queries_received, 0);
+
+	resolve("missing.zephyr.test", &first);
+	zassert_equal(atomic_get(&queries_received), 1, "Query not sent");
+	zassert_equal(first.num_addrs, 0, "Invalid number of addresses");
+	zassert_not_equal(first.status, DNS_EAI_ALLDONE, "Invalid status");
+
+	resolve("missing.zephyr.test", &cached);
+	zassert_equal(atomic_get(&queries_received), 1, "Query sent again");
+	zassert_equal(cached.num_addrs, 0, "Invalid number of addresses");
+	zassert_equal(cached.status, first.status,
+		      "Cached status differs from the network one");
+}
+
+static void test_ttl(void)
+{
+	dns_resolve_cache_flush();
+
+	resolve_expect("short.zephyr.test", 1);
+	resolve_expect("short.zephyr.test", 0);
+
+	k_msleep(MSEC_PER_SEC + 100);
+
+	resolve_expect("short.zephyr.test", 1);
+}
+
+static void test_flush(void)
+{
+	dns_resolve_cache_flush();
+
+	resolve_expect("broker.zephyr.test", 1);
+	resolve_expect("broker.zephyr.test", 0);
+
+	dns_resolve_cache_flush();
+
+	resolve_expect("broker.zephyr.test", 1);
+}
+
+static void test_lru(void)
+{
+	struct dns_resolve_cache_stats before, after;
+
+	dns_resolve_cache_flush();
+	dns_resolve_cache_stats_get(&before);
+
+	/* Fill the cache, then use the oldest entry again */
+	resolve_expect("n0.zephyr.test", 1);
+	resolve_expect("n1.zephyr.test", 1);
+	resolve_expect("n2.zephyr.test", 1);
+	resolve_expect("n3.zephyr.test", 1);
+	resolve_expect("n0.zephyr.test", 0);
+
+	/* Replaces n1, the least recently used entry */
+	resolve_expect("n4.zephyr.test", 1);
+
+	resolve_expect("n0.zephyr.test", 0);
+	resolve_expect("n1.zephyr.test", 1);
+
+	dns_resolve_cache_stats_get(&after);
+
+	zassert_equal(after.evictions - before.evictions, 2,
+		      "Invalid eviction count");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(dns_cache,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_positive),
+			 ztest_unit_test(test_negative),
+			 ztest_unit_test(test_ttl),
+			 ztest_unit_test(test_flush),
+			 ztest_unit_test(test_lru));
+
+	ztest_run_test_suite(dns_cache);
+}
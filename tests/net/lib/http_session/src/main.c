@@ -0,0 +1,509 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_NET_HTTP_LOG_LEVEL);
+
+#include <stdlib.h>
+#include <string.h>
+#include <ztest.h>
+
+#include <zephyr/net/socket.h>
+#include <zephyr/net/http_client.h>
+
+#define SERVER_PORT 8080
+#define STACK_SIZE (2048 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define THREAD_PRIORITY K_PRIO_PREEMPT(8)
+
+#define TIMEOUT 2000 /* ms */
+#define URL_LEN 32
+#define URL_LEN_MAX 31
+#define PIPELINE_DEPTH CONFIG_HTTP_CLIENT_PIPELINE_DEPTH
+
+#define RSP_HELLO "HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nhello"
+#define RSP_CHUNKED "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n" \
+		    "5\r\nhello\r\n6\r\n world\r\n0\r\n\r\n"
+#define RSP_CLOSE "HTTP/1.1 200 OK\r\nConnection: close\r\n" \
+		  "Content-Length: 2\r\n\r\nok"
+#define RSP_OK "HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok"
+
+static struct sockaddr_in server_addr = {
+	.sin_family = AF_INET,
+	.sin_port = htons(SERVER_PORT),
+	.sin_addr = INADDR_LOOPBACK_INIT,
+};
+static int server_sock = -1;
+static atomic_t server_accepts;
+static atomic_t server_requests;
+
+/* Body of the last request received by the server */
+static char server_body[128];
+static size_t server_body_len;
+
+/* Responses held back until a batch of requests is received */
+static char server_batch[PIPELINE_DEPTH * sizeof(RSP_HELLO)];
+static size_t server_batch_len;
+static int server_batch_count;
+
+static struct http_session session;
+static uint8_t recv_buf[64];
+
+struct result {
+	uint16_t status;
+	int finals;
+	char body[32];
+	size_t body_len;
+};
+
+static int server_recv_line(int sock, char *buf, size_t len)
+{
+	size_t pos = 0;
+
+	/* One byte at a time, not to read into the next request */
+	while (pos < len - 1) {
+		if (recv(sock, &buf[pos], 1, 0) <= 0) {
+			return -ENOTCONN;
+		}
+
+		if (buf[pos++] == '\n') {
+			break;
+		}
+	}
+
+	buf[pos] = '\0';
+
+	return pos;
+}
+
+static int server_recv_all(int sock, char *buf, size_t len)
+{
+	while (len > 0) {
+		int ret = recv(sock, buf, len, 0);
+
+		if (ret <= 0) {
+			return -ENOTCONN;
+		}
+
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+/* Read a request, storing its body, and return its URL */
+static int server_recv_request(int sock, char url[URL_LEN])
+{
+	size_t content_len = 0;
+	bool chunked = false;
+	char line[80];
+	char *end;
+	size_t len;
+
+	if (server_recv_line(sock, line, sizeof(line)) < 0 ||
+	    sscanf(line, "%*s %" STRINGIFY(URL_LEN_MAX) "s", url) != 1) {
+		return -EINVAL;
+	}
+
+	do {
+		if (server_recv_line(sock, line, sizeof(line)) < 0) {
+			return -ENOTCONN;
+		}
+
+		if (strncmp(line, "Content-Length: ", 16) == 0) {
+			content_len = atoi(&line[16]);
+		} else if (strcmp(line, "Transfer-Encoding: chunked\r\n") == 0) {
+			chunked = true;
+		}
+	} while (strcmp(line, "\r\n") != 0);
+
+	server_body_len = 0;
+
+	if (!chunked) {
+		if (content_len > sizeof(server_body)) {
+			return -EMSGSIZE;
+		}
+
+		server_body_len = content_len;
+
+		return server_recv_all(sock, server_body, content_len);
+	}
+
+	do {
+		if (server_recv_line(sock, line, sizeof(line)) < 0) {
+			return -ENOTCONN;
+		}
+
+		len = strtoul(line, &end, 16);
+		if (end == line ||
+		    server_body_len + len > sizeof(server_body) ||
+		    server_recv_all(sock, &server_body[server_body_len],
+				    len) < 0 ||
+		    server_recv_line(sock, line, sizeof(line)) < 0 ||
+		    strcmp(line, "\r\n") != 0) {
+			return -EINVAL;
+		}
+
+		server_body_len += len;
+	} while (len > 0);
+
+	return 0;
+}
+
+static void server_serve(int sock)
+{
+	char url[URL_LEN];
+
+	server_batch_len = 0;
+	server_batch_count = 0;
+
+	while (server_recv_request(sock, url) == 0) {
+		atomic_inc(&server_requests);
+
+		if (strcmp(url, "/batch") == 0) {
+			/* Reply to the pipelined requests with a single send */
+			memcpy(&server_batch[server_batch_len], RSP_HELLO,
+			       sizeof(RSP_HELLO) - 1);
+			server_batch_len += sizeof(RSP_HELLO) - 1;
+
+			if (++server_batch_count == PIPELINE_DEPTH) {
+				(void)send(sock, server_batch,
+					   server_batch_len, 0);
+				server_batch_len = 0;
+				server_batch_count = 0;
+			}
+		} else if (strcmp(url, "/chunked") == 0) {
+			(void)send(sock, RSP_CHUNKED, sizeof(RSP_CHUNKED) - 1,
+				   0);
+		} else if (strcmp(url, "/close") == 0) {
+			(void)send(sock, RSP_CLOSE, sizeof(RSP_CLOSE) - 1, 0);
+			return;
+		} else if (strcmp(url, "/idle") == 0) {
+			/* As if the idle timeout of the server expired */
+			(void)send(sock, RSP_OK, sizeof(RSP_OK) - 1, 0);
+			k_msleep(10);
+			return;
+		} else if (strcmp(url, "/upload") == 0) {
+			(void)send(sock, RSP_OK, sizeof(RSP_OK) - 1, 0);
+		} else {
+			(void)send(sock, RSP_HELLO, sizeof(RSP_HELLO) - 1, 0);
+		}
+	}
+}
+
+static void server_process(void)
+{
+	int sock;
+
+	while (true) {
+		sock = accept(server_sock, NULL, NULL);
+		if (sock < 0) {
+			continue;
+		}
+
+		atomic_inc(&server_accepts);
+
+		server_serve(sock);
+		close(sock);
+	}
+}
+
+K_THREAD_DEFINE(server_thread_id, STACK_SIZE,
+		server_process, NULL, NULL, NULL,
+		THREAD_PRIORITY, 0, -1);
+
+static void response_cb(struct http_response *rsp,
+			enum http_final_call final_data,
+			void *user_data)
+{
+	struct result *res = user_data;
+
+	if (final_data == HTTP_DATA_FINAL) {
+		res->status = rsp->http_status_code;
+		res->finals++;
+	}
+}
+
+static int body_cb(struct http_response *rsp, const uint8_t *data,
+		   size_t len, void *user_data)
+{
+	struct result *res = user_data;
+
+	if (res->body_len + len > sizeof(res->body)) {
+		return -ENOSPC;
+	}
+
+	memcpy(&res->body[res->body_len], data, len);
+	res->body_len += len;
+
+	return 0;
+}
+
+static void request_init(struct http_request *req, const char *url)
+{
+	memset(req, 0, sizeof(*req));
+
+	req->method = HTTP_GET;
+	req->url = url;
+	req->host = "127.0.0.1";
+	req->protocol = "HTTP/1.1";
+	req->response = response_cb;
+	req->body_cb = body_cb;
+}
+
+static void check_result(struct result *res, const char *body)
+{
+	zassert_equal(res->finals, 1, "Invalid number of final callbacks");
+	zassert_equal(res->status, 200, "Invalid status %d", res->status);
+	zassert_equal(res->body_len, strlen(body), "Invalid body length");
+	zassert_mem_equal(res->body, body, res->body_len, "Invalid body");
+}
+
+static void test_setup(void)
+{
+	int ret;
+
+	server_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(server_sock >= 0, "Cannot create socket");
+
+	ret = bind(server_sock, (struct sockaddr *)&server_addr,
+		   sizeof(server_addr));
+	zassert_equal(ret, 0, "Cannot bind socket");
+
+	ret = listen(server_sock, 1);
+	zassert_equal(ret, 0, "Cannot listen");
+
+	k_thread_start(server_thread_id);
+
+	http_session_init(&session);
+
+	session.addr = (struct sockaddr *)&server_addr;
+	session.addrlen = sizeof(server_addr);
+	session.recv_buf = recv_buf;
+	session.recv_buf_len = sizeof(recv_buf);
+}
+
+static void test_keep_alive(void)
+{
+	struct http_request req;
+	struct result res;
+	int ret;
+
+	atomic_set(&server_accepts, 0);
+
+	for (int i = 0; i < 3; i++) {
+		memset(&res, 0, sizeof(res));
+		request_init(&req, "/hello");
+
+		ret = http_session_req(&session, &req, TIMEOUT, &res);
+		zassert_true(ret > 0, "Request failed (%d)", ret);
+
+		check_result(&res, "hello");
+	}
+
+	zassert_equal(atomic_get(&server_accepts), 1,
+		      "Connection not reused");
+}
+
+static void test_pipeline(void)
+{
+	struct http_request reqs[PIPELINE_DEPTH];
+	struct result res[PIPELINE_DEPTH];
+	struct http_request extra;
+	int ret;
+
+	memset(res, 0, sizeof(res));
+	atomic_set(&server_requests, 0);
+
+	for (int i = 0; i < PIPELINE_DEPTH; i++) {
+		request_init(&reqs[i], "/batch");
+
+		ret = http_session_send(&session, &reqs[i], TIMEOUT, &res[i]);
+		zassert_true(ret > 0, "Cannot send request (%d)", ret);
+	}
+
+	request_init(&extra, "/hello");
+
+	ret = http_session_send(&session, &extra, TIMEOUT, NULL);
+	zassert_equal(ret, -ENOBUFS, "Pipeline not full (%d)", ret);
+
+	/* The responses arrive together, each one must end where the next
+	 * one starts.
+	 */
+	for (int i = 0; i < PIPELINE_DEPTH; i++) {
+		ret = http_session_recv(&session);
+		zassert_true(ret > 0, "No response (%d)", ret);
+
+		check_result(&res[i], "hello");
+
+		for (int j = i + 1; j < PIPELINE_DEPTH; j++) {
+			zassert_equal(res[j].finals, 0,
+				      "Response delivered out of order");
+		}
+	}
+
+	ret = http_session_recv(&session);
+	zassert_equal(ret, -ENOENT, "Unexpected response (%d)", ret);
+
+	zassert_equal(atomic_get(&server_requests), PIPELINE_DEPTH,
+		      "Invalid number of requests");
+}
+
+static const char * const chunks[] = { "temp=21.5;", "hum=40;", "co2=612" };
+static int chunk_idx;
+
+static int chunk_cb(struct http_request *req, const uint8_t **data,
+		    void *user_data)
+{
+	if (chunk_idx == ARRAY_SIZE(chunks)) {
+		return 0;
+	}
+
+	*data = (const uint8_t *)chunks[chunk_idx];
+
+	return strlen(chunks[chunk_idx++]);
+}
+
+static void test_chunked_upload(void)
+{
+	const char *body = "temp=21.5;hum=40;co2=612";
+	struct http_request req;
+	struct result res;
+	int ret;
+
+	memset(&res, 0, sizeof(res));
+	request_init(&req, "/upload");
+	req.method = HTTP_POST;
+	req.chunk_cb = chunk_cb;
+	chunk_idx = 0;
+
+	ret = http_session_req(&session, &req, TIMEOUT, &res);
+	zassert_true(ret > 0, "Request failed (%d)", ret);
+
+	check_result(&res, "ok");
+
+	zassert_equal(server_body_len, strlen(body), "Invalid body length");
+	zassert_mem_equal(server_body, body, server_body_len, "Invalid body");
+}
+
+static void test_body_sink(void)
+{
+	struct http_request req;
+	struct result res;
+	int ret;
+
+	memset(&res, 0, sizeof(res));
+	request_init(&req, "/chunked");
+
+	ret = http_session_req(&session, &req, TIMEOUT, &res);
+	zassert_true(ret > 0, "Request failed (%d)", ret);
+
+	/* Without the chunk framing */
+	check_result(&res, "hello world");
+}
+
+static void test_body_abort(void)
+{
+	struct http_request req;
+	struct result res;
+	int ret;
+
+	memset(&res, 0, sizeof(res));
+	/* No room left for the body */
+	res.body_len = sizeof(res.body);
+	request_init(&req, "/hello");
+	atomic_set(&server_accepts, 0);
+
+	ret = http_session_req(&session, &req, TIMEOUT, &res);
+	zassert_equal(ret, -ENOSPC, "Body callback error not returned (%d)",
+		      ret);
+
+	/* The session connects again for the next request */
+	memset(&res, 0, sizeof(res));
+
+	ret = http_session_req(&session, &req, TIMEOUT, &res);
+	zassert_true(ret > 0, "Request failed (%d)", ret);
+
+	check_result(&res, "hello");
+
+	zassert_equal(atomic_get(&server_accepts), 1, "Not connected again");
+}
+
+static void test_reconnect(void)
+{
+	struct http_request req;
+	struct result res;
+	int ret;
+
+	atomic_set(&server_accepts, 0);
+
+	/* Closed by the server, as announced in the response */
+	memset(&res, 0, sizeof(res));
+	request_init(&req, "/close");
+
+	ret = http_session_req(&session, &req, TIMEOUT, &res);
+	zassert_true(ret > 0, "Request failed (%d)", ret);
+
+	check_result(&res, "ok");
+	zassert_equal(session.sock, -1, "Connection not closed");
+
+	/* Then closed by the server without notice */
+	memset(&res, 0, sizeof(res));
+	request_init(&req, "/idle");
+
+	ret = http_session_req(&session, &req, TIMEOUT, &res);
+	zassert_true(ret > 0, "Request failed (%d)", ret);
+
+	check_result(&res, "ok");
+
+	k_msleep(100);
+
+	memset(&res, 0, sizeof(res));
+	request_init(&req, "/hello");
+
+	ret = http_session_req(&session, &req, TIMEOUT, &res);
+	zassert_true(ret > 0, "Request failed (%d)", ret);
+
+	check_result(&res, "hello");
+
+	zassert_equal(atomic_get(&server_accepts), 2,
+		      "Invalid number of connections");
+}
+
+static void test_close(void)
+{
+	struct http_request req;
+	struct result res;
+	int ret;
+
+	memset(&res, 0, sizeof(res));
+	request_init(&req, "/batch");
+
+	ret = http_session_send(&session, &req, TIMEOUT, &res);
+	zassert_true(ret > 0, "Cannot send request (%d)", ret);
+
+	/* The request waiting for its response gets a null response */
+	http_session_close(&session);
+
+	zassert_equal(res.finals, 1, "No final callback");
+	zassert_equal(res.status, 0, "Not a null response");
+	zassert_equal(session.pending_count, 0, "Requests still pending");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(http_session,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_keep_alive),
+			 ztest_unit_test(test_pipeline),
+			 ztest_unit_test(test_chunked_upload),
+			 ztest_unit_test(test_body_sink),
+			 ztest_unit_test(test_body_abort),
+			 ztest_unit_test(test_reconnect),
+			 ztest_unit_test(test_close));
+
+	ztest_run_test_suite(http_session);
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <ztest.h>
+
+#include <zephyr/net/lwm2m.h>
+
+/* Default Minimum Period of the server object instance created on init */
+#define TEST_PATH "1/0/2"
+
+static void test_get_set(void)
+{
+	uint32_t value = 0U;
+	uint16_t short_id;
+	int ret;
+
+	ret = lwm2m_engine_set_u32(TEST_PATH, 17U);
+	zassert_equal(ret, 0, "Invalid error code returned");
+
+	ret = lwm2m_engine_get_u32(TEST_PATH, &value);
+	zassert_equal(ret, 0, "Invalid error code returned");
+	zassert_equal(value, 17U, "Invalid value read");
+
+	/* Resources before and after in the same instance */
+	ret = lwm2m_engine_set_u16("1/0/0", 101U);
+	zassert_equal(ret, 0, "Invalid error code returned");
+
+	ret = lwm2m_engine_get_u16("1/0/0", &short_id);
+	zassert_equal(ret, 0, "Invalid error code returned");
+	zassert_equal(short_id, 101U, "Invalid value read");
+
+	ret = lwm2m_engine_get_u32("1/0/3", &value);
+	zassert_equal(ret, 0, "Invalid error code returned");
+
+	ret = lwm2m_engine_get_u32("1/0/1000", &value);
+	zassert_equal(ret, -ENOENT, "Invalid error code returned");
+
+	ret = lwm2m_engine_get_u32("1/5/2", &value);
+	zassert_equal(ret, -ENOENT, "Invalid error code returned");
+
+	ret = lwm2m_engine_get_u32("1000/0/2", &value);
+	zassert_equal(ret, -ENOENT, "Invalid error code returned");
+}
+
+static void test_handle(void)
+{
+	struct lwm2m_res_handle handle;
+	uint32_t value = 0U;
+	int ret;
+
+	ret = lwm2m_engine_get_res_handle(TEST_PATH, &handle);
+	zassert_equal(ret, 0, "Invalid error code returned");
+
+	value = 23U;
+	ret = lwm2m_engine_set_by_handle(&handle, &value, sizeof(value));
+	zassert_equal(ret, 0, "Invalid error code returned");
+
+	ret = lwm2m_engine_get_u32(TEST_PATH, &value);
+	zassert_equal(ret, 0, "Invalid error code returned");
+	zassert_equal(value, 23U, "Invalid value read");
+
+	ret = lwm2m_engine_set_u32(TEST_PATH, 29U);
+	zassert_equal(ret, 0, "Invalid error code returned");
+
+	ret = lwm2m_engine_get_by_handle(&handle, &value, sizeof(value));
+	zassert_equal(ret, 0, "Invalid error code returned");
+	zassert_equal(value, 29U, "Invalid value read");
+}
+
+static void test_handle_invalid(void)
+{
+	struct lwm2m_res_handle handle;
+
+	zassert_equal(lwm2m_engine_get_res_handle("1/0", &handle), -EINVAL,
+		      "Invalid error code returned");
+	zassert_equal(lwm2m_engine_get_res_handle("1/5/2", &handle), -ENOENT,
+		      "Invalid error code returned");
+	zassert_equal(lwm2m_engine_get_res_handle("1/0/1000", &handle), -ENOENT,
+		      "Invalid error code returned");
+}
+
+static void test_handle_stale(void)
+{
+	struct lwm2m_res_handle handle;
+	uint32_t value = 31U;
+	int ret;
+
+	ret = lwm2m_engine_get_res_handle(TEST_PATH, &handle);
+	zassert_equal(ret, 0, "Invalid error code returned");
+
+	ret = lwm2m_engine_delete_obj_inst("1/0");
+	zassert_equal(ret, 0, "Invalid error code returned");
+
+	ret = lwm2m_engine_set_by_handle(&handle, &value, sizeof(value));
+	zassert_equal(ret, -ENOENT, "Invalid error code returned");
+
+	ret = lwm2m_engine_get_by_handle(&handle, &value, sizeof(value));
+	zassert_equal(ret, -ENOENT, "Invalid error code returned");
+
+	ret = lwm2m_engine_create_obj_inst("1/0");
+	zassert_equal(ret, 0, "Invalid error code returned");
+
+	/* The handle is resolved again to the new instance */
+	value = 37U;
+	ret = lwm2m_engine_set_by_handle(&handle, &value, sizeof(value));
+	zassert_equal(ret, 0, "Invalid error code returned");
+
+	value = 0U;
+	ret = lwm2m_engine_get_u32(TEST_PATH, &value);
+	zassert_equal(ret, 0, "Invalid error code returned");
+	zassert_equal(value, 37U, "Invalid value read");
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lwm2m_engine_index,
+		ztest_unit_test(test_get_set),
+		ztest_unit_test(test_handle),
+		ztest_unit_test(test_handle_invalid),
+		ztest_unit_test(test_handle_stale)
+	);
+
+	ztest_run_test_suite(lwm2m_engine_index);
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/zephyr.h>
+#include <ztest.h>
+
+#include <zephyr/net/lwm2m.h>
+
+#include "lwm2m_engine.h"
+
+/* Resources of the server object instance created on init. The server
+ * default periods, 1/0/2 and 1/0/3, are left at 0: observers are only
+ * scheduled from the attributes below.
+ */
+#define PATH_SHORT_ID "1/0/0"
+#define PATH_LIFETIME "1/0/1"
+#define PATH_DISABLE_TIMEOUT "1/0/5"
+#define PATH_STORE_NOTIFY "1/0/6"
+#define PATH_BINDING "1/0/7"
+
+#define MAX_DUE 8
+
+static const char * const paths[] = {
+	PATH_SHORT_ID, PATH_LIFETIME, PATH_DISABLE_TIMEOUT, PATH_STORE_NOTIFY,
+	PATH_BINDING,
+};
+
+static struct lwm2m_ctx ctx;
+
+static void observe(const char *path, uint8_t token)
+{
+	zassert_equal(lwm2m_engine_observe_test_add(&ctx, path, &token, 1), 0,
+		      "Failed to add observer %c", token);
+}
+
+static void unobserve(uint8_t token)
+{
+	zassert_equal(lwm2m_engine_observe_test_remove(&ctx, &token, 1), 0,
+		      "Failed to remove observer %c", token);
+}
+
+static void set_pmin(const char *path, uint32_t pmin)
+{
+	zassert_equal(lwm2m_engine_update_observer_min_period(&ctx, path, pmin),
+		      0, "Failed to set pmin of %s", path);
+}
+
+static void set_pmax(const char *path, uint32_t pmax)
+{
+	zassert_equal(lwm2m_engine_update_observer_max_period(&ctx, path, pmax),
+		      0, "Failed to set pmax of %s", path);
+}
+
+/* Check the due list order and return the due times */
+static void check_due(const char *expected, int64_t *due)
+{
+	uint8_t tokens[MAX_DUE];
+	int64_t times[MAX_DUE];
+	int count;
+
+	count = lwm2m_engine_observe_test_due_get(&ctx, tokens, times, MAX_DUE);
+	zassert_equal(count, strlen(expected), "Invalid due list length %d",
+		      count);
+
+	for (int i = 0; i < count; i++) {
+		zassert_equal(tokens[i], expected[i],
+			      "Observer %c due at position %d, expected %c",
+			      tokens[i], i, expected[i]);
+		if (i > 0) {
+			zassert_true(times[i - 1] <= times[i],
+				     "Due list not ordered");
+		}
+		if (due) {
+			due[i] = times[i];
+		}
+	}
+}
+
+static void check_due_in(int64_t due, int64_t start, uint32_t period_s)
+{
+	zassert_true(due >= start + MSEC_PER_SEC * period_s &&
+		     due <= k_uptime_get() + MSEC_PER_SEC * period_s,
+		     "Invalid due time");
+}
+
+static void setup(void)
+{
+	lwm2m_engine_context_init(&ctx);
+	ctx.sock_fd = -1;
+	ctx.srv_obj_inst = 0;
+
+	/* Resource changes are only notified to the contexts of the engine */
+	zassert_equal(lwm2m_socket_add(&ctx), 0, "Failed to add context");
+}
+
+static void teardown(void)
+{
+	uint8_t token;
+
+	for (token = 'a'; token <= 'z'; token++) {
+		(void)lwm2m_engine_observe_test_remove(&ctx, &token, 1);
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(paths); i++) {
+		set_pmin(paths[i], 0);
+		set_pmax(paths[i], 0);
+	}
+
+	check_due("", NULL);
+
+	lwm2m_socket_del(&ctx);
+}
+
+static void test_due_order(void)
+{
+	int64_t start = k_uptime_get();
+	int64_t due[MAX_DUE];
+
+	set_pmax(PATH_SHORT_ID, 30);
+	set_pmax(PATH_LIFETIME, 10);
+	set_pmax(PATH_DISABLE_TIMEOUT, 20);
+	set_pmax(PATH_STORE_NOTIFY, 10);
+
+	/* Equal due times keep the insertion order, observers without pmax
+	 * are not scheduled.
+	 */
+	observe(PATH_SHORT_ID, 'a');
+	observe(PATH_LIFETIME, 'b');
+	observe(PATH_BINDING, 'e');
+	observe(PATH_DISABLE_TIMEOUT, 'c');
+	observe(PATH_STORE_NOTIFY, 'd');
+
+	check_due("bdca", due);
+	check_due_in(due[0], start, 10);
+	check_due_in(due[2], start, 20);
+	check_due_in(due[3], start, 30);
+}
+
+static void test_due_pmax_change(void)
+{
+	int64_t start = k_uptime_get();
+	int64_t due[MAX_DUE];
+
+	set_pmax(PATH_DISABLE_TIMEOUT, 30);
+	set_pmax(PATH_STORE_NOTIFY, 20);
+
+	observe(PATH_DISABLE_TIMEOUT, 'a');
+	observe(PATH_STORE_NOTIFY, 'b');
+	check_due("ba", NULL);
+
+	/* Without pmin, a change is due immediately */
+	zassert_equal(lwm2m_engine_set_u32(PATH_DISABLE_TIMEOUT, 1U), 0,
+		      "Failed to set resource");
+	check_due("ab", due);
+	zassert_true(due[0] <= k_uptime_get(), "Change not due");
+
+	/* A new pmax moves the pending notification */
+	set_pmax(PATH_DISABLE_TIMEOUT, 40);
+	check_due("ba", due);
+	check_due_in(due[1], start, 40);
+
+	set_pmax(PATH_DISABLE_TIMEOUT, 10);
+	check_due("ab", due);
+	check_due_in(due[0], start, 10);
+}
+
+static void test_due_pmin_change(void)
+{
+	int64_t start = k_uptime_get();
+	int64_t due[MAX_DUE];
+
+	set_pmax(PATH_DISABLE_TIMEOUT, 30);
+	set_pmax(PATH_STORE_NOTIFY, 20);
+
+	observe(PATH_DISABLE_TIMEOUT, 'a');
+	observe(PATH_STORE_NOTIFY, 'b');
+	check_due("ba", NULL);
+
+	/* A change is held back until pmin */
+	set_pmin(PATH_DISABLE_TIMEOUT, 10);
+	zassert_equal(lwm2m_engine_set_u32(PATH_DISABLE_TIMEOUT, 2U), 0,
+		      "Failed to set resource");
+	check_due("ab", due);
+	check_due_in(due[0], start, 10);
+
+	/* A change is due at pmin when it comes before the pending pmax */
+	set_pmin(PATH_STORE_NOTIFY, 5);
+	zassert_equal(lwm2m_engine_set_bool(PATH_STORE_NOTIFY, true), 0,
+		      "Failed to set resource");
+	check_due("ba", due);
+	check_due_in(due[0], start, 5);
+}
+
+static void test_due_remove_queued(void)
+{
+	set_pmax(PATH_SHORT_ID, 10);
+	set_pmax(PATH_LIFETIME, 20);
+	set_pmax(PATH_DISABLE_TIMEOUT, 30);
+
+	observe(PATH_SHORT_ID, 'a');
+	observe(PATH_LIFETIME, 'b');
+	observe(PATH_DISABLE_TIMEOUT, 'c');
+	check_due("abc", NULL);
+
+	/* Removed while in the due list */
+	unobserve('a');
+	check_due("bc", NULL);
+
+	/* Removed with a due time change not applied yet */
+	zassert_equal(lwm2m_engine_set_u32(PATH_DISABLE_TIMEOUT, 3U), 0,
+		      "Failed to set resource");
+	unobserve('c');
+	check_due("b", NULL);
+
+	/* The freed observers are reused and scheduled again */
+	observe(PATH_DISABLE_TIMEOUT, 'd');
+	observe(PATH_SHORT_ID, 'e');
+	check_due("ebd", NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lwm2m_engine_observe,
+		ztest_unit_test_setup_teardown(test_due_order, setup, teardown),
+		ztest_unit_test_setup_teardown(test_due_pmax_change, setup,
+					       teardown),
+		ztest_unit_test_setup_teardown(test_due_pmin_change, setup,
+					       teardown),
+		ztest_unit_test_setup_teardown(test_due_remove_queued, setup,
+					       teardown)
+	);
+
+	ztest_run_test_suite(lwm2m_engine_observe);
+}
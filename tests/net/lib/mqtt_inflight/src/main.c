@@ -0,0 +1,460 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(net_test, CONFIG_MQTT_LOG_LEVEL);
+
+#include <string.h>
+#include <ztest.h>
+
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/net/socket.h>
+#include <zephyr/net/mqtt.h>
+
+#define BROKER_PORT 1883
+#define STACK_SIZE (1536 + CONFIG_TEST_EXTRA_STACK_SIZE)
+#define THREAD_PRIORITY K_PRIO_PREEMPT(8)
+
+#define BUFFER_SIZE 128
+#define WAIT_TIME K_SECONDS(2)
+#define COALESCE_DELAY CONFIG_MQTT_TX_COALESCE_DELAY
+#define MAX_MSGS CONFIG_MQTT_INFLIGHT_MAX_MSGS
+
+/* Acknowledgments sent by the stand-in broker */
+#define BROKER_PUBACK  BIT(0)
+#define BROKER_PUBREC  BIT(1)
+#define BROKER_PUBCOMP BIT(2)
+#define BROKER_ACK_ALL (BROKER_PUBACK | BROKER_PUBREC | BROKER_PUBCOMP)
+
+/* Packets received by the stand-in broker */
+struct broker_record {
+	uint8_t type;
+	uint8_t flags;
+	uint16_t message_id;
+};
+
+static struct broker_record records[32];
+static atomic_t records_count;
+static K_SEM_DEFINE(records_sem, 0, ARRAY_SIZE(records));
+static atomic_t broker_acks;
+static int broker_sock = -1;
+static uint8_t broker_buf[512];
+
+static uint8_t rx_buffer[BUFFER_SIZE];
+static uint8_t tx_buffer[BUFFER_SIZE];
+static uint8_t inflight_buffer[512];
+static uint8_t payload_long[200];
+static struct mqtt_client client_ctx;
+static struct sockaddr_in broker = {
+	.sin_family = AF_INET,
+	.sin_port = htons(BROKER_PORT),
+	.sin_addr = INADDR_LOOPBACK_INIT,
+};
+static bool connected;
+static int pubacks;
+
+static int broker_recv_all(int sock, uint8_t *buf, size_t len)
+{
+	while (len > 0) {
+		int ret = recv(sock, buf, len, 0);
+
+		if (ret <= 0) {
+			return -ENOTCONN;
+		}
+
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+static void broker_reply(int sock, uint8_t type, uint16_t message_id)
+{
+	uint8_t reply[4] = { type, 2U, message_id >> 8, message_id };
+
+	(void)send(sock, reply, sizeof(reply), 0);
+}
+
+static void broker_record(uint8_t type_and_flags, uint16_t message_id)
+{
+	int idx = atomic_get(&records_count);
+
+	if (idx < ARRAY_SIZE(records)) {
+		records[idx].type = type_and_flags & 0xF0;
+		records[idx].flags = type_and_flags & 0x0F;
+		records[idx].message_id = message_id;
+		atomic_inc(&records_count);
+	}
+
+	k_sem_give(&records_sem);
+}
+
+static void broker_serve(int sock)
+{
+	uint8_t type, byte;
+	uint32_t len, shift;
+	uint16_t message_id;
+	uint16_t topic_len;
+
+	while (broker_recv_all(sock, &type, 1) == 0) {
+		len = 0U;
+		shift = 0U;
+
+		do {
+			if (broker_recv_all(sock, &byte, 1) < 0) {
+				return;
+			}
+
+			len |= (byte & 0x7F) << shift;
+			shift += 7U;
+		} while (byte & 0x80);
+
+		if (len > sizeof(broker_buf) ||
+		    broker_recv_all(sock, broker_buf, len) < 0) {
+			return;
+		}
+
+		switch (type & 0xF0) {
+		case 0x10: {
+			/* CONNECT, accept and report a present session */
+			const uint8_t connack[] = { 0x20, 2U, 1U, 0U };
+
+			(void)send(sock, connack, sizeof(connack), 0);
+			break;
+		}
+
+		case 0x30:
+			/* PUBLISH */
+			topic_len = sys_get_be16(broker_buf);
+			message_id = 0U;
+
+			if (type & 0x06) {
+				message_id = sys_get_be16(
+					&broker_buf[sizeof(topic_len) +
+						    topic_len]);
+			}
+
+			broker_record(type, message_id);
+
+			if ((type & 0x06) == 0x02 &&
+			    (atomic_get(&broker_acks) & BROKER_PUBACK)) {
+				broker_reply(sock, 0x40, message_id);
+			} else if ((type & 0x06) == 0x04 &&
+				   (atomic_get(&broker_acks) & BROKER_PUBREC)) {
+				broker_reply(sock, 0x50, message_id);
+			}
+
+			break;
+
+		case 0x60:
+			/* PUBREL */
+			message_id = sys_get_be16(broker_buf);
+			broker_record(type, message_id);
+
+			if (atomic_get(&broker_acks) & BROKER_PUBCOMP) {
+				broker_reply(sock, 0x70, message_id);
+			}
+
+			break;
+
+		case 0xE0:
+			/* DISCONNECT */
+			return;
+
+		default:
+			break;
+		}
+	}
+}
+
+static void broker_process(void)
+{
+	int sock;
+
+	while (true) {
+		sock = accept(broker_sock, NULL, NULL);
+		if (sock < 0) {
+			continue;
+		}
+
+		broker_serve(sock);
+		close(sock);
+	}
+}
+
+K_THREAD_DEFINE(broker_thread_id, STACK_SIZE,
+		broker_process, NULL, NULL, NULL,
+		THREAD_PRIORITY, 0, -1);
+
+static void mqtt_evt_handler(struct mqtt_client *const client,
+			     const struct mqtt_evt *evt)
+{
+	switch (evt->type) {
+	case MQTT_EVT_CONNACK:
+		connected = (evt->result == 0);
+		break;
+
+	case MQTT_EVT_DISCONNECT:
+		connected = false;
+		break;
+
+	case MQTT_EVT_PUBACK:
+		pubacks++;
+		break;
+
+	case MQTT_EVT_PUBREC: {
+		const struct mqtt_pubrel_param rel_param = {
+			.message_id = evt->param.pubrec.message_id
+		};
+
+		(void)mqtt_publish_qos2_release(client, &rel_param);
+		break;
+	}
+
+	default:
+		break;
+	}
+}
+
+/* Process what the broker sent until cond is true */
+#define client_wait_until(cond)						\
+	do {								\
+		struct zsock_pollfd fds = {				\
+			.fd = client_ctx.transport.tcp.sock,		\
+			.events = ZSOCK_POLLIN,				\
+		};							\
+		int64_t end = k_uptime_get() + 2 * MSEC_PER_SEC;	\
+									\
+		while (!(cond) && k_uptime_get() < end) {		\
+			if (zsock_poll(&fds, 1, 100) > 0) {		\
+				(void)mqtt_input(&client_ctx);		\
+			}						\
+		}							\
+									\
+		zassert_true(cond, "Timeout waiting for " #cond);	\
+	} while (0)
+
+static void client_connect(void)
+{
+	int ret;
+
+	ret = mqtt_connect(&client_ctx);
+	zassert_equal(ret, 0, "Cannot connect (%d)", ret);
+
+	client_wait_until(connected);
+}
+
+/* Send the coalesced messages */
+static void client_flush(void)
+{
+	k_msleep(COALESCE_DELAY);
+
+	(void)mqtt_live(&client_ctx);
+}
+
+static int client_publish(uint16_t message_id, enum mqtt_qos qos,
+			  uint8_t *data, size_t len)
+{
+	struct mqtt_publish_param param = {
+		.message.topic.topic = MQTT_UTF8_LITERAL("sensors"),
+		.message.topic.qos = qos,
+		.message.payload.data = data,
+		.message.payload.len = len,
+		.message_id = message_id,
+	};
+
+	return mqtt_publish(&client_ctx, &param);
+}
+
+static struct broker_record *broker_wait(void)
+{
+	int idx = atomic_get(&records_count);
+
+	zassert_equal(k_sem_take(&records_sem, WAIT_TIME), 0,
+		      "Broker did not receive a packet");
+
+	return &records[idx];
+}
+
+static void test_setup(void)
+{
+	int ret;
+
+	broker_sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	zassert_true(broker_sock >= 0, "Cannot create socket");
+
+	ret = bind(broker_sock, (struct sockaddr *)&broker, sizeof(broker));
+	zassert_equal(ret, 0, "Cannot bind socket");
+
+	ret = listen(broker_sock, 1);
+	zassert_equal(ret, 0, "Cannot listen");
+
+	k_thread_start(broker_thread_id);
+
+	mqtt_client_init(&client_ctx);
+
+	client_ctx.broker = &broker;
+	client_ctx.evt_cb = mqtt_evt_handler;
+	client_ctx.client_id.utf8 = (uint8_t *)"zephyr_inflight";
+	client_ctx.client_id.size = strlen("zephyr_inflight");
+	client_ctx.transport.type = MQTT_TRANSPORT_NON_SECURE;
+	client_ctx.clean_session = 0U;
+	client_ctx.rx_buf = rx_buffer;
+	client_ctx.rx_buf_size = sizeof(rx_buffer);
+	client_ctx.tx_buf = tx_buffer;
+	client_ctx.tx_buf_size = sizeof(tx_buffer);
+	client_ctx.inflight_buf = inflight_buffer;
+	client_ctx.inflight_buf_size = sizeof(inflight_buffer);
+
+	atomic_set(&broker_acks, BROKER_ACK_ALL);
+
+	client_connect();
+}
+
+static void test_window(void)
+{
+	uint8_t data[] = "21.5";
+	int ret;
+
+	pubacks = 0;
+
+	for (int i = 0; i < MAX_MSGS; i++) {
+		ret = client_publish(100 + i, MQTT_QOS_1_AT_LEAST_ONCE,
+				     data, sizeof(data));
+		zassert_equal(ret, 0, "Cannot publish (%d)", ret);
+	}
+
+	ret = client_publish(100 + MAX_MSGS, MQTT_QOS_1_AT_LEAST_ONCE, data,
+			     sizeof(data));
+	zassert_equal(ret, -EAGAIN, "Window not full (%d)", ret);
+
+	/* The full window sent the waiting messages out */
+	client_wait_until(pubacks == MAX_MSGS);
+
+	zassert_equal(client_ctx.internal.inflight_count, 0,
+		      "Messages still in flight");
+
+	ret = client_publish(100 + MAX_MSGS, MQTT_QOS_1_AT_LEAST_ONCE, data,
+			     sizeof(data));
+	zassert_equal(ret, 0, "Cannot publish (%d)", ret);
+
+	client_flush();
+	client_wait_until(pubacks == MAX_MSGS + 1);
+}
+
+static void test_resend(void)
+{
+	struct broker_record *rec;
+	uint8_t data[] = "21.5";
+	int ret;
+
+	/* Lose the PUBACK and the PUBCOMP */
+	atomic_set(&broker_acks, BROKER_PUBREC);
+	k_sem_reset(&records_sem);
+	atomic_set(&records_count, 0);
+
+	ret = client_publish(10, MQTT_QOS_1_AT_LEAST_ONCE, data, sizeof(data));
+	zassert_equal(ret, 0, "Cannot publish (%d)", ret);
+
+	ret = client_publish(11, MQTT_QOS_2_EXACTLY_ONCE, data, sizeof(data));
+	zassert_equal(ret, 0, "Cannot publish (%d)", ret);
+
+	client_flush();
+
+	rec = broker_wait();
+	zassert_equal(rec->message_id, 10, "Invalid message");
+	rec = broker_wait();
+	zassert_equal(rec->message_id, 11, "Invalid message");
+
+	/* PUBREL sent by the event handler on PUBREC */
+	client_wait_until(atomic_get(&records_count) == 3);
+	zassert_equal(records[2].type, 0x60, "PUBREL not sent");
+
+	zassert_equal(client_ctx.internal.inflight_count, 2,
+		      "Invalid number of messages in flight");
+
+	mqtt_abort(&client_ctx);
+
+	atomic_set(&broker_acks, BROKER_ACK_ALL);
+	k_sem_reset(&records_sem);
+	atomic_set(&records_count, 0);
+
+	client_connect();
+
+	rec = broker_wait();
+	zassert_equal(rec->type, 0x30, "PUBLISH not sent again");
+	zassert_equal(rec->message_id, 10, "Invalid message");
+	zassert_true(rec->flags & 0x08, "DUP flag not set");
+
+	rec = broker_wait();
+	zassert_equal(rec->type, 0x60, "PUBREL not sent again");
+	zassert_equal(rec->message_id, 11, "Invalid message");
+
+	client_wait_until(client_ctx.internal.inflight_count == 0);
+}
+
+static void test_coalesce(void)
+{
+	struct broker_record *rec;
+	uint8_t data[] = "21.5";
+	int ret;
+
+	k_sem_reset(&records_sem);
+	atomic_set(&records_count, 0);
+
+	for (int i = 0; i < 3; i++) {
+		ret = client_publish(0, MQTT_QOS_0_AT_MOST_ONCE, data,
+				     sizeof(data));
+		zassert_equal(ret, 0, "Cannot publish (%d)", ret);
+	}
+
+	zassert_true(mqtt_keepalive_time_left(&client_ctx) <= COALESCE_DELAY,
+		     "Keep alive time does not account for waiting messages");
+
+	k_msleep(COALESCE_DELAY / 2);
+	zassert_equal(atomic_get(&records_count), 0, "Messages not coalesced");
+
+	client_flush();
+
+	for (int i = 0; i < 3; i++) {
+		rec = broker_wait();
+		zassert_equal(rec->type, 0x30, "Invalid packet");
+	}
+
+	/* Too big to wait, sent right away after the waiting message */
+	ret = client_publish(0, MQTT_QOS_0_AT_MOST_ONCE, data, sizeof(data));
+	zassert_equal(ret, 0, "Cannot publish (%d)", ret);
+
+	ret = client_publish(0, MQTT_QOS_0_AT_MOST_ONCE, payload_long,
+			     sizeof(payload_long));
+	zassert_equal(ret, 0, "Cannot publish (%d)", ret);
+
+	rec = broker_wait();
+	zassert_equal(rec->type, 0x30, "Invalid packet");
+	rec = broker_wait();
+	zassert_equal(rec->type, 0x30, "Invalid packet");
+}
+
+static void test_disconnect(void)
+{
+	int ret;
+
+	ret = mqtt_disconnect(&client_ctx);
+	zassert_equal(ret, 0, "Cannot disconnect (%d)", ret);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(mqtt_inflight,
+			 ztest_unit_test(test_setup),
+			 ztest_unit_test(test_window),
+			 ztest_unit_test(test_resend),
+			 ztest_unit_test(test_coalesce),
+			 ztest_unit_test(test_disconnect));
+
+	ztest_run_test_suite(mqtt_inflight);
+}
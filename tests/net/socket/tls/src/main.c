@@ -611,6 +611,93 @@ void test_v6_dtls_sendmsg(void)
 			  (struct sockaddr *)&server_addr, sizeof(server_addr));
 }
 
+static void test_session_connect(int s_sock, struct sockaddr_in *s_saddr,
+				 struct tls_handshake_stats *c_stats,
+				 struct tls_handshake_stats *s_stats)
+{
+	int cache = TLS_SESSION_CACHE_ENABLED;
+	struct sockaddr_in c_saddr;
+	struct sockaddr addr;
+	socklen_t addrlen = sizeof(addr);
+	socklen_t optlen;
+	int c_sock;
+	int new_sock;
+	int ret;
+
+	prepare_sock_tls_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, ANY_PORT,
+			    &c_sock, &c_saddr, IPPROTO_TLS_1_2);
+
+	test_config_psk(s_sock, c_sock);
+
+	ret = setsockopt(c_sock, SOL_TLS, TLS_SESSION_CACHE, &cache,
+			 sizeof(cache));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	spawn_client_connect_thread(c_sock, (struct sockaddr *)s_saddr);
+
+	test_accept(s_sock, &new_sock, &addr, &addrlen);
+
+	k_thread_join(&client_connect_thread, K_FOREVER);
+
+	optlen = sizeof(*c_stats);
+	ret = getsockopt(c_sock, SOL_TLS, TLS_HANDSHAKE_STATS, c_stats,
+			 &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+
+	optlen = sizeof(*s_stats);
+	ret = getsockopt(new_sock, SOL_TLS, TLS_HANDSHAKE_STATS, s_stats,
+			 &optlen);
+	zassert_equal(ret, 0, "getsockopt failed (%d)", errno);
+
+	test_close(c_sock);
+	test_close(new_sock);
+}
+
+void test_v4_session_resumption(void)
+{
+	struct tls_handshake_stats c_stats;
+	struct tls_handshake_stats s_stats;
+	int cache = TLS_SESSION_CACHE_ENABLED;
+	struct sockaddr_in s_saddr;
+	int s_sock;
+	int ret;
+
+	prepare_sock_tls_v4(CONFIG_NET_CONFIG_MY_IPV4_ADDR, SERVER_PORT,
+			    &s_sock, &s_saddr, IPPROTO_TLS_1_2);
+
+	ret = setsockopt(s_sock, SOL_TLS, TLS_SESSION_CACHE, &cache,
+			 sizeof(cache));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	/* Start without any stored session. */
+	ret = setsockopt(s_sock, SOL_TLS, TLS_SESSION_CACHE_PURGE, &cache,
+			 sizeof(cache));
+	zassert_equal(ret, 0, "setsockopt failed (%d)", errno);
+
+	test_bind(s_sock, (struct sockaddr *)&s_saddr, sizeof(s_saddr));
+	test_listen(s_sock);
+
+	/* Full handshake, the client stores the session ticket. */
+	test_session_connect(s_sock, &s_saddr, &c_stats, &s_stats);
+
+	zassert_equal(c_stats.count, 1, "Wrong client handshake count");
+	zassert_equal(s_stats.count, 1, "Wrong server handshake count");
+	zassert_false(c_stats.session_offered, "Session offered");
+	zassert_false(s_stats.session_resumed, "Session resumed");
+
+	/* Abbreviated handshake with the ticket. */
+	test_session_connect(s_sock, &s_saddr, &c_stats, &s_stats);
+
+	zassert_equal(c_stats.count, 1, "Wrong client handshake count");
+	zassert_equal(s_stats.count, 1, "Wrong server handshake count");
+	zassert_true(c_stats.session_offered, "Session not offered");
+	zassert_true(s_stats.session_resumed, "Session not resumed");
+
+	test_close(s_sock);
+
+	k_sleep(TCP_TEARDOWN_TIMEOUT);
+}
+
 void test_main(void)
 {
 	if (IS_ENABLED(CONFIG_NET_TC_THREAD_COOPERATIVE)) {
@@ -629,7 +716,8 @@ void test_main(void)
 		ztest_unit_test(test_v4_msg_trunc),
 		ztest_unit_test(test_v6_msg_trunc),
 		ztest_unit_test(test_v4_dtls_sendmsg),
-		ztest_unit_test(test_v6_dtls_sendmsg)
+		ztest_unit_test(test_v6_dtls_sendmsg),
+		ztest_unit_test(test_v4_session_resumption)
 		);
 
 	ztest_run_test_suite(socket_tls);
@@ -269,9 +269,34 @@ static void test_recv_two_msg(void)
 	test_recv_2(sizeof(frame1) + FRAME1_HDR_SIZE / 2);
 }
 
-int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg)
+/* Masked messages are sent in chunks, so collect the whole frame before
+ * checking it.
+ */
+static uint8_t sent_buf[MAX_HEADER_LEN + sizeof(lorem_ipsum)];
+static size_t sent_len;
+
+static size_t sent_header_len(void)
+{
+	size_t len = MIN_HEADER_LEN;
+
+	if ((sent_buf[1] & 0x7f) == 126) {
+		len += 2;
+	} else if ((sent_buf[1] & 0x7f) == 127) {
+		len += 8;
+	}
+
+	if (sent_buf[1] & BIT(7)) {
+		len += 4;
+	}
+
+	return len;
+}
+
+static void verify_sent_frame(size_t header_len, bool split_msg)
 {
 	static struct websocket_context ctx;
+	uint8_t *payload = &sent_buf[header_len];
+	size_t payload_len = sent_len - header_len;
 	uint32_t msg_type = -1;
 	uint64_t remaining = -1;
 	size_t split_len = 0, total_read = 0;
@@ -283,18 +308,15 @@ int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg)
 	ctx.tmp_buf_len = sizeof(temp_recv_buf);
 
 	/* Read first the header */
-	ret = test_recv_buf(msg->msg_iov[0].iov_base,
-			    msg->msg_iov[0].iov_len,
-			    &ctx, &msg_type, &remaining,
+	ret = test_recv_buf(sent_buf, header_len, &ctx, &msg_type, &remaining,
 			    recv_buf, sizeof(recv_buf));
 	zassert_equal(ret, -EAGAIN, "Msg header not found");
 
 	/* Then the first split if it is enabled */
 	if (split_msg) {
-		split_len = msg->msg_iov[1].iov_len / 2;
+		split_len = payload_len / 2;
 
-		ret = test_recv_buf(msg->msg_iov[1].iov_base,
-				    split_len,
+		ret = test_recv_buf(payload, split_len,
 				    &ctx, &msg_type, &remaining,
 				    recv_buf, sizeof(recv_buf));
 		zassert_true(ret > 0, "Cannot read data (%d)", ret);
@@ -304,9 +326,8 @@ int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg)
 
 	/* Then the data */
 	while (remaining > 0) {
-		ret = test_recv_buf((uint8_t *)msg->msg_iov[1].iov_base +
-								total_read,
-				    msg->msg_iov[1].iov_len - total_read,
+		ret = test_recv_buf(payload + total_read,
+				    payload_len - total_read,
 				    &ctx, &msg_type, &remaining,
 				    recv_buf, sizeof(recv_buf));
 		zassert_true(ret > 0, "Cannot read data (%d)", ret);
@@ -326,10 +347,35 @@ int verify_sent_and_received_msg(struct msghdr *msg, bool split_msg)
 		      "Msg body not valid, received %d instead of %zd",
 		      total_read, test_msg_len);
 
-	NET_DBG("Received %zd header and %zd body",
-		msg->msg_iov[0].iov_len, total_read);
+	NET_DBG("Received %zd header and %zd body", header_len, total_read);
+}
+
+int verify_sent_and_received_msg(struct msghdr *msg)
+{
+	size_t len = 0;
+	int i;
+
+	for (i = 0; i < msg->msg_iovlen; i++) {
+		zassert_true(sent_len + msg->msg_iov[i].iov_len <=
+			     sizeof(sent_buf), "Sent frame too long");
+
+		memcpy(&sent_buf[sent_len], msg->msg_iov[i].iov_base,
+		       msg->msg_iov[i].iov_len);
+		sent_len += msg->msg_iov[i].iov_len;
+		len += msg->msg_iov[i].iov_len;
+	}
+
+	if (sent_len >= MIN_HEADER_LEN &&
+	    sent_len == sent_header_len() + test_msg_len) {
+		/* Simulate a case where the payload is split to two. The
+		 * unit test does not set mask bit in this case.
+		 */
+		verify_sent_frame(sent_header_len(),
+				  !(sent_buf[1] & BIT(7)));
+		sent_len = 0;
+	}
 
-	return msg->msg_iov[0].iov_len + total_read;
+	return len;
 }
 
 static void test_send_and_recv_lorem_ipsum(void)
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <ztest.h>
+#include <zephyr/debug/profiler.h>
+
+#define SPIN_MS 500
+#define SPIN_FUNC_MAX_SIZE 0x100
+
+static volatile uint32_t spin_counter;
+
+static __noinline void hot_spin(uint32_t ms)
+{
+	int64_t end = k_uptime_get() + ms;
+
+	while (k_uptime_get() < end) {
+		spin_counter++;
+	}
+}
+
+struct hit_count {
+	uint32_t total;
+	uint32_t in_spin;
+};
+
+static void count_cb(unsigned int cpu, const uintptr_t *pcs, size_t depth,
+		     uint32_t count, void *user_data)
+{
+	struct hit_count *hits = user_data;
+	uintptr_t start = (uintptr_t)hot_spin & ~1UL;
+
+	ARG_UNUSED(cpu);
+
+	zassert_true(depth >= 1 && depth <= CONFIG_PROFILER_SAMPLING_STACK_DEPTH,
+		     "invalid stack depth %zu", depth);
+
+	hits->total += count;
+	if (pcs[0] >= start && pcs[0] < start + SPIN_FUNC_MAX_SIZE) {
+		hits->in_spin += count;
+	}
+}
+
+ZTEST(profiler, test_start_stop)
+{
+	zassert_equal(profiler_start(0), 0, "start failed");
+	zassert_true(profiler_is_running(), "profiler not running");
+	zassert_equal(profiler_start(0), -EALREADY, "double start accepted");
+	zassert_equal(profiler_stop(), 0, "stop failed");
+	zassert_equal(profiler_stop(), -EALREADY, "double stop accepted");
+	zassert_false(profiler_is_running(), "profiler still running");
+}
+
+ZTEST(profiler, test_hot_function)
+{
+	struct profiler_stats stats;
+	struct hit_count hits = { 0 };
+
+	zassert_equal(profiler_start(200), 0, "start failed");
+	hot_spin(SPIN_MS);
+	zassert_equal(profiler_stop(), 0, "stop failed");
+
+	zassert_equal(profiler_stats_get(0, &stats), 0, "stats failed");
+	zassert_true(stats.samples > 0, "no samples recorded");
+	zassert_equal(stats.dropped, 0, "samples dropped");
+
+	profiler_foreach_stack(count_cb, &hits);
+	zassert_equal(hits.total, stats.samples, "sample count mismatch");
+
+	/* k_uptime_get() is also on the path, leave some slack */
+	zassert_true(hits.in_spin * 4 >= hits.total,
+		     "hot function not found (%u of %u samples)",
+		     hits.in_spin, hits.total);
+}
+
+ZTEST(profiler, test_reset)
+{
+	struct profiler_stats stats;
+
+	zassert_equal(profiler_start(0), 0, "start failed");
+	hot_spin(100);
+	zassert_equal(profiler_stop(), 0, "stop failed");
+
+	profiler_reset();
+	zassert_equal(profiler_stats_get(0, &stats), 0, "stats failed");
+	zassert_equal(stats.samples, 0, "samples not reset");
+	zassert_equal(stats.stacks, 0, "stacks not reset");
+	zassert_equal(profiler_stats_get(CONFIG_MP_NUM_CPUS, &stats), -EINVAL,
+		      "invalid CPU accepted");
+}
+
+ZTEST_SUITE(profiler, NULL, NULL, NULL, NULL, NULL);
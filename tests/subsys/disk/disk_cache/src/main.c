@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <ztest.h>
+#include <zephyr/storage/disk_access.h>
+#include <string.h>
+
+#define DISK_NAME    "CACHE"
+#define SECTOR_SIZE  512
+#define SECTOR_COUNT 64
+#define IO_SECTORS   CONFIG_DISK_CACHE_IO_SECTORS
+
+static uint8_t disk_buf[SECTOR_COUNT * SECTOR_SIZE];
+static uint8_t buf[2 * IO_SECTORS * SECTOR_SIZE];
+static uint8_t expected[2 * IO_SECTORS * SECTOR_SIZE];
+static uint32_t read_calls;
+static uint32_t write_calls;
+static uint32_t trim_calls;
+
+static int test_disk_init(struct disk_info *disk)
+{
+	return 0;
+}
+
+static int test_disk_status(struct disk_info *disk)
+{
+	return DISK_STATUS_OK;
+}
+
+static int test_disk_read(struct disk_info *disk, uint8_t *data_buf,
+			  uint32_t sector, uint32_t count)
+{
+	if (sector + count > SECTOR_COUNT) {
+		return -EIO;
+	}
+
+	memcpy(data_buf, &disk_buf[sector * SECTOR_SIZE], count * SECTOR_SIZE);
+	read_calls++;
+
+	return 0;
+}
+
+static int test_disk_write(struct disk_info *disk, const uint8_t *data_buf,
+			   uint32_t sector, uint32_t count)
+{
+	if (sector + count > SECTOR_COUNT) {
+		return -EIO;
+	}
+
+	memcpy(&disk_buf[sector * SECTOR_SIZE], data_buf, count * SECTOR_SIZE);
+	write_calls++;
+
+	return 0;
+}
+
+static int test_disk_ioctl(struct disk_info *disk, uint8_t cmd, void *buff)
+{
+	switch (cmd) {
+	case DISK_IOCTL_CTRL_SYNC:
+		return 0;
+	case DISK_IOCTL_CTRL_TRIM:
+		trim_calls++;
+		return 0;
+	case DISK_IOCTL_GET_SECTOR_COUNT:
+		*(uint32_t *)buff = SECTOR_COUNT;
+		return 0;
+	case DISK_IOCTL_GET_SECTOR_SIZE:
+		*(uint32_t *)buff = SECTOR_SIZE;
+		return 0;
+	default:
+		return -EINVAL;
+	}
+}
+
+static const struct disk_operations test_disk_ops = {
+	.init = test_disk_init,
+	.status = test_disk_status,
+	.read = test_disk_read,
+	.write = test_disk_write,
+	.ioctl = test_disk_ioctl,
+};
+
+static struct disk_info test_disk = {
+	.name = DISK_NAME,
+	.ops = &test_disk_ops,
+};
+
+static void fill(uint8_t *data, uint32_t sector, uint32_t count, uint8_t seed)
+{
+	for (uint32_t i = 0; i < count * SECTOR_SIZE; i++) {
+		data[i] = (uint8_t)(seed + sector + i / SECTOR_SIZE);
+	}
+}
+
+static void *disk_cache_setup(void)
+{
+	zassert_equal(disk_access_register(&test_disk), 0, NULL);
+
+	return NULL;
+}
+
+static void disk_cache_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	/* Writes back and drops the cached sectors */
+	zassert_equal(disk_access_init(DISK_NAME), 0, NULL);
+	fill(disk_buf, 0, SECTOR_COUNT, 0);
+	zassert_equal(disk_access_cache_stats_reset(DISK_NAME), 0, NULL);
+	read_calls = 0;
+	write_calls = 0;
+	trim_calls = 0;
+}
+
+ZTEST(disk_cache, test_read_ahead)
+{
+	struct disk_cache_stats stats;
+
+	for (uint32_t sector = 0; sector < 4 * IO_SECTORS; sector++) {
+		zassert_equal(disk_access_read(DISK_NAME, buf, sector, 1), 0,
+			      NULL);
+		fill(expected, sector, 1, 0);
+		zassert_mem_equal(buf, expected, SECTOR_SIZE, NULL);
+	}
+
+	/* The first read is not sequential: two misses, then one read-ahead
+	 * every IO_SECTORS sectors.
+	 */
+	zassert_equal(read_calls, 2 + 4, "%u driver reads", read_calls);
+
+	zassert_equal(disk_access_cache_stats_get(DISK_NAME, &stats), 0, NULL);
+	zassert_equal(stats.misses, 2, NULL);
+	zassert_equal(stats.hits, 4 * IO_SECTORS - 2, NULL);
+}
+
+ZTEST(disk_cache, test_write_coalescing)
+{
+	struct disk_cache_stats stats;
+
+	for (uint32_t sector = 0; sector < IO_SECTORS; sector++) {
+		fill(buf, sector, 1, 0x80);
+		zassert_equal(disk_access_write(DISK_NAME, buf, sector, 1), 0,
+			      NULL);
+	}
+
+	zassert_equal(write_calls, 0, "written before sync");
+
+	/* Sectors not written back yet are read from the cache */
+	zassert_equal(disk_access_read(DISK_NAME, buf, 0, IO_SECTORS), 0,
+		      NULL);
+	fill(expected, 0, IO_SECTORS, 0x80);
+	zassert_mem_equal(buf, expected, IO_SECTORS * SECTOR_SIZE, NULL);
+
+	zassert_equal(disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL),
+		      0, NULL);
+	zassert_equal(write_calls, 1, "%u driver writes", write_calls);
+	zassert_mem_equal(disk_buf, expected, IO_SECTORS * SECTOR_SIZE, NULL);
+
+	zassert_equal(disk_access_cache_stats_get(DISK_NAME, &stats), 0, NULL);
+	zassert_equal(stats.write_backs, 1, NULL);
+	zassert_equal(stats.written_back, IO_SECTORS, NULL);
+}
+
+ZTEST(disk_cache, test_eviction)
+{
+	/* More dirty sectors than the cache holds */
+	for (uint32_t sector = 0; sector < SECTOR_COUNT; sector += 2) {
+		fill(buf, sector, 1, 0x40);
+		zassert_equal(disk_access_write(DISK_NAME, buf, sector, 1), 0,
+			      NULL);
+	}
+
+	zassert_true(write_calls > 0, "nothing written back");
+
+	for (uint32_t sector = 0; sector < SECTOR_COUNT; sector++) {
+		zassert_equal(disk_access_read(DISK_NAME, buf, sector, 1), 0,
+			      NULL);
+		fill(expected, sector, 1, (sector % 2) ? 0 : 0x40);
+		zassert_mem_equal(buf, expected, SECTOR_SIZE, "sector %u",
+				  sector);
+	}
+}
+
+ZTEST(disk_cache, test_large_requests)
+{
+	uint32_t count = 2 * IO_SECTORS;
+
+	/* A dirty sector in the range of a large read */
+	fill(buf, 1, 1, 0x20);
+	zassert_equal(disk_access_write(DISK_NAME, buf, 1, 1), 0, NULL);
+
+	zassert_equal(disk_access_read(DISK_NAME, buf, 0, count), 0, NULL);
+	zassert_equal(read_calls, 1, NULL);
+	fill(expected, 0, count, 0);
+	fill(&expected[SECTOR_SIZE], 1, 1, 0x20);
+	zassert_mem_equal(buf, expected, count * SECTOR_SIZE, NULL);
+
+	/* Large writes are written through and update the cached sector */
+	fill(buf, 0, count, 0x10);
+	zassert_equal(disk_access_write(DISK_NAME, buf, 0, count), 0, NULL);
+	zassert_equal(write_calls, 1, NULL);
+	zassert_mem_equal(disk_buf, buf, count * SECTOR_SIZE, NULL);
+
+	zassert_equal(disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL),
+		      0, NULL);
+	zassert_equal(write_calls, 1, "clean sector written back");
+
+	zassert_equal(disk_access_read(DISK_NAME, buf, 1, 1), 0, NULL);
+	zassert_mem_equal(buf, &disk_buf[SECTOR_SIZE], SECTOR_SIZE, NULL);
+}
+
+ZTEST(disk_cache, test_trim)
+{
+	uint32_t range[2] = { 1, 2 };
+
+	for (uint32_t sector = 0; sector < 4; sector++) {
+		fill(buf, sector, 1, 0x30);
+		zassert_equal(disk_access_write(DISK_NAME, buf, sector, 1), 0,
+			      NULL);
+	}
+
+	/* Trimmed dirty sectors are dropped, the trim reaches the driver */
+	zassert_equal(disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_TRIM,
+					range), 0, NULL);
+	zassert_equal(trim_calls, 1, NULL);
+
+	zassert_equal(disk_access_ioctl(DISK_NAME, DISK_IOCTL_CTRL_SYNC, NULL),
+		      0, NULL);
+	zassert_equal(write_calls, 2, "%u driver writes", write_calls);
+
+	fill(expected, 0, 4, 0);
+	fill(expected, 0, 1, 0x30);
+	fill(&expected[3 * SECTOR_SIZE], 3, 1, 0x30);
+	zassert_mem_equal(disk_buf, expected, 4 * SECTOR_SIZE, NULL);
+}
+
+ZTEST_SUITE(disk_cache, NULL, disk_cache_setup, disk_cache_before, NULL,
+	    NULL);
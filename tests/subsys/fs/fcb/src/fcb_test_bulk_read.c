@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "fcb_test.h"
+
+#define BULK_ENTRIES 40
+
+struct bulk_arg {
+	int cnt;
+	int unread;
+};
+
+static void fcb_test_bulk_fill(struct fcb *fcb, struct fcb_entry *areas)
+{
+	uint8_t test_data[128];
+	struct fcb_entry loc;
+	int len;
+	int rc;
+	int i;
+
+	for (i = 0; i < BULK_ENTRIES; i++) {
+		/* Mix of small entries and ones larger than the read buffer */
+		len = (i % 8 == 7) ? sizeof(test_data) : 1 + i;
+		for (int j = 0; j < len; j++) {
+			test_data[j] = fcb_test_append_data(len, j);
+		}
+
+		rc = fcb_append(fcb, len, &loc);
+		zassert_true(rc == 0, "fcb_append call failure");
+
+		rc = flash_area_write(fcb->fap, FCB_ENTRY_FA_DATA_OFF(loc),
+				      test_data, len);
+		zassert_true(rc == 0, "flash_area_write call failure");
+
+		rc = fcb_append_finish(fcb, &loc);
+		zassert_true(rc == 0, "fcb_append_finish call failure");
+
+		areas[i] = loc;
+
+		/* Spread the entries over the sectors */
+		if ((i % 10 == 9) && (i < BULK_ENTRIES - 1)) {
+			rc = fcb_append_to_scratch(fcb);
+			zassert_true(rc == 0, "fcb_append_to_scratch failure");
+		}
+	}
+}
+
+static int fcb_test_bulk_cb(struct fcb_entry_ctx *entry_ctx,
+			    const uint8_t *data, void *arg)
+{
+	struct bulk_arg *ba = (struct bulk_arg *)arg;
+	uint8_t test_data[128];
+	uint16_t len = entry_ctx->loc.fe_data_len;
+	int rc;
+
+	if (data == NULL) {
+		rc = flash_area_read(entry_ctx->fap,
+				     FCB_ENTRY_FA_DATA_OFF(entry_ctx->loc),
+				     test_data, len);
+		zassert_true(rc == 0, "read call failure");
+		data = test_data;
+		ba->unread++;
+	}
+
+	for (int i = 0; i < len; i++) {
+		zassert_true(data[i] == fcb_test_append_data(len, i),
+			     "fcb_bulk_read data misrepresentation");
+	}
+	ba->cnt++;
+
+	return 0;
+}
+
+void test_fcb_bulk_read(void)
+{
+	struct fcb_entry areas[BULK_ENTRIES];
+	struct bulk_arg ba = { 0 };
+	struct fcb_entry loc;
+	uint8_t buf[64];
+	struct fcb *fcb;
+	int rc;
+
+	fcb = &test_fcb;
+
+	loc.fe_sector = NULL;
+	rc = fcb_bulk_read(fcb, &loc, buf, sizeof(buf), fcb_test_bulk_cb, &ba);
+	zassert_true(rc == -ENOTSUP, "fcb_bulk_read of empty fcb");
+
+	fcb_test_bulk_fill(fcb, areas);
+
+	loc.fe_sector = NULL;
+	do {
+		rc = fcb_bulk_read(fcb, &loc, buf, sizeof(buf),
+				   fcb_test_bulk_cb, &ba);
+	} while (rc == 0);
+	zassert_true(rc == -ENOTSUP, "fcb_bulk_read call failure");
+	zassert_true(ba.cnt == BULK_ENTRIES, "fcb_bulk_read missed entries");
+	zassert_true(ba.unread == BULK_ENTRIES / 8,
+		     "fcb_bulk_read large entries not passed unread");
+	zassert_true(loc.fe_sector == areas[BULK_ENTRIES - 1].fe_sector &&
+		     loc.fe_elem_off == areas[BULK_ENTRIES - 1].fe_elem_off,
+		     "fcb_bulk_read did not end at last entry");
+}
+
+void test_fcb_getnth(void)
+{
+	struct fcb_entry areas[BULK_ENTRIES];
+	struct fcb_entry loc;
+	struct fcb *fcb;
+	int rc;
+
+	fcb = &test_fcb;
+
+	rc = fcb_getnth(fcb, 0, &loc);
+	zassert_true(rc == -ENOENT, "fcb_getnth of empty fcb");
+
+	fcb_test_bulk_fill(fcb, areas);
+
+	for (int i = 0; i < BULK_ENTRIES; i++) {
+		rc = fcb_getnth(fcb, i, &loc);
+		zassert_true(rc == 0, "fcb_getnth call failure");
+		zassert_true(areas[i].fe_sector == loc.fe_sector &&
+			     areas[i].fe_data_off == loc.fe_data_off &&
+			     areas[i].fe_data_len == loc.fe_data_len,
+			     "fcb_getnth: fetched wrong n-th location");
+	}
+
+	rc = fcb_getnth(fcb, BULK_ENTRIES, &loc);
+	zassert_true(rc == -ENOENT, "fcb_getnth past last entry");
+
+	/* Entries of the oldest sector are gone after rotate */
+	rc = fcb_rotate(fcb);
+	zassert_true(rc == 0, "fcb_rotate call failure");
+
+	rc = fcb_getnth(fcb, 0, &loc);
+	zassert_true(rc == 0, "fcb_getnth call failure");
+	zassert_true(areas[10].fe_sector == loc.fe_sector &&
+		     areas[10].fe_data_off == loc.fe_data_off,
+		     "fcb_getnth: wrong first entry after rotate");
+
+	rc = fcb_getnth(fcb, BULK_ENTRIES - 10, &loc);
+	zassert_true(rc == -ENOENT, "fcb_getnth past last entry");
+}
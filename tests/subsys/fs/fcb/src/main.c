@@ -45,6 +45,9 @@ struct flash_sector test_fcb_sector[] = {
 	}
 };
 
+#ifdef CONFIG_FCB_INDEX
+static struct fcb_sector_index test_fcb_index[ARRAY_SIZE(test_fcb_sector)];
+#endif
 
 void test_fcb_wipe(void)
 {
@@ -119,6 +122,9 @@ void fcb_tc_pretest(int sectors)
 	fcb->f_erase_value = fcb_test_erase_value;
 	fcb->f_sector_cnt = sectors;
 	fcb->f_sectors = test_fcb_sector; /* XXX */
+#ifdef CONFIG_FCB_INDEX
+	fcb->f_index = test_fcb_index;
+#endif
 
 	rc = 0;
 	rc = fcb_init(TEST_FCB_FLASH_AREA_ID, fcb);
@@ -178,6 +184,8 @@ void test_fcb_reset(void);
 void test_fcb_rotate(void);
 void test_fcb_multi_scratch(void);
 void test_fcb_last_of_n(void);
+void test_fcb_bulk_read(void);
+void test_fcb_getnth(void);
 
 void test_main(void)
 {
@@ -208,6 +216,12 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(test_fcb_last_of_n,
 							fcb_pretest_4_sectors,
 							teardown_nothing),
+			 ztest_unit_test_setup_teardown(test_fcb_bulk_read,
+							fcb_pretest_4_sectors,
+							teardown_nothing),
+			 ztest_unit_test_setup_teardown(test_fcb_getnth,
+							fcb_pretest_4_sectors,
+							teardown_nothing),
 			 /* Finally, run one that leaves behind a
 			  * flash.bin file without any random content */
 			 ztest_unit_test_setup_teardown(test_fcb_reset,
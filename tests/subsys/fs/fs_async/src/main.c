@@ -0,0 +1,286 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <ztest.h>
+#include <zephyr/fs/fs.h>
+#include <zephyr/fs/fs_sys.h>
+#include <zephyr/fs/fs_async.h>
+#include <string.h>
+
+#define TEST_FS_TYPE FS_TYPE_EXTERNAL_BASE
+#define FILE_SIZE    64
+#define NUM_REQS     16
+
+/* Minimal RAM file system with two files, /ram/a and /ram/b */
+struct ram_file {
+	const char *name;
+	uint8_t data[FILE_SIZE];
+	size_t len;
+	size_t pos;
+};
+
+static struct ram_file ram_files[] = {
+	{ .name = "/ram/a" },
+	{ .name = "/ram/b" },
+};
+static atomic_t sync_calls;
+/* Calls into the file system running at once, and the highest count seen */
+static atomic_t fs_calls;
+static atomic_t fs_calls_max;
+
+static void fs_call_enter(void)
+{
+	atomic_val_t calls = atomic_inc(&fs_calls) + 1;
+	atomic_val_t max;
+
+	do {
+		max = atomic_get(&fs_calls_max);
+	} while ((calls > max) && !atomic_cas(&fs_calls_max, max, calls));
+}
+
+static void fs_call_exit(void)
+{
+	atomic_dec(&fs_calls);
+}
+
+static int ram_open(struct fs_file_t *zfp, const char *name, fs_mode_t flags)
+{
+	for (int i = 0; i < ARRAY_SIZE(ram_files); i++) {
+		if (strcmp(name, ram_files[i].name) == 0) {
+			ram_files[i].len = 0;
+			ram_files[i].pos = 0;
+			zfp->filep = &ram_files[i];
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+
+static int ram_close(struct fs_file_t *zfp)
+{
+	return 0;
+}
+
+static ssize_t ram_read(struct fs_file_t *zfp, void *ptr, size_t size)
+{
+	struct ram_file *f = zfp->filep;
+
+	size = MIN(size, f->len - f->pos);
+	memcpy(ptr, &f->data[f->pos], size);
+	f->pos += size;
+
+	return size;
+}
+
+static ssize_t ram_write(struct fs_file_t *zfp, const void *ptr, size_t size)
+{
+	struct ram_file *f = zfp->filep;
+
+	if (f->pos + size > FILE_SIZE) {
+		return -ENOSPC;
+	}
+
+	fs_call_enter();
+	memcpy(&f->data[f->pos], ptr, size);
+	f->pos += size;
+	f->len = MAX(f->len, f->pos);
+
+	/* Let the other worker run, if any */
+	k_yield();
+	fs_call_exit();
+
+	return size;
+}
+
+static int ram_lseek(struct fs_file_t *zfp, off_t off, int whence)
+{
+	struct ram_file *f = zfp->filep;
+
+	if ((whence != FS_SEEK_SET) || (off > f->len)) {
+		return -EINVAL;
+	}
+
+	f->pos = off;
+
+	return 0;
+}
+
+static int ram_sync(struct fs_file_t *zfp)
+{
+	fs_call_enter();
+	atomic_inc(&sync_calls);
+	k_msleep(1);
+	fs_call_exit();
+
+	return 0;
+}
+
+static int ram_mount(struct fs_mount_t *mountp)
+{
+	return 0;
+}
+
+static const struct fs_file_system_t ram_fs = {
+	.open = ram_open,
+	.close = ram_close,
+	.read = ram_read,
+	.write = ram_write,
+	.lseek = ram_lseek,
+	.sync = ram_sync,
+	.mount = ram_mount,
+};
+
+static struct fs_mount_t ram_mnt = {
+	.type = TEST_FS_TYPE,
+	.mnt_point = "/ram",
+};
+
+static struct fs_file_t file_a;
+static struct fs_file_t file_b;
+static struct fs_async_req reqs[NUM_REQS];
+static K_SEM_DEFINE(done_sem, 0, NUM_REQS);
+
+static void done_cb(struct fs_async_req *req)
+{
+	k_sem_give(&done_sem);
+}
+
+static void wait_done(int count)
+{
+	for (int i = 0; i < count; i++) {
+		zassert_equal(k_sem_take(&done_sem, K_SECONDS(1)), 0,
+			      "request %d not completed", i);
+	}
+}
+
+static void *fs_async_setup(void)
+{
+	zassert_equal(fs_register(TEST_FS_TYPE, &ram_fs), 0, NULL);
+	zassert_equal(fs_mount(&ram_mnt), 0, NULL);
+
+	return NULL;
+}
+
+static void fs_async_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	fs_file_t_init(&file_a);
+	fs_file_t_init(&file_b);
+	zassert_equal(fs_open(&file_a, "/ram/a", FS_O_RDWR), 0, NULL);
+	zassert_equal(fs_open(&file_b, "/ram/b", FS_O_RDWR), 0, NULL);
+
+	memset(reqs, 0, sizeof(reqs));
+	atomic_set(&sync_calls, 0);
+	atomic_set(&fs_calls_max, 0);
+	k_sem_reset(&done_sem);
+}
+
+static void fs_async_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	fs_close(&file_a);
+	fs_close(&file_b);
+}
+
+ZTEST(fs_async, test_per_file_order)
+{
+	static uint8_t values[NUM_REQS];
+
+	for (int i = 0; i < NUM_REQS; i++) {
+		values[i] = i;
+		reqs[i].cb = done_cb;
+		zassert_equal(fs_async_write(&reqs[i], (i % 2) ? &file_b : &file_a,
+					     &values[i], 1), 0, NULL);
+	}
+
+	wait_done(NUM_REQS);
+
+	for (int i = 0; i < NUM_REQS; i++) {
+		zassert_equal(reqs[i].result, 1, NULL);
+	}
+
+	zassert_equal(ram_files[0].len, NUM_REQS / 2, NULL);
+	zassert_equal(ram_files[1].len, NUM_REQS / 2, NULL);
+	for (int i = 0; i < NUM_REQS / 2; i++) {
+		zassert_equal(ram_files[0].data[i], 2 * i, NULL);
+		zassert_equal(ram_files[1].data[i], 2 * i + 1, NULL);
+	}
+
+	/* Both files are on the same mount point */
+	zassert_equal(atomic_get(&fs_calls_max), 1, "%d concurrent calls",
+		      (int)atomic_get(&fs_calls_max));
+}
+
+ZTEST(fs_async, test_sync_merge)
+{
+	static const char data[] = "abcd";
+	struct k_poll_signal signals[5];
+	struct k_poll_event event;
+	unsigned int signaled;
+	int result;
+
+	for (int i = 0; i < ARRAY_SIZE(signals); i++) {
+		k_poll_signal_init(&signals[i]);
+		reqs[i].signal = &signals[i];
+	}
+
+	/* Queued before the workers run, so they form a single batch */
+	zassert_equal(fs_async_write(&reqs[0], &file_a, data, 2), 0, NULL);
+	zassert_equal(fs_async_sync(&reqs[1], &file_a), 0, NULL);
+	zassert_equal(fs_async_write(&reqs[2], &file_a, &data[2], 2), 0, NULL);
+	zassert_equal(fs_async_sync(&reqs[3], &file_a), 0, NULL);
+	zassert_equal(fs_async_sync(&reqs[4], &file_a), 0, NULL);
+
+	for (int i = 0; i < ARRAY_SIZE(signals); i++) {
+		k_poll_event_init(&event, K_POLL_TYPE_SIGNAL,
+				  K_POLL_MODE_NOTIFY_ONLY, &signals[i]);
+		zassert_equal(k_poll(&event, 1, K_SECONDS(1)), 0, NULL);
+		k_poll_signal_check(&signals[i], &signaled, &result);
+		zassert_true(signaled, NULL);
+		zassert_equal(result,
+			      (reqs[i].op == FS_ASYNC_WRITE) ? 2 : 0,
+			      "request %d", i);
+	}
+
+	zassert_equal(atomic_get(&sync_calls), 1, "%d syncs",
+		      (int)atomic_get(&sync_calls));
+	zassert_mem_equal(ram_files[0].data, data, 4, NULL);
+}
+
+ZTEST(fs_async, test_read)
+{
+	static const char data[] = "0123456789";
+	static char buf[sizeof(data)];
+
+	reqs[0].cb = done_cb;
+	reqs[1].cb = done_cb;
+	zassert_equal(fs_async_write(&reqs[0], &file_b, data, sizeof(data)), 0,
+		      NULL);
+	wait_done(1);
+
+	zassert_equal(fs_seek(&file_b, 0, FS_SEEK_SET), 0, NULL);
+	zassert_equal(fs_async_read(&reqs[1], &file_b, buf, sizeof(buf)), 0,
+		      NULL);
+	wait_done(1);
+
+	zassert_equal(reqs[1].result, sizeof(data), NULL);
+	zassert_mem_equal(buf, data, sizeof(data), NULL);
+}
+
+ZTEST(fs_async, test_not_open)
+{
+	struct fs_file_t zfp;
+
+	fs_file_t_init(&zfp);
+	zassert_equal(fs_async_sync(&reqs[0], &zfp), -EBADF, NULL);
+}
+
+ZTEST_SUITE(fs_async, NULL, fs_async_setup, fs_async_before, fs_async_after,
+	    NULL);
@@ -23,6 +23,8 @@ void test_main(void)
 			 ztest_unit_test(test_lfs_basic),
 			 ztest_unit_test(test_lfs_dirops),
 			 ztest_unit_test(test_lfs_perf),
+			 ztest_unit_test(test_lfs_alloc_hint),
+			 ztest_unit_test(test_lfs_alloc_hint_persist),
 			 ztest_unit_test(test_fs_open_flags_lfs),
 			 ztest_unit_test(test_fs_mount_flags)
 			 );
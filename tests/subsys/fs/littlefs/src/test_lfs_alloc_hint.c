@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2022 The Zephyr Project Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Tests of the block allocation map */
+
+#include <stdio.h>
+#include <string.h>
+#include <ztest.h>
+#include "testfs_tests.h"
+#include "testfs_lfs.h"
+#include <zephyr/fs/littlefs.h>
+#include <zephyr/storage/flash_map.h>
+
+#define NUM_FILES 4
+#define FILE_SIZE 1024
+#define NUM_ROUNDS 8
+
+/* Time given to the work queue to build the map */
+#define MAP_BUILD_TIME K_MSEC(100)
+
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT
+
+static void file_path(struct testfs_path *pp, const struct fs_mount_t *mp,
+		      int idx)
+{
+	char name[8];
+
+	snprintf(name, sizeof(name), "f%d", idx);
+	testfs_path_init(pp, mp, name, TESTFS_PATH_END);
+}
+
+static void write_file(const struct fs_mount_t *mp, int idx)
+{
+	struct testfs_path path;
+	struct fs_file_t file;
+
+	fs_file_t_init(&file);
+	file_path(&path, mp, idx);
+
+	zassert_equal(fs_open(&file, path.path, FS_O_CREATE | FS_O_RDWR), 0,
+		      "open %s failed", path.path);
+	zassert_equal(testfs_write_incrementing(&file, idx, FILE_SIZE),
+		      FILE_SIZE, "write %s failed", path.path);
+	zassert_equal(fs_close(&file), 0, "close %s failed", path.path);
+}
+
+static void verify_file(const struct fs_mount_t *mp, int idx)
+{
+	struct testfs_path path;
+	struct fs_file_t file;
+
+	fs_file_t_init(&file);
+	file_path(&path, mp, idx);
+
+	zassert_equal(fs_open(&file, path.path, FS_O_READ), 0,
+		      "open %s failed", path.path);
+	zassert_equal(testfs_verify_incrementing(&file, idx, FILE_SIZE),
+		      FILE_SIZE, "verify %s failed", path.path);
+	zassert_equal(fs_close(&file), 0, "close %s failed", path.path);
+}
+
+static void stats_get(struct fs_mount_t *mp,
+		      struct fs_littlefs_alloc_stats *stats)
+{
+	zassert_equal(fs_littlefs_alloc_stats_get(mp->fs_data, stats), 0,
+		      "stats get failed");
+
+	TC_PRINT("%s: scans %u fills %u rebuilds %u\n",
+		 mp->mnt_point, stats->lookahead_scans, stats->hint_fills,
+		 stats->map_rebuilds);
+}
+
+static void unlink_file(const struct fs_mount_t *mp, int idx)
+{
+	struct testfs_path path;
+
+	file_path(&path, mp, idx);
+	zassert_equal(fs_unlink(path.path), 0, "unlink %s failed", path.path);
+}
+
+void test_lfs_alloc_hint(void)
+{
+	struct fs_mount_t *mp = &testfs_small_mnt;
+	struct fs_littlefs_alloc_stats stats;
+
+	zassert_equal(testfs_lfs_wipe_partition(mp), TC_PASS,
+		      "failed to wipe partition");
+
+	/* Nothing is built from the file system calls themselves */
+	zassert_equal(fs_mount(mp), 0, "mount failed");
+	write_file(mp, 0);
+	stats_get(mp, &stats);
+	zassert_equal(stats.hint_fills, 0, "map used before build");
+
+	/* Once idle, the map is built and fills the lookahead windows.
+	 * Deleted files leave the map full of stale blocks, which gets it
+	 * rebuilt again.
+	 */
+	for (int r = 0; r < NUM_ROUNDS; r++) {
+		k_sleep(MAP_BUILD_TIME);
+		for (int i = 1; i < NUM_FILES; i++) {
+			write_file(mp, i);
+		}
+		for (int i = 1; i < NUM_FILES; i++) {
+			verify_file(mp, i);
+			unlink_file(mp, i);
+		}
+	}
+	stats_get(mp, &stats);
+	zassert_true(stats.map_rebuilds > 0, "map not built");
+	zassert_true(stats.hint_fills > 0, "map not used");
+	zassert_equal(fs_unmount(mp), 0, "unmount failed");
+
+	zassert_equal(fs_littlefs_alloc_stats_get(mp->fs_data, &stats),
+		      -EINVAL, "stats of unmounted file system");
+
+	/* The volume is an ordinary littlefs volume */
+	zassert_equal(fs_mount(mp), 0, "remount failed");
+	verify_file(mp, 0);
+	zassert_equal(fs_unmount(mp), 0, "unmount failed");
+}
+
+#else /* CONFIG_FS_LITTLEFS_ALLOC_HINT */
+
+void test_lfs_alloc_hint(void)
+{
+	ztest_test_skip();
+}
+
+#endif /* CONFIG_FS_LITTLEFS_ALLOC_HINT */
+
+#ifdef CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST
+
+void test_lfs_alloc_hint_persist(void)
+{
+	struct fs_mount_t *mp = &testfs_small_mnt;
+	struct fs_littlefs *fs = mp->fs_data;
+	/* The medium partition is only used by the custom configuration */
+	struct fs_mount_t map_mnt = {
+		.storage_dev = (void *)FLASH_AREA_ID(medium),
+		.mnt_point = "/map",
+	};
+	struct fs_littlefs_alloc_stats stats;
+
+	zassert_equal(testfs_lfs_wipe_partition(mp), TC_PASS,
+		      "failed to wipe partition");
+	zassert_equal(testfs_lfs_wipe_partition(&map_mnt), TC_PASS,
+		      "failed to wipe map partition");
+
+	fs->alloc_hint_area_id = FLASH_AREA_ID(medium);
+	fs->alloc_hint_area_set = true;
+
+	/* Without a stored map, the map is built in RAM */
+	zassert_equal(fs_mount(mp), 0, "mount failed");
+	for (int i = 0; i < NUM_FILES; i++) {
+		write_file(mp, i);
+	}
+	stats_get(mp, &stats);
+	zassert_false(stats.hint_loaded, "map loaded from wiped partition");
+	zassert_equal(fs_littlefs_alloc_hint_save(fs), 0, "save failed");
+	zassert_equal(fs_unmount(mp), 0, "unmount failed");
+
+	zassert_equal(fs_littlefs_alloc_hint_save(fs), -EINVAL,
+		      "save of unmounted file system");
+
+	/* The stored map is used without traversal */
+	zassert_equal(fs_mount(mp), 0, "remount failed");
+	for (int i = 0; i < NUM_FILES; i++) {
+		verify_file(mp, i);
+	}
+	for (int r = 0; r < NUM_ROUNDS; r++) {
+		unlink_file(mp, 1);
+		write_file(mp, 1);
+	}
+	stats_get(mp, &stats);
+	zassert_true(stats.hint_loaded, "map not loaded");
+	zassert_true(stats.hint_fills > 0, "map not used");
+	zassert_equal(fs_unmount(mp), 0, "unmount failed");
+
+	/* A map of another file system is not used */
+	zassert_equal(testfs_lfs_wipe_partition(mp), TC_PASS,
+		      "failed to wipe partition");
+	zassert_equal(fs_mount(mp), 0, "mount after wipe failed");
+	stats_get(mp, &stats);
+	zassert_false(stats.hint_loaded, "map of wiped file system loaded");
+	zassert_equal(fs_unmount(mp), 0, "unmount failed");
+
+	fs->alloc_hint_area_set = false;
+}
+
+#else /* CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST */
+
+void test_lfs_alloc_hint_persist(void)
+{
+	ztest_test_skip();
+}
+
+#endif /* CONFIG_FS_LITTLEFS_ALLOC_HINT_PERSIST */
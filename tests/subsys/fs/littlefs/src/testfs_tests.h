@@ -24,6 +24,10 @@ void test_lfs_dirops(void);
 /* Tests in test_lfs_perf */
 void test_lfs_perf(void);
 
+/* Tests in test_lfs_alloc_hint */
+void test_lfs_alloc_hint(void);
+void test_lfs_alloc_hint_persist(void);
+
 /* Test fs_open flags */
 void test_fs_open_flags_lfs(void);
 
@@ -840,6 +840,183 @@ void test_nvs_cache_gc(void)
 #endif
 }
 
+/*
+ * Test that the sector summary stored after gc restores the lookup cache on
+ * nvs_mount().
+ */
+void test_nvs_sector_summary(void)
+{
+#ifdef CONFIG_NVS_SECTOR_SUMMARY
+	int err;
+	bool found = false;
+	struct nvs_ate ate;
+	off_t sector_offset;
+	uint32_t addr;
+	uint32_t cache[CONFIG_NVS_LOOKUP_CACHE_SIZE];
+	const uint16_t max_id = 10;
+
+	fs.sector_count = 3;
+	err = nvs_mount(&fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	/* Trigger gc */
+	write_content(max_id, 0, 51, &fs);
+
+	/* Look for the summary in the write sector */
+	sector_offset = fs.offset + (fs.ate_wra >> ADDR_SECT_SHIFT) * fs.sector_size;
+	for (addr = fs.sector_size - 2 * sizeof(ate);
+	     addr > (fs.ate_wra & ADDR_OFFS_MASK); addr -= sizeof(ate)) {
+		err = flash_read(flash_dev, sector_offset + addr, &ate, sizeof(ate));
+		zassert_true(err == 0, "flash_read failed: %d", err);
+		if (ate.id == 0xFFFF && ate.part == NVS_SECTOR_SUMMARY_PART) {
+			found = true;
+			break;
+		}
+	}
+	zassert_true(found, "no sector summary stored after gc");
+
+	/* Entries written after the summary are added to the cache */
+	write_content(max_id, 51, 55, &fs);
+
+	memcpy(cache, fs.lookup_cache, sizeof(cache));
+	memset(fs.lookup_cache, 0xAA, sizeof(fs.lookup_cache));
+
+	err = nvs_mount(&fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	zassert_mem_equal(cache, fs.lookup_cache, sizeof(cache),
+			  "invalid cache content after restart");
+	check_content(max_id, &fs);
+#endif
+}
+
+/*
+ * Test that gc is done in the background once the free space of the write
+ * sector is below the threshold.
+ */
+void test_nvs_background_gc(void)
+{
+#ifdef CONFIG_NVS_BACKGROUND_GC
+	int err;
+	uint16_t i = 0;
+	uint32_t sector;
+	const uint16_t max_id = 10;
+	const uint32_t threshold =
+		fs.sector_size * CONFIG_NVS_BACKGROUND_GC_THRESHOLD / 100U;
+
+	fs.sector_count = 3;
+	err = nvs_mount(&fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	sector = fs.ate_wra >> ADDR_SECT_SHIFT;
+
+	while ((i < max_id) || (fs.ate_wra - fs.data_wra >= threshold)) {
+		write_content(max_id, i, i + 1, &fs);
+		i++;
+	}
+
+	/* The test thread is cooperative, the work queue did not run yet */
+	zassert_equal(fs.ate_wra >> ADDR_SECT_SHIFT, sector,
+		      "unexpected write sector");
+
+	k_msleep(10);
+
+	zassert_not_equal(fs.ate_wra >> ADDR_SECT_SHIFT, sector,
+			  "background gc not done");
+	zassert_true(fs.ate_wra - fs.data_wra >= threshold,
+		     "no space reclaimed by background gc");
+	check_content(max_id, &fs);
+
+	err = nvs_mount(&fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+	check_content(max_id, &fs);
+#endif
+}
+
+/*
+ * Test that the entries written by nvs_write_multi() are only stored once the
+ * whole update is written.
+ */
+void test_nvs_write_multi(void)
+{
+#ifdef CONFIG_NVS_WRITE_MULTI
+	int err;
+	ssize_t len;
+	char rd_buf[8];
+	uint32_t *flash_write_stat;
+	uint32_t *flash_max_write_calls;
+	uint32_t write_calls;
+	const struct nvs_entry first[] = {
+		{ .id = 1, .data = "bb", .len = 2 },
+		{ .id = 2, .data = "ccc", .len = 3 },
+		{ .id = 3, .data = "g", .len = 1 },
+	};
+	const struct nvs_entry second[] = {
+		{ .id = 1, .data = "dd", .len = 2 },
+		{ .id = 2, .data = "eee", .len = 3 },
+		{ .id = 3, .data = "h", .len = 1 },
+	};
+	const struct nvs_entry third[] = {
+		{ .id = 1, .data = "x", .len = 1 },
+		{ .id = 3, .data = NULL, .len = 0 },
+	};
+
+	err = nvs_mount(&fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	len = nvs_write(&fs, 1, "a", 1);
+	zassert_equal(len, 1, "nvs_write failed: %d", len);
+
+	stats_walk(sim_thresholds, flash_sim_max_write_calls_find,
+		   &flash_max_write_calls);
+	stats_walk(sim_stats, flash_sim_write_calls_find, &flash_write_stat);
+
+	*flash_write_stat = 0;
+	err = nvs_write_multi(&fs, first, ARRAY_SIZE(first));
+	zassert_true(err == 0, "nvs_write_multi failed: %d", err);
+	write_calls = *flash_write_stat;
+
+	/* Same data, nothing is written */
+	*flash_write_stat = 0;
+	err = nvs_write_multi(&fs, first, ARRAY_SIZE(first));
+	zassert_true(err == 0, "nvs_write_multi failed: %d", err);
+	zassert_equal(*flash_write_stat, 0, "unchanged entries written");
+
+	/* Lose the last write of an update of the same size: the commit */
+	*flash_max_write_calls = write_calls;
+	*flash_write_stat = 0;
+	err = nvs_write_multi(&fs, second, ARRAY_SIZE(second));
+	zassert_true(err == 0, "nvs_write_multi failed: %d", err);
+	*flash_max_write_calls = 0;
+
+	memset(&fs, 0, sizeof(fs));
+	test_nvs_mount();
+
+	for (int i = 0; i < ARRAY_SIZE(first); i++) {
+		len = nvs_read(&fs, first[i].id, rd_buf, sizeof(rd_buf));
+		zassert_equal(len, first[i].len, "nvs_read unexpected failure: %d",
+			      len);
+		zassert_mem_equal(rd_buf, first[i].data, len,
+				  "uncommitted update not ignored");
+	}
+
+	/* The next update follows the interrupted one */
+	err = nvs_write_multi(&fs, third, ARRAY_SIZE(third));
+	zassert_true(err == 0, "nvs_write_multi failed: %d", err);
+
+	err = nvs_mount(&fs);
+	zassert_true(err == 0, "nvs_mount call failure: %d", err);
+
+	len = nvs_read(&fs, 1, rd_buf, sizeof(rd_buf));
+	zassert_true((len == 1) && (rd_buf[0] == 'x'), "update not stored");
+	len = nvs_read(&fs, 2, rd_buf, sizeof(rd_buf));
+	zassert_true((len == 3) && !memcmp(rd_buf, "ccc", 3),
+		     "uncommitted update not ignored");
+	len = nvs_read(&fs, 3, rd_buf, sizeof(rd_buf));
+	zassert_equal(len, -ENOENT, "entry not deleted");
+#endif
+}
+
 void test_main(void)
 {
 	__ASSERT_NO_MSG(device_is_ready(flash_dev));
@@ -871,7 +1048,13 @@ void test_main(void)
 			 ztest_unit_test_setup_teardown(
 				 test_nvs_cache_collission, setup, teardown),
 			 ztest_unit_test_setup_teardown(
-				 test_nvs_cache_gc, setup, teardown)
+				 test_nvs_cache_gc, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_sector_summary, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_background_gc, setup, teardown),
+			 ztest_unit_test_setup_teardown(
+				 test_nvs_write_multi, setup, teardown)
 			);
 
 	ztest_run_test_suite(test_nvs);
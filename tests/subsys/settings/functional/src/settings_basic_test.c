@@ -612,6 +612,149 @@ static void test_direct_loading_filter(void)
 	}
 }
 
+#if defined(CONFIG_SETTINGS_TXN)
+#include "settings_priv.h"
+
+static uint8_t txn_loaded[4];
+static unsigned int txn_load_cnt;
+
+static int txn_loader(const char *key, size_t len, settings_read_cb read_cb,
+		      void *cb_arg, void *param)
+{
+	const char *next;
+	int idx;
+
+	zassert_not_null(key, NULL);
+	settings_name_next(key, &next);
+	zassert_is_null(next, "Unexpected key: %s", key);
+
+	idx = key[0] - '0';
+	zassert_true(idx >= 0 && idx < ARRAY_SIZE(txn_loaded),
+		     "Unexpected key: %s", key);
+	zassert_equal(1, len, NULL);
+	zassert_equal(1, read_cb(cb_arg, &txn_loaded[idx], 1), NULL);
+	txn_load_cnt++;
+
+	return 0;
+}
+
+static void txn_load(void)
+{
+	memset(txn_loaded, 0, sizeof(txn_loaded));
+	txn_load_cnt = 0;
+	zassert_equal(0, settings_load_subtree_direct("txn", txn_loader, NULL),
+		      NULL);
+}
+
+static void test_txn(void)
+{
+	uint8_t val;
+	int rc;
+
+	val = 1;
+	zassert_equal(0, settings_save_one("txn/3", &val, 1), NULL);
+
+	zassert_equal(-EINVAL, settings_txn_set("txn/0", &val, 1),
+		      "set accepted without transaction");
+
+	/* Aborted transaction leaves the storage untouched */
+	zassert_equal(0, settings_txn_begin(), NULL);
+	zassert_equal(-EALREADY, settings_txn_begin(), NULL);
+	val = 10;
+	zassert_equal(0, settings_txn_set("txn/0", &val, 1), NULL);
+	settings_txn_abort();
+
+	txn_load();
+	zassert_equal(1, txn_load_cnt, NULL);
+	zassert_equal(1, txn_loaded[3], NULL);
+
+	/* Only the last staged value of a name is committed */
+	zassert_equal(0, settings_txn_begin(), NULL);
+	val = 10;
+	zassert_equal(0, settings_txn_set("txn/0", &val, 1), NULL);
+	val = 11;
+	zassert_equal(0, settings_txn_set("txn/1", &val, 1), NULL);
+	val = 12;
+	zassert_equal(0, settings_txn_set("txn/0", &val, 1), NULL);
+	zassert_equal(0, settings_txn_delete("txn/3"), NULL);
+	rc = settings_txn_commit();
+	zassert_equal(0, rc, "commit failed (%d)", rc);
+
+	txn_load();
+	zassert_equal(2, txn_load_cnt, NULL);
+	zassert_equal(12, txn_loaded[0], NULL);
+	zassert_equal(11, txn_loaded[1], NULL);
+	zassert_equal(0, txn_loaded[3], NULL);
+
+#if defined(CONFIG_SETTINGS_TXN_JOURNAL)
+	/* Journal left by a commit interrupted after its commit point */
+	const uint8_t journal[] = {
+		7, 0, 't', 'x', 'n', '/', '2', '=', 22,
+		7, 0, 't', 'x', 'n', '/', '1', '=', 21,
+		0, 0, 2, 0,
+	};
+
+	zassert_equal(0, settings_save_one(SETTINGS_TXN_JOURNAL_NAME, journal,
+					   sizeof(journal)), NULL);
+	zassert_equal(0, settings_txn_replay(), NULL);
+
+	txn_load();
+	zassert_equal(3, txn_load_cnt, NULL);
+	zassert_equal(12, txn_loaded[0], NULL);
+	zassert_equal(21, txn_loaded[1], NULL);
+	zassert_equal(22, txn_loaded[2], NULL);
+
+	/* The journal is removed once replayed */
+	zassert_equal(0, settings_txn_replay(), NULL);
+#endif
+}
+
+/* Enough commits for the back-end to compact its storage several times */
+#define TXN_ROUNDS 256
+
+static void test_txn_compact(void)
+{
+	uint8_t val = 0U;
+	int rc;
+
+	zassert_equal(0, settings_save_one("txn/3", &val, 1), NULL);
+
+	for (int round = 0; round < TXN_ROUNDS; round++) {
+		zassert_equal(0, settings_txn_begin(), NULL);
+		val = round;
+		zassert_equal(0, settings_txn_set("txn/0", &val, 1), NULL);
+		val = round + 1;
+		zassert_equal(0, settings_txn_set("txn/1", &val, 1), NULL);
+		/* txn/2 is only written once */
+		if (round == 0) {
+			val = 100;
+			zassert_equal(0, settings_txn_set("txn/2", &val, 1),
+				      NULL);
+		}
+		zassert_equal(0, settings_txn_delete("txn/3"), NULL);
+		rc = settings_txn_commit();
+		zassert_equal(0, rc, "commit %d failed (%d)", round, rc);
+	}
+
+	txn_load();
+	zassert_equal(3, txn_load_cnt, NULL);
+	zassert_equal((uint8_t)(TXN_ROUNDS - 1), txn_loaded[0], NULL);
+	zassert_equal((uint8_t)TXN_ROUNDS, txn_loaded[1], NULL);
+	zassert_equal(100, txn_loaded[2], NULL);
+	zassert_equal(0, txn_loaded[3], NULL);
+}
+#else
+static void test_txn(void)
+{
+	ztest_test_skip();
+}
+
+static void test_txn_compact(void)
+{
+	ztest_test_skip();
+}
+#endif /* CONFIG_SETTINGS_TXN */
+
 
 void test_main(void)
 {
@@ -620,7 +763,9 @@ void test_main(void)
 			 ztest_unit_test(test_support_rtn),
 			 ztest_unit_test(test_register_and_loading),
 			 ztest_unit_test(test_direct_loading),
-			 ztest_unit_test(test_direct_loading_filter)
+			 ztest_unit_test(test_direct_loading_filter),
+			 ztest_unit_test(test_txn),
+			 ztest_unit_test(test_txn_compact)
 			);
 
 	ztest_run_test_suite(settings_test_suite);
@@ -643,6 +643,61 @@ static void test_stream_flash_progress_clear(void)
 #endif
 }
 
+#ifdef CONFIG_STREAM_FLASH_ASYNC
+static void test_stream_flash_async(void)
+{
+	int rc;
+	size_t total = page_size * 2;
+
+	init_target();
+
+	/* Fill three pages, then overwrite the first two asynchronously */
+	rc = stream_flash_buffered_write(&ctx, write_buf, page_size * 3, true);
+	zassert_equal(rc, 0, "expected success");
+
+	memset(&ctx, 0, sizeof(ctx));
+	rc = stream_flash_init(&ctx, fdev, buf, BUF_LEN, FLASH_BASE, 0,
+			       stream_flash_callback);
+	zassert_equal(rc, 0, "expected success");
+
+	rc = stream_flash_async_enable(&ctx);
+	zassert_equal(rc, 0, "expected success");
+
+	rc = stream_flash_async_enable(&ctx);
+	zassert_equal(rc, -EINVAL, "expected failure");
+
+	/* Chunks smaller than a half buffer */
+	for (size_t off = 0; off < total; off += 100) {
+		rc = stream_flash_buffered_write(&ctx, write_buf + off,
+						 MIN(100, total - off), false);
+		zassert_equal(rc, 0, "expected success");
+	}
+
+	zassert_true(stream_flash_bytes_written(&ctx) < total,
+		     "buffered bytes should not be accounted for");
+
+	rc = stream_flash_buffered_write(&ctx, NULL, 0, true);
+	zassert_equal(rc, 0, "expected success");
+
+	zassert_equal(stream_flash_bytes_written(&ctx), total,
+		      "all bytes should be written after flush");
+
+	VERIFY_WRITTEN(0, total);
+
+	/* Third page should not be erased ahead */
+	VERIFY_WRITTEN(total, page_size);
+
+	rc = stream_flash_buffered_write(&ctx, write_buf, FLASH_AVAILABLE,
+					 false);
+	zassert_equal(rc, -ENOMEM, "expected failure");
+}
+#else
+static void test_stream_flash_async(void)
+{
+	ztest_test_skip();
+}
+#endif
+
 void test_main(void)
 {
 	__ASSERT_NO_MSG(device_is_ready(fdev));
@@ -665,6 +720,7 @@ void test_main(void)
 	     ztest_unit_test(test_stream_flash_buffered_write_whole_page),
 	     ztest_unit_test(test_stream_flash_erase_page),
 	     ztest_unit_test(test_stream_flash_bytes_written),
+	     ztest_unit_test(test_stream_flash_async),
 	     ztest_unit_test(test_stream_flash_progress_api),
 	     ztest_unit_test(test_stream_flash_progress_resume),
 	     ztest_unit_test(test_stream_flash_progress_clear)
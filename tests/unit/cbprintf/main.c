@@ -1197,6 +1197,102 @@ static void test_libc_substs(void)
 	}
 }
 
+struct span_buffer {
+	char buf[128];
+	size_t len;
+	size_t spans;
+};
+
+static int out_span(const void *data, size_t len, void *ctx)
+{
+	struct span_buffer *sb = ctx;
+
+	if (sb->len + len >= sizeof(sb->buf)) {
+		return -ENOSPC;
+	}
+
+	memcpy(&sb->buf[sb->len], data, len);
+	sb->len += len;
+	sb->buf[sb->len] = '\0';
+	sb->spans++;
+
+	return (int)len;
+}
+
+/* Check that the span output matches the character one */
+__printf_like(2, 3)
+static void check_span(struct span_buffer *sb, const char *format, ...)
+{
+	va_list ap, ap2;
+	int rc, rc_span;
+
+	reset_out();
+	(void)memset(sb, 0, sizeof(*sb));
+
+	va_start(ap, format);
+	va_copy(ap2, ap);
+	rc = cbvprintf(out, &outbuf, format, ap);
+	rc_span = cbvprintf_span(out_span, sb, format, ap2);
+	va_end(ap2);
+	va_end(ap);
+	outbuf_null_terminate(&outbuf);
+
+	zassert_equal(rc_span, rc, "%s: %d vs %d", format, rc_span, rc);
+	zassert_equal(strcmp(sb->buf, buf), 0, "%s: '%s' vs '%s'", format,
+		      sb->buf, buf);
+}
+
+__printf_like(2, 3)
+static int span_prf(struct span_buffer *sb, const char *format, ...)
+{
+	va_list ap;
+	int rc;
+
+	va_start(ap, format);
+	rc = cbvprintf_span(out_span, sb, format, ap);
+	va_end(ap);
+
+	return rc;
+}
+
+static void test_cbvprintf_span(void)
+{
+	struct span_buffer sb;
+	int rc;
+
+	check_span(&sb, "literal text only");
+	zassert_equal(sb.spans, 1, NULL);
+
+	check_span(&sb, "<%s> [%08u] %d|%-5d|%5d|%x|%X|%c|%%",
+		   "inf", 1234U, -42, 7, 7, 0xcafeU, 0xBEEFU, 'z');
+	check_span(&sb, "%u %u %u %u %u %d", 0U, 9U, 10U, 99U, 100U, INT_MIN);
+	check_span(&sb, "%u %lu %d", UINT32_MAX, (unsigned long)UINT32_MAX,
+		   INT_MAX);
+	check_span(&sb, "%20s|%-20s|%030d", "right", "left", -1);
+
+	if (IS_ENABLED(CONFIG_CBPRINTF_FULL_INTEGRAL)) {
+		check_span(&sb, "%llu %lld %llx %llu",
+			   (unsigned long long)UINT64_MAX,
+			   (long long)INT64_MIN,
+			   (unsigned long long)UINT64_MAX,
+			   10000000000ULL);
+	}
+
+	if (!IS_ENABLED(CONFIG_CBPRINTF_NANO)) {
+		check_span(&sb, "%o %#o %#x %.5d %+d % d", 8, 8, 255U, 42, 3, 3);
+
+		/* Literal text, padding and value are emitted whole */
+		check_span(&sb, "value: %8d", 12);
+		zassert_equal(sb.spans, 3, NULL);
+	}
+
+	/* Errors from the callback are reported */
+	(void)memset(&sb, 0, sizeof(sb));
+	sb.len = sizeof(sb.buf) - 4;
+	rc = span_prf(&sb, "%s", "too long");
+	zassert_equal(rc, -ENOSPC, "rc %d", rc);
+}
+
 static void test_cbprintf_package(void)
 {
 	if (!ENABLED_USE_PACKAGED) {
@@ -1466,6 +1562,7 @@ void test_main(void)
 			 ztest_unit_test(test_n),
 			 ztest_unit_test(test_p),
 			 ztest_unit_test(test_libc_substs),
+			 ztest_unit_test(test_cbvprintf_span),
 			 ztest_unit_test(test_cbprintf_package),
 			 ztest_unit_test(test_cbpprintf),
 			 ztest_unit_test(test_cbprintf_package_rw_string_indexes),
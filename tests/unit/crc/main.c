@@ -261,6 +261,55 @@ void test_crc8(void)
 	zassert_equal(fcs, expected, "0x%02x vs 0x%02x", fcs, expected);
 }
 
+/* Reflected CRC-32 computed a bit at a time, without any inversion */
+static uint32_t crc32_bitwise(uint32_t poly, uint32_t crc, const uint8_t *data,
+			      size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		crc ^= data[i];
+
+		for (int j = 0; j < 8; j++) {
+			crc = (crc >> 1) ^ ((crc & 1U) ? poly : 0U);
+		}
+	}
+
+	return crc;
+}
+
+void test_crc_tables(void)
+{
+	uint8_t buf[64];
+
+	for (int i = 0; i < sizeof(buf); i++) {
+		buf[i] = i * 37U + 11U;
+	}
+
+	/* Every alignment, and lengths around the slicing boundaries */
+	for (size_t off = 0; off < 8; off++) {
+		for (size_t len = 0; len <= sizeof(buf) - off; len++) {
+			const uint8_t *data = &buf[off];
+
+			zassert_equal(crc32_ieee(data, len),
+				      ~crc32_bitwise(0xEDB88320, 0xFFFFFFFF,
+						     data, len),
+				      "off %zu len %zu", off, len);
+			zassert_equal(crc32_c(0, data, len, true, true),
+				      ~crc32_bitwise(0x82F63B78, 0xFFFFFFFF,
+						     data, len),
+				      "off %zu len %zu", off, len);
+			zassert_equal(crc16_ccitt(0xFFFF, data, len),
+				      crc16_reflect(0x8408, 0xFFFF, data, len),
+				      "off %zu len %zu", off, len);
+			zassert_equal(crc16_itu_t(0x1D0F, data, len),
+				      crc16(0x1021, 0x1D0F, data, len),
+				      "off %zu len %zu", off, len);
+			zassert_equal(crc8_ccitt(0xFF, data, len),
+				      crc8(data, len, 0x07, 0xFF, false),
+				      "off %zu len %zu", off, len);
+		}
+	}
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_crc,
@@ -273,6 +322,7 @@ void test_main(void)
 			 ztest_unit_test(test_crc16_itu_t),
 			 ztest_unit_test(test_crc8_ccitt),
 			 ztest_unit_test(test_crc7_be),
-			 ztest_unit_test(test_crc8));
+			 ztest_unit_test(test_crc8),
+			 ztest_unit_test(test_crc_tables));
 	ztest_run_test_suite(test_crc);
 }